@@ -0,0 +1,36 @@
+// spongelang_bench 할당 카운터 (전역 operator new 교체)
+//
+// 교체는 이 파일 하나에만 둔다. 다른 TU 에서 operator delete 가 인라인되면
+// GCC 가 new 로 받은 포인터를 free 한다고 보고 -Wmismatched-new-delete 를 낸다.
+// new / new[] 는 같은 malloc 경로를 쓰고 delete 는 모두 free 로 짝을 맞춘다.
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "bench_harness.hpp"
+
+namespace sponge::bench {
+std::atomic<uint64_t> gAllocCount{0};
+std::atomic<uint64_t> gAllocBytes{0};
+}
+
+namespace {
+
+void* countedAlloc(std::size_t n)
+{
+    sponge::bench::gAllocCount.fetch_add(1, std::memory_order_relaxed);
+    sponge::bench::gAllocBytes.fetch_add(n, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t n) { return countedAlloc(n); }
+void* operator new[](std::size_t n) { return countedAlloc(n); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
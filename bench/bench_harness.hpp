@@ -0,0 +1,126 @@
+#pragma once
+// spongelang_bench 측정 하네스: 반복 횟수 자동 보정, ns/op, 할당/op, 처리량
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sponge::bench {
+
+// bench_alloc.cpp 의 operator new 교체가 올리는 카운터
+extern std::atomic<uint64_t> gAllocCount;
+extern std::atomic<uint64_t> gAllocBytes;
+
+struct Result {
+    std::string name;        // 측정 대상 (parse, vm.run, ...)
+    std::string workload;    // 입력 종류 (deep-1024, many-small, ...)
+    uint64_t iters = 0;
+    double nsPerOp = 0;
+    double allocsPerOp = 0;
+    double bytesPerOp = 0;
+    double opsPerSec = 0;
+    double itemsPerSec = 0;  // items = op 하나가 처리하는 단위 (노드, 식, 줄 ...)
+};
+
+class Harness {
+public:
+    Harness(double minSeconds, std::string filter)
+        : minSeconds(minSeconds), filter(std::move(filter)) {}
+
+    /**
+     * fn() 한 번 = op 하나. minSeconds 이상 걸릴 때까지 반복 횟수를 두 배씩 늘린다.
+     * 마지막 측정 구간의 할당 수/바이트를 op 당으로 나눈다.
+     */
+    template <typename F>
+    void run(const std::string& name, const std::string& workload,
+             double itemsPerOp, F&& fn)
+    {
+        std::string id = name + "/" + workload;
+        if (!filter.empty() && id.find(filter) == std::string::npos) return;
+
+        fn();  // 워밍업 (캐시/지연 초기화)
+
+        uint64_t iters = 1;
+        for (;;) {
+            uint64_t a0 = gAllocCount.load(std::memory_order_relaxed);
+            uint64_t b0 = gAllocBytes.load(std::memory_order_relaxed);
+            auto t0 = std::chrono::steady_clock::now();
+
+            for (uint64_t i = 0; i < iters; ++i) fn();
+
+            auto t1 = std::chrono::steady_clock::now();
+            uint64_t a1 = gAllocCount.load(std::memory_order_relaxed);
+            uint64_t b1 = gAllocBytes.load(std::memory_order_relaxed);
+
+            double secs = std::chrono::duration<double>(t1 - t0).count();
+            if (secs >= minSeconds || iters >= (1ull << 40)) {
+                Result r;
+                r.name = name;
+                r.workload = workload;
+                r.iters = iters;
+                r.nsPerOp = secs * 1e9 / static_cast<double>(iters);
+                r.allocsPerOp = static_cast<double>(a1 - a0) / static_cast<double>(iters);
+                r.bytesPerOp = static_cast<double>(b1 - b0) / static_cast<double>(iters);
+                r.opsPerSec = static_cast<double>(iters) / secs;
+                r.itemsPerSec = r.opsPerSec * itemsPerOp;
+                results.push_back(r);
+                print(r);
+                return;
+            }
+            iters *= 2;
+        }
+    }
+
+    const std::vector<Result>& all() const { return results; }
+
+    static void printHeader()
+    {
+        std::printf("%-28s %-18s %12s %12s %12s %14s\n",
+                    "benchmark", "workload", "ns/op", "allocs/op", "bytes/op", "items/s");
+    }
+
+    void writeJson(std::ostream& os) const
+    {
+        os << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            os << "  {\"name\": \"" << r.name << "\", \"workload\": \"" << r.workload
+               << "\", \"iters\": " << r.iters
+               << ", \"ns_per_op\": " << r.nsPerOp
+               << ", \"allocs_per_op\": " << r.allocsPerOp
+               << ", \"bytes_per_op\": " << r.bytesPerOp
+               << ", \"ops_per_sec\": " << r.opsPerSec
+               << ", \"items_per_sec\": " << r.itemsPerSec << "}"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        os << "]\n";
+    }
+
+    void writeCsv(std::ostream& os) const
+    {
+        os << "name,workload,iters,ns_per_op,allocs_per_op,bytes_per_op,ops_per_sec,items_per_sec\n";
+        for (const Result& r : results) {
+            os << r.name << ',' << r.workload << ',' << r.iters << ','
+               << r.nsPerOp << ',' << r.allocsPerOp << ',' << r.bytesPerOp << ','
+               << r.opsPerSec << ',' << r.itemsPerSec << '\n';
+        }
+    }
+
+private:
+    double minSeconds;
+    std::string filter;
+    std::vector<Result> results;
+
+    static void print(const Result& r)
+    {
+        std::printf("%-28s %-18s %12.1f %12.2f %12.1f %14.3e\n",
+                    r.name.c_str(), r.workload.c_str(),
+                    r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.itemsPerSec);
+        std::fflush(stdout);
+    }
+};
+
+} // namespace sponge::bench
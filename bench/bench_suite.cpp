@@ -0,0 +1,463 @@
+// spongelang_bench: parse / IR build / 평가 / VM / 팩 로딩 벤치마크 모음
+//
+//   spongelang_bench [--min-time SEC] [--filter SUBSTR] [--json FILE] [--csv FILE]
+//
+// JSON/CSV 결과는 커밋 간 diff 용으로 쓴다.
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "bench_workloads.hpp"
+
+#include "meta_engine.hpp"
+#include "meta_absorb_loader.hpp"
+#include "meta2_processor.hpp"
+#include "meta_mapped_file.hpp"
+#include "meta_pack_binary.hpp"
+#include "meta_script_compiler.hpp"
+#include "meta_script_interp.hpp"
+
+using namespace sponge;
+using namespace sponge::bench;
+
+namespace {
+
+volatile double gSink = 0;
+
+size_t countNodes(const std::string& src)
+{
+    MetaParser p;
+    return p.parse(src).size();
+}
+
+// 산술 팩 (+ - * /) 을 엔진에 직접 흡수
+void absorbArith(SpongeMetaEngine& eng, const std::string& name = "arith")
+{
+    MetaAbsorbLoader::LangPack pack;
+    pack.name = name;
+    const char* ops[]   = { "+", "-", "*", "/" };
+    const char* rules[] = { "a + b", "a - b", "a * b", "a / b" };
+    const char* codes[] = { "ADD", "SUB", "MUL", "DIV" };
+    for (int i = 0; i < 4; ++i) {
+        pack.precedence[ops[i]] = i < 2 ? 10 : 20;
+        pack.evalRules[ops[i]] = rules[i];
+        pack.bytecode[ops[i]] = codes[i];
+    }
+    MetaAbsorbLoader().mount(eng, pack);
+}
+
+struct Workload {
+    std::string name;
+    std::string src;
+    size_t nodes;
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    double minTime = 0.2;
+    std::string filter, jsonPath, csvPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "missing value for %s\n", a.c_str());
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        if (a == "--min-time")    minTime = std::atof(next().c_str());
+        else if (a == "--filter") filter = next();
+        else if (a == "--json")   jsonPath = next();
+        else if (a == "--csv")    csvPath = next();
+        else {
+            std::fprintf(stderr,
+                "usage: %s [--min-time SEC] [--filter SUBSTR] [--json FILE] [--csv FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Harness h(minTime, filter);
+    Harness::printHeader();
+
+    std::vector<Workload> exprs;
+    for (size_t n : { 16, 1024 }) {
+        std::string s = deepExpr(n);
+        exprs.push_back({ "deep-" + std::to_string(n), s, countNodes(s) });
+    }
+    for (size_t d : { 4, 10 }) {
+        std::string s = wideExpr(d);
+        exprs.push_back({ "wide-" + std::to_string(d), s, countNodes(s) });
+    }
+
+    // ---- parse ----
+    for (auto& w : exprs) {
+        MetaParser p;
+        IRArena arena;
+        h.run("parse", w.name, double(w.nodes), [&] { p.parse(w.src, arena); });
+    }
+
+    // ---- IR build (파서 없이 빌더만) ----
+    for (size_t n : { 16, 1024 }) {
+        IRArena arena;
+        OpId add = OperatorTable().find("+");
+        h.run("ir.build", "chain-" + std::to_string(n), double(2 * n), [&] {
+            arena.clear();
+            IRBuilder b(arena);
+            IRRef acc = b.literal(1);
+            for (size_t i = 0; i < n; ++i) acc = b.binary(add, acc, b.literal(double(i)));
+            arena.root = acc;
+        });
+    }
+
+    // ---- 최적화 패스 ----
+    for (auto& w : exprs) {
+        MetaParser p;
+        IRArena arena;
+        PassManager pm = PassManager::standard();
+        OperatorTable ops;
+        for (const char* op : { "+", "-", "*", "/" })
+            ops.define(ops.intern(op), kernelFunction(kernelFromRule(std::string("a ") + op + " b")));
+        h.run("passes.standard", w.name, double(w.nodes), [&] {
+            p.parse(w.src, arena);
+            pm.run(arena, ops);
+        });
+    }
+
+    // ---- 평가 (캐시 hit → 파싱 없이 트리 평가 / 클로저 / VM / JIT) ----
+    for (ExecMode mode : { ExecMode::TREE, ExecMode::CLOSURE, ExecMode::VM, ExecMode::JIT }) {
+        const char* name = mode == ExecMode::TREE    ? "engine.run.tree"
+                         : mode == ExecMode::CLOSURE ? "engine.run.closure"
+                         : mode == ExecMode::VM      ? "engine.run.vm"
+                                                     : "engine.run.jit";
+        for (auto& w : exprs) {
+            SpongeMetaEngine eng;
+            absorbArith(eng);
+            eng.setOptimize(false);   // 상수 식이 통째로 접히지 않게
+            eng.setMode(mode);
+            h.run(name, w.name, double(w.nodes), [&] { gSink = gSink + eng.run(w.src); });
+        }
+    }
+
+    // ---- 반복 부분식: hash-consing 끔 / 켬 (켜면 공유 노드를 한 번만 파싱 후 평가) ----
+    {
+        std::string s = repeatedExpr(12);
+        std::string name = "repeated-12";
+        double nodes = double(countNodes(s));
+        for (bool cons : { false, true }) {
+            MetaParser p;
+            p.hashCons = cons;
+            IRArena arena;
+            h.run(cons ? "parse.hashcons" : "parse", name, nodes, [&] { p.parse(s, arena); });
+
+            SpongeMetaEngine eng;
+            absorbArith(eng);
+            eng.setOptimize(false);
+            eng.setHashCons(cons);
+            h.run(cons ? "engine.run.tree.hashcons" : "engine.run.tree", name, nodes,
+                  [&] { gSink = gSink + eng.run(s); });
+        }
+    }
+
+    // ---- 파싱 포함 전체 경로: 캐시 끔 / 캐시 안에 다 들어감 ----
+    {
+        auto small = manySmall(200);
+        SpongeMetaEngine eng;
+        absorbArith(eng);
+        eng.setCacheCapacity(0);
+        h.run("engine.run.uncached", "many-small-200", 200.0, [&] {
+            for (auto& s : small) gSink = gSink + eng.run(s);
+        });
+
+        SpongeMetaEngine cached;
+        absorbArith(cached);
+        h.run("engine.run.cached", "many-small-200", 200.0, [&] {
+            for (auto& s : small) gSink = gSink + cached.run(s);
+        });
+    }
+
+    // ---- 언어 8 개 상주: 식마다 다른 언어로 (id / 이름) ----
+    {
+        auto small = manySmall(200);
+        SpongeMetaEngine eng;
+        std::vector<LangId> ids;
+        std::vector<std::string> names;
+        for (int k = 0; k < 8; ++k) {
+            names.push_back("arith" + std::to_string(k));
+            absorbArith(eng, names.back());
+            ids.push_back(eng.languageId(names.back()));
+        }
+        h.run("engine.run.lang-id", "langs-8/many-small-200", 200.0, [&] {
+            for (size_t i = 0; i < small.size(); ++i) gSink = gSink + eng.run(ids[i % 8], small[i]);
+        });
+        h.run("engine.run.lang-name", "langs-8/many-small-200", 200.0, [&] {
+            for (size_t i = 0; i < small.size(); ++i) gSink = gSink + eng.run(names[i % 8], small[i]);
+        });
+    }
+
+    // ---- 팩 hot reload: 교체 비용 / 다른 스레드가 계속 교체하는 중의 run ----
+    {
+        SpongeMetaEngine eng;
+        absorbArith(eng);
+        h.run("engine.absorb", "arith", 1.0, [&] { absorbArith(eng); });
+
+        std::atomic<bool> stop{ false };
+        std::thread reloader([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                absorbArith(eng);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+        h.run("engine.run.reloading", exprs[0].name, double(exprs[0].nodes), [&] { gSink = gSink + eng.run(exprs[0].src); });
+        stop = true;
+        reloader.join();
+    }
+
+    // ---- 멀티코어 배치 ----
+    {
+        auto small = manySmall(1000);
+
+        SpongeMetaEngine batch;
+        absorbArith(batch);
+        h.run("engine.runBatch", "many-small-1000", 1000.0, [&] {
+            auto r = batch.runBatch(small);
+            gSink = gSink + r[0];
+        });
+    }
+
+    // ---- VM::run 단독 ----
+    for (auto& w : exprs) {
+        SpongeMetaEngine eng;
+        absorbArith(eng);
+        eng.setOptimize(false);
+        Bytecode bc = eng.compile(w.src);
+        VM vm;
+        h.run("vm.run", w.name, double(bc.ops.size()), [&] { gSink = gSink + vm.run(bc); });
+    }
+
+    // ---- JIT: 파싱 + 코드 생성 비용 / 네이티브 호출 단독 ----
+    if (JitCompiler::available()) {
+        for (auto& w : exprs) {
+            SpongeMetaEngine eng;
+            absorbArith(eng);
+            eng.setOptimize(false);
+            eng.setCacheCapacity(0);
+            h.run("jit.compile", w.name, double(w.nodes), [&] {
+                gSink = gSink + double(eng.jitCompile(w.src)->codeSize());
+            });
+
+            auto fn = eng.jitCompile(w.src);
+            h.run("jit.call", w.name, double(w.nodes), [&] { gSink = gSink + (*fn)(); });
+        }
+    }
+
+    // ---- 코드 생성: 백엔드별 (IR 은 캐시, 출력 문자열 용량 재사용) ----
+    {
+        std::vector<Workload> emitExprs = { exprs[1], exprs[3] };
+        std::string big = wideExpr(16);
+        emitExprs.push_back({ "wide-16", big, countNodes(big) });
+
+        for (auto& w : emitExprs) {
+            SpongeMetaEngine eng;
+            absorbArith(eng);
+            eng.setOptimize(false);
+            std::string out;
+            for (const char* backend : { "go", "c", "rust", "nasm" }) {
+                h.run(std::string("emit.") + backend, w.name, double(w.nodes), [&] {
+                    out.clear();
+                    eng.emit(w.src, backend, out);
+                    gSink = gSink + double(out.size());
+                });
+            }
+        }
+    }
+
+    // ---- 컬럼 평가 ----
+    {
+        SpongeMetaEngine eng;
+        absorbArith(eng);
+        std::vector<double> x(1 << 16), y(1 << 16);
+        for (size_t i = 0; i < x.size(); ++i) { x[i] = double(i); y[i] = double(i % 13 + 1); }
+        h.run("engine.evaluateColumns", "rows-65536", double(x.size()), [&] {
+            auto r = eng.evaluateColumns("x * x + 3 * y - x / y", {{ "x", x }, { "y", y }});
+            gSink = gSink + r[0];
+        });
+    }
+
+    // ---- 바인딩 증분 재계산 ----
+    // 입력 100 개 × 100 행 시트: 행 r 의 셀 c = in_c * 2 + (r-1 행의 셀 c) / 3 + in_(c+1)
+    // tick 마다 입력 k 개를 바꾸고 마지막 행 전체를 읽는다.
+    {
+        constexpr int cols = 100, rows = 100;
+        SpongeMetaEngine eng;
+        absorbArith(eng);
+        auto cell = [](int r, int c) { return "c" + std::to_string(r) + "_" + std::to_string(c); };
+        for (int c = 0; c < cols; ++c) eng.setInput("in" + std::to_string(c), double(c));
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                std::string f = "in" + std::to_string(c) + " * 2";
+                if (r > 0) f += " + " + cell(r - 1, c) + " / 3 + in" + std::to_string((c + 1) % cols);
+                eng.define(cell(r, c), f);
+            }
+        }
+        std::vector<std::string> sinks;
+        for (int c = 0; c < cols; ++c) sinks.push_back(cell(rows - 1, c));
+
+        for (int changed : { 1, cols }) {
+            uint64_t tick = 0;
+            h.run("bindings.tick", "sheet-10000/changed-" + std::to_string(changed),
+                  double(rows * cols), [&] {
+                ++tick;
+                for (int k = 0; k < changed; ++k)
+                    eng.setInput("in" + std::to_string((tick + k) % cols), double(tick * 7 + k));
+                double s = 0.0;
+                for (const auto& n : sinks) s += eng.value(n);
+                gSink = gSink + s;
+            });
+        }
+    }
+
+    // ---- 식 파일: 매번 파싱 / .spbc 캐시 (warm = mmap 후 파싱 생략, cold = 파싱 + 캐시 쓰기) ----
+    {
+        auto dir = std::filesystem::temp_directory_path();
+        std::string srcPath = (dir / "spongelang_bench_exprs.sp").string();
+        std::string cachePath = srcPath + ".spbc";
+        {
+            std::ofstream f(srcPath);
+            for (auto& s : manySmall(10000)) f << s << "\n";
+        }
+
+        SpongeMetaEngine eng;
+        absorbArith(eng);
+        auto sink = [](size_t, double v) { gSink = gSink + v; };
+        h.run("engine.runFile", "many-small-10000", 10000.0, [&] {
+            eng.runFile(srcPath, sink);
+        });
+        h.run("engine.runFileCached.cold", "many-small-10000", 10000.0, [&] {
+            std::filesystem::remove(cachePath);
+            eng.runFileCached(srcPath, cachePath, sink);
+        });
+        eng.runFileCached(srcPath, cachePath, sink);
+        h.run("engine.runFileCached.warm", "many-small-10000", 10000.0, [&] {
+            eng.runFileCached(srcPath, cachePath, sink);
+        });
+
+        std::filesystem::remove(cachePath);
+        std::filesystem::remove(srcPath);
+    }
+
+    // ---- 팩 로딩 ----
+    {
+        auto dir = std::filesystem::temp_directory_path();
+        std::string schemaPath = (dir / "spongelang_bench_schema.meta").string();
+        writeSchema(schemaPath);
+
+        for (size_t n : { 8, 512 }) {
+            std::string packPath = (dir / ("spongelang_bench_pack_" + std::to_string(n) + ".meta")).string();
+            writeLargePack(packPath, n);
+
+            MetaAbsorbLoader loader;
+            h.run("loader.loadFromFile", "ops-" + std::to_string(n), double(n), [&] {
+                auto pack = loader.loadFromFile(packPath);
+                gSink = gSink + double(pack.precedence.size());
+            });
+
+            auto pack = loader.loadFromFile(packPath);
+            SpongeMetaEngine eng;
+            h.run("loader.mount", "ops-" + std::to_string(n), double(n), [&] {
+                loader.mount(eng, pack);
+            });
+
+            // 바이너리 팩: mmap + 검증 + 흡수 (cold start 경로)
+            std::string binPath = packPath + ".spack";
+            compileBinaryPack(pack, binPath);
+            h.run("loader.mountFile.binary", "ops-" + std::to_string(n), double(n), [&] {
+                loader.mountFile(eng, binPath);
+            });
+            h.run("loader.mountFile.text", "ops-" + std::to_string(n), double(n), [&] {
+                loader.mountFile(eng, packPath);
+            });
+            std::filesystem::remove(binPath);
+
+            Meta2Processor proc;
+            h.run("meta2.parseMetaWithSchema", "ops-" + std::to_string(n), double(n), [&] {
+                proc.schema.entries.clear();
+                auto p = proc.parseMetaWithSchema(schemaPath, packPath);
+                gSink = gSink + double(p.precedence.size());
+            });
+
+            std::filesystem::remove(packPath);
+        }
+        std::filesystem::remove(schemaPath);
+    }
+
+    // ---- 내장 언어 (packs/rust.meta 에서 생성) vs 같은 .meta 를 텍스트로 흡수 ----
+    if (findBuiltin("rust")) {
+        std::string packPath = std::string(SPONGE_PACKS_DIR) + "/rust.meta";
+        MetaAbsorbLoader loader;
+        SpongeMetaEngine eng;
+        h.run("loader.mountFile.text", "rust", 1.0, [&] { loader.mountFile(eng, packPath); });
+        h.run("engine.absorbBuiltin", "rust", 1.0, [&] { eng.absorbBuiltin("rust"); });
+
+        // 캐시를 끄고 식마다 렉싱 + 파싱 + 평가
+        auto small = manySmall(200);
+        for (bool builtin : { false, true }) {
+            SpongeMetaEngine e;
+            if (builtin) e.absorbBuiltin("rust");
+            else loader.mountFile(e, packPath);
+            e.setCacheCapacity(0);
+            h.run(builtin ? "engine.run.uncached.builtin" : "engine.run.uncached.text", "rust/many-small-200",
+                  200.0, [&] { for (auto& s : small) gSink = gSink + e.run(s); });
+        }
+    }
+
+    // ---- .sp 스크립트: examples/xagi_fullstack.sp ----
+    // tokenize() 루프 (자기 소스를 입력으로) 를 레지스터 VM 과 AST 인터프리터로
+    {
+        std::string src(MappedFile(std::string(SPONGE_EXAMPLES_DIR) + "/xagi_fullstack.sp").view());
+        const double bytes = double(src.size());
+        std::ostream discard(nullptr);
+
+        h.run("script.compile", "xagi_fullstack", bytes, [&] {
+            ScriptProgram p = compileScript(parseScript(src));
+            gSink = gSink + double(p.functions.size());
+        });
+
+        ScriptModule module = parseScript(src);
+        ScriptProgram program = compileScript(module);
+        ScriptVM vm(program, discard);
+        ScriptInterpreter interp(module, discard);
+        ScriptValue input = ScriptValue::string(src);
+
+        h.run("script.tokenize.vm", "xagi_fullstack", bytes, [&] {
+            gSink = gSink + double(vm.call("tokenize", { input }).items().size());
+        });
+        h.run("script.tokenize.interp", "xagi_fullstack", bytes, [&] {
+            gSink = gSink + double(interp.call("tokenize", { input }).items().size());
+        });
+
+        // 전역 초기화 + main() 한 번 (매번 새 실행기)
+        h.run("script.run.vm", "xagi_fullstack", 1.0, [&] { ScriptVM(program, discard).run(); });
+        h.run("script.run.interp", "xagi_fullstack", 1.0, [&] { ScriptInterpreter(module, discard).run(); });
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream f(jsonPath);
+        h.writeJson(f);
+    }
+    if (!csvPath.empty()) {
+        std::ofstream f(csvPath);
+        h.writeCsv(f);
+    }
+    return 0;
+}
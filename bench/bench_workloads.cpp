@@ -0,0 +1,108 @@
+#include "bench_workloads.hpp"
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace sponge::bench {
+
+static const char kOps[] = { '+', '-', '*', '/' };
+
+std::string deepExpr(size_t terms, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::string s = std::to_string(1 + rng() % 9);
+    for (size_t i = 1; i < terms; ++i) {
+        s += ' ';
+        s += kOps[rng() % 4];
+        s += ' ';
+        s += std::to_string(1 + rng() % 9);
+    }
+    return s;
+}
+
+static void wideRec(std::string& s, size_t depth, std::mt19937& rng)
+{
+    if (depth == 0) {
+        s += std::to_string(1 + rng() % 9);
+        return;
+    }
+    s += '(';
+    wideRec(s, depth - 1, rng);
+    s += ' ';
+    s += kOps[rng() % 4];
+    s += ' ';
+    wideRec(s, depth - 1, rng);
+    s += ')';
+}
+
+std::string wideExpr(size_t depth, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::string s;
+    wideRec(s, depth, rng);
+    return s;
+}
+
+std::string repeatedExpr(size_t depth, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::string s = "(" + std::to_string(1 + rng() % 9) + " + " + std::to_string(1 + rng() % 9) + ")";
+    for (size_t i = 0; i < depth; ++i) {
+        char op = kOps[rng() % 4];
+        s = "(" + s + " " + op + " " + s + ")";
+    }
+    return s;
+}
+
+std::vector<std::string> manySmall(size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::string> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(std::to_string(rng() % 1000) + " " + kOps[rng() % 4] + " " +
+                      std::to_string(1 + rng() % 1000) + " " + kOps[rng() % 4] + " " +
+                      std::to_string(1 + rng() % 100));
+    }
+    return out;
+}
+
+void writeLargePack(const std::string& path, size_t operators)
+{
+    std::ofstream f(path);
+    if (!f.is_open()) throw std::runtime_error("cannot write " + path);
+
+    static const char* rules[] = { "a + b", "a - b", "a * b", "a / b" };
+    static const char* codes[] = { "ADD", "SUB", "MUL", "DIV" };
+
+    f << "language: bench\n\ntokens:\n";
+    f << "  number: \"[0-9]+\"\n";
+    f << "  ident: \"[A-Za-z_][A-Za-z0-9_]*\"\n";
+
+    f << "\noperators:\n";
+    for (size_t i = 0; i < operators; ++i) f << "  op" << i << ": " << (i % 50) << "\n";
+
+    f << "\nevaluate:\n";
+    for (size_t i = 0; i < operators; ++i) f << "  op" << i << ": \"" << rules[i % 4] << "\"\n";
+
+    f << "\nir:\n";
+    for (size_t i = 0; i < operators; ++i) f << "  op" << i << ": binary\n";
+
+    f << "\nbytecode:\n";
+    for (size_t i = 0; i < operators; ++i) f << "  op" << i << ": " << codes[i % 4] << "\n";
+}
+
+void writeSchema(const std::string& path)
+{
+    std::ofstream f(path);
+    if (!f.is_open()) throw std::runtime_error("cannot write " + path);
+
+    for (const char* k : { "language", "tokens", "operators", "evaluate", "ir", "bytecode" }) {
+        f << "  - key: " << k << "\n";
+        f << "    type: map\n";
+        f << "    value: string\n";
+    }
+}
+
+} // namespace sponge::bench
@@ -0,0 +1,27 @@
+#pragma once
+// 합성 워크로드 생성기
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sponge::bench {
+
+// 1 + 2 * 3 - 4 / 5 ... 처럼 왼쪽으로 깊어지는 식 (terms 개 항)
+std::string deepExpr(size_t terms, unsigned seed = 1);
+
+// 균형 이진 트리 모양 식 ((a+b)*(c-d)) ... (depth 단계)
+std::string wideExpr(size_t depth, unsigned seed = 1);
+
+// 같은 부분식을 두 번씩 쓰는 식 (s → (s op s), depth 단계). 트리로는 2^depth 배로 커진다
+std::string repeatedExpr(size_t depth, unsigned seed = 1);
+
+// 짧은 식 count 개 (서로 다름)
+std::vector<std::string> manySmall(size_t count, unsigned seed = 1);
+
+// operators 개 연산자를 가진 .meta 팩 파일을 path 에 쓴다
+void writeLargePack(const std::string& path, size_t operators);
+
+// meta.meta 스키마 파일을 path 에 쓴다 (Meta2Processor 용)
+void writeSchema(const std::string& path);
+
+} // namespace sponge::bench
@@ -0,0 +1,111 @@
+// VM 마이크로벤치마크: 기존 switch + vector push/pop 루프 vs 새 실행 코어
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "meta_vm.hpp"
+
+using namespace sponge;
+
+// ------------------------------------------------------
+// 기준: 재설계 이전의 VM::run (매 실행 clear, push_back/pop_back)
+// ------------------------------------------------------
+static double legacyRun(const Bytecode& bc, std::vector<double>& stack)
+{
+    stack.clear();
+    size_t di = 0;
+
+    for (size_t i = 0; i < bc.ops.size(); ++i) {
+        switch (bc.ops[i]) {
+            case OpCode::PUSH:
+                stack.push_back(bc.data[di++]);
+                break;
+            case OpCode::ADD: {
+                double b = stack.back(); stack.pop_back();
+                double a = stack.back(); stack.pop_back();
+                stack.push_back(a + b);
+                break;
+            }
+            case OpCode::SUB: {
+                double b = stack.back(); stack.pop_back();
+                double a = stack.back(); stack.pop_back();
+                stack.push_back(a - b);
+                break;
+            }
+            case OpCode::MUL: {
+                double b = stack.back(); stack.pop_back();
+                double a = stack.back(); stack.pop_back();
+                stack.push_back(a * b);
+                break;
+            }
+            case OpCode::DIV: {
+                double b = stack.back(); stack.pop_back();
+                double a = stack.back(); stack.pop_back();
+                stack.push_back(a / b);
+                break;
+            }
+            case OpCode::HALT:
+                return stack.back();
+            default:
+                throw std::runtime_error("legacy VM: unsupported opcode");
+        }
+    }
+    throw std::runtime_error("VM halted unexpectedly");
+}
+
+// ((((1 + 2) * 3) - 4) / 5 ...) 형태의 terms 항짜리 식
+static Bytecode makeProgram(size_t terms)
+{
+    static const OpCode cycle[] = { OpCode::ADD, OpCode::MUL, OpCode::SUB, OpCode::DIV };
+
+    Bytecode bc;
+    bc.ops.push_back(OpCode::PUSH);
+    bc.data.push_back(1.0);
+    for (size_t i = 0; i < terms; ++i) {
+        bc.ops.push_back(OpCode::PUSH);
+        bc.data.push_back(1.0 + static_cast<double>(i % 7));
+        bc.ops.push_back(cycle[i % 4]);
+    }
+    bc.ops.push_back(OpCode::HALT);
+    return bc;
+}
+
+template <typename F>
+static double nsPerRun(size_t iters, F&& f, double& sink)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iters; ++i) sink += f();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iters);
+}
+
+int main(int argc, char** argv)
+{
+    size_t iters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    std::printf("%-8s %14s %14s %9s\n", "terms", "legacy ns/op", "vm ns/op", "speedup");
+
+    for (size_t terms : { 4, 16, 64, 256 }) {
+        Bytecode bc = makeProgram(terms);
+        VM::prepare(bc);
+
+        VM vm;
+        std::vector<double> legacyStack;
+        double sinkA = 0, sinkB = 0;
+
+        double legacy = nsPerRun(iters, [&] { return legacyRun(bc, legacyStack); }, sinkA);
+        double fast   = nsPerRun(iters, [&] { return vm.run(bc); }, sinkB);
+
+        if (sinkA != sinkB && !(std::isnan(sinkA) && std::isnan(sinkB))) {
+            std::fprintf(stderr, "result mismatch: %g vs %g\n", sinkA, sinkB);
+            return 1;
+        }
+
+        std::printf("%-8zu %14.1f %14.1f %8.2fx\n", terms, legacy, fast, legacy / fast);
+    }
+    return 0;
+}
@@ -1,4 +1,9 @@
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <string>
+#include <vector>
 
 #include "meta/meta2_processor.hpp"
 #include "meta/meta_schema.hpp"
@@ -7,20 +12,218 @@
 #include "meta/meta_engine.hpp"
 #include "meta/meta_absorb_loader.hpp"
 #include "meta/meta2_processor.hpp"
+#include "meta/meta_mapped_file.hpp"
+#include "meta/meta_pack_binary.hpp"
+#include "meta/meta_pipeline.hpp"
+#include "meta/meta_script_compiler.hpp"
+#include "meta/meta_script_interp.hpp"
+#include "meta/meta_stats.hpp"
 
 using namespace sponge;
 
-int main() {
+#if SPONGE_STATS
+// ------------------------------------------------------
+// --stats 할당 카운터 (전역 operator new 교체, 꺼져 있으면 분기 하나)
+// ------------------------------------------------------
+void* operator new(std::size_t n)
+{
+    Stats::noteAllocation(n);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n)
+{
+    return operator new(n);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+// ------------------------------------------------------
+// spongelang pack compile <in.meta> <out.spack>
+// spongelang pack info <pack>
+// ------------------------------------------------------
+static int packCommand(int argc, char** argv) {
+    std::string cmd = argc > 2 ? argv[2] : "";
+
+    if (cmd == "compile" && argc == 5) {
+        MetaAbsorbLoader loader;
+        auto pack = loader.loadFromFile(argv[3]);
+        compileBinaryPack(pack, argv[4]);
+
+        PackImage img(argv[4]);
+        std::cout << "wrote " << argv[4] << " (" << img.size() << " bytes, "
+                  << img.operators().size() << " operators)\n";
+        return 0;
+    }
+
+    if (cmd == "info" && argc == 4) {
+        PackImage img(argv[3]);
+        std::cout << "language: " << img.name() << "\n"
+                  << "version:  " << img.version() << "\n"
+                  << "size:     " << img.size() << " bytes\n"
+                  << "checksum: " << std::hex << img.checksum() << std::dec << "\n"
+                  << "tokens:   " << img.tokens().size() << "\n"
+                  << "lexer:    " << img.lexerRules().size() << " rules, "
+                  << img.lexerTables().accept.size() << " states, "
+                  << img.lexerTables().classCount << " byte classes\n"
+                  << "operators:\n";
+        for (auto& op : img.operators()) {
+            std::cout << "  " << img.str(op.name);
+            if (op.flags & PACK_OP_PRECEDENCE) std::cout << "  prec=" << op.precedence;
+            if (op.flags & PACK_OP_EVAL)       std::cout << "  eval=\"" << img.str(op.evalRule) << "\"";
+            if (op.flags & PACK_OP_BYTECODE)   std::cout << "  bytecode=" << img.str(op.bytecodeName);
+            if (op.flags & PACK_OP_RIGHT_ASSOC) std::cout << "  right";
+            std::cout << "\n";
+        }
+        return 0;
+    }
+
+    std::cerr << "usage: spongelang pack compile <in.meta> <out.spack>\n"
+                 "       spongelang pack info <pack>\n";
+    return 2;
+}
+
+// ------------------------------------------------------
+// spongelang run [--interp | --dump] <file.sp>
+// 맨 위 문장을 실행하고 fn main() 이 있으면 호출
+//   --interp  바이트코드 대신 AST 인터프리터로 (비교용)
+//   --dump    컴파일된 바이트코드만 출력
+// ------------------------------------------------------
+static int runCommand(int argc, char** argv) {
+    bool interp = false, dump = false;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--interp") interp = true;
+        else if (arg == "--dump") dump = true;
+        else files.push_back(arg);
+    }
+    if (files.size() != 1 || (interp && dump)) {
+        std::cerr << "usage: spongelang run [--interp | --dump] <file.sp>\n";
+        return 2;
+    }
+
+    ScriptModule module;
+    {
+        MappedFile file(files[0]);
+        module = parseScript(file.view());
+    }
+
+    if (interp) {
+        ScriptInterpreter(module).run();
+        return 0;
+    }
+    ScriptProgram program = compileScript(module);
+    if (dump) {
+        disassembleScript(program, std::cout);
+        return 0;
+    }
+    ScriptVM(program).run();
+    return 0;
+}
+
+// ------------------------------------------------------
+// spongelang --stream [FILE]
+// 줄마다 식 하나 → 줄마다 결과 하나 (reader / 평가 / writer 파이프라인)
+// ------------------------------------------------------
+static int streamCommand(SpongeMetaEngine& eng, const std::string& path) {
+    std::FILE* in = stdin;
+    if (path != "-") {
+        in = std::fopen(path.c_str(), "rb");
+        if (!in) throw std::runtime_error("cannot open " + path);
+    }
+
+    // 잘못된 줄은 "nan" 을 쓰고 계속 (종료 코드 1)
+    PipelineOptions options;
+    options.onError = [](uint64_t lineNo, const std::string& msg) {
+        std::cerr << "spongelang: line " << lineNo << ": " << msg << "\n";
+    };
+
+    PipelineStats st;
+    try {
+        st = runPipeline(eng, in, stdout, options);
+    } catch (...) {
+        if (in != stdin) std::fclose(in);
+        throw;
+    }
+    if (in != stdin) std::fclose(in);
+    return st.errors ? 1 : 0;
+}
+
+static int usage() {
+    std::cerr << "usage: spongelang [--stats] [--pack FILE] [EXPR ...]\n"
+                 "       spongelang [--stats] [--pack FILE] --stream [FILE]\n"
+                 "       spongelang run [--interp | --dump] <file.sp>\n"
+                 "       spongelang pack compile <in.meta> <out.spack>\n"
+                 "       spongelang pack info <pack>\n";
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    try {
+        if (argc > 1 && std::string(argv[1]) == "pack")
+            return packCommand(argc, argv);
+        if (argc > 1 && std::string(argv[1]) == "run")
+            return runCommand(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "spongelang: " << e.what() << "\n";
+        return 1;
+    }
+
+    // spongelang [--stats] [--pack FILE] [EXPR ...]
+    // spongelang [--stats] [--pack FILE] --stream [FILE]   (FILE 이 없거나 "-" 면 stdin)
+    bool stats = false;
+    bool stream = false;
+    std::string packPath;
+    std::vector<std::string> exprs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stats") stats = true;
+        else if (arg == "--pack" && i + 1 < argc) packPath = argv[++i];
+        else if (arg == "--stream") stream = true;
+        else if (arg.rfind("--", 0) == 0) return usage();    // 모르는 옵션, 값 없는 --pack
+        else exprs.push_back(arg);
+    }
+    if (stream && exprs.size() > 1) return usage();
+    if (!stream && exprs.empty()) exprs.push_back("3 + 5 * 2");
+    if (stats) SpongeMetaEngine::setStatsEnabled(true);
+
     SpongeMetaEngine eng;
     Meta2Processor processor;
     MetaAbsorbLoader loader;
 
-    auto pack = processor.parseMetaWithSchema(
-        "packs/meta.meta",
-        "packs/rust.meta"
-    );
+    int rc = 0;
+    try {
+        if (!packPath.empty()) {
+            // .meta 텍스트 / .spack 바이너리 모두
+            loader.mountFile(eng, packPath);
+        } else if (findBuiltin("rust")) {
+            // 빌드할 때 packs/rust.meta 에서 생성한 내장 언어 (파일을 읽지 않음)
+            eng.absorbBuiltin("rust");
+        } else {
+            auto pack = processor.parseMetaWithSchema(
+                "packs/meta.meta",
+                "packs/rust.meta"
+            );
+            loader.mount(eng, pack);
+        }
 
-    loader.mount(eng, pack);
+        if (stream) {
+            rc = streamCommand(eng, exprs.empty() ? "-" : exprs[0]);
+        } else {
+            for (const auto& e : exprs)
+                std::cout << eng.run(e) << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "spongelang: " << e.what() << "\n";
+        rc = 1;
+    }
 
-    std::cout << eng.run("3 + 5 * 2") << "\n";
+    if (stats) std::cerr << eng.stats().report();
+    return rc;
 }
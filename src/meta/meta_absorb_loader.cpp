@@ -1,6 +1,10 @@
 #include "meta_engine.hpp"
 
 #include "meta_absorb_loader.hpp"
+#include "meta_ops.hpp"
+#include "meta_pack_binary.hpp"
+#include "meta_stats.hpp"
+#include <cstdio>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -24,6 +28,7 @@ static inline std::string trim(const std::string& s) {
 MetaAbsorbLoader::LangPack MetaAbsorbLoader::loadFromFile(
         const std::string& path)
 {
+    SPONGE_PHASE(LOAD_PACK);
     std::ifstream f(path);
     if (!f.is_open()) {
         throw std::runtime_error(
@@ -77,9 +82,18 @@ MetaAbsorbLoader::LangPack MetaAbsorbLoader::loadFromFile(
                 pack.tokens[key] = val;
                 break;
 
-            case Section::OPERATORS:
-                pack.precedence[key] = std::stoi(val);
+            case Section::OPERATORS: {
+                // "30" 또는 "30 right"
+                size_t used = 0;
+                pack.precedence[key] = std::stoi(val, &used);
+                std::string assoc = trim(val.substr(used));
+                if (assoc == "left" || assoc == "right")
+                    pack.associativity[key] = assoc;
+                else if (!assoc.empty())
+                    throw std::runtime_error(
+                        "[MetaAbsorbLoader] bad associativity for '" + key + "': " + assoc);
                 break;
+            }
 
             case Section::EVALUATE:
                 pack.evalRules[key] = val;
@@ -111,6 +125,7 @@ void MetaAbsorbLoader::mount(
         SpongeMetaEngine& eng,
         const LangPack& pack)
 {
+    SPONGE_PHASE(MOUNT);
     // -------------------------
     // 2-1) absorb() 호출 준비
     // -------------------------
@@ -126,15 +141,10 @@ void MetaAbsorbLoader::mount(
         const std::string& op = kv.first;
         const std::string& expr = kv.second;  // "a + b"
 
-        // 아주 단순한 식 해석기: a+b, a-b, a*b, a/b
-        if (expr == "a + b")
-            evalOps[op] = [](double a,double b){ return a + b; };
-        else if (expr == "a - b")
-            evalOps[op] = [](double a,double b){ return a - b; };
-        else if (expr == "a * b")
-            evalOps[op] = [](double a,double b){ return a * b; };
-        else if (expr == "a / b")
-            evalOps[op] = [](double a,double b){ return a / b; };
+        // 알려진 커널(a+b, a-b, a*b, a/b, a%b, pow/min/max)은
+        // 커널 함수 포인터로 넘겨서 엔진이 직접 디스패치하게 한다.
+        if (EvalFn fn = kernelFunction(kernelFromRule(expr)))
+            evalOps[op] = fn;
         else {
             // 확장 가능: expression 파서를 붙여
             // 실제 문자열에 따른 계산식 생성 가능
@@ -145,7 +155,11 @@ void MetaAbsorbLoader::mount(
     // -------------------------
     // 2-2) SpongeMetaEngine에 반영
     // -------------------------
-    eng.absorb(pack.name, tokenMap, precMap, evalOps);
+    // IR / Bytecode 규칙까지 함께 흡수한다.
+    // pack.bytecode["+"] = "ADD" 같은 매핑은 BytecodeCompiler 가
+    // IR → VM opcode 변환에 그대로 사용.
+    eng.absorbMetaPack(pack.name, tokenMap, precMap, evalOps,
+                       pack.irRules, pack.bytecode, pack.associativity);
 
     // -------------------------
     // 2-3) IR 규칙 반영
@@ -157,13 +171,41 @@ void MetaAbsorbLoader::mount(
         // 이 규칙을 트랜스파일러에게도 자동 등록 가능.
         // (지금은 최소 버전만 넣어둠)
     }
+}
 
-    // -------------------------
-    // 2-4) Bytecode 규칙 반영
-    // -------------------------
-    // pack.bytecode["+"] = "ADD" 같은 것
-    // VM opcode 출력용으로 사용 가능
-    // (현재 VM은 단일 opcode enum만 제공하므로 확장 가능)
+
+
+// ----------------------------------------------------------
+// 3) 바이너리 팩 / 자동 판별
+// ----------------------------------------------------------
+void MetaAbsorbLoader::mount(
+        SpongeMetaEngine& eng,
+        std::shared_ptr<const PackImage> pack)
+{
+    SPONGE_PHASE(MOUNT);
+    eng.absorbPack(std::move(pack));
+}
+
+void MetaAbsorbLoader::mountFile(
+        SpongeMetaEngine& eng,
+        const std::string& path)
+{
+    // magic 만 확인 (ifstream 버퍼 할당 없이)
+    char head[sizeof(kPackMagic)] = {};
+    size_t got = 0;
+    if (std::FILE* f = std::fopen(path.c_str(), "rb")) {
+        got = std::fread(head, 1, sizeof(head), f);
+        std::fclose(f);
+    } else {
+        throw std::runtime_error(
+            "[MetaAbsorbLoader] Cannot open meta file: " + path
+        );
+    }
+
+    if (PackImage::isBinary(std::string_view(head, got)))
+        mount(eng, std::make_shared<const PackImage>(path));
+    else
+        mount(eng, loadFromFile(path));
 }
 
 } // namespace sponge
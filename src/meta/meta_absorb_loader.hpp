@@ -2,11 +2,13 @@
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace sponge {
 
 class SpongeMetaEngine;
+class PackImage;
 
 /**
  * 언어 스펙(.meta) 파일을 파싱해서 SpongeMetaEngine 이
@@ -24,6 +26,7 @@ public:
      * language: "rust" 등
      * tokens:   number → "[0-9]+"
      * precedence:  + → 10, * → 20
+     * associativity: ^ → "right" ("^: 30 right" 처럼 우선순위 뒤에 적음, 기본 left)
      * evalRules:   "+" → "a + b" 와 같은 문자열 기반 평가식
      * bytecode:    "+" → "ADD"
      */
@@ -32,6 +35,7 @@ public:
 
         std::unordered_map<std::string, std::string> tokens;      // tokenName → regex
         std::unordered_map<std::string, int> precedence;          // op → precedence
+        std::unordered_map<std::string, std::string> associativity; // op → "left" | "right"
         std::unordered_map<std::string, std::string> evalRules;   // op → "a + b"
         std::unordered_map<std::string, std::string> irRules;     // IR tag mapping
         std::unordered_map<std::string, std::string> bytecode;    // op → opcode
@@ -48,6 +52,15 @@ public:
      * absorb()를 호출해서 토큰/우선순위/평가규칙/바이트코드 규칙을 반영.
      */
     void mount(SpongeMetaEngine& eng, const LangPack& pack);
+
+    // 바이너리 팩은 파싱 없이 그대로 흡수
+    void mount(SpongeMetaEngine& eng, std::shared_ptr<const PackImage> pack);
+
+    /**
+     * 파일 앞부분을 보고 바이너리 팩(.spack)이면 mmap 해서,
+     * 아니면 텍스트 .meta 로 읽어서 흡수한다.
+     */
+    void mountFile(SpongeMetaEngine& eng, const std::string& path);
 };
 
 } // namespace sponge
@@ -0,0 +1,172 @@
+#include "meta_bindings.hpp"
+
+#include <algorithm>
+
+namespace sponge {
+
+BindingId BindingGraph::intern(std::string_view name)
+{
+    auto it = index.find(std::string(name));
+    if (it != index.end()) return it->second;
+
+    BindingId id = static_cast<BindingId>(names.size());
+    names.emplace_back(name);
+    kinds.push_back(Kind::UNDEFINED);
+    dirty.push_back(1);
+    values.push_back(0.0);
+    deps.emplace_back();
+    dependents.emplace_back();
+    index.emplace(names.back(), id);
+    return id;
+}
+
+bool BindingGraph::find(std::string_view name, BindingId& id) const
+{
+    auto it = index.find(std::string(name));
+    if (it == index.end()) return false;
+    id = it->second;
+    return true;
+}
+
+
+
+// ------------------------------------------------------
+// dirty 전파 (push)
+// ------------------------------------------------------
+void BindingGraph::markDependentsDirty(BindingId id)
+{
+    work.assign(dependents[id].begin(), dependents[id].end());
+    while (!work.empty()) {
+        BindingId n = work.back();
+        work.pop_back();
+        if (dirty[n]) continue;             // 불변식: 그 위도 이미 dirty
+        dirty[n] = 1;
+        counters.invalidations++;
+        work.insert(work.end(), dependents[n].begin(), dependents[n].end());
+    }
+}
+
+void BindingGraph::unlink(BindingId id)
+{
+    for (BindingId d : deps[id]) {
+        auto& ds = dependents[d];
+        auto it = std::find(ds.begin(), ds.end(), id);
+        if (it != ds.end()) {
+            *it = ds.back();
+            ds.pop_back();
+        }
+    }
+    deps[id].clear();
+}
+
+
+
+// ------------------------------------------------------
+// 정의 변경
+// ------------------------------------------------------
+void BindingGraph::setInput(BindingId id, double v)
+{
+    if (kinds[id] == Kind::INPUT && !dirty[id] && values[id] == v)
+        return;
+
+    unlink(id);
+    kinds[id] = Kind::INPUT;
+    values[id] = v;
+    dirty[id] = 0;
+    markDependentsDirty(id);
+}
+
+void BindingGraph::setFormula(BindingId id, std::vector<BindingId> uses)
+{
+    std::sort(uses.begin(), uses.end());
+    uses.erase(std::unique(uses.begin(), uses.end()), uses.end());
+
+    // 순환 검사: deps 에서 의존 방향으로 내려가다 id 를 만나면 거부
+    // (parent 는 방문한 노드만 되돌려 놓으므로 정의 하나에 그래프 전체를 훑지 않는다)
+    parent.resize(names.size(), kUnvisited);
+    std::vector<BindingId> visited;
+    auto visit = [&](BindingId d, BindingId from) {
+        if (d == id) {
+            std::string msg = cycleMessage(id, from);
+            for (BindingId v : visited) parent[v] = kUnvisited;
+            throw std::runtime_error(msg);
+        }
+        if (parent[d] == kUnvisited) {
+            parent[d] = from;
+            visited.push_back(d);
+        }
+    };
+    for (BindingId d : uses) visit(d, id);
+    for (size_t i = 0; i < visited.size(); ++i)
+        for (BindingId d : deps[visited[i]]) visit(d, visited[i]);
+    for (BindingId v : visited) parent[v] = kUnvisited;
+
+    unlink(id);
+    for (BindingId d : uses) dependents[d].push_back(id);
+
+    deps[id] = std::move(uses);
+    kinds[id] = Kind::FORMULA;
+    if (!dirty[id]) {
+        dirty[id] = 1;
+        counters.invalidations++;
+    }
+    markDependentsDirty(id);
+}
+
+void BindingGraph::undefine(BindingId id)
+{
+    unlink(id);
+    kinds[id] = Kind::UNDEFINED;
+    if (!dirty[id]) {
+        dirty[id] = 1;
+        counters.invalidations++;
+    }
+    markDependentsDirty(id);
+}
+
+void BindingGraph::truncate(size_t n)
+{
+    while (names.size() > n) {
+        index.erase(names.back());
+        names.pop_back();
+        kinds.pop_back();
+        dirty.pop_back();
+        values.pop_back();
+        deps.pop_back();
+        dependents.pop_back();
+    }
+    if (parent.size() > n) parent.resize(n);
+}
+
+void BindingGraph::invalidateAll()
+{
+    for (BindingId id = 0; id < names.size(); ++id) {
+        if (kinds[id] != Kind::INPUT && !dirty[id]) {
+            dirty[id] = 1;
+            counters.invalidations++;
+        }
+    }
+}
+
+std::string BindingGraph::cycleMessage(BindingId id, BindingId from) const
+{
+    // id → … → from → id
+    std::vector<BindingId> path{ from };
+    while (path.back() != id) path.push_back(parent[path.back()]);
+
+    std::string msg = "Cyclic binding: " + names[id];
+    for (auto it = path.rbegin() + 1; it != path.rend(); ++it)
+        msg += " -> " + names[*it];
+    msg += " -> " + names[id];
+    return msg;
+}
+
+BindingStats BindingGraph::stats() const
+{
+    BindingStats s = counters;
+    s.bindings = names.size();
+    s.dirty = static_cast<size_t>(std::count(dirty.begin(), dirty.end(), uint8_t(1)));
+    return s;
+}
+
+} // namespace sponge
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sponge {
+
+using BindingId = uint32_t;
+
+struct BindingStats {
+    uint64_t evaluations = 0;    // 다시 계산한 수식 수 (누적)
+    uint64_t invalidations = 0;  // dirty 로 바뀐 노드 수 (누적)
+    size_t bindings = 0;
+    size_t dirty = 0;
+};
+
+/**
+ * 이름 있는 바인딩들의 의존 그래프 + 메모이즈된 값.
+ *
+ *   INPUT     — 값이 직접 주어짐
+ *   FORMULA   — deps 의 값으로 계산 (계산은 get() 의 eval 콜백이 한다)
+ *   UNDEFINED — 참조만 되고 아직 정의되지 않은 이름
+ *
+ * 값을 바꾸면 전이적 dependents 만 dirty 로 표시하고 (push),
+ * 실제 계산은 get() 이 필요한 부분만 아래에서부터 한다 (pull).
+ *
+ * 불변식: dirty 인 노드의 dependents 는 모두 dirty.
+ *   → 이미 dirty 인 노드를 만나면 전파를 멈춰도 된다.
+ * 순환 정의는 setFormula() 에서 거부하므로 그래프는 항상 DAG.
+ */
+class BindingGraph {
+public:
+    enum class Kind : uint8_t { UNDEFINED, INPUT, FORMULA };
+
+    // 이름 → id (없으면 UNDEFINED 노드 추가)
+    BindingId intern(std::string_view name);
+    // 없으면 false
+    bool find(std::string_view name, BindingId& id) const;
+
+    const std::string& name(BindingId id) const { return names[id]; }
+    Kind kind(BindingId id) const { return kinds[id]; }
+    size_t size() const { return names.size(); }
+
+    // 값이 그대로면 아무것도 무효화하지 않는다
+    void setInput(BindingId id, double v);
+
+    // uses 로 계산되는 수식으로 바꾼다. 순환이면 runtime_error (그래프는 그대로).
+    void setFormula(BindingId id, std::vector<BindingId> uses);
+
+    void undefine(BindingId id);
+
+    // n 번째부터 뒤의 노드를 지운다 (실패한 정의가 intern 한 이름 되돌리기용:
+    // 아무도 참조하지 않는 UNDEFINED 노드여야 한다)
+    void truncate(size_t n);
+
+    // 모든 수식을 dirty 로 (언어 규칙이 바뀌었을 때)
+    void invalidateAll();
+
+    /**
+     * id 의 값. dirty 인 의존성을 먼저 (명시적 스택으로) 계산한다.
+     * eval(n) 은 n 의 deps 가 모두 깨끗할 때만 불리며, cached() 로 그 값을 읽는다.
+     */
+    template<class Eval>
+    double get(BindingId id, Eval&& eval);
+
+    double cached(BindingId id) const { return values[id]; }
+
+    BindingStats stats() const;
+
+private:
+    // 노드별 정보 (struct-of-arrays: get() 이 훑는 dirty/value 를 촘촘하게)
+    std::vector<std::string> names;
+    std::vector<Kind> kinds;
+    std::vector<uint8_t> dirty;
+    std::vector<double> values;
+    std::vector<std::vector<BindingId>> deps;           // 중복 없음
+    std::vector<std::vector<BindingId>> dependents;
+
+    std::unordered_map<std::string, BindingId> index;
+    std::vector<BindingId> work;    // get() / dirty 전파용 스택 (재사용)
+    BindingStats counters;
+
+    // 순환 검사용 방문 표시 (검사가 끝나면 항상 kUnvisited 로 돌려 놓는다)
+    static constexpr BindingId kUnvisited = 0xFFFFFFFFu;
+    std::vector<BindingId> parent;
+
+    void markDependentsDirty(BindingId id);
+    void unlink(BindingId id);
+    // id → … → from → id 경로 메시지 (parent 가 채워져 있을 때)
+    std::string cycleMessage(BindingId id, BindingId from) const;
+};
+
+template<class Eval>
+double BindingGraph::get(BindingId id, Eval&& eval)
+{
+    if (!dirty[id]) return values[id];
+
+    work.clear();
+    work.push_back(id);
+    while (!work.empty()) {
+        BindingId n = work.back();
+        if (!dirty[n]) { work.pop_back(); continue; }
+        if (kinds[n] == Kind::UNDEFINED)
+            throw std::runtime_error("Unbound variable: " + names[n]);
+
+        // 더러운 의존성부터 (DAG 이므로 끝난다)
+        bool ready = true;
+        for (BindingId d : deps[n]) {
+            if (dirty[d]) {
+                work.push_back(d);
+                ready = false;
+            }
+        }
+        if (!ready) continue;
+
+        work.pop_back();
+        values[n] = eval(n);
+        dirty[n] = 0;
+        counters.evaluations++;
+    }
+    return values[id];
+}
+
+} // namespace sponge
@@ -0,0 +1,27 @@
+#include "meta_builtin.hpp"
+
+namespace sponge {
+
+#if SPONGE_BUILTIN_PACKS
+// 빌드 디렉터리의 generated/meta_builtin_packs.cpp (CMake 가 packs/*.meta 에서 생성)
+std::span<const BuiltinLanguage* const> generatedBuiltins();
+#else
+// Python 이 없어 생성 단계를 건너뛴 빌드: 내장 언어 없음
+static std::span<const BuiltinLanguage* const> generatedBuiltins() { return {}; }
+#endif
+
+const BuiltinLanguage* findBuiltin(std::string_view name)
+{
+    for (const BuiltinLanguage* lang : generatedBuiltins())
+        if (name == lang->name) return lang;
+    return nullptr;
+}
+
+std::vector<std::string> builtinLanguages()
+{
+    std::vector<std::string> out;
+    for (const BuiltinLanguage* lang : generatedBuiltins()) out.emplace_back(lang->name);
+    return out;
+}
+
+} // namespace sponge
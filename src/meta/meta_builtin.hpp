@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+// ------------------------------------------------------
+// 내장 언어: 빌드할 때 packs/*.meta 에서 생성한 C++ (tools/generate_builtin.py)
+//
+// 생성 코드가 담는 것
+//   - constexpr 연산자/토큰/IR 규칙 표 (파일 읽기·맵 구성 없이 흡수)
+//   - 팩 토큰 정규식을 미리 DFA 로 풀어 goto/switch 로 옮긴 렉서 (LexerDFA::MatchFn)
+//   - 연산자 id 마다 커널을 상수로 박은 evaluateBuiltin<Lang> 특수화
+//
+// 연산자 순서는 GrammarBuilder 가 intern 하는 순서 그대로라서 (+ - * / 다음 팩 연산자,
+// 평가식만 있는 연산자는 맨 뒤) 표의 번호가 곧 OpId 이다.
+// ------------------------------------------------------
+struct BuiltinPair {
+    const char* key;
+    const char* value;
+};
+
+struct BuiltinOp {
+    const char* name;
+    int precedence;                     // PACK_OP_PRECEDENCE 일 때 팩 값
+    OpKernel kernel;                    // PACK_OP_EVAL 일 때 (모르는 평가식은 GENERIC)
+    uint8_t flags;                      // PackOpFlags
+    const char* bytecode;               // PACK_OP_BYTECODE 일 때 opcode 이름
+};
+
+struct BuiltinLanguage {
+    const char* name;
+    std::span<const BuiltinPair> tokens;    // 팩에 적힌 토큰 (이름 → 정규식)
+    std::span<const BuiltinOp> ops;         // 번호 = OpId
+    std::span<const BuiltinPair> irRules;
+
+    // 생성된 렉서와 규칙 수 (GrammarBuilder 가 만드는 규칙 목록과 같아야 한다)
+    size_t (*match)(std::string_view src, size_t pos, int& rule);
+    size_t ruleCount;
+
+    // 생성된 평가기 (IR 전체를 앞에서부터 한 번, env 는 변수 슬롯 값)
+    double (*evaluate)(const OperatorTable& ops, const IRArena& ir, const double* env);
+};
+
+// 이름으로 찾기 (없으면 nullptr) / 빌드에 들어간 내장 언어 이름
+const BuiltinLanguage* findBuiltin(std::string_view name);
+std::vector<std::string> builtinLanguages();
+
+/**
+ * 생성된 평가기 본체. Lang::apply(op, a, b) 는 연산자 id 별 switch 라서
+ * 커널이 상수로 들어가 인라인된다 (kernels[] 조회 / std::function 없음).
+ *
+ * 자식 < 부모 이므로 노드 번호 순서대로 한 번 훑으면 자식 값이 먼저 준비된다.
+ * 재귀가 없고 공유 노드 (DAG) 도 한 번씩만 계산한다.
+ * 루트에서 닿지 않는 노드도 계산하지만 파서와 표준 패스가 만든 IR 에는 없다.
+ */
+template<class Lang>
+double evaluateBuiltin(const OperatorTable& ops, const IRArena& ir, const double* env)
+{
+    // 작은 식 (대부분) 은 스택 버퍼, 큰 식만 스레드별 벡터
+    constexpr size_t kStackNodes = 64;
+    double local[kStackNodes];
+    thread_local std::vector<double> values;
+
+    if (ir.root >= ir.size()) throw std::runtime_error("IRNode null");
+    const size_t n = size_t(ir.root) + 1;
+    double* v = local;
+    if (n > kStackNodes) {
+        if (values.size() < n) values.resize(n);
+        v = values.data();
+    }
+
+    for (size_t k = 0; k < n; ++k) {
+        switch (ir.tag[k]) {
+            case IRTag::LITERAL:
+                v[k] = ir.value[k];
+                break;
+            case IRTag::VAR:
+                if (!env) throw std::runtime_error("Unbound variable: " + ir.vars[ir.lhs[k]]);
+                v[k] = env[ir.lhs[k]];
+                break;
+            case IRTag::BINARY:
+                v[k] = Lang::apply(ops, ir.op[k], v[ir.lhs[k]], v[ir.rhs[k]]);
+                break;
+            default:
+                throw std::runtime_error("Invalid IR node structure");
+        }
+    }
+    return v[ir.root];
+}
+
+// 생성된 apply() 의 default (평가 규칙이 없는 연산자)
+[[noreturn]] inline void builtinUnknownOperator(const OperatorTable& ops, OpId op)
+{
+    throw std::runtime_error("Unknown operator: " + (op < ops.size() ? ops.name(op) : std::to_string(op)));
+}
+
+} // namespace sponge
@@ -0,0 +1,196 @@
+#include "meta_closure.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sponge {
+
+namespace {
+
+using Node = ClosureProgram::Node;
+using Fn = ClosureProgram::Fn;
+
+// 피연산자 종류: 자식 노드 호출 / 상수 / 변수 슬롯
+enum class Arg { NODE, CONST, VAR };
+
+template <Arg A>
+inline double operand(const Node* child, const Node* n, const double* env) {
+    if constexpr (A == Arg::NODE)  return child->fn(child, env);
+    if constexpr (A == Arg::CONST) return n->k;
+    if constexpr (A == Arg::VAR)   return env[n->slot];
+}
+
+template <OpKernel K>
+inline double kernel(const Node* n, double x, double y) {
+    if constexpr (K == OpKernel::ADD) return x + y;
+    if constexpr (K == OpKernel::SUB) return x - y;
+    if constexpr (K == OpKernel::MUL) return x * y;
+    if constexpr (K == OpKernel::DIV) return x / y;
+    if constexpr (K == OpKernel::MOD) return std::fmod(x, y);
+    if constexpr (K == OpKernel::POW) return std::pow(x, y);
+    if constexpr (K == OpKernel::MIN) return std::min(x, y);
+    if constexpr (K == OpKernel::MAX) return std::max(x, y);
+    if constexpr (K == OpKernel::GENERIC) return (*n->generic)(x, y);
+}
+
+template <OpKernel K, Arg L, Arg R>
+double binary(const Node* n, const double* env) {
+    double x = operand<L>(n->a, n, env);
+    double y = operand<R>(n->b, n, env);
+    return kernel<K>(n, x, y);
+}
+
+double literal(const Node* n, const double*) { return n->k; }
+double variable(const Node* n, const double* env) { return env[n->slot]; }
+
+// ------------------------------------------------------
+// (커널, 왼쪽 종류, 오른쪽 종류) → 특수화된 함수
+// 상수와 변수 슬롯은 노드에 하나씩만 있으므로
+// CONST/CONST, VAR/VAR 조합은 한쪽을 NODE 로 둔다.
+// ------------------------------------------------------
+template <OpKernel K>
+Fn pick(Arg l, Arg r) {
+    switch (l) {
+        case Arg::NODE:
+            if (r == Arg::CONST) return &binary<K, Arg::NODE, Arg::CONST>;
+            if (r == Arg::VAR)   return &binary<K, Arg::NODE, Arg::VAR>;
+            return &binary<K, Arg::NODE, Arg::NODE>;
+        case Arg::CONST:
+            if (r == Arg::VAR)   return &binary<K, Arg::CONST, Arg::VAR>;
+            return &binary<K, Arg::CONST, Arg::NODE>;
+        case Arg::VAR:
+            if (r == Arg::CONST) return &binary<K, Arg::VAR, Arg::CONST>;
+            return &binary<K, Arg::VAR, Arg::NODE>;
+    }
+    return &binary<K, Arg::NODE, Arg::NODE>;
+}
+
+Fn pickKernel(OpKernel k, Arg l, Arg r) {
+    switch (k) {
+        case OpKernel::ADD:     return pick<OpKernel::ADD>(l, r);
+        case OpKernel::SUB:     return pick<OpKernel::SUB>(l, r);
+        case OpKernel::MUL:     return pick<OpKernel::MUL>(l, r);
+        case OpKernel::DIV:     return pick<OpKernel::DIV>(l, r);
+        case OpKernel::MOD:     return pick<OpKernel::MOD>(l, r);
+        case OpKernel::POW:     return pick<OpKernel::POW>(l, r);
+        case OpKernel::MIN:     return pick<OpKernel::MIN>(l, r);
+        case OpKernel::MAX:     return pick<OpKernel::MAX>(l, r);
+        case OpKernel::GENERIC: return pick<OpKernel::GENERIC>(l, r);
+        case OpKernel::NONE:    break;
+    }
+    return nullptr;
+}
+
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// 컴파일: IR 인덱스 순서 = 자식이 먼저 (포인터가 항상 유효)
+// ------------------------------------------------------
+ClosureProgram::ClosureProgram(const IRArena& ir, const OperatorTable& ops)
+{
+    if (ir.root >= ir.size())
+        throw std::runtime_error("IRNode null");
+
+    // 두 번 이상 쓰이는 BINARY → 슬롯 varCount + k (부모는 변수처럼 읽는다)
+    varCount = ir.vars.size();
+    std::vector<uint32_t> uses;
+    if (ir.shared) countUses(ir, uses);
+    std::vector<uint32_t> sharedSlot(ir.size(), UINT32_MAX);
+    uint32_t sharedCount = 0;
+    for (IRRef i = 0; i < uses.size(); ++i)
+        if (uses[i] >= 2 && ir.tag[i] == IRTag::BINARY) sharedSlot[i] = uint32_t(varCount) + sharedCount++;
+
+    // 재할당되면 자식 포인터가 깨지므로 미리 전부 잡는다 (공유 노드의 슬롯 읽기 노드 포함)
+    nodes.resize(ir.size() + sharedCount);
+    Node* proxy = nodes.data() + ir.size();
+
+    auto argKind = [&](IRRef ref) {
+        if (sharedSlot[ref] != UINT32_MAX) return Arg::VAR;
+        switch (ir.tag[ref]) {
+            case IRTag::LITERAL: return Arg::CONST;
+            case IRTag::VAR:     return Arg::VAR;
+            default:             return Arg::NODE;
+        }
+    };
+    auto slotOf = [&](IRRef ref) {
+        return sharedSlot[ref] != UINT32_MAX ? sharedSlot[ref] : ir.lhs[ref];
+    };
+    auto child = [&](IRRef ref) -> const Node* {
+        if (sharedSlot[ref] != UINT32_MAX) return &proxy[sharedSlot[ref] - varCount];
+        return &nodes[ref];
+    };
+
+    for (IRRef i = 0; i < ir.size(); ++i) {
+        Node& n = nodes[i];
+
+        switch (ir.tag[i]) {
+            case IRTag::LITERAL:
+                n.fn = &literal;
+                n.k = ir.value[i];
+                break;
+
+            case IRTag::VAR:
+                n.fn = &variable;
+                n.slot = ir.lhs[i];
+                break;
+
+            case IRTag::BINARY: {
+                OpId op = ir.op[i];
+                OpKernel k = ops.kernel(op);
+                if (k == OpKernel::NONE)
+                    throw std::runtime_error("Unknown operator: " + ops.name(op));
+
+                IRRef l = ir.lhs[i], r = ir.rhs[i];
+                Arg lk = argKind(l), rk = argKind(r);
+
+                // 노드 하나에 상수/슬롯 자리가 하나씩뿐
+                if (lk == Arg::CONST && rk == Arg::CONST) lk = Arg::NODE;
+                if (lk == Arg::VAR && rk == Arg::VAR)     rk = Arg::NODE;
+
+                n.a = child(l);
+                n.b = child(r);
+                if (lk == Arg::CONST) n.k = ir.value[l];
+                if (rk == Arg::CONST) n.k = ir.value[r];
+                if (lk == Arg::VAR)   n.slot = slotOf(l);
+                if (rk == Arg::VAR)   n.slot = slotOf(r);
+
+                if (k == OpKernel::GENERIC) n.generic = &ops.function(op);
+                n.fn = pickKernel(k, lk, rk);
+
+                if (sharedSlot[i] != UINT32_MAX) {
+                    Node& p = proxy[sharedSlot[i] - varCount];
+                    p.fn = &variable;
+                    p.slot = sharedSlot[i];
+                    shared.push_back(&n);
+                }
+                break;
+            }
+        }
+    }
+
+    root = &nodes[ir.root];
+    if (!ir.vars.empty()) firstVar = ir.vars.front();
+}
+
+double ClosureProgram::run(const double* env) const
+{
+    if (!root)
+        throw std::runtime_error("ClosureProgram: empty program");
+    if (!env && !firstVar.empty())
+        throw std::runtime_error("Unbound variable: " + firstVar);
+    if (shared.empty()) return root->fn(root, env);
+
+    // 공유 노드를 자식부터 한 번씩 계산해 변수 뒤 슬롯에 둔다
+    thread_local std::vector<double> slots;
+    slots.resize(varCount + shared.size());
+    if (varCount) std::copy_n(env, varCount, slots.data());
+    for (size_t k = 0; k < shared.size(); ++k)
+        slots[varCount + k] = shared[k]->fn(shared[k], slots.data());
+    return root->fn(root, slots.data());
+}
+
+} // namespace sponge
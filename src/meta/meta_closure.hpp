@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+/**
+ * 클로저 컴파일 평가기 (트리 워커와 VM 사이 단계).
+ *
+ * IR 을 한 번 훑어서 노드마다 "미리 묶인" 평가 함수를 고른다.
+ *   - 연산자 커널은 템플릿 인자로 고정 (실행 중 커널 switch 없음)
+ *   - 피연산자가 리터럴/변수면 자식 호출 없이 바로 읽는 특수화 사용
+ *   - GENERIC 연산자는 사용자 std::function 을 직접 가리킨다
+ * 실행은 root->fn(root, env) 한 번 — 태그 검사나 테이블 조회가 없다.
+ *
+ * 공유 노드 (IRArena::shared) 는 실행 앞부분에서 자식부터 한 번씩 계산해
+ * 변수 슬롯 뒤의 슬롯에 두고, 부모는 그 슬롯을 변수처럼 읽는다.
+ *
+ * 노드끼리 포인터로 연결되므로 복사는 막고 이동만 허용한다.
+ * GENERIC 연산자를 참조하므로 컴파일에 쓴 OperatorTable 보다 오래 살면 안 된다.
+ */
+class ClosureProgram {
+public:
+    struct Node;
+    using Fn = double (*)(const Node* n, const double* env);
+
+    struct Node {
+        Fn fn = nullptr;
+        const Node* a = nullptr;
+        const Node* b = nullptr;
+        double k = 0.0;                 // 리터럴 값 / 상수 피연산자
+        uint32_t slot = 0;              // 변수 슬롯 / 변수 피연산자
+        const std::function<double(double,double)>* generic = nullptr;
+    };
+
+    ClosureProgram() = default;
+    ClosureProgram(const IRArena& ir, const OperatorTable& ops);
+
+    ClosureProgram(ClosureProgram&& o) noexcept
+        : nodes(std::move(o.nodes)), root(std::exchange(o.root, nullptr)),
+          shared(std::move(o.shared)), varCount(o.varCount),
+          firstVar(std::move(o.firstVar)) {}
+    ClosureProgram& operator=(ClosureProgram&& o) noexcept {
+        nodes = std::move(o.nodes);
+        root = std::exchange(o.root, nullptr);
+        shared = std::move(o.shared);
+        varCount = o.varCount;
+        firstVar = std::move(o.firstVar);
+        return *this;
+    }
+    ClosureProgram(const ClosureProgram&) = delete;
+    ClosureProgram& operator=(const ClosureProgram&) = delete;
+
+    bool empty() const { return root == nullptr; }
+
+    // env: 변수 슬롯별 값 (IRArena::vars 순서). 변수가 있는데 nullptr 이면 에러.
+    double run(const double* env = nullptr) const;
+
+private:
+    std::vector<Node> nodes;
+    const Node* root = nullptr;
+    std::vector<const Node*> shared;    // 공유 노드 (계산 순서 = 슬롯 varCount + k)
+    size_t varCount = 0;
+    std::string firstVar;   // 변수 있는 식의 에러 메시지용
+};
+
+} // namespace sponge
@@ -0,0 +1,265 @@
+#include "meta_columnar.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define SPONGE_SIMD_SSE2 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPONGE_SIMD_AVX 1   // target("avx") + 런타임 CPU 체크
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SPONGE_SIMD_NEON 1
+#endif
+
+namespace sponge {
+
+// ------------------------------------------------------
+// 벡터 커널: out[i] = a[i] (op) b[i]
+// ------------------------------------------------------
+static void vvScalar(OpKernel k, const double* a, const double* b, double* o, size_t n)
+{
+    switch (k) {
+        case OpKernel::ADD: for (size_t i = 0; i < n; ++i) o[i] = a[i] + b[i]; break;
+        case OpKernel::SUB: for (size_t i = 0; i < n; ++i) o[i] = a[i] - b[i]; break;
+        case OpKernel::MUL: for (size_t i = 0; i < n; ++i) o[i] = a[i] * b[i]; break;
+        case OpKernel::DIV: for (size_t i = 0; i < n; ++i) o[i] = a[i] / b[i]; break;
+        default:
+            for (size_t i = 0; i < n; ++i) o[i] = applyKernel(k, a[i], b[i]);
+            break;
+    }
+}
+
+#if SPONGE_SIMD_AVX
+#define SPONGE_AVX_LOOP(INTR)                                           \
+    for (; i + 4 <= n; i += 4)                                          \
+        _mm256_storeu_pd(o + i, INTR(_mm256_loadu_pd(a + i),            \
+                                     _mm256_loadu_pd(b + i)));
+
+__attribute__((target("avx")))
+static size_t vvAvx(OpKernel k, const double* a, const double* b, double* o, size_t n)
+{
+    size_t i = 0;
+    switch (k) {
+        case OpKernel::ADD: SPONGE_AVX_LOOP(_mm256_add_pd) break;
+        case OpKernel::SUB: SPONGE_AVX_LOOP(_mm256_sub_pd) break;
+        case OpKernel::MUL: SPONGE_AVX_LOOP(_mm256_mul_pd) break;
+        case OpKernel::DIV: SPONGE_AVX_LOOP(_mm256_div_pd) break;
+        default: break;
+    }
+    return i;
+}
+#undef SPONGE_AVX_LOOP
+
+static bool cpuHasAvx()
+{
+    static const bool has = __builtin_cpu_supports("avx");
+    return has;
+}
+#endif
+
+#if SPONGE_SIMD_SSE2
+#define SPONGE_SSE2_LOOP(INTR)                                          \
+    for (; i + 2 <= n; i += 2)                                          \
+        _mm_storeu_pd(o + i, INTR(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+
+static size_t vvSse2(OpKernel k, const double* a, const double* b, double* o, size_t n)
+{
+    size_t i = 0;
+    switch (k) {
+        case OpKernel::ADD: SPONGE_SSE2_LOOP(_mm_add_pd) break;
+        case OpKernel::SUB: SPONGE_SSE2_LOOP(_mm_sub_pd) break;
+        case OpKernel::MUL: SPONGE_SSE2_LOOP(_mm_mul_pd) break;
+        case OpKernel::DIV: SPONGE_SSE2_LOOP(_mm_div_pd) break;
+        default: break;
+    }
+    return i;
+}
+#undef SPONGE_SSE2_LOOP
+#endif
+
+#if SPONGE_SIMD_NEON
+#define SPONGE_NEON_LOOP(INTR)                                          \
+    for (; i + 2 <= n; i += 2)                                          \
+        vst1q_f64(o + i, INTR(vld1q_f64(a + i), vld1q_f64(b + i)));
+
+static size_t vvNeon(OpKernel k, const double* a, const double* b, double* o, size_t n)
+{
+    size_t i = 0;
+    switch (k) {
+        case OpKernel::ADD: SPONGE_NEON_LOOP(vaddq_f64) break;
+        case OpKernel::SUB: SPONGE_NEON_LOOP(vsubq_f64) break;
+        case OpKernel::MUL: SPONGE_NEON_LOOP(vmulq_f64) break;
+        case OpKernel::DIV: SPONGE_NEON_LOOP(vdivq_f64) break;
+        default: break;
+    }
+    return i;
+}
+#undef SPONGE_NEON_LOOP
+#endif
+
+static void vvKernel(OpKernel k, const double* a, const double* b, double* o, size_t n)
+{
+    size_t done = 0;
+
+    if (k == OpKernel::ADD || k == OpKernel::SUB ||
+        k == OpKernel::MUL || k == OpKernel::DIV) {
+#if SPONGE_SIMD_AVX
+        if (cpuHasAvx()) done = vvAvx(k, a, b, o, n);
+        else
+#endif
+#if SPONGE_SIMD_SSE2
+        done = vvSse2(k, a, b, o, n);
+#elif SPONGE_SIMD_NEON
+        done = vvNeon(k, a, b, o, n);
+#endif
+    }
+
+    // 꼬리 + SIMD 없는 커널
+    vvScalar(k, a + done, b + done, o + done, n - done);
+}
+
+
+
+// ------------------------------------------------------
+// IR → step 목록
+// ------------------------------------------------------
+ColumnEvaluator::ColumnEvaluator(const IRArena& ir, const OperatorTable& ops)
+    : ops(ops)
+{
+    if (ir.root >= ir.size())
+        throw std::runtime_error("ColumnEvaluator: empty IR");
+
+    lower(ir);
+
+    regs.resize(static_cast<size_t>(regCount) * BLOCK);
+
+    // 상수 레지스터는 한 번만 채워두면 된다 (step 이 덮어쓰지 않음)
+    for (auto& c : constants)
+        std::fill_n(regs.data() + static_cast<size_t>(c.first) * BLOCK, BLOCK, c.second);
+}
+
+uint32_t ColumnEvaluator::allocReg(std::vector<uint32_t>& freeRegs)
+{
+    if (!freeRegs.empty()) {
+        uint32_t r = freeRegs.back();
+        freeRegs.pop_back();
+        return r;
+    }
+    constReg.push_back(0);
+    return regCount++;
+}
+
+/**
+ * 자식 < 부모 이므로 루트에서 닿는 노드를 번호 순서로 한 번씩 내린다
+ * (재귀 없음, 파서가 만든 트리에서는 후위 순서와 같다).
+ * 공유 노드 (IRArena::shared) 도 step 하나로 한 번만 계산하고,
+ * 그 임시 레지스터는 마지막 부모가 읽은 뒤에 돌려준다.
+ * 같은 값 (비트 단위, -0 과 +0 은 다름) 의 리터럴은 상수 레지스터 하나를 같이 쓴다.
+ */
+void ColumnEvaluator::lower(const IRArena& ir)
+{
+    std::vector<uint32_t> uses;
+    countUses(ir, uses);
+    std::vector<uint32_t> left = uses;          // 아직 읽지 않은 부모 수
+    std::vector<Operand> value(uses.size());
+    std::vector<uint32_t> freeRegs;
+    std::unordered_map<uint64_t, uint32_t> constantRegs;   // 값 비트 → 상수 레지스터
+
+    auto isTemp = [&](const Operand& o) {
+        return o.src == Src::REG && !constReg[o.index];
+    };
+    auto release = [&](IRRef c) {
+        if (--left[c] == 0 && isTemp(value[c])) freeRegs.push_back(value[c].index);
+    };
+
+    for (IRRef n = 0; n <= ir.root; ++n) {
+        if (n != ir.root && uses[n] == 0) continue;
+
+        switch (ir.tag[n]) {
+            case IRTag::LITERAL: {
+                // 상수 레지스터는 임시로 돌려주지 않는다 (freeRegs 에 넣지 않음)
+                uint64_t bits = std::bit_cast<uint64_t>(ir.value[n]);
+                auto [it, fresh] = constantRegs.try_emplace(bits, regCount);
+                if (fresh) {
+                    regCount++;
+                    constReg.push_back(1);
+                    constants.emplace_back(it->second, ir.value[n]);
+                }
+                value[n] = { Src::REG, it->second };
+                continue;
+            }
+            case IRTag::VAR:
+                value[n] = { Src::COLUMN, ir.lhs[n] };
+                continue;
+
+            case IRTag::BINARY: {
+                Operand a = value[ir.lhs[n]];
+                Operand b = value[ir.rhs[n]];
+
+                // 마지막 부모가 읽은 임시 레지스터는 이 step 의 결과로 다시 쓸 수 있다
+                release(ir.rhs[n]);
+                release(ir.lhs[n]);
+
+                uint32_t dst = allocReg(freeRegs);
+                OpId op = ir.op[n];
+                steps.push_back(Step{ op, ops.kernel(op), a, b, dst });
+                value[n] = { Src::REG, dst };
+                continue;
+            }
+        }
+        throw std::runtime_error("Invalid IR node structure");
+    }
+    result = value[ir.root];
+}
+
+
+
+// ------------------------------------------------------
+// 블록 단위 실행
+// ------------------------------------------------------
+void ColumnEvaluator::run(const std::vector<const double*>& inputs,
+                          size_t rows, double* out)
+{
+    for (auto& s : steps) {
+        if (s.kernel == OpKernel::NONE)
+            throw std::runtime_error("Unknown operator: " + ops.name(s.op));
+    }
+
+    auto ptr = [&](const Operand& o, size_t row) -> const double* {
+        if (o.src == Src::COLUMN) {
+            if (o.index >= inputs.size() || !inputs[o.index])
+                throw std::runtime_error("ColumnEvaluator: missing input column");
+            return inputs[o.index] + row;
+        }
+        return regs.data() + static_cast<size_t>(o.index) * BLOCK;
+    };
+
+    for (size_t row = 0; row < rows; row += BLOCK) {
+        size_t n = std::min(BLOCK, rows - row);
+
+        for (auto& s : steps) {
+            const double* a = ptr(s.a, row);
+            const double* b = ptr(s.b, row);
+            double* o = regs.data() + static_cast<size_t>(s.dst) * BLOCK;
+
+            if (s.kernel == OpKernel::GENERIC) {
+                for (size_t i = 0; i < n; ++i) o[i] = ops.apply(s.op, a[i], b[i]);
+            } else {
+                vvKernel(s.kernel, a, b, o, n);
+            }
+        }
+
+        std::memcpy(out + row, ptr(result, row), n * sizeof(double));
+    }
+}
+
+} // namespace sponge
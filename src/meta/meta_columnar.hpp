@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+/**
+ * 하나의 식을 여러 행(컬럼 입력)에 대해 블록 단위로 평가하는 실행기.
+ *
+ * 생성 시 IR 을 후위 순서 step 목록으로 평탄화하고 (공유 노드도 step 하나),
+ * run() 에서는 BLOCK 행씩 잘라서 step 마다 컬럼 전체에 커널을 적용한다.
+ * + - * / 는 SIMD 커널(SSE2/AVX/NEON), 나머지는 스칼라 루프.
+ */
+class ColumnEvaluator {
+public:
+    static constexpr size_t BLOCK = 512;
+
+    ColumnEvaluator(const IRArena& ir, const OperatorTable& ops);
+
+    // inputs[slot] = IRArena::vars[slot] 에 해당하는 컬럼 (길이 rows)
+    void run(const std::vector<const double*>& inputs, size_t rows, double* out);
+
+private:
+    enum class Src : uint8_t { REG, COLUMN };
+
+    struct Operand {
+        Src src;
+        uint32_t index;   // REG: 레지스터 번호, COLUMN: 변수 슬롯
+    };
+
+    struct Step {
+        OpId op;
+        OpKernel kernel;
+        Operand a, b;
+        uint32_t dst;     // 결과 레지스터
+    };
+
+    const OperatorTable& ops;
+
+    std::vector<Step> steps;
+    std::vector<std::pair<uint32_t, double>> constants;  // 상수 레지스터 초기값
+    Operand result{};
+    uint32_t regCount = 0;
+    std::vector<uint8_t> constReg;  // 레지스터가 상수 전용인지
+
+    std::vector<double> regs;   // regCount * BLOCK
+
+    void lower(const IRArena& ir);
+    uint32_t allocReg(std::vector<uint32_t>& freeRegs);
+};
+
+} // namespace sponge
@@ -0,0 +1,130 @@
+#include "meta_compiler.hpp"
+#include "meta_stats.hpp"
+
+#include <stdexcept>
+
+namespace sponge {
+
+// ------------------------------------------------------
+// bytecode 규칙 흡수 ("+" → "ADD")
+// ------------------------------------------------------
+void BytecodeCompiler::setRules(
+    const std::unordered_map<std::string, std::string>& bytecodeRules,
+    OperatorTable& ops)
+{
+    clearRules();
+    for (auto& kv : bytecodeRules)
+        setOpcode(ops.intern(kv.first), opcodeFromName(kv.second));
+}
+
+void BytecodeCompiler::clearRules()
+{
+    opMap.clear();
+    hasOp.clear();
+}
+
+void BytecodeCompiler::setOpcode(OpId id, OpCode code)
+{
+    if (id >= opMap.size()) {
+        opMap.resize(id + 1, OpCode::HALT);
+        hasOp.resize(id + 1, 0);
+    }
+    opMap[id] = code;
+    hasOp[id] = 1;
+}
+
+
+
+// ------------------------------------------------------
+// IR → Bytecode (후위 순회, 마지막에 HALT)
+// ------------------------------------------------------
+Bytecode BytecodeCompiler::compile(const IRArena& ir, const OperatorTable& ops) const
+{
+    SPONGE_PHASE(COMPILE);
+    Bytecode bc;
+    bc.ops.reserve(ir.size() + 1);
+    emit(ir, ops, ir.root, bc);
+    bc.ops.push_back(OpCode::HALT);
+
+    // 검증을 컴파일 시점에 한 번만
+    VM::prepare(bc);
+    return bc;
+}
+
+// 작업 스택에서 자식을 이미 내려보낸 BINARY 표시
+constexpr IRRef kExpanded = 0x80000000u;
+constexpr uint32_t kNoTemp = 0xFFFFFFFFu;
+
+/**
+ * 재귀 없이 후위 순서로 내보낸다 (명시적 작업 스택).
+ * 아주 깊은 식에서도 C++ 스택을 쓰지 않고, 내보내는 순서는 재귀 순회와 같다.
+ *
+ * 공유 노드가 있으면 (IRArena::shared) 두 번 이상 쓰이는 BINARY 는 처음 계산할 때
+ * SAVE 로 임시 슬롯에 두고, 그 뒤 자리에서는 서브트리 대신 TEMP 하나를 내보낸다.
+ */
+void BytecodeCompiler::emit(const IRArena& ir, const OperatorTable& ops,
+                            IRRef root, Bytecode& out) const
+{
+    thread_local std::vector<IRRef> work;
+    thread_local std::vector<uint32_t> uses;
+    thread_local std::vector<uint32_t> temp;    // 노드 → 임시 슬롯 (kNoTemp 면 아직 계산 전)
+    uint32_t temps = 0;
+
+    const bool shared = ir.shared && root < ir.size();
+    if (shared) {
+        countUses(ir, uses);
+        temp.assign(uses.size(), kNoTemp);
+    }
+
+    work.clear();
+    work.push_back(root);
+
+    while (!work.empty()) {
+        IRRef e = work.back();
+        work.pop_back();
+
+        // binary: 두 피연산자를 내보낸 뒤
+        if (e & kExpanded) {
+            IRRef n = e & ~kExpanded;
+            OpId id = ir.op[n];
+            if (id >= hasOp.size() || !hasOp[id])
+                throw std::runtime_error("No bytecode for operator: " + ops.name(id));
+            out.ops.push_back(opMap[id]);
+
+            if (shared && uses[n] >= 2) {
+                temp[n] = temps++;
+                out.ops.push_back(OpCode::SAVE);
+                out.data.push_back(static_cast<double>(temp[n]));
+            }
+            continue;
+        }
+
+        if (e >= ir.size()) throw std::runtime_error("IRNode null");
+
+        switch (ir.tag[e]) {
+            case IRTag::LITERAL:
+                out.ops.push_back(OpCode::PUSH);
+                out.data.push_back(ir.value[e]);
+                continue;
+
+            case IRTag::VAR:
+                out.ops.push_back(OpCode::LOAD);
+                out.data.push_back(static_cast<double>(ir.lhs[e]));
+                continue;
+
+            case IRTag::BINARY:
+                if (shared && temp[e] != kNoTemp) {
+                    out.ops.push_back(OpCode::TEMP);
+                    out.data.push_back(static_cast<double>(temp[e]));
+                    continue;
+                }
+                work.push_back(e | kExpanded);
+                work.push_back(ir.rhs[e]);
+                work.push_back(ir.lhs[e]);
+                continue;
+        }
+        throw std::runtime_error("Invalid IR node structure");
+    }
+}
+
+} // namespace sponge
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_vm.hpp"
+
+namespace sponge {
+
+/**
+ * IR 아레나 → sponge::Bytecode 컴파일러.
+ *
+ * 팩의 bytecode 섹션 ("+" → "ADD") 을 그대로 opcode 매핑으로 사용한다.
+ * 매핑이 없는 연산자를 만나면 runtime_error.
+ */
+class BytecodeCompiler {
+public:
+    // OpId → opcode (hasOp[id] 이 0 이면 매핑 없음)
+    std::vector<OpCode> opMap;
+    std::vector<uint8_t> hasOp;
+
+    void setRules(const std::unordered_map<std::string, std::string>& bytecodeRules,
+                  OperatorTable& ops);
+
+    // 바이너리 팩처럼 opcode 가 이미 풀려 있을 때
+    void clearRules();
+    void setOpcode(OpId id, OpCode code);
+
+    Bytecode compile(const IRArena& ir, const OperatorTable& ops) const;
+
+private:
+    void emit(const IRArena& ir, const OperatorTable& ops, IRRef root, Bytecode& out) const;
+};
+
+} // namespace sponge
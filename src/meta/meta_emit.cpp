@@ -0,0 +1,462 @@
+#include "meta_emit.hpp"
+
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+#include "meta_jit.hpp"
+
+namespace sponge {
+
+// ------------------------------------------------------
+// EmitBuffer
+// ------------------------------------------------------
+EmitBuffer& EmitBuffer::operator<<(double v)
+{
+    char buf[32];
+    auto r = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 6);
+    return *this << std::string_view(buf, size_t(r.ptr - buf));
+}
+
+void EmitBuffer::flush()
+{
+    if (!stream || own.empty()) return;
+    stream->write(own.data(), static_cast<std::streamsize>(own.size()));
+    own.clear();
+}
+
+
+
+// ------------------------------------------------------
+// 괄호식 백엔드 공통 (Go / C / Rust)
+// ------------------------------------------------------
+namespace {
+
+// 연산 하나의 대상 언어 표기: open L mid R close
+struct OpForm {
+    std::string open, mid, close;
+    bool ok = false;
+};
+
+OpForm infix(const char* sym) { return { "(", std::string(" ") + sym + " ", ")", true }; }
+OpForm call(const char* fn) { return { std::string(fn) + "(", ", ", ")", true }; }
+
+class ExprEmitter : public Emitter {
+protected:
+    // 커널을 옮길 수 없으면 ok == false
+    virtual OpForm form(OpKernel k) const = 0;
+    virtual void literal(double v, EmitBuffer& out) const = 0;
+
+    // 지역 변수 한 줄: open 이름 assign 식 close
+    struct LocalForm {
+        const char* open;
+        const char* assign;
+        const char* close;
+    };
+    virtual LocalForm localForm() const = 0;
+
+    // min / max 보조 함수 정의. std::min(a, b) == (b < a ? b : a), std::max(a, b) == (a < b ? b : a)
+    // 그대로라 NaN 과 ±0 에서도 다른 경로와 비트 단위로 같다 (fmin / math.Min / f64::min 은 다르다).
+    // 식에 바로 쓰면 피연산자를 두 번 써야 하므로 함수로 뺀다
+    struct MinMaxForm {
+        const char* min;
+        const char* max;
+    };
+    virtual MinMaxForm minMaxForm() const = 0;
+
+    // emit 한 번 동안 쓰는 표: 연산자 표기 + 지역 변수로 뺄 공유 노드
+    struct Context {
+        std::vector<OpForm> forms;
+        std::vector<uint8_t> hoist;     // 두 번 이상 쓰이는 BINARY 노드 (DAG 일 때만)
+        std::vector<IRRef> order;       // 정의 순서 (자식이 먼저)
+        std::string prefix = "cse";     // 지역 변수 이름 = prefix + 노드 번호
+    };
+
+    Context context(const IRArena& ir, const OperatorTable& ops) const
+    {
+        if (ir.root >= ir.size())
+            throw std::runtime_error(std::string("emit ") + name() + ": empty IR");
+
+        // 연산자마다 표기를 한 번만 만든다
+        Context cx;
+        cx.forms.resize(ops.size());
+        for (OpId id = 0; id < ops.size(); ++id) cx.forms[id] = form(ops.kernel(id));
+        if (!ir.shared) return cx;
+
+        // 루트에서 닿는 노드의 부모 수
+        std::vector<uint32_t> uses;
+        countUses(ir, uses);
+        const size_t n = uses.size();
+        cx.hoist.assign(n, 0);
+        for (IRRef k = 0; k < n; ++k) {
+            if (uses[k] >= 2 && ir.tag[k] == IRTag::BINARY) {
+                cx.hoist[k] = 1;
+                cx.order.push_back(k);
+            }
+        }
+
+        // 식의 변수 이름 (prefix + 숫자) 과 겹치지 않게
+        auto clashes = [&] {
+            for (auto& v : ir.vars) {
+                if (v.size() > cx.prefix.size() && v.compare(0, cx.prefix.size(), cx.prefix) == 0 &&
+                    v.find_first_not_of("0123456789", cx.prefix.size()) == std::string::npos)
+                    return true;
+            }
+            return false;
+        };
+        while (clashes()) cx.prefix += '_';
+        return cx;
+    }
+
+    // 공유 노드를 자식부터 지역 변수로 정의한다 (트리면 아무것도 쓰지 않음)
+    void locals(const IRArena& ir, const OperatorTable& ops, const Context& cx, EmitBuffer& out) const
+    {
+        LocalForm lf = localForm();
+        for (IRRef n : cx.order) {
+            out << lf.open << cx.prefix << n << lf.assign;
+            expression(ir, ops, cx, n, out);
+            out << lf.close;
+        }
+    }
+
+    // top 식을 한 번의 순회로 쓴다 (명시적 스택, 깊은 트리도 안전).
+    // top 이 아닌 공유 노드는 지역 변수 이름으로 대신한다.
+    void expression(const IRArena& ir, const OperatorTable& ops, const Context& cx,
+                    IRRef top, EmitBuffer& out) const
+    {
+        const std::vector<OpForm>& forms = cx.forms;
+
+        enum class Step : uint8_t { NODE, MID, CLOSE };
+        std::vector<std::pair<Step, IRRef>> stack{ { Step::NODE, top } };
+        while (!stack.empty()) {
+            auto [step, n] = stack.back();
+            stack.pop_back();
+
+            if (step == Step::MID)   { out << forms[ir.op[n]].mid; continue; }
+            if (step == Step::CLOSE) { out << forms[ir.op[n]].close; continue; }
+
+            if (n != top && !cx.hoist.empty() && cx.hoist[n]) {
+                out << cx.prefix << n;
+                continue;
+            }
+
+            switch (ir.tag[n]) {
+                case IRTag::LITERAL:
+                    literal(ir.value[n], out);
+                    break;
+                case IRTag::VAR:
+                    out << ir.vars[ir.lhs[n]];
+                    break;
+                case IRTag::BINARY: {
+                    OpId op = ir.op[n];
+                    if (op >= forms.size() || !forms[op].ok)
+                        throw std::runtime_error(std::string("emit ") + name() +
+                                                 ": no translation for operator: " + ops.name(op));
+                    out << forms[op].open;
+                    stack.push_back({ Step::CLOSE, n });
+                    stack.push_back({ Step::NODE, ir.rhs[n] });
+                    stack.push_back({ Step::MID, n });
+                    stack.push_back({ Step::NODE, ir.lhs[n] });
+                    break;
+                }
+            }
+        }
+    }
+
+    // 쓰이는 min / max 보조 함수만 정의한다
+    void helpers(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const
+    {
+        bool min = false, max = false;
+        for (size_t i = 0; i < ir.size(); ++i) {
+            if (ir.tag[i] != IRTag::BINARY) continue;
+            OpKernel k = ops.kernel(ir.op[i]);
+            min |= k == OpKernel::MIN;
+            max |= k == OpKernel::MAX;
+        }
+        MinMaxForm mm = minMaxForm();
+        if (min) out << mm.min << '\n';
+        if (max) out << mm.max << '\n';
+    }
+
+    // 연산자 열만 훑어 math 라이브러리가 필요한지 본다
+    static bool needsMath(const IRArena& ir, const OperatorTable& ops)
+    {
+        for (size_t i = 0; i < ir.size(); ++i) {
+            if (ir.tag[i] == IRTag::LITERAL && !std::isfinite(ir.value[i])) return true;
+            if (ir.tag[i] != IRTag::BINARY) continue;
+            OpKernel k = ops.kernel(ir.op[i]);
+            if (k == OpKernel::MOD || k == OpKernel::POW) return true;
+        }
+        return false;
+    }
+
+    // 다시 읽으면 같은 값이 되는 가장 짧은 표기 (소수점이 없으면 ".0" 을 붙여 실수 리터럴로)
+    static void floatLiteral(double v, EmitBuffer& out)
+    {
+        char buf[32];
+        auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        std::string_view s(buf, size_t(r.ptr - buf));
+        out << s;
+        if (s.find_first_of(".e") == std::string_view::npos) out << ".0";
+    }
+
+    static void parameters(const IRArena& ir, EmitBuffer& out, const char* type, bool typeFirst)
+    {
+        for (size_t i = 0; i < ir.vars.size(); ++i) {
+            if (i) out << ", ";
+            if (typeFirst) out << type << ' ' << ir.vars[i];
+            else out << ir.vars[i] << type;
+        }
+    }
+};
+
+// Go: 변수가 없으면 값을 출력하는 main, 있으면 spongeExpr 함수
+class GoEmitter : public ExprEmitter {
+public:
+    const char* name() const override { return "go"; }
+    const char* extension() const override { return ".go"; }
+
+    void emit(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const override
+    {
+        Context cx = context(ir, ops);
+        bool math = needsMath(ir, ops);
+        out << "package main\n\n";
+
+        if (ir.vars.empty()) {
+            out << (math ? "import (\n    \"fmt\"\n    \"math\"\n)\n\n" : "import \"fmt\"\n\n");
+            helpers(ir, ops, out);
+            out << "func main() {\n";
+            locals(ir, ops, cx, out);
+            out << "    fmt.Println(";
+            expression(ir, ops, cx, ir.root, out);
+            out << ")\n}\n";
+            return;
+        }
+
+        if (math) out << "import \"math\"\n\n";
+        helpers(ir, ops, out);
+        out << "func spongeExpr(";
+        parameters(ir, out, " float64", false);
+        out << ") float64 {\n";
+        locals(ir, ops, cx, out);
+        out << "    return ";
+        expression(ir, ops, cx, ir.root, out);
+        out << "\n}\n";
+    }
+
+protected:
+    OpForm form(OpKernel k) const override
+    {
+        switch (k) {
+            case OpKernel::ADD: return infix("+");
+            case OpKernel::SUB: return infix("-");
+            case OpKernel::MUL: return infix("*");
+            case OpKernel::DIV: return infix("/");
+            case OpKernel::MOD: return call("math.Mod");
+            case OpKernel::POW: return call("math.Pow");
+            case OpKernel::MIN: return call("spongeMin");
+            case OpKernel::MAX: return call("spongeMax");
+            default: return {};
+        }
+    }
+
+    LocalForm localForm() const override { return { "    ", " := ", "\n" }; }
+
+    MinMaxForm minMaxForm() const override
+    {
+        return { "func spongeMin(a, b float64) float64 {\n    if b < a {\n        return b\n    }\n    return a\n}\n",
+                 "func spongeMax(a, b float64) float64 {\n    if a < b {\n        return b\n    }\n    return a\n}\n" };
+    }
+
+    // C / Rust 와 같은 최단 왕복 표기 (%f 는 1e-7 을 0.000000 으로 잃는다)
+    void literal(double v, EmitBuffer& out) const override
+    {
+        if (std::isnan(v)) out << "math.NaN()";
+        else if (std::isinf(v)) out << (v > 0 ? "math.Inf(1)" : "math.Inf(-1)");
+        else floatLiteral(v, out);
+    }
+};
+
+// C99: double sponge_expr(...) (+ 변수가 없으면 printf 하는 main)
+class CEmitter : public ExprEmitter {
+public:
+    const char* name() const override { return "c"; }
+    const char* extension() const override { return ".c"; }
+
+    void emit(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const override
+    {
+        Context cx = context(ir, ops);
+        out << "#include <math.h>\n#include <stdio.h>\n\n";
+        helpers(ir, ops, out);
+        out << "double sponge_expr(";
+        if (ir.vars.empty()) out << "void";
+        else parameters(ir, out, "double", true);
+        out << ")\n{\n";
+        locals(ir, ops, cx, out);
+        out << "    return ";
+        expression(ir, ops, cx, ir.root, out);
+        out << ";\n}\n";
+
+        if (ir.vars.empty())
+            out << "\nint main(void)\n{\n    printf(\"%.17g\\n\", sponge_expr());\n    return 0;\n}\n";
+    }
+
+protected:
+    OpForm form(OpKernel k) const override
+    {
+        switch (k) {
+            case OpKernel::ADD: return infix("+");
+            case OpKernel::SUB: return infix("-");
+            case OpKernel::MUL: return infix("*");
+            case OpKernel::DIV: return infix("/");
+            case OpKernel::MOD: return call("fmod");
+            case OpKernel::POW: return call("pow");
+            case OpKernel::MIN: return call("sponge_min");
+            case OpKernel::MAX: return call("sponge_max");
+            default: return {};
+        }
+    }
+
+    LocalForm localForm() const override { return { "    const double ", " = ", ";\n" }; }
+
+    MinMaxForm minMaxForm() const override
+    {
+        return { "static double sponge_min(double a, double b)\n{\n    return b < a ? b : a;\n}\n",
+                 "static double sponge_max(double a, double b)\n{\n    return a < b ? b : a;\n}\n" };
+    }
+
+    void literal(double v, EmitBuffer& out) const override
+    {
+        if (std::isnan(v)) out << "NAN";
+        else if (std::isinf(v)) out << (v > 0 ? "INFINITY" : "(-INFINITY)");
+        else floatLiteral(v, out);
+    }
+};
+
+// Rust: fn sponge_expr(...) -> f64 (+ 변수가 없으면 println 하는 main)
+class RustEmitter : public ExprEmitter {
+public:
+    const char* name() const override { return "rust"; }
+    const char* extension() const override { return ".rs"; }
+
+    void emit(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const override
+    {
+        Context cx = context(ir, ops);
+        out << "#![allow(unused_parens)]\n\n";
+        helpers(ir, ops, out);
+        out << "fn sponge_expr(";
+        parameters(ir, out, ": f64", false);
+        out << ") -> f64 {\n";
+        locals(ir, ops, cx, out);
+        out << "    ";
+        expression(ir, ops, cx, ir.root, out);
+        out << "\n}\n";
+
+        if (ir.vars.empty())
+            out << "\nfn main() {\n    println!(\"{}\", sponge_expr());\n}\n";
+    }
+
+protected:
+    OpForm form(OpKernel k) const override
+    {
+        switch (k) {
+            case OpKernel::ADD: return infix("+");
+            case OpKernel::SUB: return infix("-");
+            case OpKernel::MUL: return infix("*");
+            case OpKernel::DIV: return infix("/");
+            case OpKernel::MOD: return infix("%");
+            case OpKernel::POW: return call("f64::powf");
+            case OpKernel::MIN: return call("sponge_min");
+            case OpKernel::MAX: return call("sponge_max");
+            default: return {};
+        }
+    }
+
+    LocalForm localForm() const override { return { "    let ", " = ", ";\n" }; }
+
+    MinMaxForm minMaxForm() const override
+    {
+        return { "fn sponge_min(a: f64, b: f64) -> f64 {\n    if b < a { b } else { a }\n}\n",
+                 "fn sponge_max(a: f64, b: f64) -> f64 {\n    if a < b { b } else { a }\n}\n" };
+    }
+
+    void literal(double v, EmitBuffer& out) const override
+    {
+        if (std::isnan(v)) out << "f64::NAN";
+        else if (std::isinf(v)) out << (v > 0 ? "f64::INFINITY" : "f64::NEG_INFINITY");
+        else floatLiteral(v, out);
+    }
+};
+
+// NASM: JIT 이 만드는 것과 같은 x86-64 코드의 텍스트
+class NasmEmitter : public Emitter {
+public:
+    const char* name() const override { return "nasm"; }
+    const char* extension() const override { return ".asm"; }
+
+    void emit(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const override
+    {
+        JitCompiler().emitNasm(ir, ops, out);
+    }
+};
+
+
+
+// ------------------------------------------------------
+// 레지스트리
+// ------------------------------------------------------
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Emitter>> emitters;
+
+    Registry()
+    {
+        emitters.push_back(std::make_unique<GoEmitter>());
+        emitters.push_back(std::make_unique<CEmitter>());
+        emitters.push_back(std::make_unique<RustEmitter>());
+        emitters.push_back(std::make_unique<NasmEmitter>());
+    }
+
+    const Emitter* find(std::string_view name) const
+    {
+        for (auto& e : emitters)
+            if (name == e->name()) return e.get();
+        return nullptr;
+    }
+};
+
+Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+} // namespace
+
+void EmitterRegistry::add(std::unique_ptr<Emitter> emitter)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (r.find(emitter->name()))
+        throw std::runtime_error(std::string("Emit backend already registered: ") + emitter->name());
+    r.emitters.push_back(std::move(emitter));
+}
+
+const Emitter& EmitterRegistry::get(std::string_view name)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    if (const Emitter* e = r.find(name)) return *e;
+    throw std::runtime_error("Unknown emit backend: " + std::string(name));
+}
+
+std::vector<std::string> EmitterRegistry::names()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<std::string> out;
+    for (auto& e : r.emitters) out.emplace_back(e->name());
+    return out;
+}
+
+} // namespace sponge
@@ -0,0 +1,89 @@
+#pragma once
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+/**
+ * 코드 생성 출력 버퍼.
+ *
+ * std::string 대상이면 그 문자열 끝에 바로 덧붙이고,
+ * std::ostream 대상이면 chunk 바이트까지 모았다가 한 번에 write 한다.
+ * 소멸 시 남은 내용을 flush 한다.
+ */
+class EmitBuffer {
+public:
+    explicit EmitBuffer(std::string& out) : target(&out) {}
+    explicit EmitBuffer(std::ostream& os, size_t chunk = size_t(1) << 16)
+        : target(&own), stream(&os), chunk(chunk) { own.reserve(chunk); }
+    ~EmitBuffer() { flush(); }
+
+    EmitBuffer(const EmitBuffer&) = delete;
+    EmitBuffer& operator=(const EmitBuffer&) = delete;
+
+    EmitBuffer& operator<<(std::string_view s) { target->append(s); spill(); return *this; }
+    EmitBuffer& operator<<(const char* s) { return *this << std::string_view(s); }
+    EmitBuffer& operator<<(const std::string& s) { return *this << std::string_view(s); }
+    EmitBuffer& operator<<(char c) { target->push_back(c); spill(); return *this; }
+
+    template<class T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char>, int> = 0>
+    EmitBuffer& operator<<(T v) {
+        char buf[24];
+        auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        return *this << std::string_view(buf, size_t(r.ptr - buf));
+    }
+
+    // ostream 기본 서식과 같은 %g (유효숫자 6)
+    EmitBuffer& operator<<(double v);
+
+    void flush();
+
+private:
+    std::string* target;
+    std::string own;
+    std::ostream* stream = nullptr;
+    size_t chunk = 0;
+
+    void spill() { if (stream && own.size() >= chunk) flush(); }
+};
+
+/**
+ * IR → 대상 언어 소스 백엔드.
+ *
+ * emit() 은 IR 을 한 번만 훑으며 out 에 바로 쓴다 (부분 문자열을 만들지 않음).
+ * 백엔드는 상태가 없어 여러 스레드가 같은 객체로 동시에 emit 해도 된다.
+ * 대상 언어로 옮길 수 없는 연산자를 만나면 runtime_error.
+ */
+class Emitter {
+public:
+    virtual ~Emitter() = default;
+    virtual const char* name() const = 0;
+    // 출력 파일 확장자 (".go" …)
+    virtual const char* extension() const = 0;
+    virtual void emit(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const = 0;
+};
+
+/**
+ * 이름 → 백엔드 (프로세스 전역).
+ * 기본으로 "go", "c", "rust", "nasm" 이 들어 있다.
+ * 등록한 백엔드는 프로세스가 끝날 때까지 살아 있으므로 get() 참조를 들고 있어도 된다.
+ */
+class EmitterRegistry {
+public:
+    // 같은 이름이 이미 있으면 runtime_error
+    static void add(std::unique_ptr<Emitter> emitter);
+    // 없으면 runtime_error("Unknown emit backend: x")
+    static const Emitter& get(std::string_view name);
+    static std::vector<std::string> names();
+};
+
+} // namespace sponge
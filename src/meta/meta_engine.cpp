@@ -1,18 +1,191 @@
 #include "meta_engine.hpp"
 #include "meta_parser.hpp"
 #include "meta_ir.hpp"
+#include "meta_mapped_file.hpp"
+#include "meta_program_file.hpp"
+#include "meta_stats.hpp"
 #include <stdexcept>
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
 
 namespace sponge {
 
+namespace {
+
+// ------------------------------------------------------
+// 팩 지문: 흡수한 규칙을 정렬해 해시 (.spbc 캐시 키)
+//   텍스트 팩과 같은 내용의 .spack 은 같은 지문이 되도록
+//   평가식은 커널로, bytecode 는 원래 이름으로 넣는다.
+// ------------------------------------------------------
+struct Fingerprint {
+    std::vector<std::string> items;
+
+    void add(char kind, std::string_view key, std::string_view value) {
+        std::string s(1, kind);
+        s.append(key).append(1, '\x1f').append(value);
+        items.push_back(std::move(s));
+    }
+
+    void op(std::string_view name, int precedence, bool right) {
+        add('P', name, std::to_string(precedence) + (right ? "r" : "l"));
+    }
+
+    uint64_t finish(std::string_view language) {
+        std::sort(items.begin(), items.end());
+        std::string all(language);
+        for (auto& s : items) all.append(1, '\x1e').append(s);
+        return hashBytes(all);
+    }
+};
+
+} // namespace
+
 // ------------------------------------------------------
 // 생성자
 // ------------------------------------------------------
 SpongeMetaEngine::SpongeMetaEngine()
 {
     parser = std::make_unique<MetaParser>();
-    irbuilder = std::make_unique<IRBuilder>();
+    vm = std::make_unique<VM>();
+
+    // 빈 언어 (+ - * / 만 intern 된 상태, 기본 문법)
+    auto s = std::make_shared<LangSnapshot>();
+    s->grammar = Grammar::defaults();
+    s->fingerprint = Fingerprint().finish("");
+    publish(std::move(s), false);
+    registry.publish(std::make_shared<LangRegistry>());
+}
+
+SpongeMetaEngine::~SpongeMetaEngine() = default;
+
+
+
+// ------------------------------------------------------
+// 스냅샷 교체 (RCU publish)
+// ------------------------------------------------------
+void SpongeMetaEngine::publish(std::shared_ptr<LangSnapshot> snap, bool registerName)
+{
+    // 동시에 흡수해도 기본 언어와 레지스트리가 같은 순서로 바뀌도록
+    std::lock_guard<std::mutex> lock(registryMutex);
+    snap->generation = ++generations;
+    std::shared_ptr<const LangSnapshot> frozen = std::move(snap);
+
+    if (registerName) {
+        // 레지스트리는 작아서 (언어 수 만큼의 포인터) 통째로 복사해 교체한다
+        auto next = std::make_shared<LangRegistry>(*registry.load());
+        auto [it, added] = next->ids.try_emplace(frozen->language, LangId(next->byId.size()));
+        if (added) {
+            next->byId.push_back(frozen);
+        } else {
+            next->byId[it->second] = frozen;
+            replacements.fetch_add(1, std::memory_order_relaxed);
+        }
+        registry.publish(std::move(next));
+    }
+    lang.publish(std::move(frozen));
+}
+
+
+
+// ------------------------------------------------------
+// 등록된 언어 조회
+// ------------------------------------------------------
+LangId SpongeMetaEngine::languageId(std::string_view name) const
+{
+    Rcu::ReadGuard guard;
+    const LangRegistry& R = *registry.peek();
+    auto it = R.ids.find(name);
+    if (it == R.ids.end())
+        throw std::runtime_error("Unknown language: " + std::string(name));
+    return it->second;
+}
+
+bool SpongeMetaEngine::hasLanguage(std::string_view name) const
+{
+    Rcu::ReadGuard guard;
+    const LangRegistry& R = *registry.peek();
+    return R.ids.find(name) != R.ids.end();
+}
+
+std::vector<std::string> SpongeMetaEngine::languages() const
+{
+    Rcu::ReadGuard guard;
+    std::vector<std::string> out;
+    for (auto& s : registry.peek()->byId) out.push_back(s->language);
+    return out;
+}
+
+std::shared_ptr<const LangSnapshot> SpongeMetaEngine::snapshot(LangId id) const
+{
+    Rcu::ReadGuard guard;
+    const LangRegistry& R = *registry.peek();
+    if (id >= R.byId.size())
+        throw std::runtime_error("Unknown language id: " + std::to_string(id));
+    return R.byId[id];
+}
+
+// ReadGuard 구간 안에서만 유효 (그 구간 동안 레지스트리가 스냅샷을 붙잡고 있다)
+const LangSnapshot& SpongeMetaEngine::pinnedLanguage(LangId id) const
+{
+    const LangRegistry& R = *registry.peek();
+    if (id >= R.byId.size())
+        throw std::runtime_error("Unknown language id: " + std::to_string(id));
+    return *R.byId[id];
+}
+
+static std::shared_ptr<LangSnapshot> buildSnapshot(
+    const std::string& langName,
+    const std::unordered_map<std::string, std::string>& tokenRules,
+    const std::unordered_map<std::string, int>& precedenceRules,
+    const std::unordered_map<std::string, std::function<double(double,double)>>& evalRules,
+    const std::unordered_map<std::string, std::string>& irRules,
+    const std::unordered_map<std::string, std::string>& bytecodeRules,
+    const std::unordered_map<std::string, std::string>& assocRules)
+{
+    auto s = std::make_shared<LangSnapshot>();
+    s->language = langName;
+
+    s->tokens = tokenRules;
+    s->precedence = precedenceRules;
+    s->evalRules = evalRules;
+    s->irRules = irRules;
+    s->bytecodeRules = bytecodeRules;
+    s->assocRules = assocRules;
+
+    // 토큰 정규식 → 결합 DFA, 우선순위/결합성 → Pratt 테이블
+    GrammarBuilder gb;
+    for (auto& kv : tokenRules)
+        gb.addToken(kv.first, kv.second);
+    for (auto& kv : precedenceRules) {
+        auto it = assocRules.find(kv.first);
+        gb.addOperator(kv.first, kv.second, it != assocRules.end() && it->second == "right");
+    }
+    s->grammar = gb.build(s->ops);
+
+    // 연산자 intern → 커널 테이블 구성
+    // (알려진 커널은 직접 분기, 나머지는 std::function 으로 fallback)
+    for (auto& kv : s->evalRules) {
+        s->ops.define(s->ops.intern(kv.first), kv.second);
+    }
+
+    // pack.bytecode["+"] = "ADD" 같은 매핑은 BytecodeCompiler 가
+    // IR → VM opcode 변환에 그대로 사용.
+    s->compiler.setRules(s->bytecodeRules, s->ops);
+
+    Fingerprint fp;
+    for (auto& kv : tokenRules) fp.add('T', kv.first, kv.second);
+    for (auto& kv : precedenceRules) {
+        auto it = assocRules.find(kv.first);
+        fp.op(kv.first, kv.second, it != assocRules.end() && it->second == "right");
+    }
+    for (auto& kv : evalRules)
+        fp.add('E', kv.first, std::to_string(int(kernelFromFunction(kv.second))));
+    for (auto& kv : irRules) fp.add('I', kv.first, kv.second);
+    for (auto& kv : bytecodeRules) fp.add('B', kv.first, kv.second);
+    s->fingerprint = fp.finish(langName);
+    return s;
 }
 
 
@@ -26,17 +199,8 @@ void SpongeMetaEngine::absorb(
     const std::unordered_map<std::string, int>& precedenceRules,
     const std::unordered_map<std::string, std::function<double(double,double)>>& evalRules
 ){
-    currentLanguage = langName;
-
-    tokenMap = tokenRules;
-    precedenceMap = precedenceRules;
-    evalMap = evalRules;
-
-    // MetaParser에 규칙을 전달
-    parser->rules.clear();
-    for (auto& kv : precedenceMap) {
-        parser->rules[kv.first] = std::to_string(kv.second);
-    }
+    // 이전 언어의 IR/Bytecode 규칙은 버린다
+    publish(buildSnapshot(langName, tokenRules, precedenceRules, evalRules, {}, {}, {}));
 }
 
 
@@ -50,45 +214,489 @@ void SpongeMetaEngine::absorbMetaPack(
     const std::unordered_map<std::string, int>& precedenceRules,
     const std::unordered_map<std::string, std::function<double(double,double)>>& evalRules,
     const std::unordered_map<std::string, std::string>& irRules,
-    const std::unordered_map<std::string, std::string>& bytecodeRules
+    const std::unordered_map<std::string, std::string>& bytecodeRules,
+    const std::unordered_map<std::string, std::string>& assocRules
 ){
-    absorb(langName, tokenRules, precedenceRules, evalRules);
+    publish(buildSnapshot(langName, tokenRules, precedenceRules, evalRules,
+                          irRules, bytecodeRules, assocRules));
+}
+
+
+
+// ------------------------------------------------------
+// 바이너리 팩 흡수 (맵 복사 / 규칙 문자열 해석 없음)
+// ------------------------------------------------------
+void SpongeMetaEngine::absorbPack(std::shared_ptr<const PackImage> pack)
+{
+    if (!pack)
+        throw std::runtime_error("absorbPack: null pack");
+
+    auto s = std::make_shared<LangSnapshot>();
+    s->language = std::string(pack->name());
+
+    Fingerprint fp;
+    for (const PackPair& t : pack->tokens())
+        fp.add('T', pack->str(t.key), pack->str(t.value));
+    for (const PackPair& r : pack->irRules())
+        fp.add('I', pack->str(r.key), pack->str(r.value));
+
+    // 레코드 번호가 곧 OpId. 이름은 OperatorTable 의 이름 조회에 필요해서 넣지만
+    // 번호를 새로 매기지 않고 팩과 같은지만 확인한다
+    std::span<const PackOp> records = pack->operators();
+    for (size_t i = 0; i < records.size(); ++i) {
+        const PackOp& rec = records[i];
+        OpId id = static_cast<OpId>(i);
+        std::string_view name = pack->str(rec.name);
+        if (s->ops.intern(std::string(name)) != id)
+            throw std::runtime_error("absorbPack: operator table out of order");
+
+        if (rec.flags & PACK_OP_PRECEDENCE)
+            fp.op(name, rec.precedence, (rec.flags & PACK_OP_RIGHT_ASSOC) != 0);
+        if (rec.flags & PACK_OP_EVAL)
+            fp.add('E', name, std::to_string(int(rec.kernel)));
+        if (rec.flags & PACK_OP_BYTECODE)
+            fp.add('B', name, pack->str(rec.bytecodeName));
+
+        if (rec.flags & PACK_OP_EVAL) {
+            // 텍스트 경로(MetaAbsorbLoader::mount)와 같은 규칙:
+            // 모르는 평가식은 0 을 돌려주는 GENERIC
+            if (EvalFn fn = kernelFunction(static_cast<OpKernel>(rec.kernel)))
+                s->ops.define(id, fn);
+            else
+                s->ops.define(id, [](double, double) { return 0.0; });
+        }
+        if (rec.flags & PACK_OP_BYTECODE)
+            s->compiler.setOpcode(id, static_cast<OpCode>(rec.opcode));
+    }
+
+    // 결합 표와 렉서 DFA 는 팩에 풀려 있다 (GrammarBuilder / 정규식 컴파일 없음).
+    // DFA 상태 표는 복사하지 않고 매핑된 파일을 가리키며, 스냅샷이 packImage 로 붙잡아 둔다
+    std::vector<OpBinding> bindings;
+    bindings.reserve(records.size());
+    for (const PackBinding& b : pack->bindings())
+        bindings.push_back({ b.precedence, b.infix != 0, b.rightAssoc != 0 });
+
+    std::vector<LexerDFA::Rule> rules;
+    rules.reserve(pack->lexerRules().size());
+    for (const PackRule& r : pack->lexerRules())
+        rules.push_back({ static_cast<TokKind>(r.kind), r.op, r.skip != 0 });
+
+    LexerDFA dfa;
+    dfa.useTables(pack->lexerTables(), std::move(rules));
+    s->grammar = Grammar(std::make_shared<const LexerDFA>(std::move(dfa)), std::move(bindings));
+    s->fingerprint = fp.finish(s->language);
+    s->packImage = std::move(pack);
+    publish(std::move(s));
+}
+
+
+
+// ------------------------------------------------------
+// 내장 언어 흡수 (생성된 표 → 스냅샷, 문자열 규칙 해석 / DFA 구성 없음)
+// ------------------------------------------------------
+void SpongeMetaEngine::absorbBuiltin(std::string_view name)
+{
+    const BuiltinLanguage* lang = findBuiltin(name);
+    if (!lang)
+        throw std::runtime_error("Unknown built-in language: " + std::string(name));
 
-    irMap = irRules;
-    bcMap = bytecodeRules;
+    auto s = std::make_shared<LangSnapshot>();
+    s->language = lang->name;
+    s->builtin = lang;
+
+    GrammarBuilder gb;
+    Fingerprint fp;
+    for (const BuiltinPair& t : lang->tokens) {
+        gb.addToken(t.key, t.value);
+        fp.add('T', t.key, t.value);
+    }
+    for (const BuiltinPair& r : lang->irRules)
+        fp.add('I', r.key, r.value);
+    for (const BuiltinOp& op : lang->ops) {
+        bool right = (op.flags & PACK_OP_RIGHT_ASSOC) != 0;
+        if (op.flags & PACK_OP_PRECEDENCE) {
+            gb.addOperator(op.name, op.precedence, right);
+            fp.op(op.name, op.precedence, right);
+        }
+        if (op.flags & PACK_OP_EVAL)
+            fp.add('E', op.name, std::to_string(int(op.kernel)));
+        if (op.flags & PACK_OP_BYTECODE)
+            fp.add('B', op.name, op.bytecode);
+    }
+    s->grammar = gb.build(s->ops, lang->match);
+
+    // 생성 코드는 표 번호를 OpId 로 쓴다 (문법 연산자 → 나머지 순서로 intern)
+    if (s->grammar.lexer().ruleCount() != lang->ruleCount)
+        throw std::runtime_error("absorbBuiltin: lexer rules out of date: " + s->language);
+    for (size_t i = 0; i < lang->ops.size(); ++i) {
+        const BuiltinOp& op = lang->ops[i];
+        OpId id = s->ops.intern(op.name);
+        if (id != i)
+            throw std::runtime_error("absorbBuiltin: operator order out of date: " + s->language);
+
+        if (op.flags & PACK_OP_EVAL) {
+            if (EvalFn fn = kernelFunction(op.kernel))
+                s->ops.define(id, fn);
+            else
+                s->ops.define(id, [](double, double) { return 0.0; });
+        }
+        if (op.flags & PACK_OP_BYTECODE)
+            s->compiler.setOpcode(id, opcodeFromName(op.bytecode));
+    }
+
+    s->fingerprint = fp.finish(s->language);
+    publish(std::move(s));
 }
 
 
 
 // ------------------------------------------------------
-// IR 평가기
+// IR 최적화
 // ------------------------------------------------------
-double SpongeMetaEngine::evaluateIR(const std::shared_ptr<IRNode>& node)
+void SpongeMetaEngine::setOptimize(bool on)
+{
+    optimize = on;
+    cache.invalidate();
+}
+
+void SpongeMetaEngine::setHashCons(bool on)
+{
+    parser->hashCons = on;
+    for (auto& w : batchWorkers) w->parser.hashCons = on;
+    cache.invalidate();
+}
+
+void SpongeMetaEngine::setPasses(PassManager pm)
+{
+    passes = std::move(pm);
+    passStatsVec.clear();
+    cache.invalidate();
+}
+
+void SpongeMetaEngine::optimizeIR(IRArena& ir, const LangSnapshot& L,
+                                  std::vector<PassStats>* stats)
+{
+    if (optimize && !passes.empty())
+        passes.run(ir, L.ops, stats);
+}
+
+CompiledProgram& SpongeMetaEngine::acquire(const std::string& src, const LangSnapshot& L)
+{
+    if (!parser)
+        throw std::runtime_error("Parser not initialized");
+
+    // 다른 스레드가 등록된 언어를 바꿨으면 옛 프로그램은 버린다 (캐시는 이 스레드만 만진다).
+    // 언어끼리 오가는 것은 세대가 캐시 키에 들어 있어 비울 필요가 없다.
+    uint64_t replaced = replacements.load(std::memory_order_relaxed);
+    if (replaced != cacheReplacements) {
+        cache.invalidate();
+        current.reset();
+        cacheReplacements = replaced;
+    }
+    parser->grammar = &L.grammar;
+
+    // 캐시 비활성: scratch 아레나 재사용
+    if (cache.capacity() == 0) {
+        parser->parse(src, scratch.ir);
+        SPONGE_STATS_IF(Stats::recordIR(scratch.ir, L.ops));
+        optimizeIR(scratch.ir, L, &passStatsVec);
+        scratch.hasBytecode = false;
+        scratch.closure = ClosureProgram();
+        scratch.jit.reset();
+        scratch.jitTried = false;
+        return scratch;
+    }
+
+    if (auto hit = cache.find(src, L.generation)) {
+        current = std::move(hit);
+        return *current;
+    }
+
+    auto prog = std::make_shared<CompiledProgram>();
+    parser->parse(src, prog->ir);
+    SPONGE_STATS_IF(Stats::recordIR(prog->ir, L.ops));
+    optimizeIR(prog->ir, L, &passStatsVec);
+    cache.insert(src, L.generation, prog);
+
+    current = std::move(prog);
+    return *current;
+}
+
+const Bytecode& SpongeMetaEngine::ensureBytecode(CompiledProgram& prog, const LangSnapshot& L)
+{
+    if (!prog.hasBytecode) {
+        prog.bc = L.compiler.compile(prog.ir, L.ops);
+        prog.hasBytecode = true;
+    }
+    return prog.bc;
+}
+
+const ClosureProgram& SpongeMetaEngine::ensureClosure(CompiledProgram& prog, const LangSnapshot& L)
 {
-    if (!node) throw std::runtime_error("IRNode null");
+    if (prog.closure.empty())
+        prog.closure = ClosureProgram(prog.ir, L.ops);
+    return prog.closure;
+}
 
-    // literal
-    if (node->op == "literal") {
-        return node->literal[0];
+const JitFunction* SpongeMetaEngine::ensureJit(CompiledProgram& prog, const LangSnapshot& L)
+{
+    if (!prog.jitTried) {
+        prog.jitTried = true;
+        // 변수가 있는 식은 env 없이 못 돌리므로 VM 쪽 에러 처리에 맡긴다.
+        // 스택 프레임이 너무 커지는 (아주 깊거나 공유 노드가 많은) 식도 VM 으로
+        if (JitCompiler::available() && prog.ir.vars.empty() &&
+            JitCompiler::frameSlots(prog.ir) <= JitCompiler::kMaxFrameSlots)
+            prog.jit = jit.compile(prog.ir, L.ops);
     }
+    return prog.jit.get();
+}
 
-    // binary
-    if (node->children.size() == 2) {
-        auto L = evaluateIR(node->children[0]);
-        auto R = evaluateIR(node->children[1]);
 
-        // op에 해당하는 evalRules ("a+b") 적용
-        auto it = evalMap.find(node->op);
-        if (it != evalMap.end()) {
-            return it->second(L, R);
+
+// ------------------------------------------------------
+// IR 평가기 (깊이 제한 재귀 + 명시적 스택)
+// ------------------------------------------------------
+namespace {
+
+// 평가 스레드별 scratch (runBatch 워커가 동시에 평가하므로 thread_local)
+struct EvalScratch {
+    std::vector<IRRef> work;        // 방문할 노드 (kExpanded = 자식을 이미 내려보낸 BINARY)
+    std::vector<double> vals;       // 값 스택
+    std::vector<double> values;     // 병렬 평가: 잘린 서브트리 값 (ready 인 노드) / DAG: 노드 값
+    std::vector<uint8_t> ready;     // DAG: node 에서 닿는 노드
+};
+
+thread_local EvalScratch tEval;
+
+constexpr IRRef kExpanded = 0x80000000u;
+
+/**
+ * 재귀 없이 root 를 평가한다 (명시적 작업 스택 + 값 스택).
+ * 왼쪽 → 오른쪽 → 부모 순서라 노드마다 하는 연산이 재귀 평가와 같고,
+ * 결과도 비트 단위로 같다. 잎 자식은 스택을 거치지 않고 바로 읽는다.
+ * ready 가 있으면 ready[n] 인 노드는 s.values[n] 을 잎처럼 쓴다.
+ */
+double evalIterative(const OperatorTable& ops, const IRArena& ir, IRRef root,
+                     const double* env, EvalScratch& s, const uint8_t* ready)
+{
+    if (root >= ir.size()) throw std::runtime_error("IRNode null");
+
+    const IRTag* tag = ir.tag.data();
+    const IRRef* lhs = ir.lhs.data();
+    const IRRef* rhs = ir.rhs.data();
+
+    // 잎이면 값을 v 에 넣고 true
+    auto leaf = [&](IRRef n, double& v) -> bool {
+        if (ready && ready[n]) { v = s.values[n]; return true; }
+        switch (tag[n]) {
+            case IRTag::LITERAL: v = ir.value[n]; return true;
+            case IRTag::VAR:
+                if (!env) throw std::runtime_error("Unbound variable: " + ir.vars[lhs[n]]);
+                v = env[lhs[n]];
+                return true;
+            case IRTag::BINARY: return false;
+        }
+        throw std::runtime_error("Invalid IR node structure");
+    };
+
+    double v;
+    if (leaf(root, v)) return v;
+
+    s.work.clear();
+    s.vals.clear();
+    s.work.push_back(root);
+    while (!s.work.empty()) {
+        IRRef e = s.work.back();
+        s.work.pop_back();
+
+        if (e & kExpanded) {
+            // 두 피연산자가 값 스택 맨 위에 있다
+            IRRef n = e & ~kExpanded;
+            double b = s.vals.back();
+            s.vals.pop_back();
+            double& a = s.vals.back();
+            a = ops.apply(ir.op[n], a, b);
+            continue;
         }
 
-        throw std::runtime_error("Unknown operator: " + node->op);
+        double a, b;
+        if (leaf(e, a)) {       // 왼쪽 서브트리 뒤로 미뤄 둔 오른쪽 잎
+            s.vals.push_back(a);
+            continue;
+        }
+        if (leaf(lhs[e], a)) {
+            if (leaf(rhs[e], b)) {
+                s.vals.push_back(ops.apply(ir.op[e], a, b));
+                continue;
+            }
+            s.vals.push_back(a);
+            s.work.push_back(e | kExpanded);
+            s.work.push_back(rhs[e]);
+            continue;
+        }
+        s.work.push_back(e | kExpanded);
+        s.work.push_back(rhs[e]);
+        s.work.push_back(lhs[e]);
     }
+    return s.vals.back();
+}
 
+/**
+ * 공유 노드가 있는 IR (IRArena::shared) 평가: 노드마다 한 번만 계산한다.
+ * 자식 < 부모 이므로 node 에서 닿는 노드를 뒤에서부터 한 번 표시하고
+ * 앞에서부터 한 번 훑으면 자식 값이 항상 먼저 준비된다 (재귀 없음).
+ */
+double evalShared(const OperatorTable& ops, const IRArena& ir, IRRef node,
+                  const double* env, EvalScratch& s)
+{
+    const size_t n = size_t(node) + 1;
+    s.ready.assign(n, 0);
+    s.ready[node] = 1;
+    for (size_t k = n; k-- > 0; ) {
+        if (s.ready[k] && ir.tag[k] == IRTag::BINARY) {
+            s.ready[ir.lhs[k]] = 1;
+            s.ready[ir.rhs[k]] = 1;
+        }
+    }
+
+    if (s.values.size() < n) s.values.resize(n);
+    double* v = s.values.data();
+    for (size_t k = 0; k < n; ++k) {
+        if (!s.ready[k]) continue;
+        switch (ir.tag[k]) {
+            case IRTag::LITERAL:
+                v[k] = ir.value[k];
+                break;
+            case IRTag::VAR:
+                if (!env) throw std::runtime_error("Unbound variable: " + ir.vars[ir.lhs[k]]);
+                v[k] = env[ir.lhs[k]];
+                break;
+            case IRTag::BINARY:
+                v[k] = ops.apply(ir.op[k], v[ir.lhs[k]], v[ir.rhs[k]]);
+                break;
+            default:
+                throw std::runtime_error("Invalid IR node structure");
+        }
+    }
+    return v[node];
+}
+
+// 이보다 깊으면 재귀를 멈추고 evalIterative 로 넘긴다 (스택 사용량 상한)
+constexpr unsigned kMaxEvalDepth = 512;
+
+/**
+ * 얕은 트리용 빠른 경로: 깊이 kMaxEvalDepth 까지만 재귀하고
+ * 그 아래 서브트리는 명시적 스택으로 평가한다.
+ */
+double evalBounded(const OperatorTable& ops, const IRArena& ir, IRRef n,
+                   const double* env, unsigned depth)
+{
+    switch (ir.tag[n]) {
+        case IRTag::LITERAL:
+            return ir.value[n];
+        case IRTag::VAR:
+            if (!env) throw std::runtime_error("Unbound variable: " + ir.vars[ir.lhs[n]]);
+            return env[ir.lhs[n]];
+        case IRTag::BINARY: {
+            if (depth >= kMaxEvalDepth)
+                return evalIterative(ops, ir, n, env, tEval, nullptr);
+            double a = evalBounded(ops, ir, ir.lhs[n], env, depth + 1);
+            double b = evalBounded(ops, ir, ir.rhs[n], env, depth + 1);
+            return ops.apply(ir.op[n], a, b);
+        }
+    }
     throw std::runtime_error("Invalid IR node structure");
 }
 
+} // namespace
+
+double SpongeMetaEngine::evaluateIR(const OperatorTable& ops, const IRArena& ir,
+                                    IRRef node, const double* env) const
+{
+    if (node >= ir.size()) throw std::runtime_error("IRNode null");
+    if (ir.shared) return evalShared(ops, ir, node, env, tEval);
+    return evalBounded(ops, ir, node, env, 0);
+}
+
+double SpongeMetaEngine::evaluateRoot(const LangSnapshot& L, const IRArena& ir) const
+{
+    SPONGE_PHASE(EVAL_TREE);
+    if (L.builtin) return L.builtin->evaluate(L.ops, ir, nullptr);
+    return evaluateIR(L.ops, ir, ir.root);
+}
+
+
+
+// ------------------------------------------------------
+// 큰 트리 병렬 평가 (fork-join)
+// ------------------------------------------------------
+void SpongeMetaEngine::ensurePool()
+{
+    if (pool) return;
+    pool = std::make_unique<WorkStealingPool>(threadCount);
+
+    // 워커 + 호출 스레드(외부 인덱스) 몫
+    for (size_t i = 0; i <= pool->size(); ++i) {
+        batchWorkers.push_back(std::make_unique<BatchWorker>());
+        batchWorkers.back()->parser.hashCons = parser->hashCons;
+    }
+}
+
+double SpongeMetaEngine::evaluateParallel(const OperatorTable& ops, const IRArena& ir)
+{
+    SPONGE_PHASE(EVAL_TREE);
+    ensurePool();
+
+    const IRRef root = ir.root;
+    if (root >= ir.size()) throw std::runtime_error("IRNode null");
+
+    // 서브트리 크기 (자식 < 부모 이므로 앞에서부터 한 번)
+    std::vector<uint32_t> size(size_t(root) + 1);
+    for (IRRef i = 0; i <= root; ++i) {
+        uint64_t n = 1;
+        if (ir.tag[i] == IRTag::BINARY) n += uint64_t(size[ir.lhs[i]]) + size[ir.rhs[i]];
+        size[i] = static_cast<uint32_t>(std::min<uint64_t>(n, UINT32_MAX));
+    }
+
+    // 위에서부터 grain 보다 큰 노드는 쪼개고, 작아진 BINARY 서브트리를 작업으로 만든다
+    const size_t grain = std::max<size_t>(4096, size[root] / ((pool->size() + 1) * 8));
+    std::vector<IRRef> cut;
+    std::vector<IRRef> stack{ root };
+    while (!stack.empty()) {
+        IRRef n = stack.back();
+        stack.pop_back();
+        if (ir.tag[n] != IRTag::BINARY) continue;
+        if (size[n] <= grain) {
+            cut.push_back(n);
+            continue;
+        }
+        stack.push_back(ir.rhs[n]);
+        stack.push_back(ir.lhs[n]);
+    }
+
+    // fork: 서브트리마다 작업 하나 (각자 자기 스레드의 scratch 로 순차 평가)
+    std::vector<double> results(cut.size());
+    {
+        TaskGroup group(*pool);
+        for (size_t k = 0; k < cut.size(); ++k) {
+            group.run([&, k] {
+                results[k] = evalIterative(ops, ir, cut[k], nullptr, tEval, nullptr);
+            });
+        }
+        group.wait();
+    }
+
+    // join: 잘린 서브트리는 값이 있는 잎으로 보고 위쪽만 평가
+    EvalScratch& s = tEval;
+    s.values.resize(size_t(root) + 1);
+    s.ready.assign(size_t(root) + 1, 0);
+    for (size_t k = 0; k < cut.size(); ++k) {
+        s.values[cut[k]] = results[k];
+        s.ready[cut[k]] = 1;
+    }
+    return evalIterative(ops, ir, root, nullptr, s, s.ready.data());
+}
+
 
 
 // ------------------------------------------------------
@@ -96,49 +704,464 @@ double SpongeMetaEngine::evaluateIR(const std::shared_ptr<IRNode>& node)
 // ------------------------------------------------------
 double SpongeMetaEngine::run(const std::string& src)
 {
-    if (!parser)
-        throw std::runtime_error("Parser not initialized");
+    // 평가가 끝날 때까지 현재 스냅샷을 pin (참조 카운트 없이 RCU 읽기 구간)
+    Rcu::ReadGuard guard;
+    return runIn(pinned(), src);
+}
+
+double SpongeMetaEngine::run(LangId id, const std::string& src)
+{
+    Rcu::ReadGuard guard;
+    return runIn(pinnedLanguage(id), src);
+}
+
+double SpongeMetaEngine::run(std::string_view name, const std::string& src)
+{
+    Rcu::ReadGuard guard;
+    const LangRegistry& R = *registry.peek();
+    auto it = R.ids.find(name);
+    if (it == R.ids.end())
+        throw std::runtime_error("Unknown language: " + std::string(name));
+    return runIn(*R.byId[it->second], src);
+}
 
-    // parse → IR
-    auto ir = parser->parse(src);
+double SpongeMetaEngine::runIn(const LangSnapshot& L, const std::string& src)
+{
+    // parse → IR (캐시 hit 이면 파싱 생략)
+    CompiledProgram& prog = acquire(src, L);
+
+    // CLOSURE 모드: 미리 묶인 함수 트리
+    if (mode == ExecMode::CLOSURE)
+        return ensureClosure(prog, L).run();
+
+    // JIT 모드: 네이티브 코드 (못 만들면 VM)
+    if (mode == ExecMode::JIT) {
+        if (const JitFunction* fn = ensureJit(prog, L))
+            return (*fn)();
+        return vm->run(ensureBytecode(prog, L));
+    }
+
+    // VM 모드: IR → Bytecode → VM
+    if (mode == ExecMode::VM)
+        return vm->run(ensureBytecode(prog, L));
 
-    // evaluate IR
-    return evaluateIR(ir);
+    // evaluate IR (아주 큰 트리는 서브트리를 나눠 병렬로)
+    // 서브트리를 잘라 나누므로 트리일 때만 (DAG 는 공유 노드를 여러 작업이 다시 계산)
+    if (parallelThreshold && prog.ir.size() >= parallelThreshold && prog.ir.vars.empty() &&
+        !prog.ir.shared)
+        return evaluateParallel(L.ops, prog.ir);
+    return evaluateRoot(L, prog.ir);
 }
 
 
 
 // ------------------------------------------------------
-// toGo() – 간단한 IR → Go 코드 변환기
+// compile() / execute() – 한 번 컴파일, 여러 번 실행
 // ------------------------------------------------------
-std::string SpongeMetaEngine::toGo(const std::string& src)
+Bytecode SpongeMetaEngine::compile(const std::string& src)
+{
+    Rcu::ReadGuard guard;
+    const LangSnapshot& L = pinned();
+    return ensureBytecode(acquire(src, L), L);
+}
+
+double SpongeMetaEngine::execute(const Bytecode& bc)
+{
+    return vm->run(bc);
+}
+
+std::shared_ptr<JitFunction> SpongeMetaEngine::jitCompile(const std::string& src, bool withNasm)
 {
-    auto ir = parser->parse(src);
+    // 돌려준 함수가 스냅샷보다 오래 살 수 있으므로 shared_ptr 로 pin
+    std::shared_ptr<const LangSnapshot> snap = lang.load();
+    CompiledProgram& prog = acquire(src, *snap);
+
+    if (withNasm) {
+        auto fn = std::shared_ptr<JitFunction>(jit.compile(prog.ir, snap->ops, true));
+        fn->retain(snap);
+        return fn;
+    }
+
+    if (!prog.jit) {
+        prog.jit = jit.compile(prog.ir, snap->ops);
+        prog.jitTried = true;
+    }
+    prog.jit->retain(snap);
+    return prog.jit;
+}
+
+std::string SpongeMetaEngine::toNasm(const std::string& src)
+{
+    Rcu::ReadGuard guard;
+    const LangSnapshot& L = pinned();
+    return jit.toNasm(acquire(src, L).ir, L.ops);
+}
+
 
-    std::function<std::string(const std::shared_ptr<IRNode>&)> emit;
-    emit = [&](const std::shared_ptr<IRNode>& n)->std::string {
 
-        if (n->op == "literal") {
-            return std::to_string(n->literal[0]);
+// ------------------------------------------------------
+// evaluateColumns() – 한 식 × 여러 행 (컬럼 입력)
+// ------------------------------------------------------
+std::vector<double> SpongeMetaEngine::evaluateColumns(
+    const std::string& src,
+    const std::unordered_map<std::string, std::span<const double>>& columns)
+{
+    Rcu::ReadGuard guard;
+    const LangSnapshot& L = pinned();
+    const IRArena& ir = acquire(src, L).ir;
+
+    // 변수 슬롯 순서대로 입력 컬럼 연결
+    size_t rows = columns.empty() ? 0 : columns.begin()->second.size();
+    for (auto& kv : columns) {
+        if (kv.second.size() != rows)
+            throw std::runtime_error("evaluateColumns: column length mismatch: " + kv.first);
+    }
+
+    std::vector<const double*> inputs;
+    for (auto& name : ir.vars) {
+        auto it = columns.find(name);
+        if (it == columns.end())
+            throw std::runtime_error("Unbound variable: " + name);
+        inputs.push_back(it->second.data());
+    }
+
+    std::vector<double> out(rows);
+    ColumnEvaluator(ir, L.ops).run(inputs, rows, out.data());
+    return out;
+}
+
+
+
+// ------------------------------------------------------
+// runStream() / runFile() – 줄 단위 스트리밍 평가
+// ------------------------------------------------------
+size_t SpongeMetaEngine::runStream(std::string_view buffer,
+    const std::function<void(size_t, double)>& sink,
+    const std::function<void(size_t, const std::string&)>& onError)
+{
+    // 긴 스트림이 reclaim 을 막지 않도록 읽기 구간 대신 참조로 pin
+    std::shared_ptr<const LangSnapshot> snap = lang.load();
+    const LangSnapshot& L = *snap;
+    parser->grammar = &L.grammar;
+
+    // 로그의 각 줄은 대부분 서로 달라서 캐시 대신 scratch 아레나 재사용
+    return parser->parseLines(buffer, scratch.ir,
+        [&](size_t lineNo, const IRArena&) {
+            sink(lineNo, runParsed(scratch.ir, L));
+        }, onError);
+}
+
+double SpongeMetaEngine::runParsed(IRArena& ir, const LangSnapshot& L)
+{
+    SPONGE_STATS_IF(Stats::recordIR(ir, L.ops));
+    // 줄마다 패스별 시계를 두 번씩 읽으면 평가보다 비싸다 → --stats 일 때만 기록
+    optimizeIR(ir, L, Stats::enabled() ? &passStatsVec : nullptr);
+
+    if (mode != ExecMode::TREE)
+        return vm->run(L.compiler.compile(ir, L.ops));
+    return evaluateRoot(L, ir);
+}
+
+size_t SpongeMetaEngine::runFile(const std::string& path,
+    const std::function<void(size_t, double)>& sink)
+{
+    MappedFile file(path);
+    return runStream(file.view(), sink);
+}
+
+CachedRunResult SpongeMetaEngine::runFileCached(const std::string& path,
+    const std::string& cachePath,
+    const std::function<void(size_t, double)>& sink)
+{
+    std::shared_ptr<const LangSnapshot> snap = lang.load();
+    const LangSnapshot& L = *snap;
+
+    MappedFile file(path);
+    std::string_view src = file.view();
+    uint64_t hash = hashBytes(src);
+    CachedRunResult res;
+
+    // 1) 맞는 캐시가 있으면 파싱 없이 IR 을 복사해서 평가
+    {
+        std::unique_ptr<ProgramImage> image;
+        std::error_code ec;
+        if (std::filesystem::exists(cachePath, ec)) {
+            try {
+                image = std::make_unique<ProgramImage>(cachePath);
+            } catch (const std::runtime_error&) {
+                // 손상/다른 버전 → 아래에서 다시 만든다
+            }
         }
 
-        if (n->children.size() == 2) {
-            std::string L = emit(n->children[0]);
-            std::string R = emit(n->children[1]);
-            return "(" + L + " " + n->op + " " + R + ")";
+        std::vector<OpId> opMap;
+        if (image && image->matches(hash, src.size(), L.fingerprint) &&
+            image->mapOperators(L.ops, opMap)) {
+            IRArena& ir = scratch.ir;
+            for (size_t i = 0; i < image->programCount(); ++i) {
+                image->load(i, opMap, ir);
+                sink(image->line(i), runParsed(ir, L));
+            }
+            res.expressions = image->programCount();
+            res.fromCache = true;
+            return res;
         }
+    }
 
-        return "0";
-    };
+    // 2) 파싱하면서 (최적화 전) IR 을 모아 캐시를 다시 쓴다
+    ProgramFileWriter writer;
+    parser->grammar = &L.grammar;
+    res.expressions = parser->parseLines(src, scratch.ir,
+        [&](size_t lineNo, const IRArena&) {
+            writer.add(static_cast<uint32_t>(lineNo), scratch.ir, L.ops);
+            sink(lineNo, runParsed(scratch.ir, L));
+        });
+
+    try {
+        writer.write(cachePath, hash, src.size(), L.fingerprint);
+        res.cacheWritten = true;
+    } catch (const std::exception&) {
+        // 결과는 이미 냈으므로 캐시는 다음 실행에서 다시 시도
+    }
+    return res;
+}
+
+
+
+// ------------------------------------------------------
+// runBatch() – 멀티코어 일괄 평가
+// ------------------------------------------------------
+void SpongeMetaEngine::setThreads(size_t n)
+{
+    threadCount = n;
+    pool.reset();
+    batchWorkers.clear();
+}
+
+std::vector<double> SpongeMetaEngine::runBatch(std::span<const std::string> sources)
+{
+    std::vector<double> results(sources.size());
+    if (sources.empty()) return results;
+
+    ensurePool();
+
+    // 배치 전체가 같은 스냅샷을 본다
+    std::shared_ptr<const LangSnapshot> snap = lang.load();
+    const LangSnapshot& L = *snap;
+    for (auto& w : batchWorkers) w->parser.grammar = &L.grammar;
+
+    // 워커당 여러 조각을 만들어 훔쳐갈 여지를 남긴다
+    size_t grain = std::max<size_t>(1, sources.size() / (pool->size() * 8));
+
+    pool->parallelFor(sources.size(), grain,
+        [&](size_t worker, size_t begin, size_t end) {
+            BatchWorker& w = *batchWorkers[worker];
+
+            for (size_t i = begin; i < end; ++i) {
+                w.parser.parse(sources[i], w.arena);
+                SPONGE_STATS_IF(Stats::recordIR(w.arena, L.ops));
+
+                // 패스 통계는 여러 워커가 동시에 쓸 수 없으므로 생략
+                if (optimize && !passes.empty())
+                    passes.run(w.arena, L.ops);
+
+                if (mode != ExecMode::TREE)
+                    results[i] = w.vm.run(L.compiler.compile(w.arena, L.ops));
+                else
+                    results[i] = evaluateRoot(L, w.arena);
+            }
+        });
+
+    return results;
+}
+
+
+
+// ------------------------------------------------------
+// emit() / toGo() – IR → 대상 언어 코드 (meta_emit.hpp 백엔드)
+// ------------------------------------------------------
+void SpongeMetaEngine::emitTo(const std::string& src, const Emitter& emitter, EmitBuffer& out)
+{
+    Rcu::ReadGuard guard;
+    const LangSnapshot& L = pinned();
+    emitter.emit(acquire(src, L).ir, L.ops, out);
+}
+
+void SpongeMetaEngine::emit(const std::string& src, std::string_view backend, std::ostream& out)
+{
+    EmitBuffer buf(out);
+    emitTo(src, EmitterRegistry::get(backend), buf);
+}
+
+void SpongeMetaEngine::emit(const std::string& src, std::string_view backend, std::string& out)
+{
+    EmitBuffer buf(out);
+    emitTo(src, EmitterRegistry::get(backend), buf);
+}
+
+std::string SpongeMetaEngine::toGo(const std::string& src)
+{
+    std::string out;
+    emit(src, "go", out);
+    return out;
+}
+
+std::vector<TranspileResult> SpongeMetaEngine::transpileDirectory(
+    const std::string& inDir, const std::string& outDir,
+    std::string_view backend, std::string_view ext)
+{
+    namespace fs = std::filesystem;
+    const Emitter& emitter = EmitterRegistry::get(backend);
+
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(inDir))
+        if (entry.is_regular_file() && entry.path().extension() == ext)
+            files.push_back(entry.path());
+    std::sort(files.begin(), files.end());
+
+    std::vector<TranspileResult> results(files.size());
+    if (files.empty()) return results;
+    fs::create_directories(outDir);
+
+    ensurePool();
+
+    // 배치 전체가 같은 스냅샷을 본다
+    std::shared_ptr<const LangSnapshot> snap = lang.load();
+    const LangSnapshot& L = *snap;
+    for (auto& w : batchWorkers) w->parser.grammar = &L.grammar;
+
+    // 파일 크기가 제각각이라 한 파일씩 훔쳐가게 한다
+    pool->parallelFor(files.size(), 1,
+        [&](size_t worker, size_t begin, size_t end) {
+            BatchWorker& w = *batchWorkers[worker];
+
+            for (size_t i = begin; i < end; ++i) {
+                TranspileResult& r = results[i];
+                fs::path out = fs::path(outDir) / files[i].stem();
+                out += emitter.extension();
+                r.input = files[i].string();
+                r.output = out.string();
+
+                try {
+                    MappedFile file(r.input);
+                    std::string_view src = file.view();
+                    while (!src.empty() && std::isspace(static_cast<unsigned char>(src.back())))
+                        src.remove_suffix(1);
+
+                    w.parser.parse(src, w.arena);
+                    SPONGE_STATS_IF(Stats::recordIR(w.arena, L.ops));
+                    if (optimize && !passes.empty())
+                        passes.run(w.arena, L.ops);
+
+                    std::ofstream os(out, std::ios::binary);
+                    if (!os) throw std::runtime_error("cannot open for writing: " + r.output);
+                    {
+                        EmitBuffer buf(os);
+                        emitter.emit(w.arena, L.ops, buf);
+                    }
+                    if (!os.flush()) throw std::runtime_error("write failed: " + r.output);
+                } catch (const std::exception& e) {
+                    r.error = e.what();
+                    std::error_code ec;
+                    fs::remove(out, ec);
+                }
+            }
+        });
+
+    return results;
+}
+
+
+
+// ------------------------------------------------------
+// 이름 있는 바인딩 – 의존 그래프 + 지연 재계산
+// ------------------------------------------------------
+void SpongeMetaEngine::compileFormula(BindingId id, const std::string& src,
+                                      const LangSnapshot& L)
+{
+    if (!parser)
+        throw std::runtime_error("Parser not initialized");
+    parser->grammar = &L.grammar;
+
+    BoundFormula f;
+    f.src = src;
+    parser->parse(src, f.ir);
+    SPONGE_STATS_IF(Stats::recordIR(f.ir, L.ops));
+    optimizeIR(f.ir, L, nullptr);
+
+    f.slots.reserve(f.ir.vars.size());
+    for (const std::string& v : f.ir.vars)
+        f.slots.push_back(bindings.intern(v));
+
+    // 순환이면 여기서 던지고 이전 정의가 그대로 남는다 (새로 intern 한 이름은 define() 이 되돌림)
+    bindings.setFormula(id, f.slots);
+
+    f.code = ClosureProgram(f.ir, L.ops);
+    if (formulas.size() <= id) formulas.resize(id + 1);
+    formulas[id] = std::move(f);
+}
+
+void SpongeMetaEngine::syncBindings(const LangSnapshot& L)
+{
+    if (L.generation == bindingGeneration) return;
+
+    // 연산자 id/커널이 바뀌었을 수 있으므로 수식을 모두 다시 컴파일
+    bindingGeneration = L.generation;
+    for (BindingId id = 0; id < formulas.size(); ++id) {
+        if (bindings.kind(id) != BindingGraph::Kind::FORMULA) continue;
+        std::string src = formulas[id].src;
+        compileFormula(id, src, L);
+    }
+    bindings.invalidateAll();
+}
+
+void SpongeMetaEngine::define(const std::string& name, const std::string& src)
+{
+    Rcu::ReadGuard guard;
+    const LangSnapshot& L = pinned();
+    syncBindings(L);
+
+    // 파싱 오류나 순환으로 거부되면 이 정의가 처음 꺼낸 이름을 남기지 않는다
+    size_t known = bindings.size();
+    try {
+        compileFormula(bindings.intern(name), src, L);
+    } catch (...) {
+        bindings.truncate(known);
+        throw;
+    }
+}
+
+void SpongeMetaEngine::setInput(const std::string& name, double value)
+{
+    BindingId id = bindings.intern(name);
+    bindings.setInput(id, value);
+    if (id < formulas.size()) formulas[id] = BoundFormula();
+}
+
+void SpongeMetaEngine::undefine(const std::string& name)
+{
+    BindingId id;
+    if (!bindings.find(name, id)) return;
+    bindings.undefine(id);
+    if (id < formulas.size()) formulas[id] = BoundFormula();
+}
+
+double SpongeMetaEngine::value(const std::string& name)
+{
+    BindingId id;
+    if (!bindings.find(name, id))
+        throw std::runtime_error("Unbound variable: " + name);
 
-    std::stringstream out;
-    out << "package main\n\n"
-        << "import \"fmt\"\n\n"
-        << "func main() {\n"
-        << "    fmt.Println(" << emit(ir) << ")\n"
-        << "}\n";
+    Rcu::ReadGuard guard;
+    const LangSnapshot& L = pinned();
+    syncBindings(L);
 
-    return out.str();
+    return bindings.get(id, [&](BindingId n) {
+        const BoundFormula& f = formulas[n];
+        bindingEnv.resize(f.slots.size());
+        for (size_t i = 0; i < f.slots.size(); ++i)
+            bindingEnv[i] = bindings.cached(f.slots[i]);
+        return f.code.run(bindingEnv.data());
+    });
 }
 
 } // namespace sponge
@@ -4,16 +4,109 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <span>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string_view>
 
 // ★ 반드시 필요한 include (중요)
 #include "meta_parser.hpp"
 #include "meta_ir.hpp"
+#include "meta_ops.hpp"
+#include "meta_vm.hpp"
+#include "meta_compiler.hpp"
+#include "meta_program_cache.hpp"
+#include "meta_thread_pool.hpp"
+#include "meta_columnar.hpp"
+#include "meta_passes.hpp"
+#include "meta_jit.hpp"
+#include "meta_pack_binary.hpp"
+#include "meta_rcu.hpp"
+#include "meta_bindings.hpp"
+#include "meta_stats.hpp"
+#include "meta_emit.hpp"
+#include "meta_builtin.hpp"
 
 namespace sponge {
 
+/**
+ * run() 실행 방식:
+ *   TREE — IR 트리를 재귀적으로 평가 (기본)
+ *   VM      — IR → Bytecode 컴파일 후 VM 에서 실행
+ *   JIT     — IR → x86-64 기계어 (지원하지 않는 플랫폼/식이면 VM 으로 대체)
+ *   CLOSURE — IR → 미리 묶인 특수화 함수 트리 (ClosureProgram)
+ *
+ * runStream()/runBatch() 는 식마다 새로 컴파일하므로 TREE 가 아니면 VM 을 쓴다.
+ */
+enum class ExecMode {
+    TREE,
+    VM,
+    JIT,
+    CLOSURE
+};
+
+/**
+ * 흡수된 언어 규칙 한 벌 (불변).
+ *
+ * absorb*() 는 새 스냅샷을 통째로 만들어 원자적으로 교체한다.
+ * 평가 중인 호출은 시작할 때 pin 한 스냅샷을 끝까지 쓰므로
+ * 다른 스레드에서 팩을 다시 흡수해도 트래픽을 멈출 필요가 없다.
+ */
+struct LangSnapshot {
+    uint64_t generation = 0;            // 캐시 키 (스냅샷마다 고유)
+    uint64_t fingerprint = 0;           // 규칙 내용 해시 (.spbc 키, 같은 팩이면 프로세스가 달라도 같음)
+    std::string language;
+
+    std::unordered_map<std::string,std::string> tokens;
+    std::unordered_map<std::string,int> precedence;
+    std::unordered_map<std::string,std::function<double(double,double)>> evalRules;
+    std::unordered_map<std::string,std::string> irRules;
+    std::unordered_map<std::string,std::string> bytecodeRules;
+    std::unordered_map<std::string,std::string> assocRules;
+
+    // 연산자 intern + 커널 테이블, IR → opcode 매핑
+    OperatorTable ops;
+    BytecodeCompiler compiler;
+
+    // 팩 토큰/우선순위로 만든 렉서 DFA + Pratt 파서 테이블
+    Grammar grammar;
+
+    // absorbPack() 으로 흡수한 mmap 팩 (이때 텍스트 규칙 맵은 비어 있음)
+    std::shared_ptr<const PackImage> packImage;
+
+    // absorbBuiltin() 으로 흡수한 내장 언어 (생성된 렉서/평가기, 텍스트 규칙 맵은 비어 있음)
+    const BuiltinLanguage* builtin = nullptr;
+};
+
+// runFileCached() 결과
+struct CachedRunResult {
+    size_t expressions = 0;
+    bool fromCache = false;     // 캐시를 읽어 파싱을 건너뛰었다
+    bool cacheWritten = false;  // 캐시가 없거나 낡아서 새로 썼다
+};
+
+// 등록된 언어 번호 (같은 이름을 다시 흡수해도 그대로)
+using LangId = uint32_t;
+
+// transpileDirectory() 의 파일 하나 결과 (error 가 비어 있으면 성공)
+struct TranspileResult {
+    std::string input;
+    std::string output;
+    std::string error;
+
+    bool ok() const { return error.empty(); }
+};
+
+/**
+ * 스레드 안전성:
+ *   absorb*() 는 아무 스레드에서나 run()/runBatch() 등과 동시에 불러도 된다.
+ *   그 밖의 호출(run, 설정 변경 …)은 엔진 하나당 한 스레드에서.
+ */
 class SpongeMetaEngine {
 public:
     SpongeMetaEngine();
+    ~SpongeMetaEngine();
 
     void absorb(
         const std::string& langName,
@@ -28,28 +121,270 @@ public:
         const std::unordered_map<std::string, int>& precedenceRules,
         const std::unordered_map<std::string, std::function<double(double,double)>>& evalRules,
         const std::unordered_map<std::string, std::string>& irRules,
-        const std::unordered_map<std::string, std::string>& bytecodeRules
+        const std::unordered_map<std::string, std::string>& bytecodeRules,
+        const std::unordered_map<std::string, std::string>& assocRules = {}
     );
 
+    /**
+     * 바이너리 팩(.spack)을 그대로 흡수한다.
+     * 연산자 커널/opcode 가 이미 풀려 있어 문자열 규칙을 다시 해석하지 않고,
+     * 팩 이미지는 엔진이 다른 팩을 흡수할 때까지 공유해서 붙잡아 둔다.
+     */
+    void absorbPack(std::shared_ptr<const PackImage> pack);
+
+    /**
+     * 빌드할 때 packs/ 의 .meta 파일에서 생성해 넣은 내장 언어를 흡수한다 (meta_builtin.hpp).
+     * 파일을 읽거나 렉서 DFA 를 만들지 않고, TREE 평가는 연산자가 인라인된 생성 평가기로 돈다.
+     * 같은 .meta 를 absorb 한 것과 결과와 팩 지문이 같다. 없는 이름이면 runtime_error.
+     */
+    void absorbBuiltin(std::string_view name);
+
+    // 현재 언어 스냅샷 pin (락 없음). 들고 있는 동안 해제되지 않는다.
+    std::shared_ptr<const LangSnapshot> snapshot() const { return lang.load(); }
+
     double run(const std::string& src);
 
+    /**
+     * 여러 언어 동시 상주.
+     *
+     * absorb*() 로 흡수한 팩은 기본 언어(run(src))가 되는 동시에 자기 language 이름으로
+     * 등록되어, 다른 팩을 흡수한 뒤에도 run(lang, src) 로 계속 쓸 수 있다.
+     * 같은 이름을 다시 흡수하면 그 언어만 교체되고 LangId 는 유지된다.
+     * 문법/연산자 테이블/컴파일러는 팩마다 흡수할 때 한 번 만들고,
+     * 프로그램 캐시·파싱 아레나·연산자 이름 문자열은 모든 언어가 함께 쓴다.
+     */
+    LangId languageId(std::string_view name) const;     // 없으면 runtime_error
+    bool hasLanguage(std::string_view name) const;
+    std::vector<std::string> languages() const;         // LangId 순서
+    std::shared_ptr<const LangSnapshot> snapshot(LangId id) const;
+
+    double run(LangId lang, const std::string& src);     // 배열 인덱스
+    double run(std::string_view lang, const std::string& src);  // 해시 한 번
+
+    void setMode(ExecMode m) { mode = m; }
+    ExecMode getMode() const { return mode; }
+
+    // 한 번 컴파일해두고 execute() 로 반복 실행
+    Bytecode compile(const std::string& src);
+    double execute(const Bytecode& bc);
+
+    // 네이티브 함수로 JIT 컴파일 (withNasm 이면 NASM 리스팅도 보관)
+    std::shared_ptr<JitFunction> jitCompile(const std::string& src, bool withNasm = false);
+    // JIT 이 만들 코드를 NASM 문법으로 출력 (모든 플랫폼)
+    std::string toNasm(const std::string& src);
+
+    // 소스 → 컴파일된 프로그램 LRU 캐시 (absorb 시 자동 무효화)
+    void setCacheCapacity(size_t n) { cache.setCapacity(n); }
+    ProgramCacheStats cacheStats() const { return cache.stats(); }
+    void clearCache() { cache.invalidate(); }
+
+    /**
+     * IR 최적화 파이프라인 (기본: PassManager::standard()).
+     * 파싱 직후 한 번 돌고, 인터프리터/VM/트랜스파일러 모두 최적화된 IR 을 쓴다.
+     * 설정을 바꾸면 프로그램 캐시는 비워진다.
+     */
+    void setOptimize(bool on);
+    bool getOptimize() const { return optimize; }
+    void setPasses(PassManager pm);
+    const std::vector<PassStats>& passStats() const { return passStatsVec; }
+
+    /**
+     * hash-consing 파싱 (기본 꺼짐): 구조가 같은 서브트리를 노드 하나로 합쳐 IR 을 DAG 로 만든다.
+     * 같은 부분식이 반복되는 (생성된) 식에서 노드 수와 TREE 평가 시간이 중복만큼 줄어든다.
+     * 모든 실행 방식과 evaluateColumns() 가 공유 노드를 실행마다 한 번만 계산하고
+     * (VM 은 SAVE/TEMP, JIT 은 프레임 칸, CLOSURE 는 변수 뒤 슬롯), emit()/toGo() 는 지역 변수로 뺀다.
+     * 바꾸면 프로그램 캐시는 비워진다.
+     */
+    void setHashCons(bool on);
+    bool getHashCons() const { return parser->hashCons; }
+
+    /**
+     * 여러 소스를 멀티코어로 평가 (결과는 sources 와 같은 순서).
+     * 워커마다 자기 파서/아레나/VM 을 쓰고, 시작 시점의 언어 스냅샷을 공유.
+     * 배치 도중 absorb() 가 불리면 배치는 옛 스냅샷으로 끝까지 간다.
+     */
+    std::vector<double> runBatch(std::span<const std::string> sources);
+
+    /**
+     * 변수가 들어간 식 하나를 컬럼 입력 전체에 대해 평가한다.
+     * columns: 변수 이름 → 값 배열 (모두 같은 길이). 결과는 한 컬럼.
+     * 식은 한 번만 컴파일되고 블록 단위 SIMD 커널로 실행된다.
+     */
+    std::vector<double> evaluateColumns(
+        const std::string& src,
+        const std::unordered_map<std::string, std::span<const double>>& columns);
+
+    /**
+     * 줄마다 식 하나씩 들어 있는 버퍼를 스트리밍 평가.
+     * 줄을 복사하지 않고 파싱하며, 결과는 sink(lineNo, value) 로 전달.
+     * onError 가 있으면 잘못된 줄은 onError(lineNo, message) 로 넘기고 계속한다
+     * (없으면 첫 오류에서 runtime_error). 처리한 식 개수 반환.
+     * passStats() 는 Stats 가 켜져 있을 때만 쌓인다.
+     */
+    size_t runStream(std::string_view buffer,
+                     const std::function<void(size_t lineNo, double value)>& sink,
+                     const std::function<void(size_t lineNo, const std::string& error)>& onError = nullptr);
+
+    // 파일을 mmap 해서 runStream()
+    size_t runFile(const std::string& path,
+                   const std::function<void(size_t lineNo, double value)>& sink);
+
+    /**
+     * runFile() + 파싱 결과 디스크 캐시 (.spbc, meta_program_file.hpp).
+     * cachePath 가 같은 소스 내용과 같은 팩 지문으로 만든 캐시면 mmap 해서 파싱 없이 평가하고,
+     * 없거나 낡았거나 손상되었으면 파싱해서 평가한 뒤 캐시를 다시 쓴다.
+     * 캐시에는 최적화 전 IR 이 들어 있어 setOptimize()/setPasses() 를 바꿔도 그대로 쓴다.
+     * 캐시를 쓸 수 없으면 (읽기 전용 디렉터리 등) cacheWritten 만 false 가 된다.
+     */
+    CachedRunResult runFileCached(const std::string& path, const std::string& cachePath,
+                                  const std::function<void(size_t lineNo, double value)>& sink);
+
+    // 배치 워커 수 (0 = hardware_concurrency). 다음 runBatch 부터 적용.
+    void setThreads(size_t n);
+
+    /**
+     * TREE 모드 run() 에서 IR 노드가 이 수 이상이면 독립 서브트리를 풀에서 병렬 평가한다
+     * (0 = 끔). 노드마다 하는 연산과 순서는 순차 평가와 같아서 결과가 비트 단위로 같다.
+     */
+    void setParallelThreshold(size_t nodes) { parallelThreshold = nodes; }
+    size_t getParallelThreshold() const { return parallelThreshold; }
+
+    /**
+     * 소스 → 대상 언어 코드. backend 는 EmitterRegistry 이름 ("go", "c", "rust", "nasm" …).
+     * IR 을 한 번 훑으며 out 에 바로 쓴다 (ostream 은 64KB 단위로 write).
+     */
+    void emit(const std::string& src, std::string_view backend, std::ostream& out);
+    void emit(const std::string& src, std::string_view backend, std::string& out);
+
+    // emit(src, "go")
     std::string toGo(const std::string& src);
 
+    /**
+     * inDir 안의 *ext 파일 (파일 하나 = 식 하나) 을 backend 로 옮겨
+     * outDir/<이름><백엔드 확장자> 로 쓴다. 파일 단위로 배치 워커에서 병렬 처리하고,
+     * 실패한 파일은 결과의 error 에 남긴 채 나머지를 계속한다 (결과는 파일 이름 순).
+     */
+    std::vector<TranspileResult> transpileDirectory(const std::string& inDir,
+                                                    const std::string& outDir,
+                                                    std::string_view backend,
+                                                    std::string_view ext = ".sp");
+
+    /**
+     * 이름 있는 바인딩 (증분 재계산).
+     *
+     * define() 한 수식은 다른 바인딩 이름을 변수로 참조할 수 있다.
+     * 입력이나 수식을 바꾸면 그에 의존하는 바인딩만 dirty 가 되고,
+     * value() 가 불릴 때 필요한 것만 다시 계산해 메모이즈한다.
+     * 순환 정의는 runtime_error (이전 정의와 바인딩 이름은 그대로). 팩을 다시 흡수하면 다음 value() 에서 모두 다시 컴파일한다.
+     */
+    void define(const std::string& name, const std::string& src);
+    void setInput(const std::string& name, double value);
+    void undefine(const std::string& name);
+    double value(const std::string& name);
+    BindingStats bindingStats() const { return bindings.stats(); }
+
+    /**
+     * 계측 (meta_stats.hpp). 구간 시간/노드 수/연산자 히스토그램/VM 최대 스택.
+     * 카운터는 프로세스 전역이라 엔진 여러 개와 로더가 같은 표에 쌓인다.
+     * 기본은 꺼져 있고, SPONGE_STATS=OFF 로 빌드하면 계측 코드 자체가 없다.
+     */
+    static void setStatsEnabled(bool on) { Stats::enable(on); }
+    static void resetStats() { Stats::reset(); }
+    EngineStats stats() const { return Stats::snapshot(); }
+
 private:
-    std::string currentLanguage;
+    // 현재 언어 규칙 (RCU 로 교체)
+    RcuCell<LangSnapshot> lang;
+    std::atomic<uint64_t> generations{ 0 };
+
+    // 이름으로 등록된 언어들 (불변, 흡수할 때마다 통째로 RCU 교체)
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    struct LangRegistry {
+        std::vector<std::shared_ptr<const LangSnapshot>> byId;
+        std::unordered_map<std::string, LangId, NameHash, std::equal_to<>> ids;
+    };
+    RcuCell<LangRegistry> registry;
+    std::mutex registryMutex;               // 레지스트리 복사-수정-교체를 직렬화
+    std::atomic<uint64_t> replacements{ 0 };  // 이미 있던 언어가 교체된 횟수
 
-    std::unordered_map<std::string,std::string> tokenMap;
-    std::unordered_map<std::string,int> precedenceMap;
-    std::unordered_map<std::string,std::function<double(double,double)>> evalMap;
+    // registerName: 이름으로도 등록 (생성자의 빈 언어는 등록하지 않음)
+    void publish(std::shared_ptr<LangSnapshot> snap, bool registerName = true);
+    const LangSnapshot& pinnedLanguage(LangId id) const;
+    double runIn(const LangSnapshot& L, const std::string& src);
 
-    std::unordered_map<std::string,std::string> irMap;
-    std::unordered_map<std::string,std::string> bcMap;
+    // ReadGuard 구간 안에서만 유효
+    const LangSnapshot& pinned() const { return *lang.peek(); }
 
     // 이제 완전한 타입이므로 unique_ptr OK
     std::unique_ptr<MetaParser> parser;
-    std::unique_ptr<IRBuilder> irbuilder;
+    std::unique_ptr<VM> vm;
+    JitCompiler jit;
+
+    ExecMode mode = ExecMode::TREE;
+
+    // 캐시 (키에 스냅샷 세대가 들어가 언어 여러 개의 프로그램이 함께 산다).
+    // 등록된 언어가 교체되면 다음 acquire 에서 비운다.
+    ProgramCache cache;
+    uint64_t cacheReplacements = 0;
+    std::shared_ptr<CompiledProgram> current;
+
+    // 캐시 용량 0 일 때 재사용하는 파싱 아레나 (매 호출마다 clear)
+    CompiledProgram scratch;
+
+    // 최적화 파이프라인
+    PassManager passes = PassManager::standard();
+    bool optimize = true;
+    std::vector<PassStats> passStatsVec;
+
+    void optimizeIR(IRArena& ir, const LangSnapshot& L, std::vector<PassStats>* stats);
+    // 스트림 한 줄: 갓 파싱한 ir 을 최적화하고 평가 (ir 은 바뀐다)
+    double runParsed(IRArena& ir, const LangSnapshot& L);
+
+    CompiledProgram& acquire(const std::string& src, const LangSnapshot& L);
+    const Bytecode& ensureBytecode(CompiledProgram& prog, const LangSnapshot& L);
+    const JitFunction* ensureJit(CompiledProgram& prog, const LangSnapshot& L);
+    const ClosureProgram& ensureClosure(CompiledProgram& prog, const LangSnapshot& L);
+
+    // 배치 워커별 scratch 상태
+    struct BatchWorker {
+        MetaParser parser;
+        IRArena arena;
+        VM vm;
+    };
+
+    size_t threadCount = 0;
+    std::unique_ptr<WorkStealingPool> pool;
+    std::vector<std::unique_ptr<BatchWorker>> batchWorkers;
+    size_t parallelThreshold = size_t(1) << 16;
+
+    void ensurePool();
+    void emitTo(const std::string& src, const Emitter& emitter, EmitBuffer& out);
+    double evaluateParallel(const OperatorTable& ops, const IRArena& ir);
+
+    // 바인딩 수식: 슬롯 i 의 변수 = 바인딩 slots[i]
+    struct BoundFormula {
+        std::string src;
+        IRArena ir;
+        ClosureProgram code;
+        std::vector<BindingId> slots;
+    };
+
+    BindingGraph bindings;
+    std::vector<BoundFormula> formulas;     // BindingId 로 인덱싱 (수식이 아니면 빈 칸)
+    std::vector<double> bindingEnv;
+    uint64_t bindingGeneration = 0;
+
+    void compileFormula(BindingId id, const std::string& src, const LangSnapshot& L);
+    void syncBindings(const LangSnapshot& L);
 
-    double evaluateIR(const std::shared_ptr<IRNode>& node);
+    // env: 변수 슬롯별 값 (없으면 VAR 노드에서 에러)
+    double evaluateIR(const OperatorTable& ops, const IRArena& ir, IRRef node,
+                      const double* env = nullptr) const;
+    // 최상위 호출 (EVAL_TREE 구간 계측, 내장 언어면 생성된 평가기)
+    double evaluateRoot(const LangSnapshot& L, const IRArena& ir) const;
 };
 
 } // namespace sponge
@@ -0,0 +1,670 @@
+#include "meta_grammar.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sponge {
+
+namespace {
+
+using ByteSet = std::bitset<256>;
+
+// ------------------------------------------------------
+// 정규식 → AST
+// ------------------------------------------------------
+struct RegexNode {
+    enum Kind { SET, CAT, ALT, REPEAT } kind = SET;
+    ByteSet set;                                   // SET
+    std::vector<std::unique_ptr<RegexNode>> kids;  // CAT / ALT / REPEAT(1)
+    int min = 0, max = -1;                         // REPEAT (-1 = 무한)
+};
+
+using NodePtr = std::unique_ptr<RegexNode>;
+
+NodePtr makeSet(const ByteSet& s) {
+    auto n = std::make_unique<RegexNode>();
+    n->kind = RegexNode::SET;
+    n->set = s;
+    return n;
+}
+
+ByteSet range(int lo, int hi) {
+    ByteSet s;
+    for (int c = lo; c <= hi; ++c) s.set(c);
+    return s;
+}
+
+ByteSet classDigit() { return range('0', '9'); }
+ByteSet classWord()  { return range('a', 'z') | range('A', 'Z') | range('0', '9') | range('_', '_'); }
+ByteSet classSpace() {
+    ByteSet s;
+    for (char c : { ' ', '\t', '\n', '\r', '\f', '\v' }) s.set(static_cast<unsigned char>(c));
+    return s;
+}
+
+class RegexParser {
+public:
+    explicit RegexParser(std::string_view re) : re(re) {}
+
+    NodePtr parse() {
+        NodePtr n = alt();
+        if (pos != re.size()) fail("unexpected ')'");
+        return n;
+    }
+
+private:
+    std::string_view re;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string& why) const {
+        throw std::runtime_error("regex error in \"" + std::string(re) + "\" at " +
+                                 std::to_string(pos) + ": " + why);
+    }
+
+    bool more() const { return pos < re.size(); }
+    char peek() const { return re[pos]; }
+
+    NodePtr alt() {
+        NodePtr first = cat();
+        if (!more() || peek() != '|') return first;
+
+        auto n = std::make_unique<RegexNode>();
+        n->kind = RegexNode::ALT;
+        n->kids.push_back(std::move(first));
+        while (more() && peek() == '|') {
+            pos++;
+            n->kids.push_back(cat());
+        }
+        return n;
+    }
+
+    NodePtr cat() {
+        auto n = std::make_unique<RegexNode>();
+        n->kind = RegexNode::CAT;
+        while (more() && peek() != '|' && peek() != ')')
+            n->kids.push_back(repeat());
+        return n;
+    }
+
+    NodePtr repeat() {
+        NodePtr n = atom();
+        while (more()) {
+            int lo, hi;
+            char c = peek();
+            if (c == '*')      { lo = 0; hi = -1; pos++; }
+            else if (c == '+') { lo = 1; hi = -1; pos++; }
+            else if (c == '?') { lo = 0; hi = 1;  pos++; }
+            else if (c == '{') { braces(lo, hi); }
+            else break;
+
+            auto r = std::make_unique<RegexNode>();
+            r->kind = RegexNode::REPEAT;
+            r->min = lo;
+            r->max = hi;
+            r->kids.push_back(std::move(n));
+            n = std::move(r);
+        }
+        return n;
+    }
+
+    int number() {
+        if (!more() || peek() < '0' || peek() > '9') fail("expected number");
+        int v = 0;
+        while (more() && peek() >= '0' && peek() <= '9') {
+            v = v * 10 + (peek() - '0');
+            if (v > 1000) fail("repeat count too large");
+            pos++;
+        }
+        return v;
+    }
+
+    void braces(int& lo, int& hi) {
+        pos++;  // {
+        lo = number();
+        hi = lo;
+        if (more() && peek() == ',') {
+            pos++;
+            hi = (more() && peek() == '}') ? -1 : number();
+        }
+        if (!more() || peek() != '}') fail("expected '}'");
+        pos++;
+        if (hi >= 0 && hi < lo) fail("bad repeat range");
+    }
+
+    ByteSet escape() {
+        if (!more()) fail("dangling '\\'");
+        char c = re[pos++];
+        switch (c) {
+            case 'd': return classDigit();
+            case 'D': return ~classDigit();
+            case 'w': return classWord();
+            case 'W': return ~classWord();
+            case 's': return classSpace();
+            case 'S': return ~classSpace();
+            case 'n': return range('\n', '\n');
+            case 't': return range('\t', '\t');
+            case 'r': return range('\r', '\r');
+            case 'f': return range('\f', '\f');
+            case 'v': return range('\v', '\v');
+            default:  break;
+        }
+        unsigned char u = static_cast<unsigned char>(c);
+        return range(u, u);
+    }
+
+    ByteSet bracket() {
+        pos++;  // [
+        bool negate = more() && peek() == '^';
+        if (negate) pos++;
+
+        ByteSet s;
+        bool first = true;
+        while (more() && (peek() != ']' || first)) {
+            first = false;
+
+            if (peek() == '\\') {
+                pos++;
+                ByteSet e = escape();
+                // 한 글자 이스케이프면 범위의 시작이 될 수 있다
+                if (e.count() != 1 || !(more() && peek() == '-' && pos + 1 < re.size() && re[pos + 1] != ']')) {
+                    s |= e;
+                    continue;
+                }
+                int lo = 0;
+                while (!e.test(lo)) lo++;
+                pos++;  // -
+                int hi = static_cast<unsigned char>(re[pos++]);
+                if (hi < lo) fail("bad class range");
+                s |= range(lo, hi);
+                continue;
+            }
+
+            int lo = static_cast<unsigned char>(re[pos++]);
+            if (more() && peek() == '-' && pos + 1 < re.size() && re[pos + 1] != ']') {
+                pos++;
+                int hi = static_cast<unsigned char>(re[pos++]);
+                if (hi < lo) fail("bad class range");
+                s |= range(lo, hi);
+            } else {
+                s.set(lo);
+            }
+        }
+        if (!more()) fail("unterminated '['");
+        pos++;  // ]
+        return negate ? ~s : s;
+    }
+
+    NodePtr atom() {
+        char c = peek();
+        switch (c) {
+            case '(': {
+                pos++;
+                if (re.substr(pos, 2) == "?:") pos += 2;
+                NodePtr n = alt();
+                if (!more() || peek() != ')') fail("expected ')'");
+                pos++;
+                return n;
+            }
+            case '[':
+                return makeSet(bracket());
+            case '.':
+                pos++;
+                return makeSet(~range('\n', '\n'));
+            case '\\':
+                pos++;
+                return makeSet(escape());
+            case '*': case '+': case '?': case '{':
+                fail("nothing to repeat");
+            default: {
+                pos++;
+                unsigned char u = static_cast<unsigned char>(c);
+                return makeSet(range(u, u));
+            }
+        }
+    }
+};
+
+
+
+// ------------------------------------------------------
+// AST → Thompson NFA
+// ------------------------------------------------------
+struct Nfa {
+    struct State {
+        int setId = -1;         // 글자 전이 (sets[setId]) → out
+        int out = -1;
+        std::vector<int> eps;
+        int accept = -1;        // 규칙 번호
+    };
+
+    std::vector<State> states;
+    std::vector<ByteSet> sets;
+
+    int add() {
+        states.emplace_back();
+        return static_cast<int>(states.size()) - 1;
+    }
+
+    // 조각: start → … → end (end 는 나가는 전이 없음)
+    std::pair<int, int> build(const RegexNode& n) {
+        switch (n.kind) {
+            case RegexNode::SET: {
+                int s = add(), e = add();
+                states[s].setId = static_cast<int>(sets.size());
+                states[s].out = e;
+                sets.push_back(n.set);
+                return { s, e };
+            }
+            case RegexNode::CAT: {
+                int s = add();
+                int cur = s;
+                for (auto& k : n.kids) {
+                    auto f = build(*k);
+                    states[cur].eps.push_back(f.first);
+                    cur = f.second;
+                }
+                return { s, cur };
+            }
+            case RegexNode::ALT: {
+                int s = add(), e = add();
+                for (auto& k : n.kids) {
+                    auto f = build(*k);
+                    states[s].eps.push_back(f.first);
+                    states[f.second].eps.push_back(e);
+                }
+                return { s, e };
+            }
+            case RegexNode::REPEAT: {
+                const RegexNode& k = *n.kids[0];
+                int s = add();
+                int cur = s;
+                for (int i = 0; i < n.min; ++i) {
+                    auto f = build(k);
+                    states[cur].eps.push_back(f.first);
+                    cur = f.second;
+                }
+                if (n.max < 0) {
+                    // 0 번 이상 반복
+                    auto f = build(k);
+                    int e = add();
+                    states[cur].eps.push_back(f.first);
+                    states[cur].eps.push_back(e);
+                    states[f.second].eps.push_back(f.first);
+                    states[f.second].eps.push_back(e);
+                    return { s, e };
+                }
+                int e = add();
+                for (int i = n.min; i < n.max; ++i) {
+                    states[cur].eps.push_back(e);
+                    auto f = build(k);
+                    states[cur].eps.push_back(f.first);
+                    cur = f.second;
+                }
+                states[cur].eps.push_back(e);
+                return { s, e };
+            }
+        }
+        return { -1, -1 };
+    }
+
+    void closure(std::vector<int>& set, std::vector<char>& seen, std::vector<int>& stack) const {
+        stack.assign(set.begin(), set.end());
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            for (int t : states[s].eps) {
+                if (!seen[t]) {
+                    seen[t] = 1;
+                    set.push_back(t);
+                    stack.push_back(t);
+                }
+            }
+        }
+        std::sort(set.begin(), set.end());
+    }
+};
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// LexerDFA
+// ------------------------------------------------------
+void LexerDFA::addPattern(std::string_view regex, const Rule& rule)
+{
+    sources.emplace_back(regex);
+    literal.push_back(0);
+    rules.push_back(rule);
+}
+
+void LexerDFA::addLiteral(std::string_view text, const Rule& rule)
+{
+    if (text.empty()) throw std::runtime_error("lexer: empty literal");
+    sources.emplace_back(text);
+    literal.push_back(1);
+    rules.push_back(rule);
+}
+
+void LexerDFA::compile()
+{
+    // 1) 규칙별 NFA 를 공통 시작 상태에 붙인다
+    //    리터럴은 공통 접두사를 나누는 트라이 하나로 붙인다 (연산자가 많은 팩)
+    Nfa nfa;
+    int start = nfa.add();
+    int trie = -1;
+    std::vector<std::vector<std::pair<uint8_t, int>>> children;   // 트라이 노드 → (바이트, 노드)
+    int byteSet[256];
+    std::fill(byteSet, byteSet + 256, -1);
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (literal[i]) {
+            if (trie < 0) {
+                trie = nfa.add();
+                nfa.states[start].eps.push_back(trie);
+            }
+            int node = trie;
+            for (unsigned char c : sources[i]) {
+                if (children.size() < nfa.states.size()) children.resize(nfa.states.size());
+                int child = -1;
+                for (auto& [b, n] : children[node])
+                    if (b == c) { child = n; break; }
+                if (child < 0) {
+                    if (byteSet[c] < 0) {
+                        byteSet[c] = static_cast<int>(nfa.sets.size());
+                        nfa.sets.emplace_back();
+                        nfa.sets.back().set(c);
+                    }
+                    int edge = nfa.add();
+                    child = nfa.add();
+                    nfa.states[edge].setId = byteSet[c];
+                    nfa.states[edge].out = child;
+                    nfa.states[node].eps.push_back(edge);
+                    children.resize(nfa.states.size());
+                    children[node].emplace_back(c, child);
+                }
+                node = child;
+            }
+            int& acc = nfa.states[node].accept;
+            if (acc < 0) acc = static_cast<int>(i);     // 먼저 넣은 규칙이 이긴다
+            continue;
+        }
+        NodePtr ast = RegexParser(sources[i]).parse();
+        auto f = nfa.build(*ast);
+        nfa.states[start].eps.push_back(f.first);
+        nfa.states[f.second].accept = static_cast<int>(i);
+    }
+
+    // 2) 바이트 동치류: 모든 글자 집합에서 같은 쪽에 있는 바이트끼리 묶는다
+    //    같은 집합은 한 번만 본다 (연산자 리터럴은 대부분 같은 글자를 공유)
+    {
+        std::unordered_set<ByteSet> distinct(nfa.sets.begin(), nfa.sets.end());
+        uint8_t cls[256] = {};
+        uint32_t count = 1;
+        for (const ByteSet& s : distinct) {
+            int16_t remap[512];
+            std::fill(remap, remap + 2 * count, int16_t(-1));
+            uint32_t nextCount = 0;
+            for (int c = 0; c < 256; ++c) {
+                int key = cls[c] * 2 + (s.test(c) ? 1 : 0);
+                if (remap[key] < 0) remap[key] = static_cast<int16_t>(nextCount++);
+                cls[c] = static_cast<uint8_t>(remap[key]);
+            }
+            count = nextCount;
+        }
+        std::copy(cls, cls + 256, byteClass);
+        classCount = count;
+    }
+
+    // 클래스 대표 바이트
+    std::vector<int> repr(classCount, -1);
+    for (int c = 0; c < 256; ++c)
+        if (repr[byteClass[c]] < 0) repr[byteClass[c]] = c;
+
+    // NFA 상태별 "이 클래스로 전이하는가" 표
+    std::vector<uint8_t> moves(nfa.states.size() * classCount, 0);
+    for (size_t s = 0; s < nfa.states.size(); ++s) {
+        int id = nfa.states[s].setId;
+        if (id < 0) continue;
+        for (uint32_t c = 0; c < classCount; ++c)
+            moves[s * classCount + c] = nfa.sets[id].test(repr[c]) ? 1 : 0;
+    }
+
+    // 3) 부분집합 구성
+    struct SetHash {
+        size_t operator()(const std::vector<int>& v) const noexcept {
+            uint64_t h = 1469598103934665603ull;
+            for (int x : v) h = (h ^ static_cast<uint32_t>(x)) * 1099511628211ull;
+            return static_cast<size_t>(h);
+        }
+    };
+    std::unordered_map<std::vector<int>, uint32_t, SetHash> ids;
+    std::vector<std::vector<int>> dstates;
+
+    next.assign(2 * classCount, kDead);
+    accept.assign(2, -1);
+    dstates.emplace_back();                 // 0 = dead
+
+    std::vector<char> seen(nfa.states.size(), 0);
+    std::vector<int> stack;
+    auto intern = [&](const std::vector<int>& set) -> uint32_t {
+        auto it = ids.find(set);
+        if (it != ids.end()) return it->second;
+
+        uint32_t id = static_cast<uint32_t>(dstates.size());
+        if (id > 1) {
+            next.resize((id + 1) * classCount, kDead);
+            accept.push_back(-1);
+        }
+        int best = -1;
+        for (int s : set) {
+            int a = nfa.states[s].accept;
+            if (a >= 0 && (best < 0 || a < best)) best = a;
+        }
+        accept[id] = best;
+        ids.emplace(set, id);
+        dstates.push_back(set);
+        return id;
+    };
+
+    {
+        std::vector<int> init{ start };
+        seen[start] = 1;
+        nfa.closure(init, seen, stack);
+        for (int s : init) seen[s] = 0;
+        intern(init);                       // 1 = start
+    }
+
+    std::vector<int> moved;
+    for (uint32_t d = kStart; d < dstates.size(); ++d) {
+        for (uint32_t c = 0; c < classCount; ++c) {
+            moved.clear();
+            for (int s : dstates[d]) {
+                const Nfa::State& st = nfa.states[s];
+                if (moves[size_t(s) * classCount + c] && !seen[st.out]) {
+                    seen[st.out] = 1;
+                    moved.push_back(st.out);
+                }
+            }
+            if (moved.empty()) continue;
+
+            nfa.closure(moved, seen, stack);
+            for (int s : moved) seen[s] = 0;
+
+            uint32_t target = intern(moved);
+            next[d * classCount + c] = target;
+        }
+    }
+    // 빈 문자열 일치는 토큰이 아니다
+    accept[kStart] = -1;
+
+    nextTab = next.data();
+    acceptTab = accept.data();
+    states = accept.size();
+}
+
+void LexerDFA::useTables(const Tables& t, std::vector<Rule> r)
+{
+    std::copy(t.byteClass, t.byteClass + 256, byteClass);
+    classCount = t.classCount;
+    nextTab = t.next.data();
+    acceptTab = t.accept.data();
+    states = t.accept.size();
+    rules = std::move(r);
+}
+
+std::string LexerDFA::signature() const
+{
+    std::string key;
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const Rule& r = rules[i];
+        key += std::to_string(sources[i].size());
+        key += literal[i] ? 'L' : 'R';
+        key += sources[i];
+        key += static_cast<char>('0' + static_cast<int>(r.kind));
+        key += std::to_string(r.op);
+        key += r.skip ? 's' : '.';
+    }
+    return key;
+}
+
+
+
+// ------------------------------------------------------
+// Grammar
+// ------------------------------------------------------
+static const char* kDefaultNumber = "([0-9]+(\\.[0-9]*)?|\\.[0-9]+)([eE][+\\-]?[0-9]+)?";
+static const char* kDefaultIdent  = "[A-Za-z_][A-Za-z0-9_]*";
+static const char* kDefaultSpace  = "[ \\t\\r\\n\\f\\v]+";
+
+const Grammar& Grammar::defaults()
+{
+    static const Grammar g = [] {
+        OperatorTable ops;
+        return GrammarBuilder().build(ops);
+    }();
+    return g;
+}
+
+void GrammarBuilder::addToken(std::string_view name, std::string_view regex)
+{
+    tokens.push_back({ std::string(name), std::string(regex) });
+}
+
+void GrammarBuilder::addOperator(std::string_view name, int precedence, bool rightAssoc)
+{
+    operators.push_back({ std::string(name), precedence, rightAssoc });
+}
+
+// 컴파일된 DFA 캐시: 연산자 우선순위나 평가 규칙만 바뀐 재흡수는 DFA 를 다시 만들지 않는다
+static std::shared_ptr<const LexerDFA> compileShared(LexerDFA&& dfa)
+{
+    static std::mutex mu;
+    static std::unordered_map<std::string, std::shared_ptr<const LexerDFA>> cache;
+    constexpr size_t kMaxEntries = 16;
+
+    std::string key = dfa.signature();
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        auto it = cache.find(key);
+        if (it != cache.end()) return it->second;
+    }
+
+    dfa.compile();
+    auto shared = std::make_shared<const LexerDFA>(std::move(dfa));
+
+    std::lock_guard<std::mutex> lock(mu);
+    if (cache.size() >= kMaxEntries) cache.clear();
+    cache.emplace(std::move(key), shared);
+    return shared;
+}
+
+static bool nameHas(const std::string& lower, std::initializer_list<const char*> keys)
+{
+    for (const char* k : keys)
+        if (lower.find(k) != std::string::npos) return true;
+    return false;
+}
+
+Grammar GrammarBuilder::build(OperatorTable& ops, LexerDFA::MatchFn compiled) const
+{
+    Grammar g;
+    LexerDFA dfa;
+
+    // 기본 + - * / 위에 팩의 우선순위를 덮어쓴다
+    std::vector<OpDef> merged = {
+        { "+", 10, false }, { "-", 10, false }, { "*", 20, false }, { "/", 20, false },
+    };
+    std::unordered_map<std::string_view, size_t> slot = {
+        { "+", 0 }, { "-", 1 }, { "*", 2 }, { "/", 3 },
+    };
+    merged.reserve(merged.size() + operators.size());
+    for (auto& op : operators) {
+        auto [it, fresh] = slot.emplace(op.name, merged.size());
+        if (fresh) merged.push_back(op);
+        else merged[it->second] = op;
+    }
+
+    // 연산자 리터럴이 식별자/숫자 규칙보다 우선 (예: "min" 은 변수가 아니라 연산자)
+    for (auto& op : merged) {
+        if (op.name.empty()) continue;
+        OpId id = ops.intern(op.name);
+        if (id >= g.bindings.size()) g.bindings.resize(id + 1);
+        g.bindings[id] = { op.precedence, true, op.rightAssoc };
+
+        LexerDFA::Rule r;
+        r.kind = TokKind::OP;
+        r.op = id;
+        dfa.addLiteral(op.name, r);
+    }
+
+    dfa.addLiteral("(", { TokKind::LPAREN, OP_NONE, false });
+    dfa.addLiteral(")", { TokKind::RPAREN, OP_NONE, false });
+
+    // 팩 토큰 (이름순)
+    std::vector<TokenDef> sorted = tokens;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const TokenDef& a, const TokenDef& b) { return a.name < b.name; });
+
+    bool haveNumber = false, haveIdent = false, haveSkip = false;
+    for (auto& t : sorted) {
+        std::string lower = t.name;
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        LexerDFA::Rule r;
+        if (nameHas(lower, { "space", "skip", "comment" }) || lower == "ws") {
+            r.skip = true;
+            haveSkip = true;
+        } else if (nameHas(lower, { "num", "int", "float", "digit" })) {
+            r.kind = TokKind::NUMBER;
+            haveNumber = true;
+        } else if (nameHas(lower, { "ident", "name", "var" }) || lower == "id") {
+            r.kind = TokKind::IDENT;
+            haveIdent = true;
+        } else {
+            r.kind = TokKind::OP;   // 연산자로 등록되지 않은 기호 → 파서가 거부
+        }
+        dfa.addPattern(t.regex, r);
+    }
+
+    if (!haveNumber) dfa.addPattern(kDefaultNumber, { TokKind::NUMBER, OP_NONE, false });
+    if (!haveIdent)  dfa.addPattern(kDefaultIdent,  { TokKind::IDENT, OP_NONE, false });
+    if (!haveSkip)   dfa.addPattern(kDefaultSpace,  { TokKind::OP, OP_NONE, true });
+
+    if (compiled) {
+        dfa.useCompiled(compiled);
+        g.dfa = std::make_shared<const LexerDFA>(std::move(dfa));
+    } else {
+        g.dfa = compileShared(std::move(dfa));
+    }
+    return g;
+}
+
+} // namespace sponge
@@ -0,0 +1,167 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "meta_lexer.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+/**
+ * 여러 토큰 정규식을 하나로 합친 DFA (최장 일치, 같은 길이면 먼저 추가된 규칙 우선).
+ *
+ * 지원 문법: 리터럴, 이스케이프(\d \w \s \D \W \S \n \t \r \. …), [a-z] / [^…] 클래스,
+ * '.', 그룹 ( ), 선택 |, 반복 * + ? {n} {n,} {n,m}.
+ * compile() 에서 Thompson NFA → 부분집합 구성으로 한 번 만들고,
+ * 실행 시에는 바이트 → 클래스 → 다음 상태 표 조회만 한다 (std::regex 없음).
+ */
+class LexerDFA {
+public:
+    struct Rule {
+        TokKind kind = TokKind::OP;
+        OpId op = OP_NONE;      // OP 토큰이면 미리 풀린 연산자 id
+        bool skip = false;      // 공백/주석: 토큰을 만들지 않음
+    };
+
+    // src[pos..] 의 최장 일치 길이와 규칙 번호를 돌려주는 생성된 렉서 (meta_builtin.hpp)
+    using MatchFn = size_t (*)(std::string_view src, size_t pos, int& rule);
+
+    // compile() 이 만든 상태 표 (바이너리 팩에 그대로 저장 / 매핑)
+    struct Tables {
+        const uint8_t* byteClass = nullptr;     // [256]
+        uint32_t classCount = 0;
+        std::span<const uint32_t> next;         // [state * classCount + class]
+        std::span<const int32_t> accept;        // 상태별 규칙 번호 (-1 = 비수용)
+    };
+
+    LexerDFA() = default;
+    // 상태 표 포인터가 자기 벡터를 가리키므로 복사하지 않는다 (move 는 버퍼를 그대로 넘긴다)
+    LexerDFA(const LexerDFA&) = delete;
+    LexerDFA& operator=(const LexerDFA&) = delete;
+    LexerDFA(LexerDFA&&) = default;
+    LexerDFA& operator=(LexerDFA&&) = default;
+
+    // 정규식 규칙 / 그대로 일치해야 하는 문자열 규칙 추가 (추가 순서 = 우선순위)
+    void addPattern(std::string_view regex, const Rule& rule);
+    void addLiteral(std::string_view text, const Rule& rule);
+
+    void compile();
+
+    // compile() 대신 같은 규칙 목록으로 미리 생성된 렉서를 쓴다 (상태 표 없음)
+    void useCompiled(MatchFn fn) { compiled = fn; }
+
+    // compile() 대신 이미 만든 상태 표를 복사 없이 쓴다 (byteClass 만 복사).
+    // 표의 메모리는 이 렉서보다 오래 살아야 한다. 규칙은 addPattern/addLiteral 없이 rules 로
+    void useTables(const Tables& t, std::vector<Rule> rules);
+    Tables tables() const {
+        return { byteClass, classCount, { nextTab, states * classCount }, { acceptTab, states } };
+    }
+
+    // 규칙 집합을 나타내는 문자열 (같으면 같은 DFA)
+    std::string signature() const;
+
+    // src[pos..] 의 최장 일치 길이 (없으면 0) 와 규칙 번호
+    size_t match(std::string_view src, size_t pos, int& rule) const {
+        if (compiled) return compiled(src, pos, rule);
+        uint32_t s = kStart;
+        size_t last = 0;
+        int lastRule = -1;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(src.data());
+        for (size_t i = pos; i < src.size(); ++i) {
+            s = nextTab[s * classCount + byteClass[p[i]]];
+            if (s == kDead) break;
+            if (acceptTab[s] >= 0) { last = i + 1 - pos; lastRule = acceptTab[s]; }
+        }
+        rule = lastRule;
+        return last;
+    }
+
+    const Rule& rule(int i) const { return rules[i]; }
+    size_t ruleCount() const { return rules.size(); }
+    size_t stateCount() const { return states; }
+
+private:
+    static constexpr uint32_t kDead = 0;
+    static constexpr uint32_t kStart = 1;
+
+    std::vector<std::string> sources;   // 규칙별 정규식, 또는 리터럴 원문
+    std::vector<char> literal;          // 1 = sources[i] 는 리터럴 (트라이로 합친다)
+    std::vector<Rule> rules;
+
+    uint8_t byteClass[256] = {};
+    uint32_t classCount = 1;
+    std::vector<uint32_t> next;         // [state * classCount + class]
+    std::vector<int32_t> accept;        // 상태별 규칙 번호 (-1 = 비수용)
+    const uint32_t* nextTab = nullptr;  // next / accept, 또는 useTables 로 받은 표
+    const int32_t* acceptTab = nullptr;
+    size_t states = 0;
+    MatchFn compiled = nullptr;
+};
+
+// 연산자 하나의 중위 결합 정보 (OpId 로 바로 조회)
+struct OpBinding {
+    int precedence = 0;
+    bool infix = false;
+    bool rightAssoc = false;
+};
+
+/**
+ * 팩에서 만든 파서 테이블: 결합 DFA 렉서 + OpId 별 우선순위/결합성.
+ * MetaParser 는 이 테이블로 Pratt 루프를 돈다 (연산자마다 규칙을 훑지 않음).
+ */
+class Grammar {
+public:
+    Grammar() = default;
+    // 이미 만든 렉서와 OpId 별 결합 표로 (바이너리 팩)
+    Grammar(std::shared_ptr<const LexerDFA> dfa, std::vector<OpBinding> bindings)
+        : dfa(std::move(dfa)), bindings(std::move(bindings)) {}
+
+    // + - * / (10/10/20/20, 왼쪽 결합) + 기본 숫자/식별자/공백 토큰
+    static const Grammar& defaults();
+
+    const LexerDFA& lexer() const { return *dfa; }
+
+    const OpBinding& binding(OpId id) const {
+        static const OpBinding none;
+        return id < bindings.size() ? bindings[id] : none;
+    }
+
+private:
+    friend class GrammarBuilder;
+
+    std::shared_ptr<const LexerDFA> dfa;    // 같은 규칙 집합끼리 공유 (재흡수 시 재사용)
+    std::vector<OpBinding> bindings;
+};
+
+/**
+ * 팩 규칙 → Grammar.
+ *
+ * 토큰 이름으로 종류를 정한다:
+ *   number/int/float…  → NUMBER     ident/identifier/name/var → IDENT
+ *   whitespace/ws/space/skip/comment → 건너뜀
+ * 팩에 없는 종류는 기본 정규식으로 채운다.
+ * 우선순위는 기본 + - * / 위에 팩 값을 덮어쓴다.
+ */
+class GrammarBuilder {
+public:
+    void addToken(std::string_view name, std::string_view regex);
+    void addOperator(std::string_view name, int precedence, bool rightAssoc);
+
+    // 연산자 이름은 ops 에 intern 된다.
+    // compiled 가 있으면 DFA 를 만들지 않고 그 렉서를 쓴다 (규칙 목록은 같게 만든다)
+    Grammar build(OperatorTable& ops, LexerDFA::MatchFn compiled = nullptr) const;
+
+private:
+    struct TokenDef { std::string name, regex; };
+    struct OpDef { std::string name; int precedence; bool rightAssoc; };
+
+    std::vector<TokenDef> tokens;
+    std::vector<OpDef> operators;
+};
+
+} // namespace sponge
@@ -1,23 +1,165 @@
 #include "meta_ir.hpp"
 #include "meta_engine.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace sponge {
 
-std::shared_ptr<IRNode> IRBuilder::literal(double v) {
-    auto n = std::make_shared<IRNode>();
-    n->op = "literal";
-    n->literal = {v};
-    return n;
+void IRArena::clear() {
+    tag.clear();
+    op.clear();
+    value.clear();
+    lhs.clear();
+    rhs.clear();
+    vars.clear();
+    root = IR_NONE;
+    shared = false;
+}
+
+void IRArena::reserve(size_t n) {
+    tag.reserve(n);
+    op.reserve(n);
+    value.reserve(n);
+    lhs.reserve(n);
+    rhs.reserve(n);
+}
+
+uint32_t IRArena::internVar(std::string_view name) {
+    // 한 식에 변수는 몇 개 안 되므로 선형 탐색
+    for (size_t i = 0; i < vars.size(); ++i)
+        if (vars[i] == name) return static_cast<uint32_t>(i);
+
+    vars.emplace_back(name);
+    return static_cast<uint32_t>(vars.size() - 1);
+}
+
+void countUses(const IRArena& ir, std::vector<uint32_t>& uses)
+{
+    if (ir.root >= ir.size()) {
+        uses.clear();
+        return;
+    }
+    uses.assign(size_t(ir.root) + 1, 0);
+    for (size_t k = ir.root + 1; k-- > 0; ) {
+        if (k != ir.root && uses[k] == 0) continue;
+        if (ir.tag[k] != IRTag::BINARY) continue;
+        uses[ir.lhs[k]]++;
+        uses[ir.rhs[k]]++;
+    }
+}
+
+// ------------------------------------------------------
+// hash-consing
+// ------------------------------------------------------
+void IRHashCons::reset()
+{
+    // 보통은 용량을 남기지만 (다음 파싱에서 재사용), 큰 식 하나 때문에 커진 테이블을
+    // 작은 식마다 통째로 지우지 않도록 거의 비어 있던 큰 테이블은 버린다
+    if (slots.size() > 1024 && count * 8 < slots.size())
+        std::vector<IRRef>().swap(slots);
+    else
+        std::fill(slots.begin(), slots.end(), IR_NONE);
+    count = 0;
+}
+
+uint64_t IRHashCons::hash(const IRArena& a, IRRef n)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &a.value[n], sizeof(bits));
+    uint64_t h = (uint64_t(a.tag[n]) << 16 | a.op[n]) * 0x9E3779B97F4A7C15ull;
+    h = (h ^ bits) * 0xFF51AFD7ED558CCDull;
+    h = (h ^ (uint64_t(a.lhs[n]) << 32 | a.rhs[n])) * 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 29);
+}
+
+bool IRHashCons::same(const IRArena& a, IRRef x, IRRef y)
+{
+    // 값은 비트로 비교 (0.0 과 -0.0 은 다른 리터럴)
+    return a.tag[x] == a.tag[y] && a.op[x] == a.op[y] &&
+           a.lhs[x] == a.lhs[y] && a.rhs[x] == a.rhs[y] &&
+           std::memcmp(&a.value[x], &a.value[y], sizeof(double)) == 0;
+}
+
+void IRHashCons::grow(const IRArena& arena)
+{
+    std::vector<IRRef> old = std::move(slots);
+    slots.assign(old.empty() ? 64 : old.size() * 2, IR_NONE);
+    size_t mask = slots.size() - 1;
+    for (IRRef r : old) {
+        if (r == IR_NONE) continue;
+        size_t i = hash(arena, r) & mask;
+        while (slots[i] != IR_NONE) i = (i + 1) & mask;
+        slots[i] = r;
+    }
+}
+
+IRRef IRHashCons::intern(const IRArena& arena, IRRef n)
+{
+    if ((count + 1) * 2 > slots.size()) grow(arena);
+
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(arena, n) & mask;; i = (i + 1) & mask) {
+        IRRef r = slots[i];
+        if (r == IR_NONE) {
+            slots[i] = n;
+            count++;
+            return n;
+        }
+        if (same(arena, r, n)) return r;
+    }
+}
+
+IRRef IRBuilder::commit(IRRef n)
+{
+    if (!cons) return n;
+    IRRef r = cons->intern(arena, n);
+    if (r != n) {
+        arena.tag.pop_back();
+        arena.op.pop_back();
+        arena.value.pop_back();
+        arena.lhs.pop_back();
+        arena.rhs.pop_back();
+        arena.shared = true;
+    }
+    return r;
+}
+
+
+
+// ------------------------------------------------------
+// 노드 추가
+// ------------------------------------------------------
+IRRef IRBuilder::literal(double v) {
+    IRRef n = static_cast<IRRef>(arena.size());
+    arena.tag.push_back(IRTag::LITERAL);
+    arena.op.push_back(OP_NONE);
+    arena.value.push_back(v);
+    arena.lhs.push_back(IR_NONE);
+    arena.rhs.push_back(IR_NONE);
+    return commit(n);
+}
+
+IRRef IRBuilder::binary(OpId op, IRRef L, IRRef R)
+{
+    IRRef n = static_cast<IRRef>(arena.size());
+    arena.tag.push_back(IRTag::BINARY);
+    arena.op.push_back(op);
+    arena.value.push_back(0.0);
+    arena.lhs.push_back(L);
+    arena.rhs.push_back(R);
+    return commit(n);
 }
 
-std::shared_ptr<IRNode> IRBuilder::binary(const std::string& op,
-            std::shared_ptr<IRNode> L,
-            std::shared_ptr<IRNode> R)
+IRRef IRBuilder::variable(std::string_view name)
 {
-    auto n = std::make_shared<IRNode>();
-    n->op = op;
-    n->children = {L, R};
-    return n;
+    IRRef n = static_cast<IRRef>(arena.size());
+    arena.tag.push_back(IRTag::VAR);
+    arena.op.push_back(OP_NONE);
+    arena.value.push_back(0.0);
+    arena.lhs.push_back(arena.internVar(name));
+    arena.rhs.push_back(IR_NONE);
+    return commit(n);
 }
 
 } // namespace sponge
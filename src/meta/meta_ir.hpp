@@ -1,22 +1,107 @@
 #pragma once
-#include <memory>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "meta_ops.hpp"
+
 namespace sponge {
 
-struct IRNode {
-    std::string op;               // "+", "literal", "call", etc.
-    std::vector<double> literal;  // numeric literal
-    std::vector<std::shared_ptr<IRNode>> children;
+// 아레나 안의 노드 인덱스
+using IRRef = uint32_t;
+constexpr IRRef IR_NONE = 0xFFFFFFFFu;
+
+// 노드 종류 (1 byte 태그)
+enum class IRTag : uint8_t {
+    LITERAL,
+    BINARY,
+    VAR        // 이름 있는 변수 (lhs[i] = vars 슬롯 번호)
+};
+
+/**
+ * 평탄화된 IR 노드 풀 (struct-of-arrays).
+ *
+ * 노드 i 의 정보는 tag[i] / op[i] / value[i] / lhs[i] / rhs[i] 에 나뉘어
+ * 연속 메모리로 저장된다. shared_ptr / 노드별 힙 할당이 없다.
+ *
+ * 자식 노드는 항상 부모보다 먼저 만들어지므로 lhs[i], rhs[i] < i.
+ * 파싱 1회 = 아레나 1개이며, clear() 또는 소멸 시 한 번에 해제된다.
+ *
+ * shared 가 false 면 트리 (부모가 하나). true 면 한 노드를 여러 부모가 가리킬 수 있는
+ * DAG 이므로 (hash-consing, CSE 패스) 트리를 그대로 훑는 소비자는
+ * 공유 노드를 여러 번 계산한다. 평가기는 이때 노드마다 한 번만 계산한다.
+ */
+struct IRArena {
+    std::vector<IRTag>    tag;
+    std::vector<OpId>     op;      // intern 된 연산자 id (OperatorTable)
+    std::vector<double>   value;   // literal 값 (인라인)
+    std::vector<IRRef>    lhs;
+    std::vector<IRRef>    rhs;
+
+    std::vector<std::string> vars;  // 변수 슬롯 → 이름 (처음 등장한 순서)
+    IRRef root = IR_NONE;
+    bool shared = false;            // 공유 노드가 있을 수 있음 (DAG)
+
+    size_t size() const { return tag.size(); }
+
+    // 용량은 남기고 노드만 비운다 (다음 파싱에서 재사용)
+    void clear();
+    void reserve(size_t n);
+
+    // 변수 이름 → 슬롯 (없으면 추가)
+    uint32_t internVar(std::string_view name);
+};
+
+/**
+ * root 에서 닿는 노드마다 그 노드를 가리키는 부모 수 (uses 크기 = root + 1).
+ * root 와 닿지 않는 노드는 0. 자식 < 부모 이므로 뒤에서부터 한 번 훑는다.
+ * DAG 를 트리로 펼치지 않고 내리는 백엔드가 공유 노드 (2 이상) 를 찾을 때 쓴다.
+ */
+void countUses(const IRArena& ir, std::vector<uint32_t>& uses);
+
+/**
+ * 구조가 같은 노드 → 먼저 만든 노드 (hash-consing 테이블).
+ *
+ * 키는 (tag, op, value 비트, lhs, rhs) 이고, 자식이 이미 합쳐져 있으면
+ * 서브트리 전체의 비교가 노드 하나 비교로 끝난다.
+ * 아레나 내용을 들고 있지 않고 ref 만 저장하므로 아레나를 clear 하면 reset() 해야 한다.
+ */
+class IRHashCons {
+public:
+    void reset();
+
+    // 노드 n 과 같은 노드가 이미 있으면 그 ref, 없으면 n 을 등록하고 n
+    IRRef intern(const IRArena& arena, IRRef n);
+
+private:
+    std::vector<IRRef> slots;       // 열린 주소법, 크기는 2 의 거듭제곱
+    size_t count = 0;
+
+    static uint64_t hash(const IRArena& a, IRRef n);
+    static bool same(const IRArena& a, IRRef x, IRRef y);
+    void grow(const IRArena& arena);
 };
 
+/**
+ * 아레나에 노드를 추가하는 빌더.
+ * cons 가 있으면 같은 노드를 다시 만들지 않고 기존 ref 를 돌려준다
+ * (그때 arena.shared 가 켜진다).
+ */
 class IRBuilder {
 public:
-    std::shared_ptr<IRNode> literal(double v);
-    std::shared_ptr<IRNode> binary(const std::string& op,
-            std::shared_ptr<IRNode> L,
-            std::shared_ptr<IRNode> R);
+    explicit IRBuilder(IRArena& arena, IRHashCons* cons = nullptr) : arena(arena), cons(cons) {}
+
+    IRRef literal(double v);
+    IRRef binary(OpId op, IRRef L, IRRef R);
+    IRRef variable(std::string_view name);
+
+private:
+    IRArena& arena;
+    IRHashCons* cons;
+
+    // 방금 추가한 노드를 cons 로 합친다 (같은 노드가 있으면 되돌리고 그 ref)
+    IRRef commit(IRRef n);
 };
 
 } // namespace sponge
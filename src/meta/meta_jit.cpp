@@ -0,0 +1,474 @@
+#include "meta_jit.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#include <unistd.h>
+#define SPONGE_JIT_X64 1
+#else
+#define SPONGE_JIT_X64 0
+#endif
+
+namespace sponge {
+
+// ------------------------------------------------------
+// JitFunction
+// ------------------------------------------------------
+JitFunction::JitFunction(void* code, size_t size, std::string nasm)
+    : code(code), size(size), listing(std::move(nasm))
+{
+    static_assert(sizeof(JitFn) == sizeof(void*), "function pointer size");
+    std::memcpy(&fn, &code, sizeof(fn));
+}
+
+JitFunction::~JitFunction()
+{
+#if SPONGE_JIT_X64
+    if (code) ::munmap(code, size);
+#endif
+}
+
+bool JitCompiler::available()
+{
+    return SPONGE_JIT_X64 != 0;
+}
+
+
+
+// ------------------------------------------------------
+// 어셈블러 (바이트 + 선택적 NASM 텍스트)
+// ------------------------------------------------------
+namespace {
+
+// GENERIC 은 테이블로 되돌아가서 계산 (프로세스 안에서만 의미가 있다)
+double jitApply(const OperatorTable* t, uint64_t id, double a, double b)
+{
+    return t->apply(static_cast<OpId>(id), a, b);
+}
+
+// MOD / POW 는 libm 을 바로 부른다 (NASM 텍스트에서는 extern fmod / pow)
+double jitFmod(double a, double b) { return std::fmod(a, b); }
+double jitPow(double a, double b) { return std::pow(a, b); }
+
+constexpr int kRegDepth = 14;      // xmm0..xmm13 = 값 스택
+constexpr int kTmpA = 14;          // xmm14 / xmm15 = 임시
+constexpr int kTmpB = 15;
+constexpr int kSaveArea = 8 * kRegDepth;
+
+// 레지스터 번호
+constexpr int RAX = 0, RSP = 4, RBX = 3;
+
+// 16 진수 (0x 없이)
+std::string hex(uint64_t v)
+{
+    char buf[17];
+    auto r = std::to_chars(buf, buf + sizeof(buf), v, 16);
+    return std::string(buf, r.ptr);
+}
+
+struct Asm {
+    std::vector<uint8_t> code;
+    EmitBuffer* text = nullptr;     // NASM 텍스트를 원할 때만
+
+    void b(uint8_t v) { code.push_back(v); }
+    void u32(uint32_t v) { for (int i = 0; i < 4; ++i) b(uint8_t(v >> (8 * i))); }
+    void u64(uint64_t v) { for (int i = 0; i < 8; ++i) b(uint8_t(v >> (8 * i))); }
+
+    template <typename... Args>
+    void line(const Args&... args) {
+        if (!text) return;
+        *text << "    ";
+        (*text << ... << args);
+        *text << '\n';
+    }
+
+    void rex(bool w, int reg, int rm) {
+        uint8_t r = uint8_t(0x40 | (w ? 8 : 0) | ((reg & 8) ? 4 : 0) | ((rm & 8) ? 1 : 0));
+        if (r != 0x40) b(r);
+    }
+
+    // prefix 0F op  xmm(dst), xmm(src)
+    void sseRR(uint8_t prefix, uint8_t op, int dst, int src, const char* mnem) {
+        b(prefix);
+        rex(false, dst, src);
+        b(0x0F); b(op);
+        b(uint8_t(0xC0 | ((dst & 7) << 3) | (src & 7)));
+        line(mnem, " xmm", dst, ", xmm", src);
+    }
+
+    // prefix 0F op  xmm(reg), [base + disp32]  (base = rbx 또는 rsp)
+    void sseRM(uint8_t prefix, uint8_t op, int reg, int base, int32_t disp,
+               const char* mnem, bool store) {
+        b(prefix);
+        rex(false, reg, base);
+        b(0x0F); b(op);
+        b(uint8_t(0x80 | ((reg & 7) << 3) | (base & 7)));
+        if (base == RSP) b(0x24);
+        u32(uint32_t(disp));
+
+        const char* r = base == RSP ? "rsp" : "rbx";
+        if (store) line(mnem, " qword [", r, " + ", disp, "], xmm", reg);
+        else       line(mnem, " xmm", reg, ", qword [", r, " + ", disp, "]");
+    }
+
+    void movsdLoad(int reg, int base, int32_t disp)  { sseRM(0xF2, 0x10, reg, base, disp, "movsd", false); }
+    void movsdStore(int reg, int base, int32_t disp) { sseRM(0xF2, 0x11, reg, base, disp, "movsd", true); }
+    void movapd(int dst, int src) { if (dst != src) sseRR(0x66, 0x28, dst, src, "movapd"); }
+
+    template <typename Comment>
+    void movRaxImm(uint64_t v, const Comment& comment) {
+        b(0x48); b(0xB8); u64(v);
+        if (text) line("mov rax, 0x", hex(v), "    ; ", comment);
+    }
+
+    // movq xmm, rax
+    void movqXmmRax(int reg) {
+        b(0x66);
+        rex(true, reg, RAX);
+        b(0x0F); b(0x6E);
+        b(uint8_t(0xC0 | ((reg & 7) << 3) | RAX));
+        line("movq xmm", reg, ", rax");
+    }
+};
+
+/**
+ * 스택 프레임 모양.
+ *   depth  — 값 스택이 가장 깊어지는 칸 수 (오른쪽 자식은 한 칸 위에서 평가)
+ *   shared — 두 번 이상 쓰이는 BINARY 노드 수 (IRArena::shared 일 때만, 노드마다 한 칸)
+ * 자식 < 부모 이므로 앞에서부터 한 번 훑는다 (재귀 없음).
+ * 공유 노드의 두 번째 자리부터는 잎처럼 한 칸이지만 depth 는 펼친 트리 기준의 상한이다.
+ */
+struct Frame {
+    int depth = 0;
+    uint32_t shared = 0;
+    std::vector<uint32_t> uses;     // shared 일 때 노드별 부모 수 (countUses)
+};
+
+Frame frameOf(const IRArena& ir)
+{
+    Frame f;
+    if (ir.root >= ir.size()) return f;
+
+    std::vector<int> need(size_t(ir.root) + 1, 1);
+    for (IRRef n = 0; n <= ir.root; ++n) {
+        if (ir.tag[n] == IRTag::BINARY)
+            need[n] = std::max(need[ir.lhs[n]], need[ir.rhs[n]] + 1);
+    }
+    f.depth = need[ir.root];
+
+    if (ir.shared) {
+        countUses(ir, f.uses);
+        for (IRRef n = 0; n <= ir.root; ++n)
+            if (f.uses[n] >= 2 && ir.tag[n] == IRTag::BINARY) f.shared++;
+    }
+    return f;
+}
+
+[[noreturn]] void genericOperator(const OperatorTable& ops, OpId op)
+{
+    throw std::runtime_error("NASM: operator '" + ops.name(op) + "' has no native kernel");
+}
+
+struct Gen {
+    Asm& as;
+    const IRArena& ir;
+    const OperatorTable& ops;
+
+    bool native = true;                 // false 면 NASM 텍스트만 (프로세스 주소를 쓸 수 없다)
+    int maxDepth = 0;
+    Frame frame = {};
+    int32_t sharedBase = 0;             // 공유 노드 칸이 시작하는 rsp 오프셋
+    std::vector<int32_t> slot = {};     // 노드 → 공유 칸 번호 (-1 이면 아직 계산 전)
+    int32_t nextSlot = 0;
+
+    int32_t spillDisp(int d) const { return kSaveArea + 8 * (d - kRegDepth); }
+    int32_t sharedDisp(int32_t k) const { return sharedBase + 8 * k; }
+
+    // 값 스택 d 의 값을 xmm(reg) 로
+    void load(int reg, int d) {
+        if (d < kRegDepth) as.movapd(reg, d);
+        else as.movsdLoad(reg, RSP, spillDisp(d));
+    }
+
+    // xmm(reg) 를 값 스택 d 로
+    void store(int reg, int d) {
+        if (d < kRegDepth) as.movapd(d, reg);
+        else as.movsdStore(reg, RSP, spillDisp(d));
+    }
+
+    // d 위치가 레지스터면 그 번호, 아니면 임시 레지스터
+    static bool spilled(int d) { return d >= kRegDepth; }
+    static int home(int d, int tmp) { return spilled(d) ? tmp : d; }
+
+    void literal(double v, int d) {
+        int r = home(d, kTmpA);
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        if (bits == 0) {
+            as.sseRR(0x66, 0x57, r, r, "xorpd");
+        } else {
+            as.movRaxImm(bits, v);
+            as.movqXmmRax(r);
+        }
+        if (spilled(d)) store(r, d);
+    }
+
+    void variable(uint32_t slot, int d) {
+        int r = home(d, kTmpA);
+        as.movsdLoad(r, RBX, int32_t(8 * slot));
+        if (spilled(d)) store(r, d);
+    }
+
+    void binary(IRRef n, int d) {
+        OpId op = ir.op[n];
+        OpKernel k = ops.kernel(op);
+        if (k == OpKernel::NONE)
+            throw std::runtime_error("Unknown operator: " + ops.name(op));
+
+        uint8_t code = 0;
+        const char* mnem = nullptr;
+        bool swapped = false;   // min/max 는 std::min/max 와 비트 단위로 같도록 (b op a)
+        switch (k) {
+            case OpKernel::ADD: code = 0x58; mnem = "addsd"; break;
+            case OpKernel::SUB: code = 0x5C; mnem = "subsd"; break;
+            case OpKernel::MUL: code = 0x59; mnem = "mulsd"; break;
+            case OpKernel::DIV: code = 0x5E; mnem = "divsd"; break;
+            case OpKernel::MIN: code = 0x5D; mnem = "minsd"; swapped = true; break;
+            case OpKernel::MAX: code = 0x5F; mnem = "maxsd"; swapped = true; break;
+            default: break;
+        }
+
+        if (mnem) {
+            int ra = home(d, kTmpA);
+            int rb = home(d + 1, kTmpB);
+            if (spilled(d)) load(ra, d);
+            if (spilled(d + 1)) load(rb, d + 1);
+
+            if (!swapped) {
+                as.sseRR(0xF2, code, ra, rb, mnem);
+            } else {
+                as.sseRR(0xF2, code, rb, ra, mnem);
+                as.movapd(ra, rb);
+            }
+            if (spilled(d)) store(ra, d);
+            return;
+        }
+
+        // 헬퍼 호출: 값 스택 아래쪽 레지스터들을 save area 에 보관
+        int live = std::min(d, kRegDepth);
+        for (int r = 0; r < live; ++r) as.movsdStore(r, RSP, 8 * r);
+
+        load(0, d);
+        load(1, d + 1);
+
+        if (k == OpKernel::MOD || k == OpKernel::POW) {
+            // 텍스트는 링크할 때 풀리는 심볼, 기계어는 같은 일을 하는 래퍼의 주소
+            bool mod = k == OpKernel::MOD;
+            auto fn = mod ? &jitFmod : &jitPow;
+            as.b(0x48); as.b(0xB8); as.u64(reinterpret_cast<uint64_t>(fn));
+            as.b(0xFF); as.b(0xD0);
+            as.line("call ", mod ? "fmod" : "pow", " wrt ..plt");
+        } else {
+            if (!native) genericOperator(ops, op);
+            // 목록 (compile 의 withNasm) 은 이 프로세스의 주소를 그대로 적는다
+            as.b(0x48); as.b(0xBF); as.u64(reinterpret_cast<uint64_t>(&ops));
+            as.line("mov rdi, 0x", hex(reinterpret_cast<uint64_t>(&ops)), "    ; OperatorTable");
+            as.b(0xBE); as.u32(op);
+            as.line("mov esi, ", op, "    ; ", ops.name(op));
+            as.movRaxImm(reinterpret_cast<uint64_t>(&jitApply), "jitApply");
+            as.b(0xFF); as.b(0xD0);
+            as.line("call rax");
+        }
+
+        as.movapd(kTmpA, 0);
+        for (int r = 0; r < live; ++r) as.movsdLoad(r, RSP, 8 * r);
+        store(kTmpA, d);
+    }
+
+    // 후위 순회를 명시적 작업 스택으로 (깊은 식에서도 C++ 스택을 쓰지 않는다)
+    struct Work {
+        IRRef n;
+        int d;
+        bool expanded;  // 자식을 이미 내려보낸 BINARY
+    };
+
+    bool isShared(IRRef n) const { return ir.shared && frame.uses[n] >= 2; }
+
+    // 이미 계산한 공유 노드를 값 스택 d 로
+    void reuse(IRRef n, int d) {
+        int r = home(d, kTmpA);
+        as.movsdLoad(r, RSP, sharedDisp(slot[n]));
+        if (spilled(d)) store(r, d);
+    }
+
+    // 값 스택 d 에 막 계산한 공유 노드를 자기 칸에 보관
+    void keep(IRRef n, int d) {
+        slot[n] = nextSlot++;
+        int r = home(d, kTmpA);
+        if (spilled(d)) load(r, d);
+        as.movsdStore(r, RSP, sharedDisp(slot[n]));
+    }
+
+    // 공유 노드는 처음 자리에서만 계산하고 (keep) 그 뒤로는 칸에서 읽는다 (reuse)
+    void emit(IRRef root) {
+        std::vector<Work> work;
+        work.push_back({ root, 0, false });
+        while (!work.empty()) {
+            Work w = work.back();
+            work.pop_back();
+            if (w.expanded) {
+                binary(w.n, w.d);
+                if (isShared(w.n)) keep(w.n, w.d);
+                continue;
+            }
+            switch (ir.tag[w.n]) {
+                case IRTag::LITERAL: literal(ir.value[w.n], w.d); continue;
+                case IRTag::VAR:     variable(ir.lhs[w.n], w.d); continue;
+                case IRTag::BINARY:
+                    if (isShared(w.n) && slot[w.n] >= 0) {
+                        reuse(w.n, w.d);
+                        continue;
+                    }
+                    work.push_back({ w.n, w.d, true });
+                    work.push_back({ ir.rhs[w.n], w.d + 1, false });
+                    work.push_back({ ir.lhs[w.n], w.d, false });
+                    continue;
+            }
+            throw std::runtime_error("Invalid IR node structure");
+        }
+    }
+
+    void function() {
+        if (ir.root >= ir.size())
+            throw std::runtime_error("JIT: empty IR");
+
+        frame = frameOf(ir);
+        if (size_t(frame.depth) + frame.shared > JitCompiler::kMaxFrameSlots)
+            throw std::runtime_error("JIT: expression too large");
+        maxDepth = frame.depth - 1;
+        int spills = std::max(0, frame.depth - kRegDepth);
+        sharedBase = kSaveArea + 8 * spills;
+        if (frame.shared) slot.assign(frame.uses.size(), -1);
+
+        uint32_t bytes = uint32_t(sharedBase + 8 * int32_t(frame.shared));
+        bytes = (bytes + 15) & ~15u;   // push rbx 후 rsp 는 16 정렬 → frame 도 16 배수
+
+        as.line("push rbx");
+        as.b(0x53);
+        as.line("mov rbx, rdi          ; env");
+        as.b(0x48); as.b(0x89); as.b(0xFB);
+        as.line("sub rsp, ", bytes);
+        as.b(0x48); as.b(0x81); as.b(0xEC); as.u32(bytes);
+
+        emit(ir.root);
+
+        as.line("add rsp, ", bytes);
+        as.b(0x48); as.b(0x81); as.b(0xC4); as.u32(bytes);
+        as.line("pop rbx");
+        as.b(0x5B);
+        as.line("ret");
+        as.b(0xC3);
+    }
+};
+
+// 머리말 + 루트에서 닿는 MOD / POW 가 부르는 libm 심볼.
+// 텍스트만 만들 때 (native == false) GENERIC 연산자는 부를 심볼이 없으므로
+// 아무것도 쓰기 전에 거절한다
+void nasmHeader(EmitBuffer& out, const IRArena& ir, const OperatorTable& ops, bool native)
+{
+    bool mod = false, pow = false;
+    if (ir.root < ir.size()) {
+        std::vector<uint8_t> reach(size_t(ir.root) + 1, 0);
+        reach[ir.root] = 1;
+        for (size_t n = reach.size(); n-- > 0; ) {
+            if (!reach[n] || ir.tag[n] != IRTag::BINARY) continue;
+            reach[ir.lhs[n]] = reach[ir.rhs[n]] = 1;
+            OpKernel k = ops.kernel(ir.op[n]);
+            if (!native && k == OpKernel::GENERIC) genericOperator(ops, ir.op[n]);
+            mod |= k == OpKernel::MOD;
+            pow |= k == OpKernel::POW;
+        }
+    }
+
+    out << "; generated by spongelang JIT (System V x86-64)\n"
+           "; double sponge_expr(const double* env)\n"
+           "section .text\n"
+           "global sponge_expr\n";
+    if (mod) out << "extern fmod\n";
+    if (pow) out << "extern pow\n";
+    out << "sponge_expr:\n";
+}
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// compile / toNasm
+// ------------------------------------------------------
+size_t JitCompiler::frameSlots(const IRArena& ir)
+{
+    Frame f = frameOf(ir);
+    return size_t(f.depth) + f.shared;
+}
+
+std::unique_ptr<JitFunction> JitCompiler::compile(
+    const IRArena& ir, const OperatorTable& ops, bool withNasm) const
+{
+#if SPONGE_JIT_X64
+    std::string listing;
+    EmitBuffer text(listing);
+    Asm as;
+    if (withNasm) {
+        nasmHeader(text, ir, ops, true);
+        as.text = &text;
+    }
+    Gen gen{ as, ir, ops };
+    gen.function();
+
+    // RW 로 쓰고 RX 로 바꾼다 (W^X)
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t size = (as.code.size() + page - 1) / page * page;
+
+    void* mem = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        throw std::runtime_error("JIT: mmap failed");
+
+    std::memcpy(mem, as.code.data(), as.code.size());
+    if (::mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+        ::munmap(mem, size);
+        throw std::runtime_error("JIT: mprotect failed");
+    }
+
+    return std::make_unique<JitFunction>(mem, size, std::move(listing));
+#else
+    (void)ir; (void)ops; (void)withNasm;
+    throw std::runtime_error("JIT: not supported on this platform");
+#endif
+}
+
+std::string JitCompiler::toNasm(const IRArena& ir, const OperatorTable& ops) const
+{
+    std::string out;
+    EmitBuffer text(out);
+    emitNasm(ir, ops, text);
+    return out;
+}
+
+void JitCompiler::emitNasm(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const
+{
+    nasmHeader(out, ir, ops, false);
+    Asm as;
+    as.text = &out;
+    Gen gen{ as, ir, ops };
+    gen.native = false;
+    gen.function();
+}
+
+} // namespace sponge
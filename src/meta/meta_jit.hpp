@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "meta_emit.hpp"
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+// env: 변수 슬롯별 값 (IRArena::vars 순서). 변수가 없으면 nullptr 가능.
+using JitFn = double (*)(const double* env);
+
+/**
+ * JIT 으로 만든 네이티브 함수 하나. 실행 가능한 mmap 버퍼를 소유한다.
+ * GENERIC 연산자는 OperatorTable 로 되돌아가 호출하므로
+ * 컴파일할 때 쓴 테이블보다 오래 살면 안 된다.
+ */
+class JitFunction {
+public:
+    JitFunction(void* code, size_t size, std::string nasm);
+    ~JitFunction();
+
+    JitFunction(const JitFunction&) = delete;
+    JitFunction& operator=(const JitFunction&) = delete;
+
+    double operator()(const double* env = nullptr) const { return fn(env); }
+    JitFn function() const { return fn; }
+
+    size_t codeSize() const { return size; }
+    // 같은 코드를 NASM 문법으로 적은 것 (compile 에서 요청했을 때만)
+    const std::string& nasm() const { return listing; }
+
+    // 헬퍼 호출이 가리키는 OperatorTable 의 소유자를 함께 붙잡아 둔다
+    void retain(std::shared_ptr<const void> o) { owner = std::move(o); }
+
+private:
+    void* code;
+    size_t size;
+    JitFn fn;
+    std::string listing;
+    std::shared_ptr<const void> owner;
+};
+
+/**
+ * IR → x86-64 SSE2 기계어 JIT (System V ABI: Linux / macOS x86-64).
+ *
+ * 값 스택 깊이 d 를 xmm_d 에 두고 (0..13), 더 깊어지면 스택 프레임에 spill 한다.
+ * 공유 노드 (IRArena::shared) 는 한 번만 계산해 프레임의 자기 칸에 두고 다시 읽는다.
+ * + - * / min max 는 인라인 SSE2 스칼라 명령으로, % 와 pow 는 libm (fmod / pow) 호출로,
+ * 커널이 없는 (GENERIC) 연산자는 OperatorTable 헬퍼 호출로 처리한다.
+ * 지원하지 않는 플랫폼에서는 available() == false 이고 compile() 은 runtime_error.
+ */
+class JitCompiler {
+public:
+    // 스택 프레임이 이보다 많은 칸을 쓰는 식은 compile() 이 runtime_error (512KB 상한)
+    static constexpr size_t kMaxFrameSlots = size_t(1) << 16;
+
+    static bool available();
+
+    // 식 하나가 쓰는 프레임 칸 수: 값 스택 최대 깊이 + 공유 노드 수 (재귀 없음)
+    static size_t frameSlots(const IRArena& ir);
+
+    std::unique_ptr<JitFunction> compile(const IRArena& ir, const OperatorTable& ops,
+                                         bool withNasm = false) const;
+
+    // 기계어 없이 NASM 텍스트만 생성 (모든 플랫폼에서 동작).
+    // 그대로 어셈블·링크할 수 있는 텍스트라 GENERIC 연산자가 있으면 runtime_error
+    std::string toNasm(const IRArena& ir, const OperatorTable& ops) const;
+    // 같은 텍스트를 out 에 바로 쓴다 (EmitterRegistry 의 "nasm" 백엔드)
+    void emitNasm(const IRArena& ir, const OperatorTable& ops, EmitBuffer& out) const;
+};
+
+} // namespace sponge
@@ -0,0 +1,80 @@
+#include "meta_lexer.hpp"
+#include "meta_grammar.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace sponge {
+
+bool parseDouble(std::string_view text, double& out)
+{
+#if defined(__cpp_lib_to_chars)
+    auto res = std::from_chars(text.data(), text.data() + text.size(), out);
+    return res.ec == std::errc() && res.ptr == text.data() + text.size();
+#else
+    // 숫자 토큰은 짧으므로 스택 버퍼에 복사해서 strtod
+    char buf[128];
+    if (text.size() >= sizeof(buf)) return false;
+    std::memcpy(buf, text.data(), text.size());
+    buf[text.size()] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buf, &end);
+    return end == buf + text.size();
+#endif
+}
+
+MetaLexer::MetaLexer(std::string_view src, const LexerDFA* dfa)
+    : src(src), dfa(dfa ? dfa : &Grammar::defaults().lexer())
+{
+    cur = scan();
+}
+
+Token MetaLexer::next()
+{
+    Token t = cur;
+    cur = scan();
+    return t;
+}
+
+
+
+// ------------------------------------------------------
+// 토큰 하나 읽기 (DFA 최장 일치)
+// ------------------------------------------------------
+Token MetaLexer::scan()
+{
+    for (;;) {
+        Token t;
+        t.offset = pos;
+
+        if (pos >= src.size()) {
+            t.kind = TokKind::END;
+            return t;
+        }
+
+        int r;
+        size_t len = dfa->match(src, pos, r);
+        if (len == 0) {
+            throw std::runtime_error(
+                "lex error: unexpected '" + std::string(1, src[pos]) +
+                "' at " + std::to_string(pos));
+        }
+
+        const LexerDFA::Rule& rule = dfa->rule(r);
+        t.text = src.substr(pos, len);
+        pos += len;
+        if (rule.skip) continue;
+
+        t.kind = rule.kind;
+        t.op = rule.op;
+
+        if (t.kind == TokKind::NUMBER && !parseDouble(t.text, t.number))
+            throw std::runtime_error("lex error: bad number '" + std::string(t.text) + "'");
+        return t;
+    }
+}
+
+} // namespace sponge
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+class LexerDFA;
+
+enum class TokKind : uint8_t {
+    NUMBER,    // 123, 4.5, 1e-3 (팩의 number 정규식)
+    IDENT,     // [A-Za-z_][A-Za-z0-9_]* (팩의 ident 정규식)
+    OP,        // 팩이 정의한 연산자 (여러 글자 가능)
+    LPAREN,
+    RPAREN,
+    END
+};
+
+struct Token {
+    TokKind kind = TokKind::END;
+    std::string_view text;   // 원본 소스를 가리킴 (복사 없음)
+    double number = 0.0;     // NUMBER 일 때 값
+    size_t offset = 0;       // 소스 내 위치 (에러 메시지용)
+    OpId op = OP_NONE;       // OP 일 때 미리 풀린 연산자 id
+};
+
+/**
+ * string_view 위에서 도는 zero-copy 렉서.
+ *
+ * 팩에서 만든 결합 DFA (LexerDFA) 로 최장 일치 토큰을 자른다.
+ * dfa 가 nullptr 이면 Grammar::defaults() 의 DFA 를 쓴다.
+ * skip 규칙(공백 등)은 건너뛰고, 숫자는 std::from_chars 로 바로 변환한다.
+ * 입력 끝을 넘어서 읽지 않으며, 끝에서는 END 토큰을 계속 돌려준다.
+ * 소스 버퍼와 DFA 는 렉서보다 오래 살아 있어야 한다.
+ */
+class MetaLexer {
+public:
+    explicit MetaLexer(std::string_view src, const LexerDFA* dfa = nullptr);
+
+    const Token& peek() const { return cur; }
+    Token next();
+
+    std::string_view source() const { return src; }
+
+private:
+    std::string_view src;
+    const LexerDFA* dfa;
+    size_t pos = 0;
+    Token cur;
+
+    Token scan();
+};
+
+// 소수/지수 포함 숫자 파싱 (from_chars 미지원 환경에서는 strtod)
+bool parseDouble(std::string_view text, double& out);
+
+} // namespace sponge
@@ -0,0 +1,63 @@
+#include "meta_mapped_file.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SPONGE_HAVE_MMAP 1
+#endif
+
+namespace sponge {
+
+MappedFile::MappedFile(const std::string& path)
+{
+#if SPONGE_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("[MappedFile] Cannot open file: " + path);
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("[MappedFile] Cannot stat file: " + path);
+    }
+
+    length = static_cast<size_t>(st.st_size);
+    if (length > 0) {
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("[MappedFile] mmap failed: " + path);
+        }
+        // 순차 스캔 힌트
+        ::madvise(p, length, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(p);
+        mapped = true;
+    }
+    ::close(fd);
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open())
+        throw std::runtime_error("[MappedFile] Cannot open file: " + path);
+
+    std::ostringstream ss;
+    ss << f.rdbuf();
+    fallback = ss.str();
+    data = fallback.data();
+    length = fallback.size();
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if SPONGE_HAVE_MMAP
+    if (mapped) ::munmap(const_cast<char*>(data), length);
+#endif
+}
+
+} // namespace sponge
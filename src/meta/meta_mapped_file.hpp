@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace sponge {
+
+/**
+ * 읽기 전용 파일 매핑.
+ *
+ * POSIX 에서는 mmap 으로 파일을 그대로 매핑하고 (복사 없음),
+ * 그 외 플랫폼에서는 파일 전체를 한 번 읽어 버퍼에 보관한다.
+ * 열 수 없으면 runtime_error.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return { data, length }; }
+    size_t size() const { return length; }
+
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::string fallback;   // mmap 불가 환경용 버퍼
+};
+
+} // namespace sponge
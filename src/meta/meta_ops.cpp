@@ -0,0 +1,132 @@
+#include "meta_ops.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace sponge {
+
+// ------------------------------------------------------
+// 커널 함수들 (std::function 에 담겨도 식별 가능하도록 일반 함수)
+// ------------------------------------------------------
+static double kAdd(double a, double b) { return a + b; }
+static double kSub(double a, double b) { return a - b; }
+static double kMul(double a, double b) { return a * b; }
+static double kDiv(double a, double b) { return a / b; }
+static double kMod(double a, double b) { return std::fmod(a, b); }
+static double kPow(double a, double b) { return std::pow(a, b); }
+static double kMin(double a, double b) { return std::min(a, b); }
+static double kMax(double a, double b) { return std::max(a, b); }
+
+static const struct {
+    OpKernel kernel;
+    EvalFn fn;
+    const char* rule;
+} kKernels[] = {
+    { OpKernel::ADD, kAdd, "a+b" },
+    { OpKernel::SUB, kSub, "a-b" },
+    { OpKernel::MUL, kMul, "a*b" },
+    { OpKernel::DIV, kDiv, "a/b" },
+    { OpKernel::MOD, kMod, "a%b" },
+    { OpKernel::POW, kPow, "pow(a,b)" },
+    { OpKernel::MIN, kMin, "min(a,b)" },
+    { OpKernel::MAX, kMax, "max(a,b)" },
+};
+
+OpKernel kernelFromRule(const std::string& rule) {
+    // 공백 무시하고 비교 ("a + b" == "a+b")
+    std::string s;
+    for (char c : rule)
+        if (c != ' ' && c != '\t') s += c;
+
+    for (auto& k : kKernels)
+        if (s == k.rule) return k.kernel;
+
+    if (s == "a^b" || s == "a**b") return OpKernel::POW;
+    return OpKernel::GENERIC;
+}
+
+EvalFn kernelFunction(OpKernel k) {
+    for (auto& e : kKernels)
+        if (e.kernel == k) return e.fn;
+    return nullptr;
+}
+
+OpKernel kernelFromFunction(const std::function<double(double,double)>& fn) {
+    auto p = fn.target<EvalFn>();
+    if (p) {
+        for (auto& e : kKernels)
+            if (*p == e.fn) return e.kernel;
+    }
+    return OpKernel::GENERIC;
+}
+
+
+
+// ------------------------------------------------------
+// 연산자 이름 풀 (모든 OperatorTable 이 공유)
+// ------------------------------------------------------
+const std::string* internOpName(std::string_view name) {
+    // unordered_set 노드는 rehash 에도 옮겨지지 않으므로 주소가 안정적
+    static std::mutex mutex;
+    static std::unordered_set<std::string> pool;
+
+    std::string key(name);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pool.find(key);
+    if (it == pool.end()) it = pool.insert(std::move(key)).first;
+    return &*it;
+}
+
+
+
+// ------------------------------------------------------
+// OperatorTable
+// ------------------------------------------------------
+OperatorTable::OperatorTable() {
+    for (const char* op : { "+", "-", "*", "/" })
+        intern(op);
+}
+
+OpId OperatorTable::intern(const std::string& name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+
+    if (names.size() >= OP_NONE)
+        throw std::runtime_error("Too many operators");
+
+    OpId id = static_cast<OpId>(names.size());
+    const std::string* shared = internOpName(name);
+    names.push_back(shared);
+    ids.emplace(*shared, id);
+    kernels.push_back(OpKernel::NONE);
+    generic.emplace_back();
+    return id;
+}
+
+OpId OperatorTable::find(std::string_view name) const {
+    auto it = ids.find(name);
+    return it == ids.end() ? OP_NONE : it->second;
+}
+
+OpId OperatorTable::findKernel(OpKernel k) const {
+    for (size_t i = 0; i < kernels.size(); ++i)
+        if (kernels[i] == k) return static_cast<OpId>(i);
+    return OP_NONE;
+}
+
+void OperatorTable::clearRules() {
+    std::fill(kernels.begin(), kernels.end(), OpKernel::NONE);
+    for (auto& g : generic) g = nullptr;
+}
+
+void OperatorTable::define(OpId id, const std::function<double(double,double)>& fn) {
+    if (!fn) {
+        kernels[id] = OpKernel::NONE;
+        generic[id] = nullptr;
+        return;
+    }
+    kernels[id] = kernelFromFunction(fn);
+    generic[id] = kernels[id] == OpKernel::GENERIC ? fn : nullptr;
+}
+
+} // namespace sponge
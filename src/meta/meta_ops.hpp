@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace sponge {
+
+// intern 된 연산자 id (IRArena::op 에 그대로 저장됨)
+using OpId = uint16_t;
+constexpr OpId OP_NONE = 0xFFFF;
+
+/**
+ * 알려진 평가 커널.
+ *   NONE    — 현재 팩에 평가 규칙이 없음
+ *   GENERIC — 인식하지 못한 사용자 규칙 (std::function 경로)
+ */
+enum class OpKernel : uint8_t {
+    NONE,
+    ADD, SUB, MUL, DIV,
+    MOD, POW, MIN, MAX,
+    GENERIC
+};
+
+using EvalFn = double(*)(double, double);
+
+// 연산자 이름 → 프로세스가 끝날 때까지 유효한 공유 문자열 (스레드 안전)
+const std::string* internOpName(std::string_view name);
+
+// "a + b", "pow(a, b)" 같은 평가식 → 커널 (모르면 GENERIC)
+OpKernel kernelFromRule(const std::string& rule);
+
+// 커널 → 일반 함수 포인터 (NONE/GENERIC 이면 nullptr)
+EvalFn kernelFunction(OpKernel k);
+
+// std::function 이 kernelFunction() 으로 만든 것이면 해당 커널, 아니면 GENERIC
+OpKernel kernelFromFunction(const std::function<double(double,double)>& fn);
+
+inline double applyKernel(OpKernel k, double a, double b) {
+    switch (k) {
+        case OpKernel::ADD: return a + b;
+        case OpKernel::SUB: return a - b;
+        case OpKernel::MUL: return a * b;
+        case OpKernel::DIV: return a / b;
+        case OpKernel::MOD: return std::fmod(a, b);
+        case OpKernel::POW: return std::pow(a, b);
+        case OpKernel::MIN: return std::min(a, b);
+        case OpKernel::MAX: return std::max(a, b);
+        default: break;
+    }
+    throw std::runtime_error("applyKernel: not a builtin kernel");
+}
+
+/**
+ * 연산자 intern 테이블 + 평탄한 디스패치 테이블.
+ *
+ * 팩을 absorb 할 때 연산자 이름을 작은 정수 id 로 바꾸고,
+ * 평가 시에는 kernels[id] 로 바로 분기한다 (해시/타입소거 호출 없음).
+ * 인식 못한 규칙만 generic[id] 의 std::function 으로 떨어진다.
+ *
+ * 파서가 하드코딩한 + - * / 는 생성 시점에 미리 intern 해둔다.
+ * 이름 문자열은 프로세스 전역 풀(internOpName)에 한 벌만 두고
+ * 테이블은 포인터만 들고 있어, 같은 연산자를 쓰는 팩 여러 개가 메모리를 나눠 쓴다.
+ */
+class OperatorTable {
+public:
+    OperatorTable();
+
+    OpId intern(const std::string& name);
+    OpId find(std::string_view name) const;
+
+    const std::string& name(OpId id) const { return *names[id]; }
+    size_t size() const { return names.size(); }
+
+    // 평가 규칙만 비운다 (id 는 유지되므로 기존 IR 과 호환)
+    void clearRules();
+    void define(OpId id, const std::function<double(double,double)>& fn);
+
+    OpKernel kernel(OpId id) const { return kernels[id]; }
+    // GENERIC 연산자의 사용자 함수 (다른 커널이면 빈 함수)
+    const std::function<double(double,double)>& function(OpId id) const { return generic[id]; }
+
+    // 해당 커널로 정의된 첫 연산자 (없으면 OP_NONE)
+    OpId findKernel(OpKernel k) const;
+
+    double apply(OpId id, double a, double b) const {
+        OpKernel k = kernels[id];
+        if (k == OpKernel::GENERIC) return generic[id](a, b);
+        if (k == OpKernel::NONE)
+            throw std::runtime_error("Unknown operator: " + *names[id]);
+        return applyKernel(k, a, b);
+    }
+
+private:
+    std::vector<const std::string*> names;          // internOpName() 풀을 가리킴
+    std::unordered_map<std::string_view, OpId> ids;  // 키도 풀의 문자열
+
+    std::vector<OpKernel> kernels;
+    std::vector<std::function<double(double,double)>> generic;
+};
+
+} // namespace sponge
@@ -0,0 +1,341 @@
+#include "meta_pack_binary.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace sponge {
+
+namespace {
+
+uint64_t fnv1a(const unsigned char* p, size_t n)
+{
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < n; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+// 같은 문자열은 한 번만 저장
+struct StringPool {
+    std::vector<std::string> list;
+    std::unordered_map<std::string, uint32_t> ids;
+
+    uint32_t intern(const std::string& s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(list.size());
+        list.push_back(s);
+        ids.emplace(s, id);
+        return id;
+    }
+};
+
+std::vector<PackPair> pairs(const std::unordered_map<std::string, std::string>& m,
+                            StringPool& pool)
+{
+    // 이름순으로 써서 같은 입력 → 같은 파일
+    std::map<std::string, std::string> sorted(m.begin(), m.end());
+    std::vector<PackPair> out;
+    for (auto& kv : sorted)
+        out.push_back({ pool.intern(kv.first), pool.intern(kv.second) });
+    return out;
+}
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// LangPack → .spack
+// ------------------------------------------------------
+void compileBinaryPack(const MetaAbsorbLoader::LangPack& pack, const std::string& path)
+{
+    StringPool pool;
+    PackFileHeader header{};
+    std::memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+    header.version = kPackVersion;
+    header.byteOrder = kPackByteOrder;
+    header.name = pool.intern(pack.name);
+
+    std::vector<PackPair> tokens = pairs(pack.tokens, pool);
+    std::vector<PackPair> ir = pairs(pack.irRules, pool);
+
+    // 세 섹션에 흩어진 연산자를 하나의 레코드로 모은다.
+    // OpId 는 흡수할 때와 같게: OperatorTable 이 미리 넣는 + - * / 다음 이름순
+    std::set<std::string> names;
+    for (auto& kv : pack.precedence) names.insert(kv.first);
+    for (auto& kv : pack.evalRules)  names.insert(kv.first);
+    for (auto& kv : pack.bytecode)   names.insert(kv.first);
+
+    OperatorTable table;
+    for (auto& name : names) table.intern(name);
+
+    // 토큰 정규식 → DFA, 우선순위 → OpId 별 결합 표 (흡수할 때는 이 결과를 매핑만 한다)
+    GrammarBuilder gb;
+    for (auto& kv : pack.tokens) gb.addToken(kv.first, kv.second);
+    for (auto& name : names) {
+        auto it = pack.precedence.find(name);
+        if (it == pack.precedence.end()) continue;
+        auto a = pack.associativity.find(name);
+        gb.addOperator(name, it->second, a != pack.associativity.end() && a->second == "right");
+    }
+    Grammar grammar = gb.build(table);
+
+    std::vector<PackOp> ops;
+    std::vector<PackBinding> bindings;
+    for (size_t i = 0; i < table.size(); ++i) {
+        OpId id = static_cast<OpId>(i);
+        const std::string& name = table.name(id);
+        PackOp op{};
+        op.name = pool.intern(name);
+
+        if (auto it = pack.precedence.find(name); it != pack.precedence.end()) {
+            op.flags |= PACK_OP_PRECEDENCE;
+            op.precedence = it->second;
+
+            auto a = pack.associativity.find(name);
+            if (a != pack.associativity.end() && a->second == "right")
+                op.flags |= PACK_OP_RIGHT_ASSOC;
+        }
+        if (auto it = pack.evalRules.find(name); it != pack.evalRules.end()) {
+            op.flags |= PACK_OP_EVAL;
+            op.evalRule = pool.intern(it->second);
+            op.kernel = static_cast<uint8_t>(kernelFromRule(it->second));
+        }
+        if (auto it = pack.bytecode.find(name); it != pack.bytecode.end()) {
+            op.flags |= PACK_OP_BYTECODE;
+            op.bytecodeName = pool.intern(it->second);
+            op.opcode = static_cast<uint8_t>(opcodeFromName(it->second));
+        }
+        ops.push_back(op);
+
+        const OpBinding& b = grammar.binding(id);
+        bindings.push_back({ b.precedence, uint8_t(b.infix), uint8_t(b.rightAssoc), {} });
+    }
+
+    const LexerDFA& lexer = grammar.lexer();
+    std::vector<PackRule> rules;
+    for (size_t i = 0; i < lexer.ruleCount(); ++i) {
+        const LexerDFA::Rule& r = lexer.rule(int(i));
+        rules.push_back({ r.op, static_cast<uint8_t>(r.kind), uint8_t(r.skip), {} });
+    }
+    LexerDFA::Tables dfa = lexer.tables();
+
+    // 문자열 테이블 + blob
+    std::vector<PackString> strings;
+    std::string blob;
+    for (auto& s : pool.list) {
+        strings.push_back({ static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(s.size()) });
+        blob += s;
+        blob += '\0';
+    }
+
+    // 레이아웃
+    size_t offset = sizeof(PackFileHeader);
+    auto at = [&](uint32_t& off, size_t bytes) {
+        off = static_cast<uint32_t>(offset);
+        offset += align8(bytes);
+    };
+    auto place = [&](uint32_t& off, uint32_t& count, size_t n, size_t elem) {
+        count = static_cast<uint32_t>(n);
+        at(off, n * elem);
+    };
+    place(header.stringsOffset, header.stringCount, strings.size(), sizeof(PackString));
+    place(header.tokensOffset, header.tokenCount, tokens.size(), sizeof(PackPair));
+    place(header.opsOffset, header.opCount, ops.size(), sizeof(PackOp));
+    at(header.bindingsOffset, bindings.size() * sizeof(PackBinding));
+    place(header.irOffset, header.irCount, ir.size(), sizeof(PackPair));
+    place(header.rulesOffset, header.ruleCount, rules.size(), sizeof(PackRule));
+    header.classCount = dfa.classCount;
+    header.stateCount = static_cast<uint32_t>(dfa.accept.size());
+    at(header.classOffset, 256);
+    at(header.nextOffset, dfa.next.size_bytes());
+    at(header.acceptOffset, dfa.accept.size_bytes());
+    place(header.blobOffset, header.blobSize, blob.size(), 1);
+    header.fileSize = offset;
+
+    if (offset > UINT32_MAX)
+        throw std::runtime_error("[PackImage] pack too large: " + path);
+
+    std::vector<unsigned char> out(offset, 0);
+    auto put = [&](uint32_t off, const void* src, size_t bytes) {
+        if (bytes) std::memcpy(out.data() + off, src, bytes);
+    };
+    put(header.stringsOffset, strings.data(), strings.size() * sizeof(PackString));
+    put(header.tokensOffset, tokens.data(), tokens.size() * sizeof(PackPair));
+    put(header.opsOffset, ops.data(), ops.size() * sizeof(PackOp));
+    put(header.bindingsOffset, bindings.data(), bindings.size() * sizeof(PackBinding));
+    put(header.irOffset, ir.data(), ir.size() * sizeof(PackPair));
+    put(header.rulesOffset, rules.data(), rules.size() * sizeof(PackRule));
+    put(header.classOffset, dfa.byteClass, 256);
+    put(header.nextOffset, dfa.next.data(), dfa.next.size_bytes());
+    put(header.acceptOffset, dfa.accept.data(), dfa.accept.size_bytes());
+    put(header.blobOffset, blob.data(), blob.size());
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    header.checksum = fnv1a(out.data() + kPackChecksumFrom, out.size() - kPackChecksumFrom);
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    // 읽는 쪽이 반쯤 쓰인 파일을 보지 않도록 임시 파일 → rename
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.is_open())
+            throw std::runtime_error("[PackImage] Cannot write pack: " + path);
+        f.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!f)
+            throw std::runtime_error("[PackImage] Cannot write pack: " + path);
+    }
+    std::filesystem::rename(tmp, path);
+}
+
+
+
+// ------------------------------------------------------
+// .spack 로드 (mmap)
+// ------------------------------------------------------
+bool PackImage::isBinary(std::string_view bytes)
+{
+    return bytes.size() >= sizeof(kPackMagic) &&
+           std::memcmp(bytes.data(), kPackMagic, sizeof(kPackMagic)) == 0;
+}
+
+PackImage::PackImage(const std::string& path)
+    : file(path)
+{
+    try {
+        validate();
+    } catch (const std::exception& e) {
+        throw std::runtime_error("[PackImage] " + path + ": " + e.what());
+    }
+}
+
+void PackImage::validate()
+{
+    std::string_view bytes = file.view();
+    const char* base = bytes.data();
+
+    if (bytes.size() < sizeof(PackFileHeader) || !isBinary(bytes))
+        throw std::runtime_error("not a binary pack");
+
+    header = reinterpret_cast<const PackFileHeader*>(base);
+    if (header->version != kPackVersion)
+        throw std::runtime_error("unsupported pack version " + std::to_string(header->version));
+    if (header->byteOrder != kPackByteOrder)
+        throw std::runtime_error("pack was built with a different byte order");
+    if (header->fileSize != bytes.size())
+        throw std::runtime_error("truncated pack");
+
+    auto section = [&](uint32_t off, uint64_t count, size_t elem) {
+        if (off % 8 != 0 || off < sizeof(PackFileHeader) ||
+            off + count * elem > bytes.size())
+            throw std::runtime_error("section out of range");
+        return base + off;
+    };
+    strings    = reinterpret_cast<const PackString*>(section(header->stringsOffset, header->stringCount, sizeof(PackString)));
+    tokenTable = reinterpret_cast<const PackPair*>(section(header->tokensOffset, header->tokenCount, sizeof(PackPair)));
+    opTable    = reinterpret_cast<const PackOp*>(section(header->opsOffset, header->opCount, sizeof(PackOp)));
+    bindingTable = reinterpret_cast<const PackBinding*>(section(header->bindingsOffset, header->opCount, sizeof(PackBinding)));
+    irTable    = reinterpret_cast<const PackPair*>(section(header->irOffset, header->irCount, sizeof(PackPair)));
+    ruleTable  = reinterpret_cast<const PackRule*>(section(header->rulesOffset, header->ruleCount, sizeof(PackRule)));
+    classTable = reinterpret_cast<const uint8_t*>(section(header->classOffset, 256, 1));
+    nextTable  = reinterpret_cast<const uint32_t*>(section(header->nextOffset,
+                     uint64_t(header->stateCount) * header->classCount, sizeof(uint32_t)));
+    acceptTable = reinterpret_cast<const int32_t*>(section(header->acceptOffset, header->stateCount, sizeof(int32_t)));
+    blob       = section(header->blobOffset, header->blobSize, 1);
+
+    uint64_t sum = fnv1a(reinterpret_cast<const unsigned char*>(base) + kPackChecksumFrom,
+                         bytes.size() - kPackChecksumFrom);
+    if (sum != header->checksum)
+        throw std::runtime_error("checksum mismatch");
+
+    // 여기부터는 체크섬이 맞으므로 구조 검사만
+    for (uint32_t i = 0; i < header->stringCount; ++i) {
+        if (uint64_t(strings[i].offset) + strings[i].length + 1 > header->blobSize)
+            throw std::runtime_error("string out of range");
+    }
+
+    auto id = [&](uint32_t s) {
+        if (s >= header->stringCount) throw std::runtime_error("bad string id");
+    };
+    id(header->name);
+    for (auto& p : tokens())  { id(p.key); id(p.value); }
+    for (auto& p : irRules()) { id(p.key); id(p.value); }
+    for (auto& op : operators()) {
+        id(op.name);
+        if (op.flags & PACK_OP_EVAL) {
+            id(op.evalRule);
+            if (op.kernel > static_cast<uint8_t>(OpKernel::GENERIC))
+                throw std::runtime_error("bad kernel");
+        }
+        if (op.flags & PACK_OP_BYTECODE) {
+            id(op.bytecodeName);
+            if (op.opcode > static_cast<uint8_t>(OpCode::HALT))
+                throw std::runtime_error("bad opcode");
+        }
+    }
+
+    // 렉서 표: 매칭 루프는 경계 검사를 하지 않으므로 여기서 한 번 전부 본다
+    if (header->opCount < 4 || header->opCount >= OP_NONE)
+        throw std::runtime_error("bad operator count");
+    for (auto& r : lexerRules()) {
+        if (r.kind > static_cast<uint8_t>(TokKind::END) ||
+            (r.op != OP_NONE && r.op >= header->opCount))
+            throw std::runtime_error("bad lexer rule");
+    }
+    uint32_t classes = header->classCount;
+    uint32_t states = header->stateCount;
+    if (classes == 0 || classes > 256 || states < 2)
+        throw std::runtime_error("bad lexer table");
+    for (uint32_t c = 0; c < 256; ++c)
+        if (classTable[c] >= classes) throw std::runtime_error("bad lexer table");
+    for (uint64_t i = 0; i < uint64_t(states) * classes; ++i)
+        if (nextTable[i] >= states) throw std::runtime_error("bad lexer table");
+    for (uint32_t s = 0; s < states; ++s)
+        if (acceptTable[s] < -1 || acceptTable[s] >= int64_t(header->ruleCount))
+            throw std::runtime_error("bad lexer table");
+}
+
+LexerDFA::Tables PackImage::lexerTables() const
+{
+    size_t cells = size_t(header->stateCount) * header->classCount;
+    return { classTable, header->classCount, { nextTable, cells }, { acceptTable, header->stateCount } };
+}
+
+std::string_view PackImage::str(uint32_t id) const
+{
+    const PackString& s = strings[id];
+    return { blob + s.offset, s.length };
+}
+
+MetaAbsorbLoader::LangPack PackImage::toLangPack() const
+{
+    MetaAbsorbLoader::LangPack pack;
+    pack.name = std::string(name());
+
+    for (auto& p : tokens())
+        pack.tokens.emplace(str(p.key), str(p.value));
+    for (auto& p : irRules())
+        pack.irRules.emplace(str(p.key), str(p.value));
+
+    for (auto& op : operators()) {
+        std::string key(str(op.name));
+        if (op.flags & PACK_OP_PRECEDENCE) pack.precedence[key] = op.precedence;
+        if (op.flags & PACK_OP_RIGHT_ASSOC) pack.associativity[key] = "right";
+        if (op.flags & PACK_OP_EVAL)       pack.evalRules[key] = std::string(str(op.evalRule));
+        if (op.flags & PACK_OP_BYTECODE)   pack.bytecode[key] = std::string(str(op.bytecodeName));
+    }
+    return pack;
+}
+
+} // namespace sponge
@@ -0,0 +1,178 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "meta_absorb_loader.hpp"
+#include "meta_grammar.hpp"
+#include "meta_mapped_file.hpp"
+#include "meta_ops.hpp"
+#include "meta_vm.hpp"
+
+namespace sponge {
+
+// ------------------------------------------------------
+// 바이너리 언어팩 (.spack) 디스크 형식
+//
+//   [PackFileHeader]
+//   [PackString  × stringCount]  blob 안의 (offset, length)
+//   [PackPair    × tokenCount]   토큰 이름 → 정규식
+//   [PackOp      × opCount]      연산자별 평탄한 레코드 (번호 = OpId)
+//   [PackBinding × opCount]      OpId 별 우선순위/결합성 (Grammar 의 Pratt 표)
+//   [PackPair    × irCount]      IR 규칙
+//   [PackRule    × ruleCount]    렉서 규칙 (번호 = DFA 의 규칙 번호)
+//   [uint8  × 256]               바이트 → 클래스
+//   [uint32 × stateCount × classCount]  다음 상태
+//   [int32  × stateCount]        상태별 수용 규칙 (-1 = 비수용)
+//   [string blob]                NUL 로 끝나는 문자열들
+//
+// 연산자 표와 렉서 DFA 는 만들 때 GrammarBuilder 로 한 번 풀어 두고,
+// 흡수할 때는 매핑된 표를 그대로 쓴다 (정규식 컴파일 / 우선순위 병합 없음).
+// OpId 0..3 은 OperatorTable 이 미리 넣는 + - * / 이고 팩에 없으면 flags 가 0 이다.
+//
+// 모든 섹션은 8 바이트 정렬. 정수는 만든 머신의 바이트 순서 그대로이며
+// byteOrder 로 확인한다. checksum 은 checksum 필드 뒤 전체 (나머지 헤더 필드 + 본문) 에
+// 대한 FNV-1a 64 이고, 앞쪽 필드 (magic / version / byteOrder / fileSize) 는 값으로 검사한다.
+// ------------------------------------------------------
+constexpr char     kPackMagic[8]  = { 'S', 'P', 'O', 'N', 'G', 'E', 'P', 'K' };
+constexpr uint32_t kPackVersion   = 3;
+constexpr uint32_t kPackByteOrder = 0x01020304;
+
+struct PackFileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint64_t checksum;
+
+    uint32_t name;                      // 언어 이름 (문자열 id)
+    uint32_t stringCount, stringsOffset;
+    uint32_t tokenCount,  tokensOffset;
+    uint32_t opCount,     opsOffset;
+    uint32_t bindingsOffset;            // opCount 개
+    uint32_t irCount,     irOffset;
+    uint32_t ruleCount,   rulesOffset;
+    uint32_t classCount,  classOffset;  // classOffset 에 256 바이트
+    uint32_t stateCount,  nextOffset, acceptOffset;
+    uint32_t blobOffset,  blobSize;
+    uint32_t reserved;
+};
+
+struct PackString {
+    uint32_t offset;                    // blob 기준
+    uint32_t length;
+};
+
+struct PackPair {
+    uint32_t key;
+    uint32_t value;
+};
+
+enum PackOpFlags : uint8_t {
+    PACK_OP_PRECEDENCE = 1,
+    PACK_OP_EVAL       = 2,
+    PACK_OP_BYTECODE   = 4,
+    PACK_OP_RIGHT_ASSOC = 8,
+};
+
+// 연산자 하나 — 우선순위/커널/opcode 가 이미 풀려 있다
+struct PackOp {
+    uint32_t name;
+    int32_t  precedence;
+    uint32_t evalRule;                  // 원문 평가식 (GENERIC 표시/디버그용)
+    uint32_t bytecodeName;
+    uint8_t  kernel;                    // OpKernel
+    uint8_t  opcode;                    // OpCode
+    uint8_t  flags;                     // PackOpFlags
+    uint8_t  reserved;
+};
+
+// 연산자 하나의 중위 결합 (OpBinding 과 같은 값, 팩에 없는 기본 + - * / 포함)
+struct PackBinding {
+    int32_t precedence;
+    uint8_t infix;
+    uint8_t rightAssoc;
+    uint8_t reserved[2];
+};
+
+// 렉서 규칙 하나 (LexerDFA::Rule)
+struct PackRule {
+    uint16_t op;                        // OP 토큰이면 OpId, 아니면 OP_NONE
+    uint8_t  kind;                      // TokKind
+    uint8_t  skip;
+    uint8_t  reserved[4];
+};
+
+static_assert(sizeof(PackFileHeader) % 8 == 0);
+static_assert(sizeof(PackOp) == 20);
+static_assert(sizeof(PackBinding) == 8);
+static_assert(sizeof(PackRule) == 8);
+
+// checksum 이 덮는 범위의 시작 (헤더의 이름 / 개수 / 오프셋 필드도 포함)
+constexpr size_t kPackChecksumFrom = offsetof(PackFileHeader, name);
+
+
+
+/**
+ * 텍스트 LangPack → 바이너리 팩 파일.
+ * 평가식은 커널로, bytecode 이름은 opcode 로, 토큰과 우선순위는 렉서 DFA 와
+ * OpId 별 결합 표로 미리 변환해 둔다 (잘못된 정규식도 여기서 runtime_error).
+ * 알 수 없는 opcode 이름이면 runtime_error.
+ */
+void compileBinaryPack(const MetaAbsorbLoader::LangPack& pack, const std::string& path);
+
+/**
+ * mmap 된 바이너리 팩. 로드 시 헤더/범위/체크섬만 검사하고
+ * 이후에는 파일 내용을 복사 없이 그대로 읽는다.
+ * 손상되었거나 버전이 다르면 runtime_error.
+ */
+class PackImage {
+public:
+    explicit PackImage(const std::string& path);
+
+    PackImage(const PackImage&) = delete;
+    PackImage& operator=(const PackImage&) = delete;
+
+    // 파일 앞부분이 바이너리 팩 magic 인지
+    static bool isBinary(std::string_view bytes);
+
+    std::string_view name() const { return str(header->name); }
+    std::string_view str(uint32_t id) const;
+
+    std::span<const PackPair> tokens() const  { return { tokenTable, header->tokenCount }; }
+    std::span<const PackOp> operators() const { return { opTable, header->opCount }; }
+    std::span<const PackBinding> bindings() const { return { bindingTable, header->opCount }; }
+    std::span<const PackPair> irRules() const { return { irTable, header->irCount }; }
+
+    // 렉서: 규칙 표 + 매핑된 DFA 상태 표 (팩 이미지가 살아 있는 동안 유효)
+    std::span<const PackRule> lexerRules() const { return { ruleTable, header->ruleCount }; }
+    LexerDFA::Tables lexerTables() const;
+
+    uint32_t version() const { return header->version; }
+    uint64_t checksum() const { return header->checksum; }
+    size_t size() const { return file.size(); }
+
+    // 도구/디버그용 텍스트 형태 복원
+    MetaAbsorbLoader::LangPack toLangPack() const;
+
+private:
+    MappedFile file;
+    const PackFileHeader* header = nullptr;
+    const PackString* strings = nullptr;
+    const PackPair* tokenTable = nullptr;
+    const PackOp* opTable = nullptr;
+    const PackBinding* bindingTable = nullptr;
+    const PackPair* irTable = nullptr;
+    const PackRule* ruleTable = nullptr;
+    const uint8_t* classTable = nullptr;
+    const uint32_t* nextTable = nullptr;
+    const int32_t* acceptTable = nullptr;
+    const char* blob = nullptr;
+
+    void validate();
+};
+
+} // namespace sponge
@@ -1,7 +1,7 @@
 #include "meta_parser.hpp"
 #include "meta_engine.hpp"
+#include "meta_stats.hpp"
 
-#include <cctype>
 #include <stdexcept>
 
 namespace sponge {
@@ -10,45 +10,148 @@ void MetaParser::addRule(const std::string& head, const std::string& pattern) {
     rules[head] = pattern;
 }
 
-char MetaParser::peek() { return input[pos]; }
-char MetaParser::advance() { return input[pos++]; }
-
-double MetaParser::parseNumber() {
-    size_t start = pos;
-    while (isdigit(peek())) advance();
-    return std::stod(input.substr(start, pos - start));
+// ------------------------------------------------------
+// 연산자 우선순위 파싱 (명시적 스택)
+//
+// 재귀 precedence climbing 과 같은 트리를 같은 노드 순서로 만든다:
+// 스택 맨 위 연산자 Q 는 다음 연산자 P 가 Q 의 오른쪽 피연산자에
+// 들어갈 수 없을 때 (P < Q, 또는 Q 가 왼쪽 결합이고 P == Q) 묶인다.
+// 깊이가 수십만인 식도 호출 스택을 쓰지 않는다.
+// ------------------------------------------------------
+void MetaParser::reduceTop() {
+    PendingOp top = opStack.back();
+    opStack.pop_back();
+    IRRef r = valStack.back();
+    valStack.pop_back();
+    IRRef l = valStack.back();
+    valStack.back() = builder().binary(top.op, l, r);
 }
 
-std::shared_ptr<IRNode> MetaParser::parseFactor() {
-    if (isdigit(peek()))
-        return IRBuilder().literal(parseNumber());
-    throw std::runtime_error("factor parse error");
-}
+IRRef MetaParser::parseExpr() {
+    opStack.clear();
+    valStack.clear();
+    size_t depth = 0;       // 열린 괄호 수
+
+    for (;;) {
+        // 피연산자 자리: NUMBER | IDENT | '(' …
+        Token t = lex->next();
+        if (t.kind == TokKind::LPAREN) {
+            opStack.push_back({ OP_NONE, 0, false });
+            depth++;
+            continue;
+        }
+        if (t.kind == TokKind::NUMBER)
+            valStack.push_back(builder().literal(t.number));
+        else if (t.kind == TokKind::IDENT)
+            valStack.push_back(builder().variable(t.text));
+        else
+            throw std::runtime_error("factor parse error at " + std::to_string(t.offset));
 
-std::shared_ptr<IRNode> MetaParser::parseTerm() {
-    auto n = parseFactor();
-    while (peek() == '*' || peek() == '/') {
-        char op = advance();
-        auto r = parseFactor();
-        n = IRBuilder().binary(std::string(1,op), n, r);
+        // 연산자 자리: 중위 연산자면 묶고 다음 피연산자로, ')' 면 괄호를 닫는다
+        for (;;) {
+            const Token& p = lex->peek();
+            if (p.kind == TokKind::OP) {
+                const OpBinding& b = active->binding(p.op);
+                if (b.infix) {
+                    while (!opStack.empty() && opStack.back().op != OP_NONE) {
+                        const PendingOp& q = opStack.back();
+                        int rhsMin = q.rightAssoc ? q.precedence : q.precedence + 1;
+                        if (b.precedence >= rhsMin) break;
+                        reduceTop();
+                    }
+                    opStack.push_back({ lex->next().op, b.precedence, b.rightAssoc });
+                    break;
+                }
+            }
+
+            // 식의 끝 (괄호 안이면 ')' 가 와야 한다)
+            while (!opStack.empty() && opStack.back().op != OP_NONE) reduceTop();
+            if (depth == 0) return valStack.back();
+
+            if (lex->next().kind != TokKind::RPAREN)
+                throw std::runtime_error("parse error: expected ')'");
+            opStack.pop_back();     // '(' 표시
+            depth--;
+        }
     }
-    return n;
 }
 
-std::shared_ptr<IRNode> MetaParser::parseExpr() {
-    auto n = parseTerm();
-    while (peek() == '+' || peek() == '-') {
-        char op = advance();
-        auto r = parseTerm();
-        n = IRBuilder().binary(std::string(1,op), n, r);
-    }
-    return n;
+IRRef MetaParser::parse(std::string_view src, IRArena& out) {
+    SPONGE_PHASE(PARSE);
+    active = grammar ? grammar : &Grammar::defaults();
+
+    MetaLexer lexer(src, &active->lexer());
+    lex = &lexer;
+    arena = &out;
+
+    out.clear();
+    if (hashCons) cons.reset();
+    out.root = parseExpr();
+
+    bool trailing = lexer.peek().kind != TokKind::END;
+    size_t at = lexer.peek().offset;
+    lex = nullptr;
+    arena = nullptr;
+
+    if (trailing)
+        throw std::runtime_error("parse error: unexpected token at " + std::to_string(at));
+
+    SPONGE_COUNT(PROGRAMS, 1);
+    SPONGE_COUNT(IR_NODES, out.size());
+    return out.root;
 }
 
-std::shared_ptr<IRNode> MetaParser::parse(const std::string& src) {
-    input = src;
-    pos = 0;
-    return parseExpr();
+IRArena MetaParser::parse(std::string_view src) {
+    IRArena out;
+    parse(src, out);
+    return out;
+}
+
+
+
+// ------------------------------------------------------
+// 줄 단위 스트리밍 파싱
+// ------------------------------------------------------
+size_t MetaParser::parseLines(std::string_view buffer, IRArena& out,
+    const std::function<void(size_t, const IRArena&)>& onExpr,
+    const std::function<void(size_t, const std::string&)>& onError)
+{
+    size_t count = 0;
+    size_t lineNo = 0;
+    size_t pos = 0;
+
+    while (pos < buffer.size()) {
+        size_t nl = buffer.find('\n', pos);
+        if (nl == std::string_view::npos) nl = buffer.size();
+
+        std::string_view line = buffer.substr(pos, nl - pos);
+        pos = nl + 1;
+        lineNo++;
+
+        // 공백뿐인 줄은 건너뜀
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+            continue;
+
+        if (onError) {
+            try {
+                parse(line, out);
+                onExpr(lineNo, out);
+                count++;
+            } catch (const std::exception& e) {
+                onError(lineNo, e.what());
+            }
+            continue;
+        }
+
+        try {
+            parse(line, out);
+        } catch (const std::exception& e) {
+            throw std::runtime_error("line " + std::to_string(lineNo) + ": " + e.what());
+        }
+        onExpr(lineNo, out);
+        count++;
+    }
+    return count;
 }
 
 } // namespace sponge
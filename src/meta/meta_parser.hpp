@@ -1,30 +1,76 @@
 #pragma once
 #include <string>
-#include <memory>
+#include <string_view>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 #include "meta_ir.hpp"
+#include "meta_lexer.hpp"
+#include "meta_grammar.hpp"
 
 namespace sponge {
 
+/**
+ * 팩에서 만든 Grammar 로 도는 연산자 우선순위 파서.
+ *
+ *   expr    := primary (OP expr)*     — OP 의 우선순위/결합성은 grammar 에서 OpId 로 조회
+ *   primary := NUMBER | IDENT | '(' expr ')'
+ *
+ * 토큰마다 연산자 id 가 이미 붙어 있으므로 규칙을 훑지 않고 선형 시간에 끝난다.
+ * 재귀 대신 연산자/피연산자 스택을 쓰므로 식 깊이에 제한이 없다.
+ * grammar 가 nullptr 이면 Grammar::defaults() (+ - * /).
+ */
 class MetaParser {
 public:
-    // rule: "Expr": "Term ((+|-) Term)*"
+    // rule: "Expr": "Term ((+|-) Term)*"  (문서용, 파싱에는 쓰지 않음)
     std::unordered_map<std::string, std::string> rules;
 
+    // 렉서 DFA + 연산자 결합 정보 (엔진의 언어 스냅샷이 소유)
+    const Grammar* grammar = nullptr;
+
+    // 구조가 같은 서브트리를 노드 하나로 합친다 (IRHashCons → DAG, IRArena::shared)
+    bool hashCons = false;
+
     void addRule(const std::string& head, const std::string& pattern);
 
-    std::shared_ptr<IRNode> parse(const std::string& src);
+    // src 를 파싱해서 out 아레나를 채운다 (out 은 먼저 clear 됨). 루트 반환.
+    // src 는 복사하지 않는다.
+    IRRef parse(std::string_view src, IRArena& out);
+
+    // 새 아레나를 만들어 반환하는 편의 버전
+    IRArena parse(std::string_view src);
+
+    /**
+     * 줄 단위로 여러 식이 들어 있는 버퍼를 스트리밍 파싱.
+     * 빈 줄은 건너뛰고, 각 줄을 arena 에 파싱한 뒤 onExpr(lineNo, arena) 호출.
+     * 줄을 복사하지 않으므로 mmap 된 파일을 그대로 넘기면 된다.
+     * onError 가 없으면 첫 오류에서 "line N: …" runtime_error,
+     * 있으면 그 줄의 오류(파싱이든 onExpr 이든)를 넘기고 다음 줄로 간다.
+     * 처리한 식 개수를 반환 (오류 난 줄 제외).
+     */
+    size_t parseLines(std::string_view buffer, IRArena& arena,
+                      const std::function<void(size_t lineNo, const IRArena&)>& onExpr,
+                      const std::function<void(size_t lineNo, const std::string& error)>& onError = nullptr);
 
 private:
-    std::string input;
-    size_t pos;
-
-    char peek();
-    char advance();
-    double parseNumber();
-    std::shared_ptr<IRNode> parseExpr();
-    std::shared_ptr<IRNode> parseTerm();
-    std::shared_ptr<IRNode> parseFactor();
+    MetaLexer* lex = nullptr;
+    IRArena* arena = nullptr;
+    const Grammar* active = nullptr;
+
+    // 아직 묶이지 않은 중위 연산자 (op == OP_NONE 이면 '(' 표시)
+    struct PendingOp {
+        OpId op;
+        int precedence;
+        bool rightAssoc;
+    };
+    std::vector<PendingOp> opStack;
+    std::vector<IRRef> valStack;
+    IRHashCons cons;
+
+    IRBuilder builder() { return IRBuilder(*arena, hashCons ? &cons : nullptr); }
+
+    IRRef parseExpr();
+    void reduceTop();
 };
 
 } // namespace sponge
@@ -0,0 +1,306 @@
+#include "meta_passes.hpp"
+#include "meta_stats.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace sponge {
+
+// ------------------------------------------------------
+// 공통: 인덱스 순서(= 위상 순서)로 새 아레나에 다시 쌓기
+// ------------------------------------------------------
+namespace {
+
+struct Rebuild {
+    const IRArena& in;
+    IRArena& out;
+    std::vector<IRRef>& remap;
+    size_t changes = 0;
+
+    // 노드 i 를 (새 자식 ref 로) 그대로 복사
+    IRRef copy(IRRef i, IRRef L, IRRef R) {
+        IRRef n = static_cast<IRRef>(out.size());
+        out.tag.push_back(in.tag[i]);
+        out.op.push_back(in.op[i]);
+        out.value.push_back(in.value[i]);
+        out.lhs.push_back(in.tag[i] == IRTag::BINARY ? L : in.lhs[i]);
+        out.rhs.push_back(in.tag[i] == IRTag::BINARY ? R : in.rhs[i]);
+        return n;
+    }
+
+    IRRef literal(double v) { changes++; return IRBuilder(out).literal(v); }
+    IRRef binary(OpId op, IRRef L, IRRef R) { changes++; return IRBuilder(out).binary(op, L, R); }
+    IRRef forward(IRRef to) { changes++; return to; }
+
+    // 마지막으로 추가한 노드를 되돌린다
+    void drop() {
+        out.tag.pop_back();
+        out.op.pop_back();
+        out.value.pop_back();
+        out.lhs.pop_back();
+        out.rhs.pop_back();
+    }
+
+    bool isLit(IRRef r) const { return out.tag[r] == IRTag::LITERAL; }
+    bool isLit(IRRef r, double v) const { return isLit(r) && out.value[r] == v; }
+    bool isLeaf(IRRef r) const { return out.tag[r] != IRTag::BINARY; }
+
+    // 같은 값임이 확실한가 (같은 노드 또는 같은 변수 슬롯)
+    bool same(IRRef a, IRRef b) const {
+        if (a == b) return true;
+        return out.tag[a] == IRTag::VAR && out.tag[b] == IRTag::VAR && out.lhs[a] == out.lhs[b];
+    }
+};
+
+template <typename Visit>
+size_t rebuild(IRArena& ir, Visit&& visit, const std::vector<uint8_t>* live = nullptr)
+{
+    thread_local IRArena out;
+    thread_local std::vector<IRRef> remap;
+
+    out.clear();
+    out.reserve(ir.size());
+    out.vars = std::move(ir.vars);
+    out.shared = ir.shared;
+    remap.assign(ir.size(), IR_NONE);
+
+    Rebuild rb{ ir, out, remap };
+
+    for (IRRef i = 0; i < ir.size(); ++i) {
+        if (live && !(*live)[i]) continue;
+
+        IRRef L = IR_NONE, R = IR_NONE;
+        if (ir.tag[i] == IRTag::BINARY) {
+            L = remap[ir.lhs[i]];
+            R = remap[ir.rhs[i]];
+        }
+        remap[i] = visit(rb, i, L, R);
+    }
+
+    out.root = ir.root == IR_NONE ? IR_NONE : remap[ir.root];
+    std::swap(ir, out);
+    return rb.changes;
+}
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// constant-fold
+// ------------------------------------------------------
+size_t ConstantFoldPass::run(IRArena& ir, const OperatorTable& ops) const
+{
+    return rebuild(ir, [&](Rebuild& rb, IRRef i, IRRef L, IRRef R) -> IRRef {
+        if (ir.tag[i] == IRTag::BINARY && rb.isLit(L) && rb.isLit(R)) {
+            OpId op = ir.op[i];
+            if (ops.kernel(op) != OpKernel::NONE)
+                return rb.literal(ops.apply(op, rb.out.value[L], rb.out.value[R]));
+        }
+        return rb.copy(i, L, R);
+    });
+}
+
+
+
+// ------------------------------------------------------
+// algebraic-simplify
+// ------------------------------------------------------
+size_t AlgebraicSimplifyPass::run(IRArena& ir, const OperatorTable& ops) const
+{
+    // 모든 x 에서 항등원인 0 은 x + (-0) 과 x - (+0) 뿐이다 (x = -0 이면 x + 0 = +0)
+    auto zero = [&](const Rebuild& rb, IRRef r, bool negative) {
+        return rb.isLit(r, 0) && (fastMath || std::signbit(rb.out.value[r]) == negative);
+    };
+
+    return rebuild(ir, [&](Rebuild& rb, IRRef i, IRRef L, IRRef R) -> IRRef {
+        if (ir.tag[i] != IRTag::BINARY) return rb.copy(i, L, R);
+
+        switch (ops.kernel(ir.op[i])) {
+            case OpKernel::ADD:
+                if (zero(rb, R, true)) return rb.forward(L);
+                if (zero(rb, L, true)) return rb.forward(R);
+                break;
+            case OpKernel::SUB:
+                if (zero(rb, R, false)) return rb.forward(L);
+                // x 가 NaN/Inf 면 NaN
+                if (fastMath && rb.same(L, R)) return rb.literal(0);
+                break;
+            case OpKernel::MUL:
+                if (rb.isLit(R, 1)) return rb.forward(L);
+                if (rb.isLit(L, 1)) return rb.forward(R);
+                // x 가 NaN/Inf 면 NaN, 음수면 -0
+                if (fastMath && (rb.isLit(R, 0) || rb.isLit(L, 0))) return rb.literal(0);
+                break;
+            case OpKernel::DIV:
+                if (rb.isLit(R, 1)) return rb.forward(L);
+                break;
+            case OpKernel::POW:
+                if (rb.isLit(R, 1)) return rb.forward(L);
+                if (rb.isLit(R, 0)) return rb.literal(1);
+                break;
+            case OpKernel::MIN:
+            case OpKernel::MAX:
+                if (rb.same(L, R)) return rb.forward(L);
+                break;
+            default:
+                break;
+        }
+        return rb.copy(i, L, R);
+    });
+}
+
+
+
+// ------------------------------------------------------
+// strength-reduce
+// ------------------------------------------------------
+size_t StrengthReducePass::run(IRArena& ir, const OperatorTable& ops) const
+{
+    // 대체 연산자가 현재 팩에 있어야만 바꿀 수 있다
+    OpId addOp = ops.findKernel(OpKernel::ADD);
+    OpId mulOp = ops.findKernel(OpKernel::MUL);
+
+    return rebuild(ir, [&](Rebuild& rb, IRRef i, IRRef L, IRRef R) -> IRRef {
+        if (ir.tag[i] != IRTag::BINARY) return rb.copy(i, L, R);
+
+        switch (ops.kernel(ir.op[i])) {
+            // op(x, x) 는 x 가 잎일 때만: 서브트리면 두 자리가 같은 노드를 가리키는 DAG 가 되고
+            // 트리를 훑는 백엔드는 x 를 두 번 (중첩되면 지수적으로) 계산한다
+            case OpKernel::POW:
+                if (mulOp != OP_NONE && rb.isLit(R, 2) && rb.isLeaf(L))
+                    return rb.binary(mulOp, L, L);
+                break;
+            case OpKernel::MUL:
+                if (addOp != OP_NONE && rb.isLit(R, 2) && rb.isLeaf(L)) return rb.binary(addOp, L, L);
+                if (addOp != OP_NONE && rb.isLit(L, 2) && rb.isLeaf(R)) return rb.binary(addOp, R, R);
+                break;
+            case OpKernel::DIV:
+                // 2 의 거듭제곱으로 나누기만 (역수가 정확히 표현됨).
+                // 서브노멀 c 는 역수가 inf 로 넘치므로 (0 / c → 0 * inf = NaN) 역수도 정규수여야 한다
+                if (mulOp != OP_NONE && rb.isLit(R)) {
+                    double c = rb.out.value[R];
+                    int e = 0;
+                    if (c != 0 && std::isfinite(c) && std::frexp(c, &e) == 0.5 &&
+                        std::isnormal(1.0 / c)) {
+                        IRRef inv = rb.literal(1.0 / c);
+                        return rb.binary(mulOp, L, inv);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+        return rb.copy(i, L, R);
+    });
+}
+
+
+
+// ------------------------------------------------------
+// cse
+// ------------------------------------------------------
+size_t CommonSubexprPass::run(IRArena& ir, const OperatorTable&) const
+{
+    thread_local IRHashCons cons;
+    cons.reset();
+
+    // 자식이 이미 합쳐져 있으므로 노드 하나씩만 비교하면 된다
+    return rebuild(ir, [&](Rebuild& rb, IRRef i, IRRef L, IRRef R) -> IRRef {
+        IRRef n = rb.copy(i, L, R);
+        IRRef same = cons.intern(rb.out, n);
+        if (same == n) return n;
+        rb.drop();
+        rb.out.shared = true;
+        return rb.forward(same);
+    });
+}
+
+
+
+// ------------------------------------------------------
+// dead-node-elim
+// ------------------------------------------------------
+size_t DeadNodeElimPass::run(IRArena& ir, const OperatorTable& ops) const
+{
+    if (ir.root == IR_NONE) return 0;
+
+    // 자식 < 부모 이므로 뒤에서부터 한 번 훑으면 도달성 계산 끝
+    thread_local std::vector<uint8_t> live;
+    live.assign(ir.size(), 0);
+    live[ir.root] = 1;
+
+    size_t dead = 0;
+    for (size_t k = ir.size(); k-- > 0; ) {
+        if (!live[k]) { dead++; continue; }
+        if (ir.tag[k] == IRTag::BINARY) {
+            live[ir.lhs[k]] = 1;
+            live[ir.rhs[k]] = 1;
+        }
+    }
+    if (dead == 0) return 0;
+
+    rebuild(ir, [&](Rebuild& rb, IRRef i, IRRef L, IRRef R) -> IRRef {
+        return rb.copy(i, L, R);
+    }, &live);
+    return dead;
+}
+
+
+
+// ------------------------------------------------------
+// PassManager
+// ------------------------------------------------------
+void PassManager::add(std::unique_ptr<IRPass> pass)
+{
+    passes.push_back(std::move(pass));
+}
+
+PassManager PassManager::standard()
+{
+    PassManager pm;
+    pm.add(std::make_unique<ConstantFoldPass>());
+    pm.add(std::make_unique<AlgebraicSimplifyPass>());
+    pm.add(std::make_unique<StrengthReducePass>());
+    pm.add(std::make_unique<ConstantFoldPass>());
+    pm.add(std::make_unique<DeadNodeElimPass>());
+    return pm;
+}
+
+size_t PassManager::run(IRArena& ir, const OperatorTable& ops,
+                        std::vector<PassStats>* stats) const
+{
+    SPONGE_PHASE(OPTIMIZE);
+    if (stats && stats->size() != passes.size()) {
+        stats->resize(passes.size());
+        for (size_t i = 0; i < passes.size(); ++i)
+            (*stats)[i].name = passes[i]->name();
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < passes.size(); ++i) {
+        if (!stats) {
+            total += passes[i]->run(ir, ops);
+            continue;
+        }
+
+        PassStats& s = (*stats)[i];
+        s.nodesBefore += ir.size();
+
+        auto t0 = std::chrono::steady_clock::now();
+        size_t changed = passes[i]->run(ir, ops);
+        auto t1 = std::chrono::steady_clock::now();
+
+        s.runs++;
+        s.changes += changed;
+        s.nodesAfter += ir.size();
+        s.nanos += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        total += changed;
+    }
+    SPONGE_COUNT(IR_NODES_OPT, ir.size());
+    return total;
+}
+
+} // namespace sponge
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+struct PassStats {
+    std::string name;
+    uint64_t runs = 0;
+    uint64_t changes = 0;       // 다시 쓴 노드 수
+    uint64_t nodesBefore = 0;
+    uint64_t nodesAfter = 0;
+    uint64_t nanos = 0;
+};
+
+/**
+ * IR 최적화 패스 인터페이스.
+ * run() 은 아레나를 제자리에서 바꾸고 변경한 노드 수를 반환한다.
+ * 결과 아레나도 "자식 인덱스 < 부모 인덱스" 불변식을 지켜야 한다.
+ */
+class IRPass {
+public:
+    virtual ~IRPass() = default;
+    virtual const char* name() const = 0;
+    virtual size_t run(IRArena& ir, const OperatorTable& ops) const = 0;
+};
+
+// 양쪽이 literal 인 연산을 흡수된 평가 규칙으로 미리 계산
+class ConstantFoldPass : public IRPass {
+public:
+    const char* name() const override { return "constant-fold"; }
+    size_t run(IRArena& ir, const OperatorTable& ops) const override;
+};
+
+// 항등원 제거: x+(-0), x-0, x*1, x/1, x^1 → x / x^0 → 1 (IEEE 결과 그대로).
+// fastMath 를 켜야 NaN/Inf/-0 에서 결과가 달라지는 x+0 → x, x*0 → 0, x-x → 0 도 한다.
+class AlgebraicSimplifyPass : public IRPass {
+public:
+    explicit AlgebraicSimplifyPass(bool fastMath = false) : fastMath(fastMath) {}
+
+    const char* name() const override { return "algebraic-simplify"; }
+    size_t run(IRArena& ir, const OperatorTable& ops) const override;
+
+private:
+    bool fastMath;
+};
+
+// 강도 감소: x^2 → x*x, x*2 → x+x (x 가 리터럴/변수일 때만), x/2^k → x*2^-k
+class StrengthReducePass : public IRPass {
+public:
+    const char* name() const override { return "strength-reduce"; }
+    size_t run(IRArena& ir, const OperatorTable& ops) const override;
+};
+
+// 공통 부분식 제거: 구조가 같은 노드를 하나로 합친다 (MetaParser::hashCons 와 같은 DAG).
+// 접기/단순화 뒤에 같아진 서브트리도 합쳐지므로 dead-node-elim 앞에 둔다.
+class CommonSubexprPass : public IRPass {
+public:
+    const char* name() const override { return "cse"; }
+    size_t run(IRArena& ir, const OperatorTable& ops) const override;
+};
+
+// 루트에서 닿지 않는 노드 제거 (아레나 압축)
+class DeadNodeElimPass : public IRPass {
+public:
+    const char* name() const override { return "dead-node-elim"; }
+    size_t run(IRArena& ir, const OperatorTable& ops) const override;
+};
+
+/**
+ * 패스 파이프라인.
+ * run() 은 const 이고 통계는 호출자가 넘긴 stats 에만 쌓인다
+ * (배치 워커처럼 여러 스레드가 같은 파이프라인을 돌릴 수 있음).
+ */
+class PassManager {
+public:
+    void add(std::unique_ptr<IRPass> pass);
+    void clear() { passes.clear(); }
+    bool empty() const { return passes.empty(); }
+
+    // fold → simplify → strength-reduce → fold → dce
+    static PassManager standard();
+
+    // stats 가 있으면 패스별로 누적 (크기는 자동으로 맞춤)
+    size_t run(IRArena& ir, const OperatorTable& ops,
+               std::vector<PassStats>* stats = nullptr) const;
+
+private:
+    std::vector<std::unique_ptr<IRPass>> passes;
+};
+
+} // namespace sponge
@@ -0,0 +1,176 @@
+#include "meta_pipeline.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "meta_engine.hpp"
+
+namespace sponge {
+
+namespace {
+
+// 비어 있는 버퍼를 되돌려 받아 쓰고, 없으면 새로 만든다 (큰 버퍼의 mmap/munmap 반복 방지)
+std::string takeBuffer(BoundedQueue<std::string>& spare, size_t reserve)
+{
+    std::string s;
+    if (!spare.tryPop(s)) s.reserve(reserve);
+    s.clear();
+    return s;
+}
+
+// 예외를 잡아 두고 큐를 닫아서 다른 단계가 기다리다 멈추지 않게 한다
+struct StageError {
+    std::mutex mutex;
+    std::exception_ptr first;
+
+    void capture() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!first) first = std::current_exception();
+    }
+};
+
+} // namespace
+
+PipelineStats runPipeline(SpongeMetaEngine& eng, std::FILE* in, std::FILE* out,
+                          const PipelineOptions& options)
+{
+    const size_t chunk = std::max<size_t>(options.chunkBytes, 4096);
+    const size_t depth = std::max<size_t>(options.queueDepth, 1);
+
+    BoundedQueue<std::string> inputs(depth), outputs(depth);
+    // 되돌려 받는 버퍼. 새 버퍼는 spare 가 비었을 때만 만들므로 한 종류가
+    // depth + 2 개 (생산자 1 + 큐 depth + 소비자 1) 를 넘지 않아 push 가 막히지 않는다.
+    BoundedQueue<std::string> spareIn(depth + 2), spareOut(depth + 2);
+
+    PipelineStats stats;
+    StageError error;
+    uint64_t bytesIn = 0, bytesOut = 0;
+
+    // ---- reader: 줄 경계에서 자른 chunk ----
+    std::thread reader([&] {
+        try {
+            std::string carry;
+            for (;;) {
+                std::string buf = takeBuffer(spareIn, chunk + carry.size());
+                buf.assign(carry);
+                size_t have = buf.size();
+                buf.resize(have + chunk);
+                size_t n = std::fread(buf.data() + have, 1, chunk, in);
+                buf.resize(have + n);
+                bytesIn += n;
+
+                if (n == 0) {
+                    if (std::ferror(in)) throw std::runtime_error("read error");
+                    if (!buf.empty() && !inputs.push(std::move(buf))) return;
+                    break;
+                }
+
+                // 한 줄이 chunk 보다 길면 다음 읽기와 이어 붙인다
+                size_t cut = buf.rfind('\n');
+                if (cut == std::string::npos) {
+                    carry.swap(buf);
+                    continue;
+                }
+                carry.assign(buf, cut + 1, std::string::npos);
+                buf.resize(cut + 1);
+                if (!inputs.push(std::move(buf))) return;
+            }
+        } catch (...) {
+            error.capture();
+        }
+        inputs.close();
+    });
+
+    // ---- writer ----
+    std::thread writer([&] {
+        try {
+            std::string text;
+            while (outputs.pop(text)) {
+                if (std::fwrite(text.data(), 1, text.size(), out) != text.size())
+                    throw std::runtime_error("write error");
+                bytesOut += text.size();
+                spareOut.push(std::move(text));
+            }
+            if (std::fflush(out) != 0) throw std::runtime_error("write error");
+        } catch (...) {
+            error.capture();
+            // 더 쓸 수 없으니 앞 단계를 멈춘다
+            outputs.close();
+            inputs.close();
+        }
+    });
+
+    // ---- 파싱 + 평가 (이 스레드) ----
+    try {
+        std::string text;
+        uint64_t base = 0;      // 이전 chunk 까지의 줄 수
+        while (inputs.pop(text)) {
+            std::string res = takeBuffer(spareOut, text.size());
+            size_t written = 0;     // 이 chunk 에서 출력한 줄 수
+
+            // 빈 줄 (runStream 이 건너뛴 줄) 을 채워 입력과 줄을 맞춘다
+            auto padTo = [&](size_t lineNo) {
+                if (lineNo > written + 1) res.append(lineNo - 1 - written, '\n');
+                written = lineNo;
+            };
+
+            std::function<void(size_t, const std::string&)> onError;
+            if (options.onError) {
+                onError = [&](size_t lineNo, const std::string& msg) {
+                    padTo(lineNo);
+                    res += "nan\n";
+                    stats.errors++;
+                    options.onError(base + lineNo, msg);
+                };
+            }
+
+            try {
+                stats.expressions += eng.runStream(text, [&](size_t lineNo, double v) {
+                    padTo(lineNo);
+                    char num[32];
+                    auto r = std::to_chars(num, num + sizeof(num), v, std::chars_format::general, 6);
+                    res.append(num, size_t(r.ptr - num));
+                    res += '\n';
+                }, onError);
+            } catch (const std::exception& e) {
+                // "line N: …" 를 전체 입력 기준 줄 번호로 고쳐서 던진다
+                std::string msg = e.what();
+                size_t colon = msg.find(": ");
+                if (msg.rfind("line ", 0) == 0 && colon != std::string::npos) {
+                    uint64_t local = std::strtoull(msg.c_str() + 5, nullptr, 10);
+                    msg = "line " + std::to_string(base + local) + msg.substr(colon);
+                }
+                throw std::runtime_error(msg);
+            }
+
+            size_t lines = size_t(std::count(text.begin(), text.end(), '\n'));
+            if (!text.empty() && text.back() != '\n') lines++;
+            if (lines > written) res.append(lines - written, '\n');
+            base += lines;
+
+            spareIn.push(std::move(text));
+            if (!outputs.push(std::move(res))) break;
+        }
+        stats.lines = base;
+    } catch (...) {
+        error.capture();
+        inputs.close();
+    }
+
+    outputs.close();
+    // reader 가 push 에서 기다리고 있을 수 있다
+    inputs.close();
+    reader.join();
+    writer.join();
+
+    if (error.first) std::rethrow_exception(error.first);
+    stats.bytesIn = bytesIn;
+    stats.bytesOut = bytesOut;
+    return stats;
+}
+
+} // namespace sponge
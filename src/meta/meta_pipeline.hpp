@@ -0,0 +1,99 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace sponge {
+
+class SpongeMetaEngine;
+
+/**
+ * 크기 제한 있는 다중 생산자/소비자 큐.
+ * push() 는 가득 차 있으면 기다리고 (뒤 단계가 느리면 앞 단계도 멈춘다),
+ * close() 뒤에는 push() 가 false, pop() 은 남은 것을 다 꺼낸 뒤 false.
+ */
+template<class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : cap(capacity ? capacity : 1) {}
+
+    bool push(T v) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return closed || items.size() < cap; });
+        if (closed) return false;
+        items.push_back(std::move(v));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool pop(T& v) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        v = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // 기다리지 않는다 (비어 있으면 false)
+    bool tryPop(T& v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) return false;
+        v = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+    std::deque<T> items;
+    size_t cap;
+    bool closed = false;
+};
+
+struct PipelineOptions {
+    size_t chunkBytes = size_t(1) << 20;    // 한 번에 읽는 양 (줄 경계에서 자름)
+    size_t queueDepth = 4;                  // 단계 사이에 쌓일 수 있는 chunk 수
+
+    // 잘못된 줄 (평가 스레드에서 호출). 없으면 첫 오류에서 runtime_error.
+    std::function<void(uint64_t lineNo, const std::string& error)> onError;
+};
+
+struct PipelineStats {
+    uint64_t lines = 0;         // 빈 줄 포함
+    uint64_t expressions = 0;   // 평가에 성공한 줄
+    uint64_t errors = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+};
+
+/**
+ * 줄마다 식 하나인 입력을 읽어 결과를 줄마다 하나씩 쓰는 3 단계 파이프라인.
+ *
+ *   reader 스레드 — in 에서 chunkBytes 씩 읽어 마지막 줄바꿈에서 자른다
+ *   호출 스레드   — eng.runStream() 으로 파싱 + 평가, 결과를 텍스트로 모은다
+ *   writer 스레드 — 모인 텍스트를 out 에 한 번에 fwrite
+ *
+ * 단계 사이는 queueDepth 짜리 BoundedQueue 이고, 버퍼는 되돌려 받아 재사용한다.
+ * 출력은 입력 줄과 1:1 (빈 줄 → 빈 줄, 오류 줄 → "nan") 이고
+ * 값은 std::ostream 기본 서식 (%g) 으로 쓴다.
+ */
+PipelineStats runPipeline(SpongeMetaEngine& eng, std::FILE* in, std::FILE* out,
+                          const PipelineOptions& options = {});
+
+} // namespace sponge
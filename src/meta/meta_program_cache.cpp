@@ -0,0 +1,99 @@
+#include "meta_program_cache.hpp"
+
+#include <string_view>
+
+namespace sponge {
+
+ProgramCache::ProgramCache(size_t capacity)
+    : cap(capacity)
+{
+}
+
+uint64_t ProgramCache::makeKey(const std::string& src, uint64_t packKey) {
+    uint64_t h = std::hash<std::string_view>{}(src);
+    // 팩 세대를 섞는다 (splitmix64 상수)
+    return h ^ (packKey * 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2));
+}
+
+
+
+// ------------------------------------------------------
+// 조회 (hit 이면 LRU 맨 앞으로)
+// ------------------------------------------------------
+std::shared_ptr<CompiledProgram> ProgramCache::find(
+    const std::string& src, uint64_t packKey)
+{
+    auto it = index.find(makeKey(src, packKey));
+    if (it == index.end() || it->second->packKey != packKey || it->second->src != src) {
+        counters.misses++;
+        return nullptr;
+    }
+
+    lru.splice(lru.begin(), lru, it->second);
+    counters.hits++;
+    return it->second->prog;
+}
+
+
+
+// ------------------------------------------------------
+// 등록
+// ------------------------------------------------------
+void ProgramCache::insert(const std::string& src, uint64_t packKey,
+                          std::shared_ptr<CompiledProgram> prog)
+{
+    if (cap == 0) return;
+
+    uint64_t key = makeKey(src, packKey);
+
+    // 같은 키 (또는 해시 충돌) → 덮어쓰기
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->packKey = packKey;
+        it->second->src = src;
+        it->second->prog = std::move(prog);
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+
+    lru.push_front(Entry{ key, packKey, src, std::move(prog) });
+    index[key] = lru.begin();
+    evictOverflow();
+}
+
+void ProgramCache::evictOverflow() {
+    while (lru.size() > cap) {
+        index.erase(lru.back().key);
+        lru.pop_back();
+        counters.evictions++;
+    }
+}
+
+
+
+// ------------------------------------------------------
+// 무효화 / 설정 / 통계
+// ------------------------------------------------------
+void ProgramCache::invalidate() {
+    if (!lru.empty()) counters.invalidations++;
+    lru.clear();
+    index.clear();
+}
+
+void ProgramCache::setCapacity(size_t n) {
+    cap = n;
+    evictOverflow();
+}
+
+ProgramCacheStats ProgramCache::stats() const {
+    ProgramCacheStats s = counters;
+    s.size = lru.size();
+    s.capacity = cap;
+    return s;
+}
+
+void ProgramCache::resetStats() {
+    counters = ProgramCacheStats{};
+}
+
+} // namespace sponge
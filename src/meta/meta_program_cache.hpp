@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "meta_ir.hpp"
+#include "meta_vm.hpp"
+#include "meta_closure.hpp"
+
+namespace sponge {
+
+class JitFunction;
+
+/**
+ * 파싱/컴파일이 끝난 프로그램 하나.
+ * bc / closure / jit 은 각각 VM / CLOSURE / JIT 모드에서 처음 필요할 때 채워진다.
+ */
+struct CompiledProgram {
+    IRArena ir;
+    Bytecode bc;
+    bool hasBytecode = false;
+
+    ClosureProgram closure;   // empty() 면 아직 컴파일 전
+
+    std::shared_ptr<JitFunction> jit;
+    bool jitTried = false;   // JIT 실패 시 다시 시도하지 않고 VM 으로
+};
+
+struct ProgramCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+/**
+ * 소스 텍스트 → CompiledProgram LRU 캐시.
+ *
+ * 키 = hash(src) ⊕ packKey (언어팩 스냅샷 세대).
+ * 해시 충돌은 저장된 소스 문자열과 packKey 비교로 걸러낸다
+ * (언어 여러 개가 같은 소스를 각자 컴파일해 함께 들어 있을 수 있다).
+ * capacity 0 이면 아무것도 저장하지 않는다.
+ */
+class ProgramCache {
+public:
+    explicit ProgramCache(size_t capacity = 256);
+
+    // 없으면 nullptr (miss 카운트)
+    std::shared_ptr<CompiledProgram> find(const std::string& src, uint64_t packKey);
+
+    // 새 프로그램 등록, 필요하면 가장 오래된 항목을 evict
+    void insert(const std::string& src, uint64_t packKey,
+                std::shared_ptr<CompiledProgram> prog);
+
+    // 언어팩 변경 등으로 전체 무효화
+    void invalidate();
+
+    void setCapacity(size_t n);
+    size_t capacity() const { return cap; }
+
+    ProgramCacheStats stats() const;
+    void resetStats();
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t packKey;
+        std::string src;
+        std::shared_ptr<CompiledProgram> prog;
+    };
+
+    size_t cap;
+    std::list<Entry> lru;   // front = 최근 사용
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+    ProgramCacheStats counters;
+
+    static uint64_t makeKey(const std::string& src, uint64_t packKey);
+    void evictOverflow();
+};
+
+} // namespace sponge
@@ -0,0 +1,316 @@
+#include "meta_program_file.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace sponge {
+
+namespace {
+
+size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace
+
+// 네 갈래로 나눠 곱셈 지연을 겹친다 (FNV 처럼 바이트마다 곱하면 큰 소스에서 느림)
+uint64_t hashBytes(std::string_view bytes)
+{
+    constexpr uint64_t K = 0x9E3779B97F4A7C15ull;
+    const char* p = bytes.data();
+    size_t n = bytes.size();
+
+    uint64_t h[4] = { K, K ^ 1, K ^ 2, K ^ 3 };
+    for (; n >= 32; p += 32, n -= 32) {
+        for (int i = 0; i < 4; ++i) {
+            uint64_t w;
+            std::memcpy(&w, p + 8 * i, 8);
+            h[i] = (h[i] ^ w) * K;
+            h[i] ^= h[i] >> 29;
+        }
+    }
+
+    uint64_t out = bytes.size();
+    for (int i = 0; i < 4; ++i) out = mix(out ^ h[i]);
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        out = mix(out ^ w);
+    }
+
+    uint64_t tail = 0;
+    if (n) std::memcpy(&tail, p, n);
+    return mix(out ^ tail ^ (uint64_t(n) << 56));
+}
+
+
+
+// ------------------------------------------------------
+// IR → .spbc
+// ------------------------------------------------------
+uint32_t ProgramFileWriter::intern(const std::string& s)
+{
+    auto it = stringIds.find(s);
+    if (it != stringIds.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.push_back(s);
+    stringIds.emplace(s, id);
+    return id;
+}
+
+void ProgramFileWriter::add(uint32_t line, const IRArena& ir, const OperatorTable& table)
+{
+    if (ir.root >= ir.size())
+        throw std::runtime_error("[ProgramFile] empty IR");
+
+    records.push_back({ line, static_cast<uint32_t>(tags.size()), static_cast<uint32_t>(ir.size()),
+                        ir.root, static_cast<uint32_t>(vars.size()),
+                        static_cast<uint32_t>(ir.vars.size()),
+                        ir.shared ? uint32_t(PROGRAM_SHARED) : 0u, 0u });
+
+    for (IRRef i = 0; i < ir.size(); ++i) {
+        uint16_t op = 0;
+        if (ir.tag[i] == IRTag::BINARY) {
+            OpId id = ir.op[i];
+            if (id >= opIndex.size()) opIndex.resize(size_t(id) + 1, OP_NONE);
+            if (opIndex[id] == OP_NONE) {
+                opIndex[id] = static_cast<uint16_t>(opNames.size());
+                opNames.push_back(intern(table.name(id)));
+            }
+            op = opIndex[id];
+        }
+        tags.push_back(static_cast<uint8_t>(ir.tag[i]));
+        ops.push_back(op);
+        values.push_back(ir.value[i]);
+        lhs.push_back(ir.lhs[i]);
+        rhs.push_back(ir.rhs[i]);
+    }
+
+    for (auto& v : ir.vars) vars.push_back(intern(v));
+}
+
+void ProgramFileWriter::write(const std::string& path, uint64_t sourceHash,
+                              uint64_t sourceSize, uint64_t packFingerprint) const
+{
+    ProgramFileHeader header{};
+    std::memcpy(header.magic, kProgramMagic, sizeof(kProgramMagic));
+    header.version = kProgramVersion;
+    header.byteOrder = kProgramByteOrder;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    header.packFingerprint = packFingerprint;
+
+    std::vector<PackString> table;
+    std::string blob;
+    for (auto& s : strings) {
+        table.push_back({ static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(s.size()) });
+        blob += s;
+        blob += '\0';
+    }
+
+    // 레이아웃 (8 바이트 정렬)
+    size_t offset = sizeof(ProgramFileHeader);
+    auto place = [&](uint32_t& off, size_t n, size_t elem) {
+        off = static_cast<uint32_t>(offset);
+        offset += align8(n * elem);
+    };
+    header.programCount = static_cast<uint32_t>(records.size());
+    header.nodeCount = static_cast<uint32_t>(tags.size());
+    header.opNameCount = static_cast<uint32_t>(opNames.size());
+    header.varCount = static_cast<uint32_t>(vars.size());
+    header.stringCount = static_cast<uint32_t>(table.size());
+    header.blobSize = static_cast<uint32_t>(blob.size());
+
+    place(header.programsOffset, records.size(), sizeof(ProgramRecord));
+    place(header.valuesOffset, values.size(), sizeof(double));
+    place(header.lhsOffset, lhs.size(), sizeof(uint32_t));
+    place(header.rhsOffset, rhs.size(), sizeof(uint32_t));
+    place(header.opsOffset, ops.size(), sizeof(uint16_t));
+    place(header.tagsOffset, tags.size(), sizeof(uint8_t));
+    place(header.opNamesOffset, opNames.size(), sizeof(uint32_t));
+    place(header.varsOffset, vars.size(), sizeof(uint32_t));
+    place(header.stringsOffset, table.size(), sizeof(PackString));
+    place(header.blobOffset, blob.size(), 1);
+    header.fileSize = offset;
+
+    if (offset > UINT32_MAX)
+        throw std::runtime_error("[ProgramFile] cache too large: " + path);
+
+    std::vector<unsigned char> out(offset, 0);
+    auto put = [&](uint32_t off, const void* src, size_t bytes) {
+        if (bytes) std::memcpy(out.data() + off, src, bytes);
+    };
+    put(header.programsOffset, records.data(), records.size() * sizeof(ProgramRecord));
+    put(header.valuesOffset, values.data(), values.size() * sizeof(double));
+    put(header.lhsOffset, lhs.data(), lhs.size() * sizeof(uint32_t));
+    put(header.rhsOffset, rhs.data(), rhs.size() * sizeof(uint32_t));
+    put(header.opsOffset, ops.data(), ops.size() * sizeof(uint16_t));
+    put(header.tagsOffset, tags.data(), tags.size());
+    put(header.opNamesOffset, opNames.data(), opNames.size() * sizeof(uint32_t));
+    put(header.varsOffset, vars.data(), vars.size() * sizeof(uint32_t));
+    put(header.stringsOffset, table.data(), table.size() * sizeof(PackString));
+    put(header.blobOffset, blob.data(), blob.size());
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    header.checksum = hashBytes(std::string_view(
+        reinterpret_cast<const char*>(out.data()) + kProgramChecksumFrom,
+        out.size() - kProgramChecksumFrom));
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f.is_open())
+            throw std::runtime_error("[ProgramFile] Cannot write cache: " + path);
+        f.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+        if (!f)
+            throw std::runtime_error("[ProgramFile] Cannot write cache: " + path);
+    }
+    std::filesystem::rename(tmp, path);
+}
+
+
+
+// ------------------------------------------------------
+// .spbc 로드 (mmap)
+// ------------------------------------------------------
+bool ProgramImage::isCompiled(std::string_view bytes)
+{
+    return bytes.size() >= sizeof(kProgramMagic) &&
+           std::memcmp(bytes.data(), kProgramMagic, sizeof(kProgramMagic)) == 0;
+}
+
+ProgramImage::ProgramImage(const std::string& path)
+    : file(path)
+{
+    try {
+        validate();
+    } catch (const std::exception& e) {
+        throw std::runtime_error("[ProgramImage] " + path + ": " + e.what());
+    }
+}
+
+void ProgramImage::validate()
+{
+    std::string_view bytes = file.view();
+    const char* base = bytes.data();
+
+    if (bytes.size() < sizeof(ProgramFileHeader) || !isCompiled(bytes))
+        throw std::runtime_error("not a program cache");
+
+    header = reinterpret_cast<const ProgramFileHeader*>(base);
+    if (header->version != kProgramVersion)
+        throw std::runtime_error("unsupported cache version " + std::to_string(header->version));
+    if (header->byteOrder != kProgramByteOrder)
+        throw std::runtime_error("cache was built with a different byte order");
+    if (header->fileSize != bytes.size())
+        throw std::runtime_error("truncated cache");
+
+    auto section = [&](uint32_t off, uint64_t count, size_t elem) {
+        if (off % 8 != 0 || off < sizeof(ProgramFileHeader) ||
+            off + count * elem > bytes.size())
+            throw std::runtime_error("section out of range");
+        return base + off;
+    };
+    const uint32_t nodes = header->nodeCount;
+    records = reinterpret_cast<const ProgramRecord*>(section(header->programsOffset, header->programCount, sizeof(ProgramRecord)));
+    values  = reinterpret_cast<const double*>(section(header->valuesOffset, nodes, sizeof(double)));
+    lhs     = reinterpret_cast<const uint32_t*>(section(header->lhsOffset, nodes, sizeof(uint32_t)));
+    rhs     = reinterpret_cast<const uint32_t*>(section(header->rhsOffset, nodes, sizeof(uint32_t)));
+    ops     = reinterpret_cast<const uint16_t*>(section(header->opsOffset, nodes, sizeof(uint16_t)));
+    tags    = reinterpret_cast<const uint8_t*>(section(header->tagsOffset, nodes, 1));
+    opNames = reinterpret_cast<const uint32_t*>(section(header->opNamesOffset, header->opNameCount, sizeof(uint32_t)));
+    vars    = reinterpret_cast<const uint32_t*>(section(header->varsOffset, header->varCount, sizeof(uint32_t)));
+    strings = reinterpret_cast<const PackString*>(section(header->stringsOffset, header->stringCount, sizeof(PackString)));
+    blob    = section(header->blobOffset, header->blobSize, 1);
+
+    uint64_t sum = hashBytes(bytes.substr(kProgramChecksumFrom));
+    if (sum != header->checksum)
+        throw std::runtime_error("checksum mismatch");
+
+    // 여기부터는 체크섬이 맞으므로 구조 검사만 (load() 가 범위를 다시 보지 않도록)
+    for (uint32_t i = 0; i < header->stringCount; ++i) {
+        if (uint64_t(strings[i].offset) + strings[i].length + 1 > header->blobSize)
+            throw std::runtime_error("string out of range");
+    }
+    for (uint32_t i = 0; i < header->opNameCount; ++i)
+        if (opNames[i] >= header->stringCount) throw std::runtime_error("bad string id");
+    for (uint32_t i = 0; i < header->varCount; ++i)
+        if (vars[i] >= header->stringCount) throw std::runtime_error("bad string id");
+
+    for (uint32_t p = 0; p < header->programCount; ++p) {
+        const ProgramRecord& r = records[p];
+        if (uint64_t(r.nodeBegin) + r.nodeCount > nodes || r.root >= r.nodeCount ||
+            uint64_t(r.varBegin) + r.varCount > header->varCount)
+            throw std::runtime_error("program out of range");
+
+        for (uint32_t j = 0; j < r.nodeCount; ++j) {
+            uint32_t k = r.nodeBegin + j;
+            switch (static_cast<IRTag>(tags[k])) {
+                case IRTag::LITERAL:
+                    break;
+                case IRTag::BINARY:
+                    // 자식 < 부모 (평가기/패스가 기대하는 위상 순서)
+                    if (lhs[k] >= j || rhs[k] >= j || ops[k] >= header->opNameCount)
+                        throw std::runtime_error("bad node");
+                    break;
+                case IRTag::VAR:
+                    if (lhs[k] >= r.varCount) throw std::runtime_error("bad variable slot");
+                    break;
+                default:
+                    throw std::runtime_error("bad node tag");
+            }
+        }
+    }
+}
+
+std::string_view ProgramImage::str(uint32_t id) const
+{
+    const PackString& s = strings[id];
+    return { blob + s.offset, s.length };
+}
+
+bool ProgramImage::mapOperators(const OperatorTable& table, std::vector<OpId>& out) const
+{
+    out.resize(header->opNameCount);
+    for (uint32_t i = 0; i < header->opNameCount; ++i) {
+        out[i] = table.find(str(opNames[i]));
+        if (out[i] == OP_NONE) return false;
+    }
+    return true;
+}
+
+void ProgramImage::load(size_t i, const std::vector<OpId>& opMap, IRArena& out) const
+{
+    const ProgramRecord& r = records[i];
+    const uint32_t b = r.nodeBegin, n = r.nodeCount;
+
+    out.clear();
+    out.tag.resize(n);
+    out.op.resize(n);
+    for (uint32_t j = 0; j < n; ++j) {
+        IRTag t = static_cast<IRTag>(tags[b + j]);
+        out.tag[j] = t;
+        out.op[j] = t == IRTag::BINARY ? opMap[ops[b + j]] : OP_NONE;
+    }
+    out.value.assign(values + b, values + b + n);
+    out.lhs.assign(lhs + b, lhs + b + n);
+    out.rhs.assign(rhs + b, rhs + b + n);
+
+    for (uint32_t k = 0; k < r.varCount; ++k)
+        out.vars.emplace_back(str(vars[r.varBegin + k]));
+    out.root = r.root;
+    out.shared = (r.flags & PROGRAM_SHARED) != 0;
+}
+
+} // namespace sponge
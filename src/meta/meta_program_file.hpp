@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "meta_ir.hpp"
+#include "meta_mapped_file.hpp"
+#include "meta_ops.hpp"
+#include "meta_pack_binary.hpp"
+
+namespace sponge {
+
+// ------------------------------------------------------
+// 컴파일된 식 파일 캐시 (.spbc) 디스크 형식
+//
+//   [ProgramFileHeader]
+//   [ProgramRecord × programCount]  줄 번호 + 노드/변수 범위
+//   [double   × nodeCount]          literal 값
+//   [uint32_t × nodeCount]          lhs (VAR 면 변수 슬롯)
+//   [uint32_t × nodeCount]          rhs
+//   [uint16_t × nodeCount]          연산자 (파일 안 번호 → opNames)
+//   [uint8_t  × nodeCount]          IRTag
+//   [uint32_t × opNameCount]        파일 안 연산자 번호 → 문자열 id
+//   [uint32_t × varCount]           변수 이름 문자열 id
+//   [PackString × stringCount]      blob 안의 (offset, length)
+//   [string blob]
+//
+// 노드 ref 는 프로그램 안에서의 번호 (자식 < 부모).
+// 연산자 id 는 팩마다 다를 수 있어 이름으로 저장하고 읽을 때 다시 찾는다.
+// 최적화 전 IR 을 담으므로 패스 설정/평가 함수는 캐시 키에 들어가지 않는다.
+//
+// 캐시 키 = (sourceHash, sourceSize, packFingerprint). 하나라도 다르면 낡은 캐시.
+// 정수는 만든 머신의 바이트 순서 그대로, checksum 은 checksum 필드 뒤 전체
+// (나머지 헤더 필드 + 본문) 에 대한 hashBytes(). 앞쪽 필드는 값으로 검사한다.
+// ------------------------------------------------------
+constexpr char     kProgramMagic[8]  = { 'S', 'P', 'O', 'N', 'G', 'E', 'B', 'C' };
+constexpr uint32_t kProgramVersion   = 3;
+constexpr uint32_t kProgramByteOrder = 0x01020304;
+
+struct ProgramFileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint64_t checksum;
+
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint64_t packFingerprint;
+
+    uint32_t programCount, programsOffset;
+    uint32_t nodeCount;
+    uint32_t valuesOffset, lhsOffset, rhsOffset, opsOffset, tagsOffset;
+    uint32_t opNameCount, opNamesOffset;
+    uint32_t varCount,    varsOffset;
+    uint32_t stringCount, stringsOffset;
+    uint32_t blobOffset,  blobSize;
+};
+
+enum ProgramFlags : uint32_t {
+    PROGRAM_SHARED = 1,                 // IRArena::shared (hash-consing 으로 만든 DAG)
+};
+
+struct ProgramRecord {
+    uint32_t line;                      // 소스의 줄 번호 (1 부터)
+    uint32_t nodeBegin, nodeCount;
+    uint32_t root;                      // 프로그램 안 번호
+    uint32_t varBegin, varCount;
+    uint32_t flags;                     // ProgramFlags
+    uint32_t reserved;
+};
+
+static_assert(sizeof(ProgramFileHeader) % 8 == 0);
+static_assert(sizeof(ProgramRecord) == 32);
+
+// checksum 이 덮는 범위의 시작 (헤더의 개수 / 오프셋 필드도 포함)
+constexpr size_t kProgramChecksumFrom = offsetof(ProgramFileHeader, sourceHash);
+
+// 큰 버퍼용 64 비트 해시 (8 바이트 단위, 소스 내용 키와 파일 checksum)
+uint64_t hashBytes(std::string_view bytes);
+
+
+
+/**
+ * 파싱된 IR 을 모아 .spbc 파일로 쓴다.
+ * add() 는 IR 을 복사해 두므로 같은 아레나를 다시 써도 된다.
+ * 한 파일에 넣는 IR 은 모두 같은 OperatorTable 로 만든 것이어야 한다.
+ */
+class ProgramFileWriter {
+public:
+    void add(uint32_t line, const IRArena& ir, const OperatorTable& ops);
+
+    size_t size() const { return records.size(); }
+
+    // 임시 파일에 쓴 뒤 rename (읽는 쪽은 반쯤 쓰인 파일을 보지 않는다). 실패하면 runtime_error.
+    void write(const std::string& path, uint64_t sourceHash, uint64_t sourceSize,
+               uint64_t packFingerprint) const;
+
+private:
+    std::vector<ProgramRecord> records;
+    std::vector<double> values;
+    std::vector<uint32_t> lhs, rhs;
+    std::vector<uint16_t> ops;
+    std::vector<uint8_t> tags;
+    std::vector<uint32_t> vars;
+
+    // 문자열 (연산자/변수 이름) 은 한 번만 저장
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIds;
+    std::vector<uint32_t> opNames;      // 파일 안 연산자 번호 → 문자열 id
+    std::vector<uint16_t> opIndex;      // 팩 OpId → 파일 안 번호 (OP_NONE = 아직 없음)
+
+    uint32_t intern(const std::string& s);
+};
+
+/**
+ * mmap 된 .spbc 파일. 로드 시 헤더/범위/체크섬/노드 구조를 검사하고
+ * 이후에는 파일 내용을 복사 없이 읽는다. 손상되었거나 버전이 다르면 runtime_error.
+ */
+class ProgramImage {
+public:
+    explicit ProgramImage(const std::string& path);
+
+    ProgramImage(const ProgramImage&) = delete;
+    ProgramImage& operator=(const ProgramImage&) = delete;
+
+    static bool isCompiled(std::string_view bytes);
+
+    bool matches(uint64_t sourceHash, uint64_t sourceSize, uint64_t packFingerprint) const {
+        return header->sourceHash == sourceHash && header->sourceSize == sourceSize &&
+               header->packFingerprint == packFingerprint;
+    }
+
+    size_t programCount() const { return header->programCount; }
+    uint32_t line(size_t i) const { return records[i].line; }
+
+    /**
+     * 파일 안 연산자 번호 → ops 의 OpId 를 out 에 채운다.
+     * ops 에 없는 이름이 있으면 false (지문이 같으면 생기지 않지만 낡은 캐시로 취급).
+     */
+    bool mapOperators(const OperatorTable& ops, std::vector<OpId>& out) const;
+
+    // 프로그램 i 를 out 에 복사 (opMap = mapOperators() 결과)
+    void load(size_t i, const std::vector<OpId>& opMap, IRArena& out) const;
+
+    size_t size() const { return file.size(); }
+
+private:
+    MappedFile file;
+    const ProgramFileHeader* header = nullptr;
+    const ProgramRecord* records = nullptr;
+    const double* values = nullptr;
+    const uint32_t* lhs = nullptr;
+    const uint32_t* rhs = nullptr;
+    const uint16_t* ops = nullptr;
+    const uint8_t* tags = nullptr;
+    const uint32_t* opNames = nullptr;
+    const uint32_t* vars = nullptr;
+    const PackString* strings = nullptr;
+    const char* blob = nullptr;
+
+    std::string_view str(uint32_t id) const;
+    void validate();
+};
+
+} // namespace sponge
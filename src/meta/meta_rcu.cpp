@@ -0,0 +1,129 @@
+#include "meta_rcu.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace sponge {
+
+namespace {
+
+// 스레드 하나의 읽기 상태. 스레드가 끝나면 슬롯은 재사용되고 해제되지 않는다.
+struct alignas(64) Reader {
+    std::atomic<uint64_t> epoch{ 0 };   // 0 = 읽기 구간 밖
+    std::atomic<bool> inUse{ true };
+    uint32_t nest = 0;
+    Reader* next = nullptr;
+};
+
+std::atomic<uint64_t> gEpoch{ 1 };
+std::atomic<Reader*> gReaders{ nullptr };
+
+struct Retired {
+    uint64_t epoch;
+    std::function<void()> free;
+};
+
+std::mutex gRetiredMutex;
+std::vector<Retired> gRetired;
+
+Reader* acquireReader()
+{
+    for (Reader* r = gReaders.load(std::memory_order_acquire); r; r = r->next) {
+        bool expected = false;
+        if (!r->inUse.load(std::memory_order_relaxed) &&
+            r->inUse.compare_exchange_strong(expected, true))
+            return r;
+    }
+
+    Reader* r = new Reader;
+    Reader* head = gReaders.load(std::memory_order_relaxed);
+    do {
+        r->next = head;
+    } while (!gReaders.compare_exchange_weak(head, r,
+                 std::memory_order_release, std::memory_order_relaxed));
+    return r;
+}
+
+struct ThreadReader {
+    Reader* r = acquireReader();
+    ~ThreadReader() {
+        r->epoch.store(0, std::memory_order_release);
+        r->inUse.store(false, std::memory_order_release);
+    }
+};
+
+Reader& localReader()
+{
+    thread_local ThreadReader tr;
+    return *tr.r;
+}
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// 읽기 구간
+// ------------------------------------------------------
+Rcu::ReadGuard::ReadGuard()
+{
+    Reader& r = localReader();
+    if (r.nest++ == 0) {
+        // 포인터를 읽기 전에 epoch 공지가 보여야 한다 (둘 다 seq_cst)
+        r.epoch.store(gEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+Rcu::ReadGuard::~ReadGuard()
+{
+    Reader& r = localReader();
+    if (--r.nest == 0)
+        r.epoch.store(0, std::memory_order_release);
+}
+
+
+
+// ------------------------------------------------------
+// retire / reclaim
+// ------------------------------------------------------
+void Rcu::retire(std::function<void()> free)
+{
+    // 교체 후 epoch 를 올린다: 옛 포인터를 읽은 구간은 모두 epoch <= e
+    uint64_t e = gEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+    std::lock_guard<std::mutex> lk(gRetiredMutex);
+    gRetired.push_back({ e, std::move(free) });
+}
+
+size_t Rcu::reclaim()
+{
+    // 활성 읽기 구간 중 가장 오래된 epoch
+    uint64_t oldest = UINT64_MAX;
+    for (Reader* r = gReaders.load(std::memory_order_acquire); r; r = r->next) {
+        uint64_t e = r->epoch.load(std::memory_order_seq_cst);
+        if (e != 0 && e < oldest) oldest = e;
+    }
+
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lk(gRetiredMutex);
+        auto keep = gRetired.begin();
+        for (auto it = gRetired.begin(); it != gRetired.end(); ++it) {
+            if (it->epoch < oldest) ready.push_back(std::move(*it));
+            else *keep++ = std::move(*it);
+        }
+        gRetired.erase(keep, gRetired.end());
+    }
+
+    // 해제는 락 밖에서 (소멸자가 다시 retire 할 수도 있다)
+    for (auto& r : ready) r.free();
+    return ready.size();
+}
+
+size_t Rcu::pending()
+{
+    std::lock_guard<std::mutex> lk(gRetiredMutex);
+    return gRetired.size();
+}
+
+} // namespace sponge
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace sponge {
+
+/**
+ * 프로세스 전역 epoch 기반 RCU.
+ *
+ * 읽는 쪽은 ReadGuard 구간 안에서 포인터를 읽는다. 구간 진입/탈출은
+ * 스레드별 슬롯에 epoch 를 적고 지우는 것뿐이라 락도 대기도 없다.
+ * 쓰는 쪽은 포인터를 바꾼 뒤 옛 객체를 retire() 로 넘기고,
+ * reclaim() 은 그 객체를 볼 수 있었던 읽기 구간이 모두 끝난 것만 해제한다.
+ *
+ * ReadGuard 는 중첩해도 된다 (바깥 구간만 epoch 를 기록).
+ */
+class Rcu {
+public:
+    class ReadGuard {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    // 지금 이전에 시작된 읽기 구간이 다 끝난 뒤 free 를 호출하도록 예약
+    static void retire(std::function<void()> free);
+
+    // 안전해진 retire 항목들을 해제하고 개수를 반환
+    static size_t reclaim();
+
+    // 아직 해제되지 않은 retire 항목 수
+    static size_t pending();
+};
+
+/**
+ * RCU 로 교체되는 불변 객체 하나 (shared_ptr<const T>).
+ *
+ *   load()    — 락 없이 현재 값을 pin (참조 카운트 +1)
+ *   peek()    — ReadGuard 구간 안에서만 유효한 raw 포인터 (카운트 없음)
+ *   publish() — 원자적 교체. 옛 값은 RCU 로 미뤄서 놓는다.
+ *
+ * 옛 값을 load() 로 pin 한 쪽은 publish 이후에도 계속 안전하게 쓴다.
+ */
+template <typename T>
+class RcuCell {
+public:
+    RcuCell() = default;
+    ~RcuCell() {
+        // 셀을 지우는 시점에는 이 셀을 읽는 스레드가 없어야 한다
+        delete cur.load(std::memory_order_acquire);
+        Rcu::reclaim();
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    std::shared_ptr<const T> load() const {
+        Rcu::ReadGuard guard;
+        const Holder* h = cur.load(std::memory_order_seq_cst);
+        return h ? h->value : nullptr;
+    }
+
+    const T* peek() const {
+        const Holder* h = cur.load(std::memory_order_seq_cst);
+        return h ? h->value.get() : nullptr;
+    }
+
+    void publish(std::shared_ptr<const T> value) {
+        Holder* h = new Holder{ std::move(value) };
+        Holder* old = cur.exchange(h, std::memory_order_seq_cst);
+        if (old) Rcu::retire([old] { delete old; });
+        Rcu::reclaim();
+    }
+
+private:
+    struct Holder {
+        std::shared_ptr<const T> value;
+    };
+
+    std::atomic<Holder*> cur{ nullptr };
+};
+
+} // namespace sponge
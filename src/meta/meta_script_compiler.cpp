@@ -0,0 +1,590 @@
+#include "meta_script_compiler.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sponge {
+
+namespace {
+
+constexpr uint32_t kMaxOperand = 0xFFFF;
+
+[[noreturn]] void fail(uint32_t line, const std::string& msg)
+{
+    throw std::runtime_error("line " + std::to_string(line) + ": " + msg);
+}
+
+bool isLiteral(const ScriptExpr& e)
+{
+    return e.kind == ScriptExpr::NUMBER || e.kind == ScriptExpr::STRING;
+}
+
+// ------------------------------------------------------
+// 모듈 전체 상태 (함수/전역 이름표)
+// ------------------------------------------------------
+struct ModuleState {
+    ScriptProgram program;
+    std::unordered_map<std::string, uint16_t> functions;
+    std::unordered_map<std::string, uint16_t> globals;
+};
+
+// ------------------------------------------------------
+// 함수 하나 컴파일
+//
+// 레지스터: [0, active) 는 이름 있는 지역 변수 (블록 순서대로 쌓임),
+// 그 위는 식 계산용 임시. 문장이 끝나면 임시는 모두 풀린다.
+// ------------------------------------------------------
+class FunctionCompiler {
+public:
+    FunctionCompiler(ModuleState& m, ScriptFunction& fn, bool topLevel)
+        : m(m), fn(fn), topLevel(topLevel) {}
+
+    void params(const std::vector<std::string>& names, uint32_t line)
+    {
+        for (const auto& p : names) {
+            for (const auto& l : locals)
+                if (l.name == p) fail(line, "duplicate parameter '" + p + "'");
+            declare(p, alloc(line));
+        }
+        fn.params = uint16_t(names.size());
+    }
+
+    void body(const std::vector<ScriptStmtPtr>& stmts, uint32_t endLine)
+    {
+        for (const auto& s : stmts) statement(*s);
+        emit(ScriptOp::RETNIL, endLine);
+    }
+
+private:
+    struct Local {
+        std::string name;
+        uint16_t reg;
+    };
+
+    struct Loop {
+        std::vector<size_t> breaks, continues;
+    };
+
+    ModuleState& m;
+    ScriptFunction& fn;
+    bool topLevel;
+
+    std::vector<Local> locals;
+    uint16_t active = 0;                // 이름 있는 지역 변수 레지스터 수
+    uint16_t freeReg = 0;
+    size_t blockDepth = 0;
+    std::vector<Loop> loops;
+
+    std::unordered_map<std::string, uint16_t> stringConsts;
+    std::unordered_map<uint64_t, uint16_t> numberConsts;    // double 비트 패턴
+    int boolConsts[2] = { -1, -1 };
+
+    // ---- 명령 / 레지스터 / 상수 ----
+    size_t emit(ScriptOp op, uint32_t line, uint16_t a = 0, uint16_t b = 0, uint16_t c = 0)
+    {
+        if (fn.code.size() >= kMaxOperand) fail(line, "function '" + fn.name + "' is too large");
+        fn.code.push_back({ op, a, b, c });
+        fn.lines.push_back(line);
+        return fn.code.size() - 1;
+    }
+
+    uint16_t here() const { return uint16_t(fn.code.size()); }
+
+    void patch(const std::vector<size_t>& jumps, uint16_t target)
+    {
+        for (size_t j : jumps) fn.code[j].c = target;
+    }
+
+    uint16_t alloc(uint32_t line)
+    {
+        if (freeReg >= kMaxOperand) fail(line, "too many registers in '" + fn.name + "'");
+        uint16_t r = freeReg++;
+        if (freeReg > fn.registers) fn.registers = freeReg;
+        return r;
+    }
+
+    void declare(const std::string& name, uint16_t reg)
+    {
+        locals.push_back({ name, reg });
+        active = uint16_t(reg + 1);
+        freeReg = active;
+    }
+
+    uint16_t addConstant(ScriptValue v, uint32_t line)
+    {
+        if (fn.constants.size() >= kMaxOperand) fail(line, "too many constants in '" + fn.name + "'");
+        fn.constants.push_back(std::move(v));
+        return uint16_t(fn.constants.size() - 1);
+    }
+
+    uint16_t numberConstant(double d, uint32_t line)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof bits);
+        auto it = numberConsts.find(bits);
+        if (it != numberConsts.end()) return it->second;
+        return numberConsts[bits] = addConstant(ScriptValue::number(d), line);
+    }
+
+    uint16_t constant(const ScriptExpr& e)
+    {
+        switch (e.kind) {
+            case ScriptExpr::NUMBER:
+                return numberConstant(e.number, e.line);
+            case ScriptExpr::STRING: {
+                auto it = stringConsts.find(e.text);
+                if (it != stringConsts.end()) return it->second;
+                return stringConsts[e.text] = addConstant(ScriptValue::string(e.text), e.line);
+            }
+            default: {
+                int& slot = boolConsts[e.number != 0.0];
+                if (slot < 0) slot = addConstant(ScriptValue::boolean(e.number != 0.0), e.line);
+                return uint16_t(slot);
+            }
+        }
+    }
+
+    // ---- 이름 ----
+    const Local* findLocal(const std::string& name) const
+    {
+        for (auto it = locals.rbegin(); it != locals.rend(); ++it)
+            if (it->name == name) return &*it;
+        return nullptr;
+    }
+
+    int findGlobal(const std::string& name) const
+    {
+        auto it = m.globals.find(name);
+        return it == m.globals.end() ? -1 : it->second;
+    }
+
+    [[noreturn]] void undefined(const ScriptExpr& e) const
+    {
+        if (m.functions.count(e.text))
+            fail(e.line, "function '" + e.text + "' can only be called");
+        fail(e.line, "undefined variable '" + e.text + "'");
+    }
+
+    // ---- 문장 ----
+    void block(const std::vector<ScriptStmtPtr>& stmts)
+    {
+        const size_t savedLocals = locals.size();
+        const uint16_t savedActive = active;
+        ++blockDepth;
+        for (const auto& s : stmts) statement(*s);
+        --blockDepth;
+        locals.resize(savedLocals);
+        active = savedActive;
+        freeReg = active;
+    }
+
+    void statement(const ScriptStmt& s)
+    {
+        freeReg = active;
+        switch (s.kind) {
+            case ScriptStmt::LET:
+                if (topLevel && blockDepth == 0) {
+                    uint16_t r = anyReg(*s.value);
+                    emit(ScriptOp::SETG, s.line, r, m.globals.at(s.name));
+                } else {
+                    // 값을 먼저 계산 (let x = x + 1 은 바깥 x 를 읽는다)
+                    uint16_t r = alloc(s.line);
+                    exprTo(*s.value, r);
+                    declare(s.name, r);
+                }
+                break;
+
+            case ScriptStmt::ASSIGN:
+                assign(s);
+                break;
+
+            case ScriptStmt::EXPR:
+                effect(*s.value);
+                break;
+
+            case ScriptStmt::IF: {
+                std::vector<size_t> otherwise;
+                condJump(*s.cond, false, otherwise);
+                block(s.body);
+                if (s.orelse.empty()) {
+                    patch(otherwise, here());
+                    break;
+                }
+                size_t end = emit(ScriptOp::JMP, s.line);
+                patch(otherwise, here());
+                block(s.orelse);
+                patch({ end }, here());
+                break;
+            }
+
+            case ScriptStmt::WHILE: {
+                // 조건을 본문 뒤에 두어 한 바퀴에 분기 하나 (JMP 는 처음 들어갈 때만)
+                //   JMP cond; body: ...; cond: 참이면 body 로
+                size_t enter = emit(ScriptOp::JMP, s.line);
+                const uint16_t top = here();
+                loops.emplace_back();
+                block(s.body);
+                patch({ enter }, here());
+                patch(loops.back().continues, here());
+                std::vector<size_t> again;
+                condJump(*s.cond, true, again);
+                patch(again, top);
+                patch(loops.back().breaks, here());
+                loops.pop_back();
+                break;
+            }
+
+            case ScriptStmt::RETURN:
+                if (s.value) emit(ScriptOp::RET, s.line, anyReg(*s.value));
+                else emit(ScriptOp::RETNIL, s.line);
+                break;
+
+            case ScriptStmt::PUSH: {
+                uint16_t list = anyReg(*s.target);
+                uint16_t v = anyReg(*s.value);
+                emit(ScriptOp::PUSH, s.line, list, v);
+                break;
+            }
+
+            case ScriptStmt::POP:
+                emit(ScriptOp::POP, s.line, anyReg(*s.target));
+                break;
+
+            case ScriptStmt::BREAK:
+                if (loops.empty()) fail(s.line, "'break' outside a loop");
+                loops.back().breaks.push_back(emit(ScriptOp::JMP, s.line));
+                break;
+
+            case ScriptStmt::CONTINUE:
+                if (loops.empty()) fail(s.line, "'continue' outside a loop");
+                loops.back().continues.push_back(emit(ScriptOp::JMP, s.line));
+                break;
+        }
+        freeReg = active;
+    }
+
+    void assign(const ScriptStmt& s)
+    {
+        const ScriptExpr& t = *s.target;
+        if (t.kind == ScriptExpr::INDEX) {
+            uint16_t c = anyReg(*t.kids[0]);
+            uint16_t k = anyReg(*t.kids[1]);
+            uint16_t v = anyReg(*s.value);
+            emit(ScriptOp::SETINDEX, s.line, c, k, v);
+            return;
+        }
+        if (const Local* l = findLocal(t.text)) {
+            // cur = concat(cur, c) 가 CONCAT2 cur cur c 로 내려가 제자리에 붙는다
+            exprTo(*s.value, l->reg);
+            return;
+        }
+        int g = findGlobal(t.text);
+        if (g < 0) undefined(t);
+        emit(ScriptOp::SETG, s.line, anyReg(*s.value), uint16_t(g));
+    }
+
+    // 값을 쓰지 않는 식 문장 (print(..) 은 결과 nil 을 만들지 않는다)
+    void effect(const ScriptExpr& e)
+    {
+        if (e.kind == ScriptExpr::CALL && e.text == "print" && !m.functions.count(e.text)) {
+            uint16_t base = args(e);
+            emit(ScriptOp::PRINT, e.line, base, uint16_t(e.kids.size()));
+            return;
+        }
+        anyReg(e);
+    }
+
+    // ---- 식 ----
+
+    // 값이 들어 있는 레지스터 (지역 변수면 복사 없이 그 레지스터)
+    uint16_t anyReg(const ScriptExpr& e)
+    {
+        if (e.kind == ScriptExpr::NAME)
+            if (const Local* l = findLocal(e.text)) return l->reg;
+        uint16_t r = alloc(e.line);
+        exprTo(e, r);
+        return r;
+    }
+
+    // 인자를 새 임시 레지스터에 연달아 계산, 첫 번호를 돌려준다
+    uint16_t args(const ScriptExpr& e)
+    {
+        uint16_t base = freeReg;
+        for (const auto& a : e.kids) exprTo(*a, alloc(a->line));
+        return base;
+    }
+
+    void exprTo(const ScriptExpr& e, uint16_t dst)
+    {
+        const uint16_t saved = freeReg;
+        switch (e.kind) {
+            case ScriptExpr::NIL:
+                emit(ScriptOp::LOADNIL, e.line, dst);
+                break;
+            case ScriptExpr::BOOL:
+            case ScriptExpr::NUMBER:
+            case ScriptExpr::STRING:
+                emit(ScriptOp::LOADK, e.line, dst, constant(e));
+                break;
+            case ScriptExpr::NAME: {
+                if (const Local* l = findLocal(e.text)) {
+                    if (l->reg != dst) emit(ScriptOp::MOVE, e.line, dst, l->reg);
+                    break;
+                }
+                int g = findGlobal(e.text);
+                if (g < 0) undefined(e);
+                emit(ScriptOp::GETG, e.line, dst, uint16_t(g));
+                break;
+            }
+            case ScriptExpr::LIST:
+                emit(ScriptOp::NEWLIST, e.line, dst, args(e), uint16_t(e.kids.size()));
+                break;
+            case ScriptExpr::MAP:
+                emit(ScriptOp::NEWMAP, e.line, dst, args(e), uint16_t(e.kids.size() / 2));
+                break;
+            case ScriptExpr::INDEX: {
+                uint16_t c = anyReg(*e.kids[0]);
+                uint16_t k = anyReg(*e.kids[1]);
+                emit(ScriptOp::INDEX, e.line, dst, c, k);
+                break;
+            }
+            case ScriptExpr::CALL:
+                call(e, dst);
+                break;
+            case ScriptExpr::NEG:
+                emit(ScriptOp::NEG, e.line, dst, anyReg(*e.kids[0]));
+                break;
+            case ScriptExpr::NOT:
+                emit(ScriptOp::NOT, e.line, dst, anyReg(*e.kids[0]));
+                break;
+            case ScriptExpr::BINARY:
+                binary(e.op, *e.kids[0], *e.kids[1], dst, e.line);
+                break;
+        }
+        freeReg = saved;
+    }
+
+    void binary(ScriptBinOp op, const ScriptExpr& l, const ScriptExpr& r, uint16_t dst, uint32_t line)
+    {
+        switch (op) {
+            case ScriptBinOp::AND:
+            case ScriptBinOp::OR: {
+                // 왼쪽 값을 dst 에 먼저 쓰므로 dst 가 지역 변수면 (x = y or x) 임시를 거친다
+                const uint16_t t = dst < active ? alloc(line) : dst;
+                exprTo(l, t);
+                size_t skip = emit(op == ScriptBinOp::OR ? ScriptOp::JT : ScriptOp::JF, line, t);
+                exprTo(r, t);
+                patch({ skip }, here());
+                if (t != dst) emit(ScriptOp::MOVE, line, dst, t);
+                return;
+            }
+            case ScriptBinOp::ADD:
+            case ScriptBinOp::SUB:
+                if (r.kind == ScriptExpr::NUMBER) {
+                    double k = op == ScriptBinOp::ADD ? r.number : -r.number;
+                    emit(ScriptOp::ADDK, line, dst, anyReg(l), numberConstant(k, line));
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // > >= 는 피연산자를 바꿔 LT LE 로
+        const bool swap = op == ScriptBinOp::GT || op == ScriptBinOp::GE;
+        uint16_t a = anyReg(l);
+        uint16_t b = anyReg(r);
+        if (swap) std::swap(a, b);
+
+        ScriptOp code = ScriptOp::ADD;
+        switch (op) {
+            case ScriptBinOp::ADD: code = ScriptOp::ADD; break;
+            case ScriptBinOp::SUB: code = ScriptOp::SUB; break;
+            case ScriptBinOp::MUL: code = ScriptOp::MUL; break;
+            case ScriptBinOp::DIV: code = ScriptOp::DIV; break;
+            case ScriptBinOp::MOD: code = ScriptOp::MOD; break;
+            case ScriptBinOp::EQ:  code = ScriptOp::EQ; break;
+            case ScriptBinOp::NE:  code = ScriptOp::NE; break;
+            case ScriptBinOp::LT:
+            case ScriptBinOp::GT:  code = ScriptOp::LT; break;
+            case ScriptBinOp::LE:
+            case ScriptBinOp::GE:  code = ScriptOp::LE; break;
+            default: break;
+        }
+        emit(code, line, dst, a, b);
+    }
+
+    void expectArgs(const ScriptExpr& e, size_t n) const
+    {
+        if (e.kids.size() != n) fail(e.line, scriptArityMessage(e.text, n, e.kids.size()));
+    }
+
+    void call(const ScriptExpr& e, uint16_t dst)
+    {
+        auto fit = m.functions.find(e.text);
+        if (fit != m.functions.end()) {
+            const ScriptFunction& callee = m.program.functions[fit->second];
+            expectArgs(e, callee.params);
+            // dst 가 방금 잡은 임시면 그 자리에서 인자를 시작해 결과 MOVE 를 없앤다
+            if (dst >= active && dst + 1 == freeReg) freeReg = dst;
+            uint16_t base = args(e);
+            if (base == freeReg) alloc(e.line);             // 인자 없는 호출의 결과 자리
+            emit(ScriptOp::CALL, e.line, base, fit->second, uint16_t(e.kids.size()));
+            if (base != dst) emit(ScriptOp::MOVE, e.line, dst, base);
+            return;
+        }
+
+        const std::string& f = e.text;
+        if (f == "len") {
+            expectArgs(e, 1);
+            emit(ScriptOp::LEN, e.line, dst, anyReg(*e.kids[0]));
+        } else if (f == "char_at") {
+            expectArgs(e, 2);
+            uint16_t s = anyReg(*e.kids[0]);
+            uint16_t i = anyReg(*e.kids[1]);
+            emit(ScriptOp::CHARAT, e.line, dst, s, i);
+        } else if (f == "concat") {
+            if (e.kids.size() == 2) {
+                uint16_t a = anyReg(*e.kids[0]);
+                uint16_t b = anyReg(*e.kids[1]);
+                emit(ScriptOp::CONCAT2, e.line, dst, a, b);
+            } else {
+                emit(ScriptOp::CONCAT, e.line, dst, args(e), uint16_t(e.kids.size()));
+            }
+        } else if (f == "add" || f == "sub") {
+            expectArgs(e, 2);
+            binary(f == "add" ? ScriptBinOp::ADD : ScriptBinOp::SUB, *e.kids[0], *e.kids[1], dst, e.line);
+        } else if (f == "has") {
+            expectArgs(e, 2);
+            uint16_t c = anyReg(*e.kids[0]);
+            uint16_t k = anyReg(*e.kids[1]);
+            emit(ScriptOp::HAS, e.line, dst, c, k);
+        } else if (f == "print") {
+            emit(ScriptOp::PRINT, e.line, args(e), uint16_t(e.kids.size()));
+            emit(ScriptOp::LOADNIL, e.line, dst);
+        } else {
+            fail(e.line, "unknown function '" + f + "'");
+        }
+    }
+
+    // ---- 조건 분기 ----
+
+    // e 의 참/거짓이 when 과 같으면 점프 (점프 위치를 out 에 모아 나중에 대상 지정)
+    void condJump(const ScriptExpr& e, bool when, std::vector<size_t>& out)
+    {
+        const uint16_t saved = freeReg;
+        if (e.kind == ScriptExpr::NOT) {
+            condJump(*e.kids[0], !when, out);
+            return;
+        }
+        if (e.kind != ScriptExpr::BINARY) {
+            out.push_back(emit(when ? ScriptOp::JT : ScriptOp::JF, e.line, anyReg(e)));
+            freeReg = saved;
+            return;
+        }
+
+        const ScriptExpr& l = *e.kids[0];
+        const ScriptExpr& r = *e.kids[1];
+        switch (e.op) {
+            case ScriptBinOp::OR:
+            case ScriptBinOp::AND: {
+                // or 는 하나라도 참이면 참으로 점프, and 는 하나라도 거짓이면 거짓으로 점프
+                const bool shortCircuit = e.op == ScriptBinOp::OR;
+                if (when == shortCircuit) {
+                    condJump(l, when, out);
+                    condJump(r, when, out);
+                } else {
+                    std::vector<size_t> skip;
+                    condJump(l, !when, skip);
+                    condJump(r, when, out);
+                    patch(skip, here());
+                }
+                return;
+            }
+            case ScriptBinOp::EQ:
+            case ScriptBinOp::NE: {
+                const bool equal = (e.op == ScriptBinOp::EQ) == when;
+                if (isLiteral(r) || isLiteral(l)) {
+                    const ScriptExpr& k = isLiteral(r) ? r : l;
+                    const ScriptExpr& v = isLiteral(r) ? l : r;
+                    uint16_t a = anyReg(v);
+                    out.push_back(emit(equal ? ScriptOp::JEQK : ScriptOp::JNEK, e.line, a, constant(k)));
+                } else {
+                    uint16_t a = anyReg(l);
+                    uint16_t b = anyReg(r);
+                    out.push_back(emit(equal ? ScriptOp::JEQ : ScriptOp::JNE, e.line, a, b));
+                }
+                break;
+            }
+            case ScriptBinOp::LT:
+            case ScriptBinOp::LE:
+            case ScriptBinOp::GT:
+            case ScriptBinOp::GE: {
+                const bool swap = e.op == ScriptBinOp::GT || e.op == ScriptBinOp::GE;
+                const bool strict = e.op == ScriptBinOp::LT || e.op == ScriptBinOp::GT;
+                uint16_t a = anyReg(l);
+                uint16_t b = anyReg(r);
+                if (swap) std::swap(a, b);
+                ScriptOp op = strict ? (when ? ScriptOp::JLT : ScriptOp::JNLT)
+                                     : (when ? ScriptOp::JLE : ScriptOp::JNLE);
+                out.push_back(emit(op, e.line, a, b));
+                break;
+            }
+            default:
+                out.push_back(emit(when ? ScriptOp::JT : ScriptOp::JF, e.line, anyReg(e)));
+                break;
+        }
+        freeReg = saved;
+    }
+};
+
+// 맨 위 let 이 만드는 전역 (함수 안에서 앞으로 참조할 수 있도록 먼저 모은다)
+void collectGlobals(const ScriptModule& module, ModuleState& m)
+{
+    for (const auto& s : module.top) {
+        if (s->kind != ScriptStmt::LET || m.globals.count(s->name)) continue;
+        if (m.globals.size() >= kMaxOperand) fail(s->line, "too many globals");
+        m.globals.emplace(s->name, uint16_t(m.program.globals.size()));
+        m.program.globals.push_back(s->name);
+    }
+}
+
+} // namespace
+
+ScriptProgram compileScript(const ScriptModule& module)
+{
+    ModuleState m;
+    if (module.functions.size() >= kMaxOperand) throw std::runtime_error("too many functions");
+
+    // 함수 번호를 먼저 정해 두어 정의 순서와 상관없이 호출할 수 있다
+    auto& fns = m.program.functions;
+    fns.resize(module.functions.size() + 1);
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        const auto& d = module.functions[i];
+        if (!m.functions.emplace(d.name, uint16_t(i)).second)
+            fail(d.line, "function '" + d.name + "' is already defined");
+        fns[i].name = d.name;
+        fns[i].params = uint16_t(d.params.size());
+    }
+    collectGlobals(module, m);
+
+    for (size_t i = 0; i < module.functions.size(); ++i) {
+        const auto& d = module.functions[i];
+        FunctionCompiler fc(m, fns[i], false);
+        fc.params(d.params, d.line);
+        fc.body(d.body, d.body.empty() ? d.line : d.body.back()->line);
+    }
+
+    const uint16_t top = uint16_t(module.functions.size());
+    fns[top].name = "<top>";
+    FunctionCompiler fc(m, fns[top], true);
+    fc.body(module.top, module.top.empty() ? 1 : module.top.back()->line);
+
+    m.program.topLevel = top;
+    auto it = m.functions.find("main");
+    m.program.mainFunction = it == m.functions.end() ? -1 : it->second;
+    return std::move(m.program);
+}
+
+} // namespace sponge
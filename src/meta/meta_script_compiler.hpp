@@ -0,0 +1,23 @@
+#pragma once
+#include "meta_script_parser.hpp"
+#include "meta_script_vm.hpp"
+
+namespace sponge {
+
+/**
+ * ScriptModule → ScriptProgram (레지스터 바이트코드).
+ *
+ * 지역 변수는 레지스터에 바로 두고 (블록이 끝나면 레지스터를 돌려준다),
+ * 맨 위의 let 만 전역 슬롯이 된다. 이름은 컴파일 때 모두 풀려서
+ * 실행 중 이름 조회가 없다.
+ *
+ * 조건식 (if/while, or/and/not, 비교) 은 값을 만들지 않고 JEQK/JNLT 같은
+ * 비교-분기 명령으로 바로 내리고, len/char_at/concat/add/sub/has/print 는
+ * 전용 명령으로 내린다.
+ *
+ * 정의되지 않은 변수/함수, 인자 수 불일치, 루프 밖 break 는
+ * "line N: 메시지" runtime_error.
+ */
+ScriptProgram compileScript(const ScriptModule& module);
+
+} // namespace sponge
@@ -0,0 +1,335 @@
+#include "meta_script_interp.hpp"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace sponge {
+
+namespace {
+
+// 호출마다 C++ 재귀가 여러 단계라 ScriptVM 보다 훨씬 얕게 끊는다
+constexpr size_t kMaxDepth = 2000;
+
+// 줄 번호가 이미 붙은 에러 (바깥 문장이 다시 붙이지 않도록)
+struct ScriptError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// 블록 밖으로 새어 나온 break / continue (컴파일러가 잡는 에러와 같은 문구)
+[[noreturn]] void outsideLoop(const ScriptStmt& s, bool isContinue)
+{
+    const char* what = isContinue ? "continue" : "break";
+    throw ScriptError("line " + std::to_string(s.line) + ": '" + what + "' outside a loop");
+}
+
+} // namespace
+
+ScriptInterpreter::ScriptInterpreter(const ScriptModule& module)
+    : ScriptInterpreter(module, std::cout) {}
+
+ScriptInterpreter::ScriptInterpreter(const ScriptModule& module, std::ostream& out)
+    : module(module), out(out)
+{
+    for (const auto& f : module.functions)
+        if (!functions.emplace(f.name, &f).second)
+            throw std::runtime_error("line " + std::to_string(f.line) + ": function '" + f.name +
+                                     "' is already defined");
+}
+
+void ScriptInterpreter::init()
+{
+    if (initialized) return;
+    initialized = true;
+    // 맨 위 문장은 스코프 없이 (let 이 전역이 된다)
+    for (const auto& s : module.top) {
+        Flow flow = statement(*s);
+        if (flow == Flow::RETURN) break;
+        if (flow != Flow::NORMAL) outsideLoop(*s, flow == Flow::CONTINUE);
+    }
+    returned = ScriptValue();
+}
+
+ScriptValue ScriptInterpreter::run()
+{
+    init();
+    auto it = functions.find("main");
+    if (it == functions.end()) return {};
+    return invoke(*it->second, {});
+}
+
+ScriptValue ScriptInterpreter::call(std::string_view function, std::vector<ScriptValue> args)
+{
+    auto it = functions.find(std::string(function));
+    if (it == functions.end()) throw std::runtime_error("Unknown function: " + std::string(function));
+    init();
+    return invoke(*it->second, std::move(args));
+}
+
+const ScriptValue& ScriptInterpreter::global(std::string_view name) const
+{
+    auto it = globals.find(std::string(name));
+    if (it == globals.end()) throw std::runtime_error("Unknown global: " + std::string(name));
+    return it->second;
+}
+
+ScriptValue ScriptInterpreter::invoke(const ScriptFunctionDecl& fn, std::vector<ScriptValue> args)
+{
+    if (args.size() != fn.params.size())
+        throw std::runtime_error(scriptArityMessage(fn.name, fn.params.size(), args.size()));
+    if (depth >= kMaxDepth) throw std::runtime_error("stack overflow");
+
+    // 호출마다 새 스코프 체인 (호출자의 지역 변수는 보이지 않는다)
+    std::vector<Scope> saved;
+    saved.swap(scopes);
+    scopes.emplace_back();
+    for (size_t i = 0; i < args.size(); ++i) scopes.back()[fn.params[i]] = std::move(args[i]);
+
+    ++depth;
+    try {
+        for (const auto& s : fn.body) {
+            Flow flow = statement(*s);
+            if (flow == Flow::RETURN) break;
+            if (flow != Flow::NORMAL) outsideLoop(*s, flow == Flow::CONTINUE);
+        }
+    } catch (...) {
+        --depth;
+        scopes.swap(saved);
+        throw;
+    }
+    --depth;
+    scopes.swap(saved);
+
+    ScriptValue r = std::move(returned);
+    returned = ScriptValue();
+    return r;
+}
+
+ScriptValue* ScriptInterpreter::lookup(const std::string& name)
+{
+    for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+        auto v = it->find(name);
+        if (v != it->end()) return &v->second;
+    }
+    auto g = globals.find(name);
+    return g == globals.end() ? nullptr : &g->second;
+}
+
+
+
+// ------------------------------------------------------
+// 문장
+// ------------------------------------------------------
+ScriptInterpreter::Flow ScriptInterpreter::block(const std::vector<ScriptStmtPtr>& stmts)
+{
+    scopes.emplace_back();
+    Flow flow = Flow::NORMAL;
+    try {
+        for (const auto& s : stmts) {
+            flow = statement(*s);
+            if (flow != Flow::NORMAL) break;
+        }
+    } catch (...) {
+        scopes.pop_back();
+        throw;
+    }
+    scopes.pop_back();
+    return flow;
+}
+
+ScriptInterpreter::Flow ScriptInterpreter::statement(const ScriptStmt& s)
+{
+    try {
+        return execute(s);
+    } catch (const ScriptError&) {
+        throw;
+    } catch (const std::exception& e) {
+        throw ScriptError("line " + std::to_string(s.line) + ": " + e.what());
+    }
+}
+
+ScriptInterpreter::Flow ScriptInterpreter::execute(const ScriptStmt& s)
+{
+    switch (s.kind) {
+        case ScriptStmt::LET: {
+            ScriptValue v = eval(*s.value);
+            (scopes.empty() ? globals : scopes.back())[s.name] = std::move(v);
+            return Flow::NORMAL;
+        }
+        case ScriptStmt::ASSIGN: {
+            const ScriptExpr& t = *s.target;
+            if (t.kind == ScriptExpr::INDEX) {
+                ScriptValue c = eval(*t.kids[0]);
+                ScriptValue k = eval(*t.kids[1]);
+                scriptSetIndex(c, k, eval(*s.value));
+                return Flow::NORMAL;
+            }
+            ScriptValue v = eval(*s.value);
+            ScriptValue* slot = lookup(t.text);
+            if (!slot) throw std::runtime_error("undefined variable '" + t.text + "'");
+            *slot = std::move(v);
+            return Flow::NORMAL;
+        }
+        case ScriptStmt::EXPR:
+            eval(*s.value);
+            return Flow::NORMAL;
+        case ScriptStmt::IF:
+            if (scriptTruthy(eval(*s.cond))) return block(s.body);
+            if (!s.orelse.empty()) return block(s.orelse);
+            return Flow::NORMAL;
+        case ScriptStmt::WHILE:
+            while (scriptTruthy(eval(*s.cond))) {
+                Flow flow = block(s.body);
+                if (flow == Flow::BREAK) break;
+                if (flow == Flow::RETURN) return flow;
+            }
+            return Flow::NORMAL;
+        case ScriptStmt::RETURN:
+            returned = s.value ? eval(*s.value) : ScriptValue();
+            return Flow::RETURN;
+        case ScriptStmt::PUSH: {
+            ScriptValue list = eval(*s.target);
+            scriptPush(list, eval(*s.value));
+            return Flow::NORMAL;
+        }
+        case ScriptStmt::POP:
+            scriptPop(eval(*s.target));
+            return Flow::NORMAL;
+        case ScriptStmt::BREAK:
+            return Flow::BREAK;
+        case ScriptStmt::CONTINUE:
+            return Flow::CONTINUE;
+    }
+    return Flow::NORMAL;
+}
+
+
+
+// ------------------------------------------------------
+// 식
+// ------------------------------------------------------
+ScriptValue ScriptInterpreter::eval(const ScriptExpr& e)
+{
+    switch (e.kind) {
+        case ScriptExpr::NIL:    return {};
+        case ScriptExpr::BOOL:   return ScriptValue::boolean(e.number != 0.0);
+        case ScriptExpr::NUMBER: return ScriptValue::number(e.number);
+        case ScriptExpr::STRING: return ScriptValue::string(e.text);
+        case ScriptExpr::NAME: {
+            if (ScriptValue* v = lookup(e.text)) return *v;
+            throw std::runtime_error("undefined variable '" + e.text + "'");
+        }
+        case ScriptExpr::LIST: {
+            std::vector<ScriptValue> items;
+            for (const auto& k : e.kids) items.push_back(eval(*k));
+            return ScriptValue::list(std::move(items));
+        }
+        case ScriptExpr::MAP: {
+            ScriptValue m = ScriptValue::map();
+            for (size_t i = 0; i + 1 < e.kids.size(); i += 2) {
+                ScriptValue k = eval(*e.kids[i]);
+                scriptSetIndex(m, k, eval(*e.kids[i + 1]));
+            }
+            return m;
+        }
+        case ScriptExpr::INDEX: {
+            ScriptValue c = eval(*e.kids[0]);
+            return scriptIndex(c, eval(*e.kids[1]));
+        }
+        case ScriptExpr::CALL:
+            return callExpr(e);
+        case ScriptExpr::NEG:
+            return ScriptValue::number(-scriptNumber(eval(*e.kids[0]), "negate"));
+        case ScriptExpr::NOT:
+            return ScriptValue::boolean(!scriptTruthy(eval(*e.kids[0])));
+        case ScriptExpr::BINARY:
+            break;
+    }
+
+    if (e.op == ScriptBinOp::AND || e.op == ScriptBinOp::OR) {
+        ScriptValue l = eval(*e.kids[0]);
+        if (scriptTruthy(l) == (e.op == ScriptBinOp::OR)) return l;
+        return eval(*e.kids[1]);
+    }
+
+    ScriptValue l = eval(*e.kids[0]);
+    ScriptValue r = eval(*e.kids[1]);
+    switch (e.op) {
+        case ScriptBinOp::EQ: return ScriptValue::boolean(scriptEquals(l, r));
+        case ScriptBinOp::NE: return ScriptValue::boolean(!scriptEquals(l, r));
+        case ScriptBinOp::LT: return ScriptValue::boolean(scriptLess(l, r));
+        case ScriptBinOp::LE: return ScriptValue::boolean(!scriptLess(r, l));
+        case ScriptBinOp::GT: return ScriptValue::boolean(scriptLess(r, l));
+        case ScriptBinOp::GE: return ScriptValue::boolean(!scriptLess(l, r));
+        default: break;
+    }
+
+    const char* what = "ADD";
+    switch (e.op) {
+        case ScriptBinOp::SUB: what = "SUB"; break;
+        case ScriptBinOp::MUL: what = "MUL"; break;
+        case ScriptBinOp::DIV: what = "DIV"; break;
+        case ScriptBinOp::MOD: what = "MOD"; break;
+        default: break;
+    }
+    double a = scriptNumber(l, what);
+    double b = scriptNumber(r, what);
+    switch (e.op) {
+        case ScriptBinOp::SUB: return ScriptValue::number(a - b);
+        case ScriptBinOp::MUL: return ScriptValue::number(a * b);
+        case ScriptBinOp::DIV: return ScriptValue::number(a / b);
+        case ScriptBinOp::MOD: return ScriptValue::number(std::fmod(a, b));
+        default:               return ScriptValue::number(a + b);
+    }
+}
+
+ScriptValue ScriptInterpreter::callExpr(const ScriptExpr& e)
+{
+    std::vector<ScriptValue> args;
+    args.reserve(e.kids.size());
+    for (const auto& k : e.kids) args.push_back(eval(*k));
+
+    auto it = functions.find(e.text);
+    if (it != functions.end()) return invoke(*it->second, std::move(args));
+
+    auto arity = [&](size_t n) {
+        if (args.size() != n) throw std::runtime_error(scriptArityMessage(e.text, n, args.size()));
+    };
+
+    const std::string& f = e.text;
+    if (f == "len") {
+        arity(1);
+        return scriptLength(args[0]);
+    }
+    if (f == "char_at") {
+        arity(2);
+        return scriptCharAt(args[0], args[1]);
+    }
+    if (f == "concat") {
+        std::string s;
+        for (const auto& a : args) scriptAppend(s, a);
+        return ScriptValue::string(std::move(s));
+    }
+    if (f == "add") {
+        arity(2);
+        return ScriptValue::number(scriptNumber(args[0], "ADD") + scriptNumber(args[1], "ADD"));
+    }
+    if (f == "sub") {
+        arity(2);
+        return ScriptValue::number(scriptNumber(args[0], "SUB") - scriptNumber(args[1], "SUB"));
+    }
+    if (f == "has") {
+        arity(2);
+        return ScriptValue::boolean(scriptHas(args[0], args[1]));
+    }
+    if (f == "print") {
+        std::string line;
+        for (const auto& a : args) scriptAppend(line, a);
+        line += '\n';
+        out << line;
+        return {};
+    }
+    throw std::runtime_error("unknown function '" + f + "'");
+}
+
+} // namespace sponge
@@ -0,0 +1,60 @@
+#pragma once
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "meta_script_parser.hpp"
+#include "meta_script_value.hpp"
+
+namespace sponge {
+
+/**
+ * AST 를 그대로 도는 .sp 인터프리터 (ScriptVM 의 비교 기준, spongelang run --interp).
+ *
+ * 변수는 블록마다 이름 → 값 맵에 두고 매번 이름으로 찾으며,
+ * 내장 함수도 호출할 때 이름으로 고른다. 값 규칙은 ScriptVM 과 같은
+ * meta_script_value 의 함수를 쓰므로 출력과 에러가 같다.
+ * (다른 점: 에러 메시지에 함수 이름이 없고 concat 은 항상 새 문자열을 만든다)
+ *
+ * 모듈은 인터프리터보다 오래 살아 있어야 한다.
+ */
+class ScriptInterpreter {
+public:
+    explicit ScriptInterpreter(const ScriptModule& module);
+    ScriptInterpreter(const ScriptModule& module, std::ostream& out);
+
+    // ScriptVM 과 같은 의미
+    void init();
+    ScriptValue run();
+    ScriptValue call(std::string_view function, std::vector<ScriptValue> args = {});
+
+    const ScriptValue& global(std::string_view name) const;
+
+private:
+    using Scope = std::unordered_map<std::string, ScriptValue>;
+
+    enum class Flow { NORMAL, BREAK, CONTINUE, RETURN };
+
+    const ScriptModule& module;
+    std::ostream& out;
+    std::unordered_map<std::string, const ScriptFunctionDecl*> functions;
+    Scope globals;
+    std::vector<Scope> scopes;          // 현재 호출의 블록들 (안쪽이 뒤)
+    ScriptValue returned;
+    size_t depth = 0;
+    bool initialized = false;
+
+    ScriptValue invoke(const ScriptFunctionDecl& fn, std::vector<ScriptValue> args);
+
+    Flow block(const std::vector<ScriptStmtPtr>& stmts);
+    Flow statement(const ScriptStmt& s);     // 에러에 문장 줄 번호를 붙인다
+    Flow execute(const ScriptStmt& s);
+    ScriptValue eval(const ScriptExpr& e);
+    ScriptValue callExpr(const ScriptExpr& e);
+
+    ScriptValue* lookup(const std::string& name);
+};
+
+} // namespace sponge
@@ -0,0 +1,599 @@
+#include "meta_script_parser.hpp"
+#include "meta_lexer.hpp"
+
+#include <stdexcept>
+
+namespace sponge {
+
+namespace {
+
+// AST 깊이 상한. 컴파일러 / 인터프리터 / AST 해제가 모두 재귀라서
+// 파서에서 끊는다 (왼쪽으로 쌓이는 a + b + c 사슬도 한 단계씩 센다)
+constexpr size_t kMaxNesting = 1000;
+
+// ------------------------------------------------------
+// 스크립트 렉서 (한 글자씩, 키워드는 IDENT 로 자른 뒤 비교)
+// ------------------------------------------------------
+enum class STok : uint8_t {
+    IDENT, NUMBER, STRING,
+    LPAREN, RPAREN, LBRACE, RBRACE, LBRACKET, RBRACKET,
+    COMMA, COLON, ARROW, ASSIGN,
+    EQ, NE, LT, LE, GT, GE,
+    PLUS, MINUS, STAR, SLASH, PERCENT,
+    END
+};
+
+struct SToken {
+    STok kind = STok::END;
+    std::string_view text;
+    std::string str;            // STRING (escape 를 푼 값)
+    double number = 0.0;
+    uint32_t line = 1;
+    bool newline = false;       // 앞 토큰과 다른 줄에서 시작
+};
+
+[[noreturn]] void fail(uint32_t line, const std::string& msg)
+{
+    throw std::runtime_error("line " + std::to_string(line) + ": " + msg);
+}
+
+// 'text' (에러 메시지용)
+std::string quoted(std::string_view text)
+{
+    std::string q(1, '\'');
+    q.append(text);
+    q += '\'';
+    return q;
+}
+
+bool isIdentStart(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+class ScriptLexer {
+public:
+    explicit ScriptLexer(std::string_view src) : src(src) { advance(); }
+
+    const SToken& peek() const { return cur; }
+
+    SToken next()
+    {
+        SToken t = std::move(cur);
+        advance();
+        return t;
+    }
+
+private:
+    std::string_view src;
+    size_t pos = 0;
+    uint32_t line = 1;
+    SToken cur;
+
+    void advance()
+    {
+        const uint32_t before = line;
+        skipSpace();
+        cur = SToken{};
+        cur.line = line;
+        cur.newline = line != before;
+        if (pos >= src.size()) return;
+
+        const size_t start = pos;
+        const char c = src[pos];
+
+        if (isIdentStart(c)) {
+            while (pos < src.size() && (isIdentStart(src[pos]) || isDigit(src[pos]))) ++pos;
+            cur.kind = STok::IDENT;
+            cur.text = src.substr(start, pos - start);
+            return;
+        }
+        if (isDigit(c)) {
+            while (pos < src.size() && isDigit(src[pos])) ++pos;
+            if (pos + 1 < src.size() && src[pos] == '.' && isDigit(src[pos + 1])) {
+                ++pos;
+                while (pos < src.size() && isDigit(src[pos])) ++pos;
+            }
+            cur.kind = STok::NUMBER;
+            cur.text = src.substr(start, pos - start);
+            if (!parseDouble(cur.text, cur.number))
+                fail(line, "bad number " + quoted(cur.text));
+            return;
+        }
+        if (c == '"') {
+            lexString();
+            return;
+        }
+
+        auto two = [&](char second) { return pos + 1 < src.size() && src[pos + 1] == second; };
+        auto op = [&](STok k, size_t len) {
+            cur.kind = k;
+            cur.text = src.substr(pos, len);
+            pos += len;
+        };
+        switch (c) {
+            case '(': return op(STok::LPAREN, 1);
+            case ')': return op(STok::RPAREN, 1);
+            case '{': return op(STok::LBRACE, 1);
+            case '}': return op(STok::RBRACE, 1);
+            case '[': return op(STok::LBRACKET, 1);
+            case ']': return op(STok::RBRACKET, 1);
+            case ',': return op(STok::COMMA, 1);
+            case ':': return op(STok::COLON, 1);
+            case '+': return op(STok::PLUS, 1);
+            case '*': return op(STok::STAR, 1);
+            case '/': return op(STok::SLASH, 1);
+            case '%': return op(STok::PERCENT, 1);
+            case '-': return two('>') ? op(STok::ARROW, 2) : op(STok::MINUS, 1);
+            case '=': return two('=') ? op(STok::EQ, 2) : op(STok::ASSIGN, 1);
+            case '<': return two('=') ? op(STok::LE, 2) : op(STok::LT, 1);
+            case '>': return two('=') ? op(STok::GE, 2) : op(STok::GT, 1);
+            case '!':
+                if (two('=')) return op(STok::NE, 2);
+                break;
+            default:
+                break;
+        }
+        fail(line, "unexpected character " + quoted(std::string_view(&c, 1)));
+    }
+
+    void skipSpace()
+    {
+        while (pos < src.size()) {
+            char c = src[pos];
+            if (c == '\n') {
+                ++line;
+                ++pos;
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                ++pos;
+            } else if (c == '#') {
+                while (pos < src.size() && src[pos] != '\n') ++pos;
+            } else {
+                break;
+            }
+        }
+    }
+
+    void lexString()
+    {
+        const size_t start = pos++;
+        cur.kind = STok::STRING;
+        while (pos < src.size() && src[pos] != '"') {
+            char c = src[pos++];
+            if (c == '\n') fail(cur.line, "unterminated string");
+            if (c != '\\') {
+                cur.str += c;
+                continue;
+            }
+            if (pos >= src.size()) break;
+            switch (char e = src[pos++]) {
+                case 'n':  cur.str += '\n'; break;
+                case 't':  cur.str += '\t'; break;
+                case 'r':  cur.str += '\r'; break;
+                case '0':  cur.str += '\0'; break;
+                case '"':  cur.str += '"'; break;
+                case '\\': cur.str += '\\'; break;
+                default:   fail(line, std::string("unknown escape '\\") + e + "'");
+            }
+        }
+        if (pos >= src.size()) fail(cur.line, "unterminated string");
+        ++pos;
+        cur.text = src.substr(start, pos - start);
+    }
+};
+
+
+
+// ------------------------------------------------------
+// 재귀 하강 파서
+//   or < and < not < 비교 < + - < * / % < 단항 - < 호출/인덱스 < 기본식
+// ------------------------------------------------------
+class ScriptParser {
+public:
+    explicit ScriptParser(std::string_view src) : lex(src) {}
+
+    ScriptModule module()
+    {
+        ScriptModule m;
+        while (lex.peek().kind != STok::END) {
+            if (isKeyword("fn")) m.functions.push_back(function());
+            else m.top.push_back(statement());
+        }
+        return m;
+    }
+
+private:
+    ScriptLexer lex;
+    size_t depth = 0;
+
+    // 함수가 끝날 때 들어간 만큼 되돌리는 깊이 카운터
+    class Nesting {
+    public:
+        explicit Nesting(ScriptParser& p) : p(p) {}
+        ~Nesting() { p.depth -= n; }
+        Nesting(const Nesting&) = delete;
+        Nesting& operator=(const Nesting&) = delete;
+
+        void enter(uint32_t line, const char* what) {
+            ++n;
+            if (++p.depth > kMaxNesting) fail(line, std::string(what) + " nested too deeply");
+        }
+
+    private:
+        ScriptParser& p;
+        size_t n = 0;
+    };
+
+    bool isKeyword(std::string_view kw) const
+    {
+        return lex.peek().kind == STok::IDENT && lex.peek().text == kw;
+    }
+
+    bool accept(STok k)
+    {
+        if (lex.peek().kind != k) return false;
+        lex.next();
+        return true;
+    }
+
+    SToken expect(STok k, const char* what)
+    {
+        if (lex.peek().kind != k) {
+            const SToken& t = lex.peek();
+            fail(t.line, std::string("expected ") + what + ", got " +
+                         (t.kind == STok::END ? std::string("end of file") : quoted(t.text)));
+        }
+        return lex.next();
+    }
+
+    std::string name(const char* what)
+    {
+        SToken t = expect(STok::IDENT, what);
+        if (isReserved(t.text)) fail(t.line, quoted(t.text) + " is a keyword");
+        return std::string(t.text);
+    }
+
+    static bool isReserved(std::string_view s)
+    {
+        for (const char* kw : { "fn", "let", "if", "else", "while", "return", "push", "pop",
+                                "break", "continue", "or", "and", "not", "true", "false", "nil" })
+            if (s == kw) return true;
+        return false;
+    }
+
+    // ---- 선언 / 문장 ----
+    ScriptFunctionDecl function()
+    {
+        ScriptFunctionDecl f;
+        f.line = lex.next().line;               // fn
+        f.name = name("function name");
+        expect(STok::LPAREN, "'('");
+        if (!accept(STok::RPAREN)) {
+            do f.params.push_back(name("parameter name"));
+            while (accept(STok::COMMA));
+            expect(STok::RPAREN, "')'");
+        }
+        if (accept(STok::ARROW)) expect(STok::IDENT, "return type");
+        f.body = block();
+        return f;
+    }
+
+    std::vector<ScriptStmtPtr> block()
+    {
+        Nesting nest(*this);
+        nest.enter(lex.peek().line, "block");
+        expect(STok::LBRACE, "'{'");
+        std::vector<ScriptStmtPtr> out;
+        while (!accept(STok::RBRACE)) {
+            if (lex.peek().kind == STok::END) fail(lex.peek().line, "expected '}'");
+            out.push_back(statement());
+        }
+        return out;
+    }
+
+    ScriptStmtPtr statement()
+    {
+        auto s = std::make_unique<ScriptStmt>();
+        s->line = lex.peek().line;
+
+        if (isKeyword("let")) {
+            lex.next();
+            s->kind = ScriptStmt::LET;
+            s->name = name("variable name");
+            expect(STok::ASSIGN, "'='");
+            s->value = expr();
+        } else if (isKeyword("if")) {
+            ifStatement(*s);
+        } else if (isKeyword("while")) {
+            lex.next();
+            s->kind = ScriptStmt::WHILE;
+            s->cond = expr();
+            s->body = block();
+        } else if (isKeyword("return")) {
+            lex.next();
+            s->kind = ScriptStmt::RETURN;
+            // 같은 줄에 식이 이어질 때만 반환값
+            const SToken& t = lex.peek();
+            if (t.kind != STok::END && t.kind != STok::RBRACE && !t.newline) s->value = expr();
+        } else if (isKeyword("push")) {
+            lex.next();
+            s->kind = ScriptStmt::PUSH;
+            s->target = postfix();
+            s->value = expr();
+        } else if (isKeyword("pop")) {
+            lex.next();
+            s->kind = ScriptStmt::POP;
+            s->target = postfix();
+        } else if (isKeyword("break")) {
+            lex.next();
+            s->kind = ScriptStmt::BREAK;
+        } else if (isKeyword("continue")) {
+            lex.next();
+            s->kind = ScriptStmt::CONTINUE;
+        } else if (isKeyword("fn")) {
+            fail(s->line, "functions can only be declared at the top level");
+        } else {
+            ScriptExprPtr e = expr();
+            if (accept(STok::ASSIGN)) {
+                if (e->kind != ScriptExpr::NAME && e->kind != ScriptExpr::INDEX)
+                    fail(s->line, "cannot assign to this expression");
+                s->kind = ScriptStmt::ASSIGN;
+                s->target = std::move(e);
+                s->value = expr();
+            } else {
+                s->kind = ScriptStmt::EXPR;
+                s->value = std::move(e);
+            }
+        }
+        return s;
+    }
+
+    void ifStatement(ScriptStmt& s)
+    {
+        lex.next();                             // if
+        s.kind = ScriptStmt::IF;
+        s.cond = expr();
+        s.body = block();
+        if (!isKeyword("else")) return;
+        lex.next();
+        if (isKeyword("if")) {
+            Nesting nest(*this);                // else if 사슬은 orelse 안으로 한 단계씩
+            nest.enter(lex.peek().line, "block");
+            auto nested = std::make_unique<ScriptStmt>();
+            nested->line = lex.peek().line;
+            ifStatement(*nested);
+            s.orelse.push_back(std::move(nested));
+        } else {
+            s.orelse = block();
+        }
+    }
+
+    // ---- 식 ----
+    static ScriptExprPtr node(ScriptExpr::Kind k, uint32_t line)
+    {
+        auto e = std::make_unique<ScriptExpr>();
+        e->kind = k;
+        e->line = line;
+        return e;
+    }
+
+    static ScriptExprPtr binary(ScriptBinOp op, ScriptExprPtr l, ScriptExprPtr r, uint32_t line)
+    {
+        auto e = node(ScriptExpr::BINARY, line);
+        e->op = op;
+        e->kids.push_back(std::move(l));
+        e->kids.push_back(std::move(r));
+        return e;
+    }
+
+    ScriptExprPtr expr()
+    {
+        Nesting nest(*this);
+        nest.enter(lex.peek().line, "expression");
+        return orExpr();
+    }
+
+    ScriptExprPtr orExpr()
+    {
+        Nesting nest(*this);
+        ScriptExprPtr l = andExpr();
+        while (isKeyword("or")) {
+            nest.enter(lex.peek().line, "expression");
+            uint32_t line = lex.next().line;
+            l = binary(ScriptBinOp::OR, std::move(l), andExpr(), line);
+        }
+        return l;
+    }
+
+    ScriptExprPtr andExpr()
+    {
+        Nesting nest(*this);
+        ScriptExprPtr l = notExpr();
+        while (isKeyword("and")) {
+            nest.enter(lex.peek().line, "expression");
+            uint32_t line = lex.next().line;
+            l = binary(ScriptBinOp::AND, std::move(l), notExpr(), line);
+        }
+        return l;
+    }
+
+    ScriptExprPtr notExpr()
+    {
+        if (!isKeyword("not")) return comparison();
+        Nesting nest(*this);
+        nest.enter(lex.peek().line, "expression");
+        auto e = node(ScriptExpr::NOT, lex.next().line);
+        e->kids.push_back(notExpr());
+        return e;
+    }
+
+    ScriptExprPtr comparison()
+    {
+        Nesting nest(*this);
+        ScriptExprPtr l = additive();
+        for (;;) {
+            ScriptBinOp op;
+            switch (lex.peek().kind) {
+                case STok::EQ: op = ScriptBinOp::EQ; break;
+                case STok::NE: op = ScriptBinOp::NE; break;
+                case STok::LT: op = ScriptBinOp::LT; break;
+                case STok::LE: op = ScriptBinOp::LE; break;
+                case STok::GT: op = ScriptBinOp::GT; break;
+                case STok::GE: op = ScriptBinOp::GE; break;
+                default: return l;
+            }
+            nest.enter(lex.peek().line, "expression");
+            uint32_t line = lex.next().line;
+            l = binary(op, std::move(l), additive(), line);
+        }
+    }
+
+    ScriptExprPtr additive()
+    {
+        Nesting nest(*this);
+        ScriptExprPtr l = multiplicative();
+        for (;;) {
+            ScriptBinOp op;
+            switch (lex.peek().kind) {
+                case STok::PLUS:  op = ScriptBinOp::ADD; break;
+                case STok::MINUS: op = ScriptBinOp::SUB; break;
+                default: return l;
+            }
+            nest.enter(lex.peek().line, "expression");
+            uint32_t line = lex.next().line;
+            l = binary(op, std::move(l), multiplicative(), line);
+        }
+    }
+
+    ScriptExprPtr multiplicative()
+    {
+        Nesting nest(*this);
+        ScriptExprPtr l = unary();
+        for (;;) {
+            ScriptBinOp op;
+            switch (lex.peek().kind) {
+                case STok::STAR:    op = ScriptBinOp::MUL; break;
+                case STok::SLASH:   op = ScriptBinOp::DIV; break;
+                case STok::PERCENT: op = ScriptBinOp::MOD; break;
+                default: return l;
+            }
+            nest.enter(lex.peek().line, "expression");
+            uint32_t line = lex.next().line;
+            l = binary(op, std::move(l), unary(), line);
+        }
+    }
+
+    ScriptExprPtr unary()
+    {
+        if (lex.peek().kind != STok::MINUS) return postfix();
+        Nesting nest(*this);
+        nest.enter(lex.peek().line, "expression");
+        auto e = node(ScriptExpr::NEG, lex.next().line);
+        e->kids.push_back(unary());
+        return e;
+    }
+
+    ScriptExprPtr postfix()
+    {
+        Nesting nest(*this);
+        ScriptExprPtr e = primary();
+        for (;;) {
+            const SToken& t = lex.peek();
+            if (t.newline) return e;
+            if (t.kind == STok::LBRACKET) {
+                nest.enter(t.line, "expression");
+                auto ix = node(ScriptExpr::INDEX, lex.next().line);
+                ix->kids.push_back(std::move(e));
+                ix->kids.push_back(expr());
+                expect(STok::RBRACKET, "']'");
+                e = std::move(ix);
+            } else if (t.kind == STok::LPAREN) {
+                if (e->kind != ScriptExpr::NAME) fail(t.line, "only named functions can be called");
+                lex.next();
+                e->kind = ScriptExpr::CALL;
+                if (!accept(STok::RPAREN)) {
+                    do e->kids.push_back(expr());
+                    while (accept(STok::COMMA));
+                    expect(STok::RPAREN, "')'");
+                }
+            } else {
+                return e;
+            }
+        }
+    }
+
+    ScriptExprPtr primary()
+    {
+        const SToken& t = lex.peek();
+        const uint32_t line = t.line;
+        switch (t.kind) {
+            case STok::NUMBER: {
+                auto e = node(ScriptExpr::NUMBER, line);
+                e->number = lex.next().number;
+                return e;
+            }
+            case STok::STRING: {
+                auto e = node(ScriptExpr::STRING, line);
+                e->text = std::move(lex.next().str);
+                return e;
+            }
+            case STok::LPAREN: {
+                lex.next();
+                ScriptExprPtr e = expr();
+                expect(STok::RPAREN, "')'");
+                return e;
+            }
+            case STok::LBRACKET: {
+                lex.next();
+                auto e = node(ScriptExpr::LIST, line);
+                while (!accept(STok::RBRACKET)) {
+                    e->kids.push_back(expr());
+                    if (!accept(STok::COMMA)) {
+                        expect(STok::RBRACKET, "']'");
+                        break;
+                    }
+                }
+                return e;
+            }
+            case STok::LBRACE: {
+                lex.next();
+                auto e = node(ScriptExpr::MAP, line);
+                while (!accept(STok::RBRACE)) {
+                    e->kids.push_back(expr());
+                    expect(STok::COLON, "':'");
+                    e->kids.push_back(expr());
+                    if (!accept(STok::COMMA)) {
+                        expect(STok::RBRACE, "'}'");
+                        break;
+                    }
+                }
+                return e;
+            }
+            case STok::IDENT: {
+                if (t.text == "true" || t.text == "false") {
+                    auto e = node(ScriptExpr::BOOL, line);
+                    e->number = lex.next().text == "true" ? 1.0 : 0.0;
+                    return e;
+                }
+                if (t.text == "nil") {
+                    lex.next();
+                    return node(ScriptExpr::NIL, line);
+                }
+                auto e = node(ScriptExpr::NAME, line);
+                e->text = name("expression");
+                return e;
+            }
+            case STok::END:
+                fail(line, "unexpected end of file");
+            default:
+                fail(line, "unexpected " + quoted(t.text));
+        }
+    }
+};
+
+} // namespace
+
+ScriptModule parseScript(std::string_view src)
+{
+    return ScriptParser(src).module();
+}
+
+} // namespace sponge
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sponge {
+
+// ------------------------------------------------------
+// .sp 스크립트 AST (examples/xagi_fullstack.sp 의 문법)
+//
+//   fn name(a, b) -> type { ... }      -> type 은 주석 취급 (검사하지 않음)
+//   let x = e      x = e      xs[i] = e
+//   if e { } else if e { } else { }
+//   while e { }    break    continue    return [e]
+//   push xs e      pop xs
+//   식: or / and / not, == != < <= > >=, + - * / %, 단항 -,
+//       호출 f(..), 인덱스 a[i], [리스트], {"키": 값}, "문자열", 숫자, true false nil
+//   # 부터 줄 끝까지 주석. 줄바꿈은 문장 구분이 아니지만
+//   다음 줄의 ( [ 는 앞 식의 호출/인덱스로 붙이지 않는다.
+//
+// 호출은 이름으로만 한다 (함수 값 없음). 맨 위의 let 은 전역 변수.
+// ------------------------------------------------------
+enum class ScriptBinOp : uint8_t {
+    ADD, SUB, MUL, DIV, MOD,
+    EQ, NE, LT, LE, GT, GE,
+    AND, OR
+};
+
+struct ScriptExpr {
+    enum Kind : uint8_t {
+        NIL, BOOL, NUMBER, STRING,
+        NAME,       // text
+        LIST,       // kids = 원소
+        MAP,        // kids = 키, 값, 키, 값 ...
+        INDEX,      // kids = { 대상, 키 }
+        CALL,       // text = 함수 이름, kids = 인자
+        NEG, NOT,   // kids = { 피연산자 }
+        BINARY      // op, kids = { 왼쪽, 오른쪽 }
+    };
+
+    Kind kind = NIL;
+    ScriptBinOp op = ScriptBinOp::ADD;
+    uint32_t line = 0;
+    double number = 0.0;        // NUMBER, BOOL (0/1)
+    std::string text;           // STRING, NAME, CALL
+    std::vector<std::unique_ptr<ScriptExpr>> kids;
+};
+
+using ScriptExprPtr = std::unique_ptr<ScriptExpr>;
+
+struct ScriptStmt {
+    enum Kind : uint8_t {
+        LET,        // name = value
+        ASSIGN,     // target (NAME 또는 INDEX) = value
+        EXPR,       // value
+        IF,         // cond, body, orelse (else if 는 IF 하나짜리 orelse)
+        WHILE,      // cond, body
+        RETURN,     // value (없으면 nullptr)
+        PUSH,       // target, value
+        POP,        // target
+        BREAK,
+        CONTINUE
+    };
+
+    Kind kind = EXPR;
+    uint32_t line = 0;
+    std::string name;
+    ScriptExprPtr target, value, cond;
+    std::vector<std::unique_ptr<ScriptStmt>> body, orelse;
+};
+
+using ScriptStmtPtr = std::unique_ptr<ScriptStmt>;
+
+struct ScriptFunctionDecl {
+    std::string name;
+    std::vector<std::string> params;
+    std::vector<ScriptStmtPtr> body;
+    uint32_t line = 0;
+};
+
+struct ScriptModule {
+    std::vector<ScriptFunctionDecl> functions;
+    std::vector<ScriptStmtPtr> top;         // 맨 위 문장 (선언 순서대로 실행)
+};
+
+/**
+ * .sp 소스 → ScriptModule. 문법 오류는 "line N: 메시지" runtime_error.
+ * 이름 해석 (정의되지 않은 변수/함수) 은 compileScript() 가 한다.
+ */
+ScriptModule parseScript(std::string_view src);
+
+} // namespace sponge
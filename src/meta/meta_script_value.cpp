@@ -0,0 +1,284 @@
+#include "meta_script_value.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace sponge {
+
+const char* scriptTypeName(ScriptType t)
+{
+    switch (t) {
+        case ScriptType::NIL:    return "nil";
+        case ScriptType::BOOL:   return "bool";
+        case ScriptType::NUMBER: return "number";
+        case ScriptType::STRING: return "string";
+        case ScriptType::LIST:   return "list";
+        case ScriptType::MAP:    return "map";
+    }
+    return "?";
+}
+
+ScriptValue ScriptValue::string(std::string s)
+{
+    ScriptValue v;
+    v.type = ScriptType::STRING;
+    v.obj = new ScriptString(std::move(s));
+    return v;
+}
+
+ScriptValue ScriptValue::list(std::vector<ScriptValue> items)
+{
+    ScriptValue v;
+    v.type = ScriptType::LIST;
+    v.obj = new ScriptList(std::move(items));
+    return v;
+}
+
+ScriptValue ScriptValue::map()
+{
+    ScriptValue v;
+    v.type = ScriptType::MAP;
+    v.obj = new ScriptMap();
+    return v;
+}
+
+constinit thread_local const ScriptValue* ScriptValue::characters = nullptr;
+
+const ScriptValue* ScriptValue::makeCharacters()
+{
+    // 표가 한 참조씩 잡고 있어 refs 가 1 로 떨어지지 않는다 (제자리 수정 대상이 아님)
+    thread_local std::unique_ptr<ScriptValue[]> table;
+    table = std::make_unique<ScriptValue[]>(256);
+    for (int i = 0; i < 256; ++i) table[i] = string(std::string(1, char(i)));
+    characters = table.get();
+    return characters;
+}
+
+void ScriptValue::destroy(ScriptObject* o) noexcept
+{
+    switch (o->type) {
+        case ScriptType::STRING: delete static_cast<ScriptString*>(o); break;
+        case ScriptType::LIST:   delete static_cast<ScriptList*>(o); break;
+        case ScriptType::MAP:    delete static_cast<ScriptMap*>(o); break;
+        default: break;
+    }
+}
+
+
+
+// ------------------------------------------------------
+// 비교 / 변환
+// ------------------------------------------------------
+bool scriptTruthy(const ScriptValue& v)
+{
+    switch (v.type) {
+        case ScriptType::NIL:    return false;
+        case ScriptType::BOOL:   return v.flag;
+        case ScriptType::NUMBER: return v.num != 0.0;
+        case ScriptType::STRING: return !v.str().empty();
+        default:                 return true;
+    }
+}
+
+bool scriptEquals(const ScriptValue& a, const ScriptValue& b)
+{
+    if (a.type != b.type) return false;
+    switch (a.type) {
+        case ScriptType::NIL:    return true;
+        case ScriptType::BOOL:   return a.flag == b.flag;
+        case ScriptType::NUMBER: return a.num == b.num;
+        case ScriptType::STRING: return a.obj == b.obj || a.str() == b.str();
+        default:                 return a.obj == b.obj;
+    }
+}
+
+bool scriptLess(const ScriptValue& a, const ScriptValue& b)
+{
+    if (a.isNumber() && b.isNumber()) return a.num < b.num;
+    if (a.isString() && b.isString()) return a.str() < b.str();
+    throw std::runtime_error(std::string("Cannot compare ") + scriptTypeName(a.type) +
+                             " with " + scriptTypeName(b.type));
+}
+
+static void appendNumber(std::string& out, double d)
+{
+    char buf[32];
+    // 정수는 소수점 없이 (len(), 인덱스, 카운터가 "3" 으로 찍히도록)
+    if (d == std::floor(d) && std::fabs(d) < 1e15) {
+        auto r = std::to_chars(buf, buf + sizeof(buf), static_cast<long long>(d));
+        out.append(buf, r.ptr);
+        return;
+    }
+    auto r = std::to_chars(buf, buf + sizeof(buf), d);
+    out.append(buf, r.ptr);
+}
+
+void scriptAppend(std::string& out, const ScriptValue& v)
+{
+    switch (v.type) {
+        case ScriptType::NIL:    out += "nil"; break;
+        case ScriptType::BOOL:   out += v.flag ? "true" : "false"; break;
+        case ScriptType::NUMBER: appendNumber(out, v.num); break;
+        case ScriptType::STRING: out += v.str(); break;
+        case ScriptType::LIST: {
+            out += '[';
+            bool first = true;
+            for (const auto& x : v.items()) {
+                if (!first) out += ", ";
+                first = false;
+                scriptAppend(out, x);
+            }
+            out += ']';
+            break;
+        }
+        case ScriptType::MAP: {
+            // unordered_map 순서는 구현마다 달라서 키로 정렬해 찍는다
+            std::vector<const std::pair<const std::string, ScriptValue>*> sorted;
+            for (const auto& e : v.entries()) sorted.push_back(&e);
+            std::sort(sorted.begin(), sorted.end(), [](auto* x, auto* y) { return x->first < y->first; });
+            out += '{';
+            bool first = true;
+            for (auto* e : sorted) {
+                if (!first) out += ", ";
+                first = false;
+                out += e->first;
+                out += ": ";
+                scriptAppend(out, e->second);
+            }
+            out += '}';
+            break;
+        }
+    }
+}
+
+std::string scriptToString(const ScriptValue& v)
+{
+    if (v.isString()) return v.str();
+    std::string out;
+    scriptAppend(out, v);
+    return out;
+}
+
+double scriptNumber(const ScriptValue& v, const char* what)
+{
+    if (!v.isNumber())
+        throw std::runtime_error(std::string(what) + ": expected number, got " + scriptTypeName(v.type));
+    return v.num;
+}
+
+
+
+// ------------------------------------------------------
+// 내장 함수 / 인덱싱
+// ------------------------------------------------------
+ScriptValue scriptLength(const ScriptValue& v)
+{
+    switch (v.type) {
+        case ScriptType::STRING: return ScriptValue::number(double(v.str().size()));
+        case ScriptType::LIST:   return ScriptValue::number(double(v.items().size()));
+        case ScriptType::MAP:    return ScriptValue::number(double(v.entries().size()));
+        default:
+            throw std::runtime_error(std::string("len: expected string, list or map, got ") +
+                                     scriptTypeName(v.type));
+    }
+}
+
+// 정수이고 [0, size) 안이어야 한다
+static size_t position(const ScriptValue& i, size_t size, const char* what)
+{
+    double d = scriptNumber(i, what);
+    if (d < 0 || d != std::floor(d) || d >= double(size))
+        throw std::runtime_error(std::string(what) + ": index " + scriptToString(i) +
+                                 " out of range (size " + std::to_string(size) + ")");
+    return static_cast<size_t>(d);
+}
+
+ScriptValue scriptCharAt(const ScriptValue& s, const ScriptValue& i)
+{
+    if (!s.isString())
+        throw std::runtime_error(std::string("char_at: expected string, got ") + scriptTypeName(s.type));
+    const std::string& text = s.str();
+    return ScriptValue::character(static_cast<unsigned char>(text[position(i, text.size(), "char_at")]));
+}
+
+ScriptValue scriptIndex(const ScriptValue& c, const ScriptValue& k)
+{
+    switch (c.type) {
+        case ScriptType::LIST: {
+            auto& items = c.items();
+            return items[position(k, items.size(), "index")];
+        }
+        case ScriptType::STRING:
+            return scriptCharAt(c, k);
+        case ScriptType::MAP: {
+            auto& entries = c.entries();
+            auto it = k.isString() ? entries.find(k.str()) : entries.find(scriptToString(k));
+            if (it == entries.end())
+                throw std::runtime_error("Missing key: " + scriptToString(k));
+            return it->second;
+        }
+        default:
+            throw std::runtime_error(std::string("Cannot index ") + scriptTypeName(c.type));
+    }
+}
+
+void scriptSetIndex(const ScriptValue& c, const ScriptValue& k, ScriptValue v)
+{
+    switch (c.type) {
+        case ScriptType::LIST: {
+            auto& items = c.items();
+            items[position(k, items.size(), "index")] = std::move(v);
+            return;
+        }
+        case ScriptType::MAP:
+            c.entries()[scriptToString(k)] = std::move(v);
+            return;
+        default:
+            throw std::runtime_error(std::string("Cannot assign into ") + scriptTypeName(c.type));
+    }
+}
+
+bool scriptHas(const ScriptValue& c, const ScriptValue& k)
+{
+    switch (c.type) {
+        case ScriptType::MAP: {
+            auto& entries = c.entries();
+            return k.isString() ? entries.count(k.str()) != 0 : entries.count(scriptToString(k)) != 0;
+        }
+        case ScriptType::LIST:
+            for (const auto& x : c.items())
+                if (scriptEquals(x, k)) return true;
+            return false;
+        default:
+            throw std::runtime_error(std::string("has: expected map or list, got ") + scriptTypeName(c.type));
+    }
+}
+
+void scriptPush(const ScriptValue& list, ScriptValue v)
+{
+    if (!list.isList())
+        throw std::runtime_error(std::string("push: expected list, got ") + scriptTypeName(list.type));
+    list.items().push_back(std::move(v));
+}
+
+std::string scriptArityMessage(std::string_view function, size_t expected, size_t got)
+{
+    return std::string(function) + "() expects " + std::to_string(expected) +
+           (expected == 1 ? " argument" : " arguments") + ", got " + std::to_string(got);
+}
+
+ScriptValue scriptPop(const ScriptValue& list)
+{
+    if (!list.isList())
+        throw std::runtime_error(std::string("pop: expected list, got ") + scriptTypeName(list.type));
+    auto& items = list.items();
+    if (items.empty()) throw std::runtime_error("pop: empty list");
+    ScriptValue v = std::move(items.back());
+    items.pop_back();
+    return v;
+}
+
+} // namespace sponge
@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sponge {
+
+// ------------------------------------------------------
+// .sp 스크립트 값 (ScriptVM / ScriptInterpreter 공용)
+//
+// 16 바이트 태그 + union. 문자열/리스트/맵은 참조 카운트 힙 객체이고
+// 리스트/맵은 참조 의미 (push ai["memory"] x 가 ai 안의 리스트를 바꾼다).
+// 카운트는 atomic 이 아니므로 값을 스레드 사이에 공유하지 않는다.
+// 순환 참조 (자기 자신을 담은 리스트) 는 회수하지 않는다.
+// ------------------------------------------------------
+enum class ScriptType : uint8_t {
+    NIL,
+    BOOL,
+    NUMBER,
+    STRING,     // 여기부터 힙 객체
+    LIST,
+    MAP
+};
+
+const char* scriptTypeName(ScriptType t);
+
+struct ScriptObject {
+    uint32_t refs = 1;
+    ScriptType type;
+    explicit ScriptObject(ScriptType t) : type(t) {}
+};
+
+struct ScriptString;
+struct ScriptList;
+struct ScriptMap;
+
+class ScriptValue {
+public:
+    ScriptValue() noexcept {}
+    ~ScriptValue() { release(); }
+
+    ScriptValue(const ScriptValue& o) noexcept : type(o.type), bits(o.bits) { retain(); }
+    ScriptValue(ScriptValue&& o) noexcept : type(o.type), bits(o.bits) { o.type = ScriptType::NIL; }
+
+    ScriptValue& operator=(const ScriptValue& o) noexcept {
+        o.retain();             // 자기 대입에서도 안전하도록 먼저 올린다
+        release();
+        type = o.type;
+        bits = o.bits;
+        return *this;
+    }
+    ScriptValue& operator=(ScriptValue&& o) noexcept {
+        if (this != &o) {
+            release();
+            type = o.type;
+            bits = o.bits;
+            o.type = ScriptType::NIL;
+        }
+        return *this;
+    }
+
+    static ScriptValue boolean(bool b) { ScriptValue v; v.type = ScriptType::BOOL; v.flag = b; return v; }
+    static ScriptValue number(double d) { ScriptValue v; v.type = ScriptType::NUMBER; v.num = d; return v; }
+    static ScriptValue string(std::string s);
+    static ScriptValue list(std::vector<ScriptValue> items = {});
+    static ScriptValue map();
+
+    // 한 바이트 문자열 (char_at). 스레드별 표에서 꺼내므로 할당하지 않는다.
+    static const ScriptValue& character(unsigned char c) {
+        const ScriptValue* table = characters;
+        if (!table) table = makeCharacters();
+        return table[c];
+    }
+
+    // 임시 값 없이 제자리에서 바꾸기 (VM 이 결과 레지스터에 바로 쓸 때)
+    void setNumber(double d) noexcept { release(); type = ScriptType::NUMBER; num = d; }
+    void setBool(bool b) noexcept { release(); type = ScriptType::BOOL; bits = 0; flag = b; }
+
+    bool isNil() const { return type == ScriptType::NIL; }
+    bool isNumber() const { return type == ScriptType::NUMBER; }
+    bool isString() const { return type == ScriptType::STRING; }
+    bool isList() const { return type == ScriptType::LIST; }
+    bool isMap() const { return type == ScriptType::MAP; }
+    bool isObject() const { return type >= ScriptType::STRING; }
+
+    // 태그 검사 없음 (호출하는 쪽이 확인)
+    const std::string& str() const;
+    std::string& mutableStr();
+    std::vector<ScriptValue>& items() const;
+    std::unordered_map<std::string, ScriptValue>& entries() const;
+
+    // 이 값만 객체를 잡고 있으면 제자리에서 고쳐도 아무도 보지 못한다
+    bool unique() const { return isObject() && obj->refs == 1; }
+
+    ScriptType type = ScriptType::NIL;
+    union {
+        double num;
+        bool flag;
+        ScriptObject* obj;
+        uint64_t bits = 0;      // 복사용 (어느 멤버든 통째로)
+    };
+
+private:
+    void retain() const noexcept { if (isObject()) ++obj->refs; }
+    void release() noexcept { if (isObject() && --obj->refs == 0) destroy(obj); }
+    static void destroy(ScriptObject* o) noexcept;
+
+    // 정적 초기화라 접근에 TLS 래퍼 호출이 없다 (처음 한 번만 makeCharacters)
+    static constinit thread_local const ScriptValue* characters;
+    static const ScriptValue* makeCharacters();
+};
+
+struct ScriptString : ScriptObject {
+    std::string text;
+    explicit ScriptString(std::string s) : ScriptObject(ScriptType::STRING), text(std::move(s)) {}
+};
+
+struct ScriptList : ScriptObject {
+    std::vector<ScriptValue> items;
+    explicit ScriptList(std::vector<ScriptValue> v) : ScriptObject(ScriptType::LIST), items(std::move(v)) {}
+};
+
+struct ScriptMap : ScriptObject {
+    std::unordered_map<std::string, ScriptValue> entries;
+    ScriptMap() : ScriptObject(ScriptType::MAP) {}
+};
+
+inline const std::string& ScriptValue::str() const { return static_cast<ScriptString*>(obj)->text; }
+inline std::string& ScriptValue::mutableStr() { return static_cast<ScriptString*>(obj)->text; }
+inline std::vector<ScriptValue>& ScriptValue::items() const { return static_cast<ScriptList*>(obj)->items; }
+inline std::unordered_map<std::string, ScriptValue>& ScriptValue::entries() const {
+    return static_cast<ScriptMap*>(obj)->entries;
+}
+
+
+
+// ------------------------------------------------------
+// 공용 의미 규칙 (두 실행기가 같은 결과를 내도록 여기 한 곳에만 둔다)
+// 타입이 맞지 않으면 runtime_error
+// ------------------------------------------------------
+
+// nil / false / 0 / "" 은 거짓
+bool scriptTruthy(const ScriptValue& v);
+
+// 타입이 다르면 false. 문자열은 내용, 리스트/맵은 같은 객체인지.
+bool scriptEquals(const ScriptValue& a, const ScriptValue& b);
+
+// 숫자끼리 / 문자열끼리 (사전순)
+bool scriptLess(const ScriptValue& a, const ScriptValue& b);
+
+// print / concat 이 쓰는 표기 (정수는 소수점 없이, 맵은 키 순서로)
+std::string scriptToString(const ScriptValue& v);
+void scriptAppend(std::string& out, const ScriptValue& v);
+
+double scriptNumber(const ScriptValue& v, const char* what);
+
+// len(x): 문자열 바이트 수 / 리스트 길이 / 맵 항목 수
+ScriptValue scriptLength(const ScriptValue& v);
+
+// char_at(s, i): i 번째 바이트 한 글자
+ScriptValue scriptCharAt(const ScriptValue& s, const ScriptValue& i);
+
+// c[k] / c[k] = v / has(m, k). 맵 키는 문자열 (숫자는 scriptToString 으로)
+ScriptValue scriptIndex(const ScriptValue& c, const ScriptValue& k);
+void scriptSetIndex(const ScriptValue& c, const ScriptValue& k, ScriptValue v);
+bool scriptHas(const ScriptValue& c, const ScriptValue& k);
+
+// push xs v / pop xs
+void scriptPush(const ScriptValue& list, ScriptValue v);
+ScriptValue scriptPop(const ScriptValue& list);
+
+// "f() expects 2 arguments, got 1" (컴파일러 / 두 실행기 공용 문구)
+std::string scriptArityMessage(std::string_view function, size_t expected, size_t got);
+
+} // namespace sponge
@@ -0,0 +1,426 @@
+#include "meta_script_vm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__GNUC__) && !defined(SPONGE_VM_NO_THREADED)
+#define SPONGE_VM_THREADED 1
+#else
+#define SPONGE_VM_THREADED 0
+#endif
+
+namespace sponge {
+
+const char* scriptOpName(ScriptOp op)
+{
+    static const char* const names[] = {
+        "LOADK", "LOADNIL", "MOVE", "GETG", "SETG",
+        "NEWLIST", "NEWMAP", "INDEX", "SETINDEX", "PUSH", "POP",
+        "ADD", "SUB", "MUL", "DIV", "MOD", "ADDK", "NEG", "NOT",
+        "EQ", "NE", "LT", "LE",
+        "JMP", "JT", "JF", "JEQ", "JNE", "JEQK", "JNEK", "JLT", "JNLT", "JLE", "JNLE",
+        "LEN", "CHARAT", "CONCAT", "CONCAT2", "HAS", "PRINT",
+        "CALL", "RET", "RETNIL",
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(ScriptOp::COUNT),
+                  "names out of sync with ScriptOp");
+    auto i = static_cast<size_t>(op);
+    return i < static_cast<size_t>(ScriptOp::COUNT) ? names[i] : "?";
+}
+
+int ScriptProgram::find(std::string_view name) const
+{
+    for (size_t i = 0; i < functions.size(); ++i)
+        if (i != topLevel && functions[i].name == name) return int(i);
+    return -1;
+}
+
+// 상수 표기 (문자열은 따옴표와 escape 로, 공백 한 글자도 보이게)
+static std::string constantText(const ScriptValue& v)
+{
+    if (!v.isString()) return scriptToString(v);
+    std::string q = "\"";
+    for (char c : v.str()) {
+        switch (c) {
+            case '\n': q += "\\n"; break;
+            case '\t': q += "\\t"; break;
+            case '\r': q += "\\r"; break;
+            case '"':  q += "\\\""; break;
+            case '\\': q += "\\\\"; break;
+            default:   q += c; break;
+        }
+    }
+    return q + "\"";
+}
+
+void disassembleScript(const ScriptProgram& program, std::ostream& out)
+{
+    for (const auto& fn : program.functions) {
+        out << "fn " << fn.name << " (params " << fn.params << ", registers " << fn.registers
+            << ", constants " << fn.constants.size() << ")\n";
+        for (size_t i = 0; i < fn.code.size(); ++i) {
+            const ScriptInstr& in = fn.code[i];
+            out << "  " << std::setw(4) << i << "  line " << std::setw(4) << fn.lines[i] << "  "
+                << std::left << std::setw(8) << scriptOpName(in.op) << std::right
+                << " " << in.a << " " << in.b << " " << in.c;
+            if (in.op == ScriptOp::LOADK || in.op == ScriptOp::JEQK || in.op == ScriptOp::JNEK)
+                out << "    ; " << constantText(fn.constants[in.b]);
+            else if (in.op == ScriptOp::ADDK)
+                out << "    ; " << constantText(fn.constants[in.c]);
+            else if (in.op == ScriptOp::CALL)
+                out << "    ; " << program.functions[in.b].name;
+            else if (in.op == ScriptOp::GETG || in.op == ScriptOp::SETG)
+                out << "    ; " << program.globals[in.b];
+            out << "\n";
+        }
+    }
+}
+
+
+
+// ------------------------------------------------------
+// ScriptVM
+// ------------------------------------------------------
+ScriptVM::ScriptVM(const ScriptProgram& program)
+    : ScriptVM(program, std::cout) {}
+
+ScriptVM::ScriptVM(const ScriptProgram& program, std::ostream& out)
+    : program(program), out(out), globals(program.globals.size()) {}
+
+void ScriptVM::init()
+{
+    if (initialized) return;
+    initialized = true;
+    execute(program.topLevel, 0);
+}
+
+ScriptValue ScriptVM::run()
+{
+    init();
+    if (program.mainFunction < 0) return {};
+    return execute(uint16_t(program.mainFunction), 0);
+}
+
+ScriptValue ScriptVM::call(std::string_view function, std::vector<ScriptValue> args)
+{
+    int f = program.find(function);
+    if (f < 0) throw std::runtime_error("Unknown function: " + std::string(function));
+    const ScriptFunction& fn = program.functions[f];
+    if (args.size() != fn.params)
+        throw std::runtime_error(scriptArityMessage(function, fn.params, args.size()));
+    init();
+
+    if (regs.size() < fn.registers) regs.resize(fn.registers);
+    for (size_t i = 0; i < args.size(); ++i) regs[i] = std::move(args[i]);
+    return execute(uint16_t(f), 0);
+}
+
+const ScriptValue& ScriptVM::global(std::string_view name) const
+{
+    for (size_t i = 0; i < program.globals.size(); ++i)
+        if (program.globals[i] == name) return globals[i];
+    throw std::runtime_error("Unknown global: " + std::string(name));
+}
+
+namespace {
+
+constexpr size_t kMaxFrames = 100000;
+
+// 자주 나오는 타입은 여기서 바로, 나머지는 공용 규칙으로
+inline bool equals(const ScriptValue& x, const ScriptValue& y)
+{
+    if (x.type != y.type) return false;
+    if (x.type == ScriptType::NUMBER) return x.num == y.num;
+    if (x.type == ScriptType::STRING) {
+        if (x.obj == y.obj) return true;
+        const std::string& a = x.str();
+        const std::string& b = y.str();
+        // 토크나이저의 c == "(" 같은 한 글자 비교는 memcmp 호출 없이
+        if (a.size() != b.size()) return false;
+        if (a.size() == 1) return a[0] == b[0];
+        return std::memcmp(a.data(), b.data(), a.size()) == 0;
+    }
+    return scriptEquals(x, y);
+}
+
+inline bool less(const ScriptValue& x, const ScriptValue& y)
+{
+    if (x.isNumber() && y.isNumber()) return x.num < y.num;
+    return scriptLess(x, y);
+}
+
+inline bool lessEqual(const ScriptValue& x, const ScriptValue& y)
+{
+    if (x.isNumber() && y.isNumber()) return x.num <= y.num;
+    return !scriptLess(y, x);
+}
+
+inline bool truthy(const ScriptValue& v)
+{
+    return v.type == ScriptType::BOOL ? v.flag : scriptTruthy(v);
+}
+
+} // namespace
+
+
+
+// ------------------------------------------------------
+// 실행 루프
+// ------------------------------------------------------
+#if SPONGE_VM_THREADED
+// computed goto 는 GNU 확장
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#define VM_CASE(op)  L_##op:
+#define VM_NEXT      do { in = *ip++; goto *dispatch[static_cast<uint8_t>(in.op)]; } while (0)
+#define VM_BEGIN     VM_NEXT;
+#define VM_END
+#else
+#define VM_CASE(op)  case ScriptOp::op:
+#define VM_NEXT      continue
+#define VM_BEGIN     for (;;) { in = *ip++; switch (in.op) {
+#define VM_END       default: break; } }
+#endif
+
+#define VM_ARITH(op, expr)                                              \
+    VM_CASE(op) {                                                       \
+        const ScriptValue& x = R[in.b];                                 \
+        const ScriptValue& y = R[in.c];                                 \
+        if (!x.isNumber() || !y.isNumber()) {                           \
+            scriptNumber(x, #op); scriptNumber(y, #op);                 \
+        }                                                               \
+        double a = x.num, b = y.num;                                    \
+        R[in.a].setNumber(expr);                                        \
+        VM_NEXT;                                                        \
+    }
+
+#define VM_JUMP_IF(op, cond)                                            \
+    VM_CASE(op) {                                                       \
+        if (cond) ip = code + in.c;                                     \
+        VM_NEXT;                                                        \
+    }
+
+ScriptValue ScriptVM::execute(uint16_t function, size_t base)
+{
+    const ScriptFunction* fn = &program.functions[function];
+    if (regs.size() < base + fn->registers) regs.resize(base + fn->registers);
+
+    const size_t outerFrames = frames.size();
+    const ScriptInstr* code = fn->code.data();
+    const ScriptInstr* ip = code;
+    const ScriptValue* K = fn->constants.data();
+    ScriptValue* R = regs.data() + base;
+    ScriptInstr in{};
+
+#if SPONGE_VM_THREADED
+    // ScriptOp 선언 순서와 동일해야 함
+    static void* const dispatch[] = {
+        &&L_LOADK, &&L_LOADNIL, &&L_MOVE, &&L_GETG, &&L_SETG,
+        &&L_NEWLIST, &&L_NEWMAP, &&L_INDEX, &&L_SETINDEX, &&L_PUSH, &&L_POP,
+        &&L_ADD, &&L_SUB, &&L_MUL, &&L_DIV, &&L_MOD, &&L_ADDK, &&L_NEG, &&L_NOT,
+        &&L_EQ, &&L_NE, &&L_LT, &&L_LE,
+        &&L_JMP, &&L_JT, &&L_JF, &&L_JEQ, &&L_JNE, &&L_JEQK, &&L_JNEK,
+        &&L_JLT, &&L_JNLT, &&L_JLE, &&L_JNLE,
+        &&L_LEN, &&L_CHARAT, &&L_CONCAT, &&L_CONCAT2, &&L_HAS, &&L_PRINT,
+        &&L_CALL, &&L_RET, &&L_RETNIL,
+    };
+    static_assert(sizeof(dispatch) / sizeof(dispatch[0]) == static_cast<size_t>(ScriptOp::COUNT),
+                  "dispatch table out of sync with ScriptOp");
+#endif
+
+    // 에러 메시지에 현재 함수와 줄을 붙인다 (정상 경로에는 비용 없음)
+    try {
+
+    VM_BEGIN
+
+    VM_CASE(LOADK)   { R[in.a] = K[in.b]; VM_NEXT; }
+    VM_CASE(LOADNIL) { R[in.a] = ScriptValue(); VM_NEXT; }
+    VM_CASE(MOVE)    { R[in.a] = R[in.b]; VM_NEXT; }
+    VM_CASE(GETG)    { R[in.a] = globals[in.b]; VM_NEXT; }
+    VM_CASE(SETG)    { globals[in.b] = R[in.a]; VM_NEXT; }
+
+    VM_CASE(NEWLIST) {
+        R[in.a] = ScriptValue::list(std::vector<ScriptValue>(R + in.b, R + in.b + in.c));
+        VM_NEXT;
+    }
+    VM_CASE(NEWMAP) {
+        ScriptValue m = ScriptValue::map();
+        for (uint16_t i = 0; i < in.c; ++i)
+            scriptSetIndex(m, R[in.b + 2 * i], R[in.b + 2 * i + 1]);
+        R[in.a] = std::move(m);
+        VM_NEXT;
+    }
+    VM_CASE(INDEX) {
+        const ScriptValue& c = R[in.b];
+        const ScriptValue& k = R[in.c];
+        if (c.isList() && k.isNumber()) {
+            auto& items = c.items();
+            double d = k.num;
+            if (d >= 0 && d < double(items.size()) && d == double(size_t(d))) {
+                R[in.a] = ScriptValue(items[size_t(d)]);
+                VM_NEXT;
+            }
+        }
+        R[in.a] = scriptIndex(c, k);
+        VM_NEXT;
+    }
+    VM_CASE(SETINDEX) { scriptSetIndex(R[in.a], R[in.b], R[in.c]); VM_NEXT; }
+    VM_CASE(PUSH)     { scriptPush(R[in.a], R[in.b]); VM_NEXT; }
+    VM_CASE(POP)      { scriptPop(R[in.a]); VM_NEXT; }
+
+    VM_ARITH(ADD, a + b)
+    VM_ARITH(SUB, a - b)
+    VM_ARITH(MUL, a * b)
+    VM_ARITH(DIV, a / b)
+    VM_ARITH(MOD, std::fmod(a, b))
+
+    VM_CASE(ADDK) {
+        const ScriptValue& x = R[in.b];
+        double a = x.isNumber() ? x.num : scriptNumber(x, "ADD");
+        R[in.a].setNumber(a + K[in.c].num);
+        VM_NEXT;
+    }
+    VM_CASE(NEG) { R[in.a].setNumber(-scriptNumber(R[in.b], "negate")); VM_NEXT; }
+    VM_CASE(NOT) { R[in.a].setBool(!truthy(R[in.b])); VM_NEXT; }
+
+    VM_CASE(EQ) { bool r = equals(R[in.b], R[in.c]); R[in.a].setBool(r); VM_NEXT; }
+    VM_CASE(NE) { bool r = !equals(R[in.b], R[in.c]); R[in.a].setBool(r); VM_NEXT; }
+    VM_CASE(LT) { bool r = less(R[in.b], R[in.c]); R[in.a].setBool(r); VM_NEXT; }
+    VM_CASE(LE) { bool r = lessEqual(R[in.b], R[in.c]); R[in.a].setBool(r); VM_NEXT; }
+
+    VM_CASE(JMP) { ip = code + in.c; VM_NEXT; }
+    VM_JUMP_IF(JT,   truthy(R[in.a]))
+    VM_JUMP_IF(JF,   !truthy(R[in.a]))
+    VM_JUMP_IF(JEQ,  equals(R[in.a], R[in.b]))
+    VM_JUMP_IF(JNE,  !equals(R[in.a], R[in.b]))
+    VM_JUMP_IF(JEQK, equals(R[in.a], K[in.b]))
+    VM_JUMP_IF(JNEK, !equals(R[in.a], K[in.b]))
+    VM_JUMP_IF(JLT,  less(R[in.a], R[in.b]))
+    VM_JUMP_IF(JNLT, !less(R[in.a], R[in.b]))
+    VM_JUMP_IF(JLE,  lessEqual(R[in.a], R[in.b]))
+    VM_JUMP_IF(JNLE, !lessEqual(R[in.a], R[in.b]))
+
+    VM_CASE(LEN) {
+        const ScriptValue& v = R[in.b];
+        if (v.isString()) R[in.a].setNumber(double(v.str().size()));
+        else R[in.a] = scriptLength(v);
+        VM_NEXT;
+    }
+    VM_CASE(CHARAT) {
+        const ScriptValue& s = R[in.b];
+        const ScriptValue& i = R[in.c];
+        if (s.isString() && i.isNumber() && i.num >= 0 && i.num < double(s.str().size()) &&
+            i.num == double(size_t(i.num)))
+            R[in.a] = ScriptValue::character(static_cast<unsigned char>(s.str()[size_t(i.num)]));
+        else
+            R[in.a] = scriptCharAt(s, i);
+        VM_NEXT;
+    }
+    VM_CASE(CONCAT) {
+        std::string s;
+        for (uint16_t i = 0; i < in.c; ++i) scriptAppend(s, R[in.b + i]);
+        R[in.a] = ScriptValue::string(std::move(s));
+        VM_NEXT;
+    }
+    VM_CASE(CONCAT2) {
+        ScriptValue& dst = R[in.a];
+        if (in.a == in.b && in.a != in.c && dst.isString() && dst.unique()) {
+            // cur = concat(cur, c): 아무도 보지 않는 문자열이면 복사 없이 붙인다
+            const ScriptValue& tail = R[in.c];
+            if (tail.isString()) dst.mutableStr() += tail.str();
+            else scriptAppend(dst.mutableStr(), tail);
+        } else {
+            std::string s;
+            scriptAppend(s, R[in.b]);
+            scriptAppend(s, R[in.c]);
+            dst = ScriptValue::string(std::move(s));
+        }
+        VM_NEXT;
+    }
+    VM_CASE(HAS) { R[in.a] = ScriptValue::boolean(scriptHas(R[in.b], R[in.c])); VM_NEXT; }
+    VM_CASE(PRINT) {
+        std::string line;
+        for (uint16_t i = 0; i < in.b; ++i) scriptAppend(line, R[in.a + i]);
+        line += '\n';
+        out << line;
+        VM_NEXT;
+    }
+
+    VM_CASE(CALL) {
+        if (frames.size() - outerFrames >= kMaxFrames) throw std::runtime_error("stack overflow");
+        const ScriptFunction* callee = &program.functions[in.b];
+        frames.push_back({ fn, ip, base });
+
+        base += in.a;
+        if (regs.size() < base + callee->registers) {
+            regs.resize(std::max(regs.size() * 2, base + callee->registers));
+        }
+        fn = callee;
+        code = ip = fn->code.data();
+        K = fn->constants.data();
+        R = regs.data() + base;
+        VM_NEXT;
+    }
+    VM_CASE(RET) {
+        ScriptValue result = std::move(R[in.a]);
+        // 프레임을 비워 둔다 (다음 호출이 쓰기 전까지 객체를 붙잡지 않게, CONCAT2 의 unique 판단도 정확하게)
+        for (uint16_t i = 0; i < fn->registers; ++i) R[i] = ScriptValue();
+        if (frames.size() == outerFrames) return result;
+
+        const Frame f = frames.back();
+        frames.pop_back();
+        R[0] = std::move(result);                   // 호출자의 R[a]
+        fn = f.fn;
+        ip = f.ip;
+        base = f.base;
+        code = fn->code.data();
+        K = fn->constants.data();
+        R = regs.data() + base;
+        VM_NEXT;
+    }
+    VM_CASE(RETNIL) {
+        for (uint16_t i = 0; i < fn->registers; ++i) R[i] = ScriptValue();
+        if (frames.size() == outerFrames) return {};
+
+        const Frame f = frames.back();
+        frames.pop_back();
+        fn = f.fn;
+        ip = f.ip;
+        base = f.base;
+        code = fn->code.data();
+        K = fn->constants.data();
+        R = regs.data() + base;
+        VM_NEXT;
+    }
+
+    VM_END
+
+    } catch (const std::exception& e) {
+        const size_t at = size_t(ip - code) - 1;
+        const uint32_t line = at < fn->lines.size() ? fn->lines[at] : 0;
+        frames.resize(outerFrames);
+        throw std::runtime_error("line " + std::to_string(line) + " in " + fn->name + ": " + e.what());
+    }
+
+#if !SPONGE_VM_THREADED
+    return {};  // 도달하지 않음 (모든 함수는 RETNIL 로 끝난다)
+#endif
+}
+
+#undef VM_ARITH
+#undef VM_JUMP_IF
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_BEGIN
+#undef VM_END
+
+#if SPONGE_VM_THREADED
+#pragma GCC diagnostic pop
+#endif
+
+} // namespace sponge
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "meta_script_value.hpp"
+
+namespace sponge {
+
+// ------------------------------------------------------
+// .sp 스크립트용 레지스터 바이트코드
+//
+// 명령은 8 바이트 (op + 16 비트 피연산자 a, b, c). R = 현재 프레임 레지스터,
+// K = 함수 상수, G = 전역, 점프 대상은 함수 안의 절대 명령 번호.
+// 산술/식 VM (meta_vm.hpp 의 OpCode) 과는 따로 간다.
+// ------------------------------------------------------
+enum class ScriptOp : uint8_t {
+    LOADK,      // R[a] = K[b]
+    LOADNIL,    // R[a] = nil
+    MOVE,       // R[a] = R[b]
+    GETG,       // R[a] = G[b]
+    SETG,       // G[b] = R[a]
+
+    NEWLIST,    // R[a] = [R[b] .. R[b+c-1]]
+    NEWMAP,     // R[a] = {R[b]: R[b+1], ...}  (c 쌍)
+    INDEX,      // R[a] = R[b][R[c]]
+    SETINDEX,   // R[a][R[b]] = R[c]
+    PUSH,       // push R[a] R[b]
+    POP,        // pop R[a]
+
+    ADD, SUB, MUL, DIV, MOD,    // R[a] = R[b] op R[c]
+    ADDK,       // R[a] = R[b] + K[c]   (add(i, 1), sub(i, 1))
+    NEG,        // R[a] = -R[b]
+    NOT,        // R[a] = not R[b]
+    EQ, NE, LT, LE,             // R[a] = R[b] op R[c]  (> >= 는 피연산자를 바꿔서)
+
+    JMP,        // goto c
+    JT, JF,     // R[a] 가 참/거짓이면 goto c
+    JEQ, JNE,   // R[a] == R[b] 이면 / 아니면 goto c
+    JEQK, JNEK, // R[a] == K[b] 이면 / 아니면 goto c
+    JLT, JNLT,  // R[a] < R[b]
+    JLE, JNLE,  // R[a] <= R[b]
+
+    LEN,        // R[a] = len(R[b])
+    CHARAT,     // R[a] = char_at(R[b], R[c])
+    CONCAT,     // R[a] = concat(R[b] .. R[b+c-1])
+    CONCAT2,    // R[a] = concat(R[b], R[c])  (a == b 이고 혼자 쥔 문자열이면 제자리에 붙인다)
+    HAS,        // R[a] = has(R[b], R[c])
+    PRINT,      // print(R[a] .. R[a+b-1])
+
+    CALL,       // R[a] = F[b](R[a] .. R[a+c-1])  (호출된 함수의 프레임은 R[a] 부터)
+    RET,        // return R[a]
+    RETNIL,
+
+    COUNT
+};
+
+const char* scriptOpName(ScriptOp op);
+
+struct ScriptInstr {
+    ScriptOp op;
+    uint16_t a = 0, b = 0, c = 0;
+};
+
+static_assert(sizeof(ScriptInstr) == 8);
+
+struct ScriptFunction {
+    std::string name;
+    uint16_t params = 0;
+    uint16_t registers = 0;             // 프레임 크기 (인자 포함)
+    std::vector<ScriptInstr> code;
+    std::vector<uint32_t> lines;        // code 와 같은 길이 (에러 메시지용 소스 줄)
+    std::vector<ScriptValue> constants;
+};
+
+/**
+ * compileScript() 결과. functions 의 마지막이 맨 위 문장 ("<top>").
+ * 상수 문자열을 참조 카운트로 나눠 쓰므로 한 프로그램을
+ * 여러 스레드의 VM 이 동시에 돌리면 안 된다 (스레드마다 컴파일).
+ */
+struct ScriptProgram {
+    std::vector<ScriptFunction> functions;
+    std::vector<std::string> globals;
+    uint16_t topLevel = 0;
+    int mainFunction = -1;              // fn main() 이 없으면 -1
+
+    // 이름으로 함수 번호 (없으면 -1)
+    int find(std::string_view name) const;
+};
+
+// 함수별 명령 목록 (spongelang run --dump)
+void disassembleScript(const ScriptProgram& program, std::ostream& out);
+
+/**
+ * 레지스터 VM.
+ *
+ * 호출은 C++ 재귀 없이 프레임 스택으로 처리하고, 피호출 함수의 레지스터 창은
+ * 호출자의 인자 레지스터에서 바로 시작한다 (인자 복사 없음).
+ * 레지스터 파일은 필요할 때만 늘리며, 반환할 때 피호출 프레임을 비워
+ * 값이 남아 객체를 붙잡지 않게 한다.
+ *
+ * GCC/Clang 에서는 computed goto 로 디스패치한다 (SPONGE_VM_NO_THREADED 로 끌 수 있음).
+ * 실행 중 에러는 "line N in 함수: 메시지" runtime_error.
+ */
+class ScriptVM {
+public:
+    explicit ScriptVM(const ScriptProgram& program);
+    ScriptVM(const ScriptProgram& program, std::ostream& out);
+
+    // 맨 위 문장 실행 (전역 초기화). run()/call() 이 처음 한 번 알아서 부른다.
+    void init();
+
+    // init() 후 main() 이 있으면 호출해서 그 반환값
+    ScriptValue run();
+
+    ScriptValue call(std::string_view function, std::vector<ScriptValue> args = {});
+
+    const ScriptValue& global(std::string_view name) const;
+
+private:
+    struct Frame {
+        const ScriptFunction* fn;
+        const ScriptInstr* ip;          // 돌아올 위치
+        size_t base;
+    };
+
+    const ScriptProgram& program;
+    std::ostream& out;
+    std::vector<ScriptValue> globals;
+    std::vector<ScriptValue> regs;
+    std::vector<Frame> frames;
+    bool initialized = false;
+
+    ScriptValue execute(uint16_t function, size_t base);
+};
+
+} // namespace sponge
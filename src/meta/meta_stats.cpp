@@ -0,0 +1,192 @@
+#include "meta_stats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+#include "meta_ir.hpp"
+#include "meta_ops.hpp"
+
+namespace sponge {
+
+std::atomic<bool> Stats::flag{ false };
+
+namespace {
+
+struct PhaseSlot {
+    std::atomic<uint64_t> calls{ 0 };
+    std::atomic<uint64_t> nanos{ 0 };
+    std::atomic<uint64_t> maxNanos{ 0 };
+};
+
+PhaseSlot gPhases[static_cast<size_t>(Phase::COUNT)];
+std::atomic<uint64_t> gCounters[static_cast<size_t>(Counter::COUNT)];
+std::atomic<uint32_t> gPeakStack{ 0 };
+
+// 연산자 히스토그램 (파싱 1 회당 락 1 번)
+std::mutex gOpsMutex;
+std::unordered_map<std::string, uint64_t> gOps;
+
+template<class T>
+void atomicMax(std::atomic<T>& slot, T v)
+{
+    T cur = slot.load(std::memory_order_relaxed);
+    while (cur < v && !slot.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+const char* phaseName(Phase p)
+{
+    switch (p) {
+        case Phase::LOAD_PACK: return "loadFromFile";
+        case Phase::MOUNT:     return "mount";
+        case Phase::PARSE:     return "parse";
+        case Phase::OPTIMIZE:  return "optimize";
+        case Phase::COMPILE:   return "compile";
+        case Phase::EVAL_TREE: return "evaluateIR";
+        case Phase::VM_RUN:    return "VM::run";
+        case Phase::COUNT:     break;
+    }
+    return "?";
+}
+
+const char* counterName(Counter c)
+{
+    switch (c) {
+        case Counter::PROGRAMS:        return "programs parsed";
+        case Counter::IR_NODES:        return "IR nodes built";
+        case Counter::IR_NODES_OPT:    return "IR nodes after opt";
+        case Counter::VM_INSTRUCTIONS: return "VM instructions";
+        case Counter::ALLOCATIONS:     return "allocations";
+        case Counter::ALLOC_BYTES:     return "allocated bytes";
+        case Counter::COUNT:           break;
+    }
+    return "?";
+}
+
+
+
+// ------------------------------------------------------
+// 기록
+// ------------------------------------------------------
+void Stats::enable(bool on)
+{
+    flag.store(on && SPONGE_STATS, std::memory_order_relaxed);
+}
+
+void Stats::reset()
+{
+    for (auto& p : gPhases) {
+        p.calls.store(0, std::memory_order_relaxed);
+        p.nanos.store(0, std::memory_order_relaxed);
+        p.maxNanos.store(0, std::memory_order_relaxed);
+    }
+    for (auto& c : gCounters) c.store(0, std::memory_order_relaxed);
+    gPeakStack.store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(gOpsMutex);
+    gOps.clear();
+}
+
+void Stats::addPhase(Phase p, uint64_t nanos)
+{
+    PhaseSlot& s = gPhases[static_cast<size_t>(p)];
+    s.calls.fetch_add(1, std::memory_order_relaxed);
+    s.nanos.fetch_add(nanos, std::memory_order_relaxed);
+    atomicMax(s.maxNanos, nanos);
+}
+
+void Stats::add(Counter c, uint64_t n)
+{
+    gCounters[static_cast<size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+}
+
+void Stats::notePeakStack(uint32_t depth)
+{
+    atomicMax(gPeakStack, depth);
+}
+
+void Stats::recordIR(const IRArena& ir, const OperatorTable& ops)
+{
+    std::vector<uint64_t> counts(ops.size(), 0);
+    for (size_t i = 0; i < ir.size(); ++i)
+        if (ir.tag[i] == IRTag::BINARY && ir.op[i] < counts.size())
+            counts[ir.op[i]]++;
+
+    std::lock_guard<std::mutex> lock(gOpsMutex);
+    for (OpId id = 0; id < counts.size(); ++id)
+        if (counts[id]) gOps[ops.name(id)] += counts[id];
+}
+
+
+
+// ------------------------------------------------------
+// 스냅샷 / 리포트
+// ------------------------------------------------------
+EngineStats Stats::snapshot()
+{
+    EngineStats s;
+    s.enabled = enabled();
+    for (size_t i = 0; i < s.phases.size(); ++i) {
+        s.phases[i].calls = gPhases[i].calls.load(std::memory_order_relaxed);
+        s.phases[i].nanos = gPhases[i].nanos.load(std::memory_order_relaxed);
+        s.phases[i].maxNanos = gPhases[i].maxNanos.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < s.counters.size(); ++i)
+        s.counters[i] = gCounters[i].load(std::memory_order_relaxed);
+    s.peakVmStack = gPeakStack.load(std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(gOpsMutex);
+        s.operators.assign(gOps.begin(), gOps.end());
+    }
+    std::sort(s.operators.begin(), s.operators.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return s;
+}
+
+std::string EngineStats::report() const
+{
+    if (!compiledIn) return "stats: not compiled in (SPONGE_STATS=OFF)\n";
+
+    std::string out;
+    char line[160];
+
+    out += "phase                 calls      total ms       avg us       max us\n";
+    for (size_t i = 0; i < phases.size(); ++i) {
+        const PhaseStats& p = phases[i];
+        if (p.calls == 0) continue;
+        std::snprintf(line, sizeof(line), "%-16s %10llu %13.3f %12.3f %12.3f\n",
+                      phaseName(static_cast<Phase>(i)),
+                      static_cast<unsigned long long>(p.calls),
+                      double(p.nanos) / 1e6,
+                      double(p.nanos) / 1e3 / double(p.calls),
+                      double(p.maxNanos) / 1e3);
+        out += line;
+    }
+
+    out += "\ncounter                          value\n";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        std::snprintf(line, sizeof(line), "%-24s %14llu\n",
+                      counterName(static_cast<Counter>(i)),
+                      static_cast<unsigned long long>(counters[i]));
+        out += line;
+    }
+    std::snprintf(line, sizeof(line), "%-24s %14u\n", "peak VM stack", peakVmStack);
+    out += line;
+
+    if (!operators.empty()) {
+        out += "\noperator                         count\n";
+        for (const auto& [name, n] : operators) {
+            std::snprintf(line, sizeof(line), "%-24s %14llu\n",
+                          name.c_str(), static_cast<unsigned long long>(n));
+            out += line;
+        }
+    }
+    return out;
+}
+
+} // namespace sponge
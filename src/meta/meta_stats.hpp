@@ -0,0 +1,150 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// CMake 옵션 SPONGE_STATS=OFF 면 아래 매크로가 전부 빈 문장이 된다
+#ifndef SPONGE_STATS
+#define SPONGE_STATS 1
+#endif
+
+namespace sponge {
+
+struct IRArena;
+class OperatorTable;
+
+// 시간을 재는 구간
+enum class Phase : uint8_t {
+    LOAD_PACK,   // MetaAbsorbLoader::loadFromFile
+    MOUNT,       // MetaAbsorbLoader::mount (엔진 흡수 포함)
+    PARSE,       // MetaParser::parse (렉싱 + IR 빌드)
+    OPTIMIZE,    // IR 최적화 패스
+    COMPILE,     // IR → Bytecode
+    EVAL_TREE,   // evaluateIR (run() 한 번 = 1 회)
+    VM_RUN,      // VM::run
+    COUNT
+};
+
+enum class Counter : uint8_t {
+    PROGRAMS,          // 파싱한 식 수
+    IR_NODES,          // 파싱으로 만든 IR 노드 수 (최적화 전)
+    IR_NODES_OPT,      // 최적화 후 남은 노드 수
+    VM_INSTRUCTIONS,   // VM 이 실행한 명령 수
+    ALLOCATIONS,       // noteAllocation() 으로 들어온 힙 할당 수
+    ALLOC_BYTES,
+    COUNT
+};
+
+const char* phaseName(Phase p);
+const char* counterName(Counter c);
+
+struct PhaseStats {
+    uint64_t calls = 0;
+    uint64_t nanos = 0;
+    uint64_t maxNanos = 0;
+};
+
+// Stats::snapshot() 결과 (복사본이라 이후 카운터 변화와 무관)
+struct EngineStats {
+    bool compiledIn = SPONGE_STATS != 0;
+    bool enabled = false;
+
+    std::array<PhaseStats, static_cast<size_t>(Phase::COUNT)> phases{};
+    std::array<uint64_t, static_cast<size_t>(Counter::COUNT)> counters{};
+    uint32_t peakVmStack = 0;
+
+    // 연산자 이름 → 파싱된 IR 에 나온 횟수 (많은 순)
+    std::vector<std::pair<std::string, uint64_t>> operators;
+
+    const PhaseStats& phase(Phase p) const { return phases[static_cast<size_t>(p)]; }
+    uint64_t counter(Counter c) const { return counters[static_cast<size_t>(c)]; }
+
+    // 사람이 읽는 표 (spongelang --stats)
+    std::string report() const;
+};
+
+/**
+ * 프로세스 전역 계측 카운터/타이머.
+ *
+ * 컴파일 시: SPONGE_STATS=0 이면 SPONGE_PHASE/SPONGE_COUNT/SPONGE_STATS_IF 가 사라진다.
+ * 실행 시: enable(false) (기본) 면 구간마다 relaxed load + 분기 하나뿐이고
+ *          노드/명령 단위 루프 안에는 계측 코드가 없다.
+ * 카운터는 relaxed atomic 이라 runBatch 워커에서 불러도 된다.
+ */
+class Stats {
+public:
+    static bool enabled() {
+#if SPONGE_STATS
+        return flag.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    static void enable(bool on);
+    static void reset();
+
+    static void addPhase(Phase p, uint64_t nanos);
+    static void add(Counter c, uint64_t n = 1);
+    static void notePeakStack(uint32_t depth);
+
+    // 파싱된 IR 의 연산자 히스토그램을 더한다 (노드 수만큼 돈다)
+    static void recordIR(const IRArena& ir, const OperatorTable& ops);
+
+    // 호스트가 operator new 를 바꿔 끼웠을 때 부른다 (라이브러리는 전역 new 를 건드리지 않음)
+    static void noteAllocation(size_t bytes) {
+        if (enabled()) {
+            add(Counter::ALLOCATIONS);
+            add(Counter::ALLOC_BYTES, bytes);
+        }
+    }
+
+    static EngineStats snapshot();
+
+private:
+    static std::atomic<bool> flag;
+};
+
+// 구간 타이머: 켜져 있을 때만 시계를 읽는다
+class ScopedPhase {
+public:
+    explicit ScopedPhase(Phase p) : phase(p), on(Stats::enabled()) {
+        if (on) start = std::chrono::steady_clock::now();
+    }
+    ~ScopedPhase() {
+        if (on) {
+            auto d = std::chrono::steady_clock::now() - start;
+            Stats::addPhase(phase, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+        }
+    }
+    ScopedPhase(const ScopedPhase&) = delete;
+    ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+private:
+    Phase phase;
+    bool on;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace sponge
+
+#if SPONGE_STATS
+#define SPONGE_STATS_CAT2(a, b) a##b
+#define SPONGE_STATS_CAT(a, b) SPONGE_STATS_CAT2(a, b)
+#define SPONGE_PHASE(p) \
+    ::sponge::ScopedPhase SPONGE_STATS_CAT(spongePhase_, __LINE__)(::sponge::Phase::p)
+#define SPONGE_COUNT(c, n) \
+    do { if (::sponge::Stats::enabled()) ::sponge::Stats::add(::sponge::Counter::c, (n)); } while (0)
+#define SPONGE_STATS_IF(...) \
+    do { if (::sponge::Stats::enabled()) { __VA_ARGS__; } } while (0)
+#else
+#define SPONGE_PHASE(p) ((void)0)
+#define SPONGE_COUNT(c, n) ((void)0)
+#define SPONGE_STATS_IF(...) ((void)0)
+#endif
@@ -0,0 +1,186 @@
+#include "meta_thread_pool.hpp"
+
+#include <algorithm>
+
+namespace sponge {
+
+// 현재 스레드가 어느 풀의 몇 번 워커인지
+static thread_local const WorkStealingPool* tlsPool = nullptr;
+static thread_local size_t tlsIndex = 0;
+
+// ------------------------------------------------------
+// 생성 / 소멸
+// ------------------------------------------------------
+WorkStealingPool::WorkStealingPool(size_t n)
+{
+    if (n == 0) n = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < n; ++i)
+        workers.push_back(std::make_unique<Worker>());
+
+    for (size_t i = 0; i < n; ++i)
+        threads.emplace_back([this, i] { loop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex);
+        stopping = true;
+    }
+    sleepCv.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+size_t WorkStealingPool::workerIndex() const
+{
+    return tlsPool == this ? tlsIndex : workers.size();
+}
+
+
+
+// ------------------------------------------------------
+// 큐 조작
+// ------------------------------------------------------
+void WorkStealingPool::submit(Task t)
+{
+    // 워커 스레드면 자기 큐, 외부면 라운드로빈
+    size_t self = workerIndex();
+    size_t target = self < workers.size()
+        ? self
+        : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+    {
+        std::lock_guard<std::mutex> lk(workers[target]->m);
+        workers[target]->q.push_back(std::move(t));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lk(sleepMutex);
+    }
+    sleepCv.notify_one();
+}
+
+bool WorkStealingPool::pop(size_t self, Task& out)
+{
+    if (queued.load(std::memory_order_acquire) == 0) return false;
+
+    // 1) 자기 큐 뒤에서 (LIFO)
+    if (self < workers.size()) {
+        Worker& w = *workers[self];
+        std::lock_guard<std::mutex> lk(w.m);
+        if (!w.q.empty()) {
+            out = std::move(w.q.back());
+            w.q.pop_back();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 2) 다른 워커 큐 앞에서 훔치기 (FIFO)
+    size_t n = workers.size();
+    size_t start = self < n ? self + 1 : 0;
+    for (size_t k = 0; k < n; ++k) {
+        Worker& w = *workers[(start + k) % n];
+        std::lock_guard<std::mutex> lk(w.m);
+        if (!w.q.empty()) {
+            out = std::move(w.q.front());
+            w.q.pop_front();
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::runOne()
+{
+    Task t;
+    if (!pop(workerIndex(), t)) return false;
+    t();
+    return true;
+}
+
+void WorkStealingPool::loop(size_t index)
+{
+    tlsPool = this;
+    tlsIndex = index;
+
+    for (;;) {
+        Task t;
+        if (pop(index, t)) {
+            t();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lk(sleepMutex);
+        sleepCv.wait(lk, [&] {
+            return stopping || queued.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && queued.load() == 0) return;
+    }
+}
+
+
+
+// ------------------------------------------------------
+// parallelFor
+// ------------------------------------------------------
+void WorkStealingPool::parallelFor(size_t n, size_t grain,
+    const std::function<void(size_t, size_t, size_t)>& body)
+{
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+
+    TaskGroup group(*this);
+    for (size_t begin = 0; begin < n; begin += grain) {
+        size_t end = std::min(n, begin + grain);
+        group.run([this, &body, begin, end] {
+            body(workerIndex(), begin, end);
+        });
+    }
+    group.wait();
+}
+
+
+
+// ------------------------------------------------------
+// TaskGroup
+// ------------------------------------------------------
+TaskGroup::~TaskGroup()
+{
+    // 예외로 빠져나가더라도 캡처된 참조가 살아있는 동안 합류
+    while (pending.load(std::memory_order_acquire) != 0) {
+        if (!pool.runOne()) std::this_thread::yield();
+    }
+}
+
+void TaskGroup::run(std::function<void()> fn)
+{
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.submit([this, fn = std::move(fn)] {
+        try {
+            fn();
+        } catch (...) {
+            std::lock_guard<std::mutex> lk(errMutex);
+            if (!error) error = std::current_exception();
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void TaskGroup::wait()
+{
+    while (pending.load(std::memory_order_acquire) != 0) {
+        if (!pool.runOne()) std::this_thread::yield();
+    }
+
+    if (error) {
+        auto e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+} // namespace sponge
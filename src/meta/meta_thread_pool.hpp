@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sponge {
+
+/**
+ * work-stealing 스레드 풀.
+ *
+ * 워커마다 자기 deque 를 갖고, 자기 것은 뒤에서 꺼내고(LIFO)
+ * 비면 다른 워커의 deque 앞에서 훔쳐온다(FIFO).
+ * 작업을 기다리는 스레드(TaskGroup::wait)도 놀지 않고 같이 훔쳐서 실행한다.
+ *
+ * workerIndex() 는 워커 스레드면 [0, size()), 외부 스레드면 size().
+ * 워커별 scratch 상태는 size()+1 개를 준비해두면 된다.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads == 0 → hardware_concurrency
+    explicit WorkStealingPool(size_t threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+    size_t workerIndex() const;
+
+    void submit(Task t);
+
+    // 큐에서 작업 하나를 꺼내 실행 (없으면 false)
+    bool runOne();
+
+    /**
+     * [0, n) 을 grain 크기 조각으로 나눠 병렬 실행하고 끝날 때까지 기다린다.
+     * body(worker, begin, end). 예외는 첫 번째 것을 호출자에게 다시 던진다.
+     */
+    void parallelFor(size_t n, size_t grain,
+        const std::function<void(size_t worker, size_t begin, size_t end)>& body);
+
+private:
+    struct Worker {
+        std::mutex m;
+        std::deque<Task> q;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> nextQueue{0};
+    bool stopping = false;
+
+    bool pop(size_t self, Task& out);
+    void loop(size_t index);
+};
+
+/**
+ * fork-join 그룹: run() 으로 작업을 내보내고 wait() 에서 합류.
+ * wait() 중에는 풀의 작업을 같이 실행하므로 중첩 fork 에도 교착되지 않는다.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool) : pool(pool) {}
+    ~TaskGroup();
+
+    void run(std::function<void()> fn);
+    void wait();
+
+private:
+    WorkStealingPool& pool;
+    std::atomic<size_t> pending{0};
+    std::mutex errMutex;
+    std::exception_ptr error;
+};
+
+} // namespace sponge
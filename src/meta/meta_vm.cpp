@@ -1,48 +1,241 @@
 #include "meta_vm.hpp"
 #include "meta_engine.hpp"
+#include "meta_stats.hpp"
 
 #include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__GNUC__) && !defined(SPONGE_VM_NO_THREADED)
+#define SPONGE_VM_THREADED 1
+#else
+#define SPONGE_VM_THREADED 0
+#endif
 
 namespace sponge {
 
-double VM::run(const Bytecode& bc) {
-    stack.clear();
+OpCode opcodeFromName(const std::string& name) {
+    static const std::unordered_map<std::string, OpCode> table = {
+        {"PUSH", OpCode::PUSH},
+        {"LOAD", OpCode::LOAD},
+        {"ADD",  OpCode::ADD},
+        {"SUB",  OpCode::SUB},
+        {"MUL",  OpCode::MUL},
+        {"DIV",  OpCode::DIV},
+        {"MOD",  OpCode::MOD},
+        {"POW",  OpCode::POW},
+        {"MIN",  OpCode::MIN},
+        {"MAX",  OpCode::MAX},
+        {"HALT", OpCode::HALT},
+    };
+
+    auto it = table.find(name);
+    if (it == table.end())
+        throw std::runtime_error("Unknown opcode: " + name);
+    return it->second;
+}
+
+
+
+// ------------------------------------------------------
+// 검증기: 한 번 훑어서 스택 깊이 / data 사용량 계산
+// ------------------------------------------------------
+// data 의 슬롯 번호 (음이 아닌 정수)
+static uint32_t slotOperand(const Bytecode& bc, size_t di, const char* what)
+{
+    if (di >= bc.data.size())
+        throw std::runtime_error("VM verify: data underflow");
+    double s = bc.data[di];
+    if (s < 0 || s != std::floor(s) || s >= double(UINT32_MAX))
+        throw std::runtime_error(std::string("VM verify: bad ") + what + " slot");
+    return static_cast<uint32_t>(s);
+}
+
+void VM::verify(const Bytecode& bc, uint32_t& maxStack, uint32_t& envSlots,
+                uint32_t& tempSlots)
+{
+    uint32_t depth = 0;
     size_t di = 0;
+    maxStack = 0;
+    envSlots = 0;
+    tempSlots = 0;
+    std::vector<uint8_t> saved;     // SAVE 된 임시 슬롯 (직선 코드라 앞에서부터 한 번)
 
     for (size_t i = 0; i < bc.ops.size(); ++i) {
         switch (bc.ops[i]) {
             case OpCode::PUSH:
-                stack.push_back(bc.data[di++]);
-                break;
-            case OpCode::ADD: {
-                double b = stack.back(); stack.pop_back();
-                double a = stack.back(); stack.pop_back();
-                stack.push_back(a + b);
+            case OpCode::LOAD: {
+                if (di >= bc.data.size())
+                    throw std::runtime_error("VM verify: data underflow");
+                if (bc.ops[i] == OpCode::LOAD) {
+                    double s = bc.data[di];
+                    if (s < 0 || s != std::floor(s))
+                        throw std::runtime_error("VM verify: bad LOAD slot");
+                    envSlots = std::max(envSlots, static_cast<uint32_t>(s) + 1);
+                }
+                di++;
+                depth++;
+                maxStack = std::max(maxStack, depth);
                 break;
             }
-            case OpCode::SUB: {
-                double b = stack.back(); stack.pop_back();
-                double a = stack.back(); stack.pop_back();
-                stack.push_back(a - b);
+            case OpCode::ADD: case OpCode::SUB:
+            case OpCode::MUL: case OpCode::DIV:
+            case OpCode::MOD: case OpCode::POW:
+            case OpCode::MIN: case OpCode::MAX:
+                if (depth < 2)
+                    throw std::runtime_error("VM verify: stack underflow");
+                depth--;
                 break;
-            }
-            case OpCode::MUL: {
-                double b = stack.back(); stack.pop_back();
-                double a = stack.back(); stack.pop_back();
-                stack.push_back(a * b);
+            case OpCode::SAVE: {
+                if (depth < 1)
+                    throw std::runtime_error("VM verify: stack underflow");
+                uint32_t s = slotOperand(bc, di++, "SAVE");
+                if (s >= saved.size()) saved.resize(size_t(s) + 1, 0);
+                saved[s] = 1;
+                tempSlots = std::max(tempSlots, s + 1);
                 break;
             }
-            case OpCode::DIV: {
-                double b = stack.back(); stack.pop_back();
-                double a = stack.back(); stack.pop_back();
-                stack.push_back(a / b);
+            case OpCode::TEMP: {
+                uint32_t s = slotOperand(bc, di++, "TEMP");
+                if (s >= saved.size() || !saved[s])
+                    throw std::runtime_error("VM verify: TEMP before SAVE");
+                depth++;
+                maxStack = std::max(maxStack, depth);
                 break;
             }
             case OpCode::HALT:
-                return stack.back();
+                if (depth != 1)
+                    throw std::runtime_error("VM verify: HALT with stack depth != 1");
+                return;
+            default:
+                throw std::runtime_error("VM verify: invalid opcode");
         }
     }
     throw std::runtime_error("VM halted unexpectedly");
 }
 
+void VM::prepare(Bytecode& bc)
+{
+    verify(bc, bc.maxStack, bc.envSlots, bc.tempSlots);
+    bc.verified = true;
+}
+
+
+
+// ------------------------------------------------------
+// 실행 루프 (검증된 바이트코드 전제, 경계 검사 없음)
+// ------------------------------------------------------
+#if SPONGE_VM_THREADED
+// computed goto 는 GNU 확장
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#define VM_CASE(op)  L_##op:
+#define VM_NEXT      goto *dispatch[static_cast<uint8_t>(*ip++)]
+#define VM_BEGIN     VM_NEXT;
+#define VM_END
+#else
+#define VM_CASE(op)  case OpCode::op:
+#define VM_NEXT      continue
+#define VM_BEGIN     for (;;) { switch (*ip++) {
+#define VM_END       } }
+#endif
+
+#define VM_BINARY(op, expr)                 \
+    VM_CASE(op) {                           \
+        double b = *--sp;                   \
+        double a = sp[-1];                  \
+        sp[-1] = (expr);                    \
+        VM_NEXT;                            \
+    }
+
+double VM::run(const Bytecode& bc, const double* env) {
+    SPONGE_PHASE(VM_RUN);
+    uint32_t maxStack = bc.maxStack;
+    uint32_t envSlots = bc.envSlots;
+    uint32_t tempSlots = bc.tempSlots;
+    if (!bc.verified) verify(bc, maxStack, envSlots, tempSlots);
+
+    // 분기가 없는 직선 코드라 실행 명령 수 = 코드 길이 (루프 안에서 세지 않는다)
+    SPONGE_STATS_IF(
+        Stats::notePeakStack(maxStack);
+        Stats::add(Counter::VM_INSTRUCTIONS, bc.ops.size()));
+
+    if (envSlots > 0 && !env)
+        throw std::runtime_error("VM: unbound variable");
+
+    // 스택은 필요한 만큼 한 번만 늘린다 (clear/push_back 없음)
+    if (stack.size() < maxStack) stack.resize(maxStack);
+    if (temps.size() < tempSlots) temps.resize(tempSlots);
+    peak = std::max(peak, maxStack);
+
+    const OpCode* ip = bc.ops.data();
+    const double* dp = bc.data.data();
+    double* sp = stack.data();
+    double* tp = temps.data();
+
+#if SPONGE_VM_THREADED
+    // OpCode 선언 순서와 동일해야 함
+    static void* const dispatch[] = {
+        &&L_PUSH, &&L_LOAD,
+        &&L_ADD, &&L_SUB, &&L_MUL, &&L_DIV,
+        &&L_MOD, &&L_POW, &&L_MIN, &&L_MAX,
+        &&L_HALT,
+        &&L_SAVE, &&L_TEMP,
+    };
+    static_assert(sizeof(dispatch) / sizeof(dispatch[0]) ==
+                  static_cast<size_t>(OpCode::TEMP) + 1,
+                  "dispatch table out of sync with OpCode");
+#endif
+
+    VM_BEGIN
+
+    VM_CASE(PUSH) {
+        *sp++ = *dp++;
+        VM_NEXT;
+    }
+    VM_CASE(LOAD) {
+        *sp++ = env[static_cast<size_t>(*dp++)];
+        VM_NEXT;
+    }
+
+    VM_BINARY(ADD, a + b)
+    VM_BINARY(SUB, a - b)
+    VM_BINARY(MUL, a * b)
+    VM_BINARY(DIV, a / b)
+    VM_BINARY(MOD, std::fmod(a, b))
+    VM_BINARY(POW, std::pow(a, b))
+    VM_BINARY(MIN, std::min(a, b))
+    VM_BINARY(MAX, std::max(a, b))
+
+    VM_CASE(SAVE) {
+        tp[static_cast<size_t>(*dp++)] = sp[-1];
+        VM_NEXT;
+    }
+    VM_CASE(TEMP) {
+        *sp++ = tp[static_cast<size_t>(*dp++)];
+        VM_NEXT;
+    }
+
+    VM_CASE(HALT) {
+        return sp[-1];
+    }
+
+    VM_END
+
+#if !SPONGE_VM_THREADED
+    return sp[-1];  // 도달하지 않음 (verify 가 HALT 를 보장)
+#endif
+}
+
+#undef VM_BINARY
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_BEGIN
+#undef VM_END
+
+#if SPONGE_VM_THREADED
+#pragma GCC diagnostic pop
+#endif
+
 } // namespace sponge
@@ -8,21 +8,66 @@ namespace sponge {
 
 enum class OpCode : uint8_t {
     PUSH,      // push literal
+    LOAD,      // push env[slot] (slot 은 data 에 저장)
     ADD, SUB, MUL, DIV,
-    HALT
+    MOD, POW, MIN, MAX,
+    HALT,
+
+    // 공유 노드 (IRArena::shared) 를 한 번만 계산하기 위한 내부 opcode.
+    // 팩 bytecode 규칙으로는 고를 수 없다 (opcodeFromName 이 모름).
+    SAVE,      // temps[slot] = 스택 top (pop 하지 않음)
+    TEMP       // push temps[slot]
 };
 
+/**
+ * 팩의 bytecode 섹션에 적힌 opcode 이름("ADD" 등)을 OpCode 로 변환.
+ * 모르는 이름이면 runtime_error.
+ */
+OpCode opcodeFromName(const std::string& name);
+
 struct Bytecode {
     std::vector<OpCode> ops;
     std::vector<double> data;
+
+    // VM::prepare() 가 채우는 검증 결과
+    bool verified = false;
+    uint32_t maxStack = 0;    // 실행 중 최대 스택 깊이
+    uint32_t envSlots = 0;    // LOAD 가 참조하는 슬롯 수 (0 이면 env 불필요)
+    uint32_t tempSlots = 0;   // SAVE/TEMP 가 쓰는 임시 슬롯 수
 };
 
+/**
+ * 스택 VM.
+ *
+ * 실행 전에 verify() 로 한 번 검사해서 (스택 underflow, data 범위,
+ * HALT 도달, 최대 깊이) 스택을 미리 한 번에 잡아두고,
+ * 실행 루프는 경계 검사 없이 포인터로 push/pop 한다.
+ *
+ * GCC/Clang 에서는 computed goto 로 디스패치하고
+ * 그 외 컴파일러는 switch 루프로 동작한다 (SPONGE_VM_NO_THREADED 로 강제 가능).
+ */
 class VM {
 public:
-    double run(const Bytecode& bc);
+    // env: 변수 슬롯별 값 (IRArena::vars 순서)
+    double run(const Bytecode& bc, const double* env = nullptr);
+
+    /**
+     * 검사만 하고 결과를 out 에 기록 (잘못된 바이트코드면 runtime_error).
+     * HALT 없이 끝나는 프로그램, SAVE 전에 읽는 TEMP 도 여기서 걸러진다.
+     */
+    static void verify(const Bytecode& bc, uint32_t& maxStack, uint32_t& envSlots,
+                       uint32_t& tempSlots);
+
+    // verify() 후 bc 에 결과를 저장 → run() 이 재검사하지 않음
+    static void prepare(Bytecode& bc);
+
+    // 지금까지 run() 에서 본 최대 스택 깊이
+    uint32_t peakStack() const { return peak; }
 
 private:
     std::vector<double> stack;
+    std::vector<double> temps;
+    uint32_t peak = 0;
 };
 
 } // namespace sponge
@@ -0,0 +1,192 @@
+// spongelang_bindings_test: 이름 있는 바인딩 (define / setInput / undefine / value)
+//
+// 증분 재계산: 바뀐 입력에 의존하는 수식만 dirty 가 되고 value() 가 그것만 다시 계산하는지
+// 순환 정의: 거부된 뒤 이전 정의가 남고, 거부된 정의가 꺼낸 이름이 남지 않는지
+// undefine: 의존하는 바인딩이 Unbound variable 로 실패하고 다시 정의하면 돌아오는지
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "meta_absorb_loader.hpp"
+#include "meta_engine.hpp"
+
+using namespace sponge;
+
+namespace {
+
+// ------------------------------------------------------
+// 보고
+// ------------------------------------------------------
+size_t gChecks = 0;
+size_t gFailures = 0;
+
+void expect(bool ok, const std::string& what)
+{
+    gChecks++;
+    if (!ok && ++gFailures <= 20) std::printf("FAIL %s\n", what.c_str());
+}
+
+void expectValue(SpongeMetaEngine& eng, const std::string& name, double want)
+{
+    try {
+        double got = eng.value(name);
+        expect(got == want, "value(" + name + ") = " + std::to_string(got) +
+                            ", expect " + std::to_string(want));
+    } catch (const std::exception& e) {
+        expect(false, "value(" + name + ") threw: " + e.what());
+    }
+}
+
+// f() 가 message 를 포함하는 runtime_error 를 던져야 한다
+template<class F>
+void expectThrow(const std::string& what, const std::string& message, F&& f)
+{
+    try {
+        f();
+        expect(false, what + ": did not throw");
+    } catch (const std::exception& e) {
+        expect(std::string(e.what()).find(message) != std::string::npos,
+               what + ": wrong error: " + e.what());
+    }
+}
+
+
+
+// ------------------------------------------------------
+// 경우
+// ------------------------------------------------------
+
+//   a, b 입력
+//   s = a + b      t = s * 2      u = b - 1      w = t + u
+void sheet(SpongeMetaEngine& eng)
+{
+    eng.setInput("a", 1);
+    eng.setInput("b", 2);
+    eng.define("s", "a + b");
+    eng.define("t", "s * 2");
+    eng.define("u", "b - 1");
+    eng.define("w", "t + u");
+}
+
+void incremental(SpongeMetaEngine& eng)
+{
+    sheet(eng);
+
+    BindingStats before = eng.bindingStats();
+    expect(before.bindings == 6, "six bindings");
+    expect(before.dirty == 4, "four formulas dirty after define");
+    expectValue(eng, "w", 7);
+    BindingStats after = eng.bindingStats();
+    expect(after.evaluations - before.evaluations == 4, "first value() evaluates all four formulas");
+    expect(after.dirty == 0, "nothing dirty after value()");
+
+    // 캐시된 값은 다시 계산하지 않는다
+    before = after;
+    expectValue(eng, "w", 7);
+    expect(eng.bindingStats().evaluations == before.evaluations, "clean value() evaluates nothing");
+
+    // a 는 s, t, w 만 더럽힌다 (u 는 b 에만 의존)
+    before = eng.bindingStats();
+    eng.setInput("a", 10);
+    after = eng.bindingStats();
+    expect(after.invalidations - before.invalidations == 3, "setInput(a) dirties s, t, w");
+    expect(after.dirty == 3, "three dirty after setInput(a)");
+    expectValue(eng, "t", 24);
+    expect(eng.bindingStats().evaluations - after.evaluations == 2, "value(t) evaluates s, t");
+    expect(eng.bindingStats().dirty == 1, "w still dirty after value(t)");
+    expectValue(eng, "w", 25);
+
+    // 같은 값이면 아무것도 더럽히지 않는다
+    before = eng.bindingStats();
+    eng.setInput("a", 10);
+    expect(eng.bindingStats().invalidations == before.invalidations, "same input value dirties nothing");
+
+    // 수식을 바꾸면 그 위만
+    before = eng.bindingStats();
+    eng.define("u", "b * 100");
+    after = eng.bindingStats();
+    expect(after.invalidations - before.invalidations == 2, "redefining u dirties u, w");
+    expectValue(eng, "w", 224);
+    expect(eng.bindingStats().evaluations - after.evaluations == 2, "value(w) evaluates u, w");
+}
+
+void cycles(SpongeMetaEngine& eng)
+{
+    sheet(eng);
+    expectValue(eng, "w", 7);
+
+    // s → t → s
+    BindingStats before = eng.bindingStats();
+    expectThrow("define s = t + 1", "Cyclic binding", [&] { eng.define("s", "t + 1"); });
+    expectThrow("define w = w", "Cyclic binding", [&] { eng.define("w", "w"); });
+    BindingStats after = eng.bindingStats();
+    expect(after.bindings == before.bindings, "rejected cycle adds no bindings");
+    expect(after.dirty == 0 && after.invalidations == before.invalidations,
+           "rejected cycle dirties nothing");
+    expectValue(eng, "s", 3);
+    expectValue(eng, "w", 7);
+
+    // 새 이름으로 만든 순환과 파싱 오류는 이름을 남기지 않는다
+    expectThrow("define x = y + x", "Cyclic binding", [&] { eng.define("x", "y + x"); });
+    expectThrow("define z = (1 +", "", [&] { eng.define("z", "(1 + q"); });
+    expect(eng.bindingStats().bindings == before.bindings, "rejected definitions leave no new names");
+    expectThrow("value(x)", "Unbound variable: x", [&] { eng.value("x"); });
+    expectThrow("value(y)", "Unbound variable: y", [&] { eng.value("y"); });
+    expectThrow("value(q)", "Unbound variable: q", [&] { eng.value("q"); });
+
+    // 같은 이름을 순환 없이 정의하면 그대로 된다
+    eng.define("x", "y + 1");
+    eng.setInput("y", 4);
+    expectValue(eng, "x", 5);
+}
+
+void undefining(SpongeMetaEngine& eng)
+{
+    sheet(eng);
+    expectValue(eng, "w", 7);
+
+    BindingStats before = eng.bindingStats();
+    eng.undefine("b");
+    BindingStats after = eng.bindingStats();
+    expect(after.bindings == before.bindings, "undefine keeps the name");
+    expect(after.invalidations - before.invalidations == 5, "undefine(b) dirties b, s, t, u, w");
+    expectThrow("value(w) without b", "Unbound variable: b", [&] { eng.value("w"); });
+    expectThrow("value(u) without b", "Unbound variable: b", [&] { eng.value("u"); });
+
+    eng.setInput("b", 5);
+    expectValue(eng, "w", 16);
+
+    // 수식을 지우면 그 이름에 의존하는 것만 실패
+    eng.undefine("t");
+    expectThrow("value(w) without t", "Unbound variable: t", [&] { eng.value("w"); });
+    expectValue(eng, "s", 6);
+    eng.define("t", "s + 0.5");
+    expectValue(eng, "w", 10.5);
+
+    // 없는 이름은 무시
+    before = eng.bindingStats();
+    eng.undefine("nope");
+    expect(eng.bindingStats().bindings == before.bindings, "undefine of unknown name adds nothing");
+}
+
+} // namespace
+
+
+
+int main()
+{
+    using Case = void (*)(SpongeMetaEngine&);
+    for (Case c : { incremental, cycles, undefining }) {
+        try {
+            SpongeMetaEngine eng;
+            MetaAbsorbLoader loader;
+            loader.mountFile(eng, SPONGE_PACKS_DIR "/rust.meta");
+            c(eng);
+        } catch (const std::exception& e) {
+            expect(false, std::string("unexpected error: ") + e.what());
+        }
+    }
+
+    std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+// spongelang_cache_test: 파싱 결과 디스크 캐시 (.spbc, runFileCached)
+//
+// 재사용: 같은 소스 + 같은 팩이면 두 번째부터 캐시에서 읽고 결과가 runFile() 과 같은지
+// 낡음:   소스 내용 (크기가 같아도) 이나 팩이 바뀌면 다시 파싱해 캐시를 새로 쓰는지,
+//         최적화 설정은 캐시 키가 아닌지
+// 손상:   캐시의 아무 바이트를 바꾸거나 자르거나 엉뚱한 파일이어도 던지지 않고
+//         다시 파싱해 맞는 결과를 낸 뒤 캐시를 고쳐 쓰는지
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "meta_absorb_loader.hpp"
+#include "meta_engine.hpp"
+
+using namespace sponge;
+namespace fs = std::filesystem;
+
+namespace {
+
+// ------------------------------------------------------
+// 보고
+// ------------------------------------------------------
+size_t gChecks = 0;
+size_t gFailures = 0;
+
+void expect(bool ok, const std::string& what)
+{
+    gChecks++;
+    if (!ok && ++gFailures <= 20) std::printf("FAIL %s\n", what.c_str());
+}
+
+
+
+// ------------------------------------------------------
+// 파일 / 실행
+// ------------------------------------------------------
+std::string readAll(const fs::path& p)
+{
+    std::ifstream in(p, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+void writeAll(const fs::path& p, const std::string& bytes)
+{
+    std::ofstream(p, std::ios::binary | std::ios::trunc).write(bytes.data(),
+                                                               static_cast<std::streamsize>(bytes.size()));
+}
+
+using Lines = std::vector<std::pair<size_t, double>>;
+
+bool sameLines(const Lines& a, const Lines& b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].first != b[i].first) return false;
+        bool nan = std::isnan(a[i].second) && std::isnan(b[i].second);
+        if (!nan && std::bit_cast<uint64_t>(a[i].second) != std::bit_cast<uint64_t>(b[i].second))
+            return false;
+    }
+    return true;
+}
+
+Lines direct(SpongeMetaEngine& eng, const fs::path& src)
+{
+    Lines out;
+    eng.runFile(src.string(), [&](size_t line, double v) { out.emplace_back(line, v); });
+    return out;
+}
+
+struct Cached {
+    Lines lines;
+    CachedRunResult result;
+};
+
+Cached cached(SpongeMetaEngine& eng, const fs::path& src, const fs::path& cache)
+{
+    Cached c;
+    c.result = eng.runFileCached(src.string(), cache.string(),
+                                 [&](size_t line, double v) { c.lines.emplace_back(line, v); });
+    return c;
+}
+
+// 캐시가 없거나 쓸 수 없는 상태: 다시 파싱하고 새로 써야 한다
+void expectRebuilt(SpongeMetaEngine& eng, const fs::path& src, const fs::path& cache,
+                   const std::string& what)
+{
+    Lines want = direct(eng, src);
+    try {
+        Cached c = cached(eng, src, cache);
+        expect(!c.result.fromCache && c.result.cacheWritten, what + ": cache not rebuilt");
+        expect(sameLines(c.lines, want), what + ": wrong results");
+        expect(c.result.expressions == want.size(), what + ": expression count");
+
+        Cached again = cached(eng, src, cache);
+        expect(again.result.fromCache && !again.result.cacheWritten, what + ": rebuilt cache not reused");
+        expect(sameLines(again.lines, want), what + ": wrong results from rebuilt cache");
+    } catch (const std::exception& e) {
+        expect(false, what + ": threw " + e.what());
+    }
+}
+
+void expectReused(SpongeMetaEngine& eng, const fs::path& src, const fs::path& cache,
+                  const std::string& what)
+{
+    Lines want = direct(eng, src);
+    Cached c = cached(eng, src, cache);
+    expect(c.result.fromCache && !c.result.cacheWritten, what + ": cache not reused");
+    expect(sameLines(c.lines, want), what + ": wrong results");
+}
+
+const char* const kSource =
+    "3 + 5 * 2\n"
+    "2 * 2 // 줄 끝 주석\n"
+    "\n"
+    "(1 + 2) * (3 + 4) min 20\n"
+    "0 / 0\n"
+    "0 * (0 - 1)\n"
+    "1e308 * 10 - 1\n"
+    "7 % 3 max 0.5\n"
+    "4.9406564584124654e-324 / 2\n"
+    "((2 * 2) * (2 * 2)) / ((2 * 2) * (2 * 2))";
+
+
+
+// ------------------------------------------------------
+// 경우
+// ------------------------------------------------------
+void reuse(const fs::path& dir)
+{
+    fs::path src = dir / "reuse.txt", cache = dir / "reuse.spbc";
+    writeAll(src, kSource);
+    fs::remove(cache);
+
+    SpongeMetaEngine eng;
+    MetaAbsorbLoader loader;
+    loader.mountFile(eng, SPONGE_PACKS_DIR "/rust.meta");
+
+    expectRebuilt(eng, src, cache, "no cache");
+    expectReused(eng, src, cache, "second run");
+
+    // 최적화 / 모드는 캐시 키가 아니다 (최적화 전 IR 을 담는다)
+    eng.setOptimize(false);
+    expectReused(eng, src, cache, "optimize off");
+    eng.setMode(ExecMode::VM);
+    eng.setHashCons(true);
+    expectReused(eng, src, cache, "VM + hash-cons");
+
+    // 다른 엔진 (같은 팩) 도 같은 캐시를 쓴다
+    SpongeMetaEngine other;
+    loader.mountFile(other, SPONGE_PACKS_DIR "/rust.meta");
+    expectReused(other, src, cache, "another engine");
+}
+
+void stale(const fs::path& dir)
+{
+    fs::path src = dir / "stale.txt", cache = dir / "stale.spbc";
+    writeAll(src, kSource);
+    fs::remove(cache);
+
+    SpongeMetaEngine eng;
+    MetaAbsorbLoader loader;
+    loader.mountFile(eng, SPONGE_PACKS_DIR "/rust.meta");
+    expectRebuilt(eng, src, cache, "first build");
+
+    // 크기가 같은 내용 변경
+    std::string edited = kSource;
+    edited[0] = '4';
+    writeAll(src, edited);
+    expectRebuilt(eng, src, cache, "same-size edit");
+
+    // 줄 추가
+    writeAll(src, edited + "\n1 + 1\n");
+    expectRebuilt(eng, src, cache, "appended line");
+
+    // 팩이 바뀌면 (연산자 표 / 지문) 낡은 캐시
+    loader.mountFile(eng, SPONGE_TESTS_DIR "/pow.meta");
+    expectRebuilt(eng, src, cache, "different pack");
+    loader.mountFile(eng, SPONGE_PACKS_DIR "/rust.meta");
+    expectRebuilt(eng, src, cache, "original pack again");
+}
+
+void corrupt(const fs::path& dir)
+{
+    fs::path src = dir / "corrupt.txt", cache = dir / "corrupt.spbc";
+    writeAll(src, kSource);
+    fs::remove(cache);
+
+    SpongeMetaEngine eng;
+    MetaAbsorbLoader loader;
+    loader.mountFile(eng, SPONGE_PACKS_DIR "/rust.meta");
+    expectRebuilt(eng, src, cache, "first build");
+    const std::string good = readAll(cache);
+    const Lines want = direct(eng, src);
+
+    // 바이트 하나씩 바꿔 본다: 거부되면 다시 만들고, 받아들여져도 결과는 맞아야 한다
+    size_t wrong = 0, rebuiltWithoutWrite = 0;
+    for (size_t i = 0; i < good.size(); ++i) {
+        std::string bytes = good;
+        bytes[i] = static_cast<char>(bytes[i] ^ (1 << (i % 8)));
+        writeAll(cache, bytes);
+        try {
+            Cached c = cached(eng, src, cache);
+            wrong += !sameLines(c.lines, want);
+            rebuiltWithoutWrite += !c.result.fromCache && !c.result.cacheWritten;
+        } catch (const std::exception& e) {
+            expect(false, "bit flip at byte " + std::to_string(i) + " threw " + e.what());
+        }
+    }
+    expect(wrong == 0, std::to_string(wrong) + " corrupted caches gave wrong results");
+    expect(rebuiltWithoutWrite == 0, std::to_string(rebuiltWithoutWrite) + " rejected caches not rewritten");
+    expect(readAll(cache) == good, "cache not restored after corruption");
+
+    // 잘린 캐시
+    size_t bad = 0;
+    for (size_t n = 0; n < good.size(); n += 1 + n / 16) {
+        writeAll(cache, good.substr(0, n));
+        size_t before = gFailures;
+        expectRebuilt(eng, src, cache, "truncated to " + std::to_string(n) + " bytes");
+        bad += gFailures != before;
+    }
+    expect(bad == 0, std::to_string(bad) + " truncated caches mishandled");
+
+    // 캐시 자리에 엉뚱한 내용
+    writeAll(cache, "");
+    expectRebuilt(eng, src, cache, "empty cache");
+    writeAll(cache, kSource);
+    expectRebuilt(eng, src, cache, "source text as cache");
+    writeAll(cache, good + std::string(16, '\0'));
+    expectRebuilt(eng, src, cache, "cache with trailing bytes");
+    writeAll(cache, readAll(SPONGE_PACKS_DIR "/rust.meta"));
+    expectRebuilt(eng, src, cache, "pack file as cache");
+}
+
+} // namespace
+
+
+
+int main()
+{
+    try {
+        fs::path dir = fs::path(SPONGE_TEST_TMP) / "cache_test";
+        fs::create_directories(dir);
+
+        reuse(dir);
+        stale(dir);
+        corrupt(dir);
+    } catch (const std::exception& e) {
+        expect(false, std::string("unexpected error: ") + e.what());
+    }
+
+    std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,619 @@
+// spongelang_differential_test: 모든 실행 경로가 TREE (최적화 끔) 와 같은 값을 내는지
+//
+// 기준: ExecMode::TREE, setOptimize(false), setHashCons(false)
+// 비교: TREE / VM / JIT / CLOSURE × 최적화 켬/끔 × hash-cons 켬/끔, evaluateColumns,
+//       emit() 한 C / Go / Rust 코드 (도구가 있으면 빌드해 실행)
+// 입력: 무작위 식 (같은 부분식 반복 포함 → DAG), 깊은 식 (왼쪽/오른쪽 중첩),
+//       NaN / ±Inf / -0 / 서브노멀 / 최대 유한값 리터럴과 컬럼 값,
+//       ^ (pow) 를 더한 팩 (tests/pow.meta) 에서 같은 생성기와 강도 줄이기 대상 식
+//
+// 두 값이 모두 NaN 이거나 비트 단위로 같아야 통과 (-0 과 +0 은 다르다).
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "meta_absorb_loader.hpp"
+#include "meta_engine.hpp"
+
+using namespace sponge;
+
+namespace {
+
+// ------------------------------------------------------
+// 비교 / 보고
+// ------------------------------------------------------
+size_t gChecks = 0;
+size_t gFailures = 0;
+
+bool same(double a, double b)
+{
+    if (std::isnan(a) && std::isnan(b)) return true;
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+}
+
+std::string shorten(const std::string& s)
+{
+    return s.size() <= 160 ? s : s.substr(0, 160) + "... (" + std::to_string(s.size()) + " chars)";
+}
+
+void check(const std::string& what, const std::string& src, double expect, double got)
+{
+    gChecks++;
+    if (same(expect, got)) return;
+    if (++gFailures <= 20)
+        std::printf("FAIL %s\n  src:    %s\n  expect: %.17g\n  got:    %.17g\n",
+                    what.c_str(), shorten(src).c_str(), expect, got);
+}
+
+void error(const std::string& what, const std::string& src, const std::exception& e)
+{
+    gChecks++;
+    if (++gFailures <= 20)
+        std::printf("FAIL %s\n  src:   %s\n  error: %s\n", what.c_str(), shorten(src).c_str(), e.what());
+}
+
+
+
+// ------------------------------------------------------
+// 엔진 구성
+// ------------------------------------------------------
+struct Config {
+    ExecMode mode;
+    bool optimize;
+    bool hashCons;
+};
+
+const char* modeName(ExecMode m)
+{
+    switch (m) {
+        case ExecMode::TREE:    return "TREE";
+        case ExecMode::VM:      return "VM";
+        case ExecMode::JIT:     return "JIT";
+        case ExecMode::CLOSURE: return "CLOSURE";
+    }
+    return "?";
+}
+
+std::string describe(const Config& c)
+{
+    return std::string(modeName(c.mode)) + (c.optimize ? " opt" : " noopt") +
+           (c.hashCons ? " hashcons" : "");
+}
+
+// 설정마다 엔진 하나 (설정을 바꾸면 프로그램 캐시가 비워지므로)
+struct Engines {
+    SpongeMetaEngine reference;
+    std::vector<Config> configs;
+    std::vector<std::unique_ptr<SpongeMetaEngine>> engines;
+
+    explicit Engines(const std::string& pack) {
+        MetaAbsorbLoader loader;
+        setup(reference, { ExecMode::TREE, false, false }, loader, pack);
+        for (ExecMode m : { ExecMode::TREE, ExecMode::VM, ExecMode::JIT, ExecMode::CLOSURE })
+            for (bool opt : { false, true })
+                for (bool hc : { false, true }) {
+                    configs.push_back({ m, opt, hc });
+                    engines.push_back(std::make_unique<SpongeMetaEngine>());
+                    setup(*engines.back(), configs.back(), loader, pack);
+                }
+    }
+
+    static void setup(SpongeMetaEngine& eng, const Config& c, MetaAbsorbLoader& loader,
+                      const std::string& pack) {
+        loader.mountFile(eng, pack);
+        eng.setMode(c.mode);
+        eng.setOptimize(c.optimize);
+        eng.setHashCons(c.hashCons);
+    }
+};
+
+
+
+// ------------------------------------------------------
+// 식 생성 (rust 팩: + - * / % min max, pow 팩: + ^)
+// ------------------------------------------------------
+const char* const kOps[] = { "+", "-", "*", "/", "%", "min", "max" };
+const char* const kPowOps[] = { "+", "-", "*", "/", "%", "min", "max", "^" };
+
+// 숫자 토큰만으로 특수값을 만든다 (팩에 단항 - 와 nan/inf 리터럴이 없다)
+const char* const kLiterals[] = {
+    "0", "1", "2", "3", "0.5", "7.25", "1e308", "1.7976931348623157e308",
+    "4.9406564584124654e-324",          // 가장 작은 서브노멀
+    "2.2250738585072014e-308",          // 가장 작은 정규수
+    "(1 / 0)", "(0 - 1 / 0)", "(0 / 0)", "(0 * (0 - 1))",
+};
+
+class ExprGen {
+public:
+    ExprGen(unsigned seed, std::vector<std::string> vars, std::span<const char* const> ops = kOps)
+        : rng(seed), vars(std::move(vars)), ops(ops) {}
+
+    std::string expr(int depth) {
+        pool.clear();
+        return node(depth);
+    }
+
+private:
+    std::mt19937 rng;
+    std::vector<std::string> vars;
+    std::span<const char* const> ops;
+    std::vector<std::string> pool;      // 이미 만든 부분식 (다시 써서 공유 노드를 만든다)
+
+    size_t pick(size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(rng); }
+
+    std::string leaf() {
+        if (!vars.empty() && pick(3) == 0) return vars[pick(vars.size())];
+        return kLiterals[pick(std::size(kLiterals))];
+    }
+
+    std::string node(int depth) {
+        if (depth == 0 || pick(5) == 0) return leaf();
+        if (!pool.empty() && pick(4) == 0) return pool[pick(pool.size())];
+
+        std::string s = "(";
+        s += node(depth - 1);
+        s += ' ';
+        s += ops[pick(ops.size())];
+        s += ' ';
+        s += node(depth - 1);
+        s += ')';
+        pool.push_back(s);
+        return s;
+    }
+};
+
+std::vector<std::string> deepExprs()
+{
+    std::vector<std::string> out;
+
+    // 왼쪽으로 깊은 사슬 (파서가 반복으로 쌓는다)
+    std::string left = "1";
+    const char* const steps[] = { " * 1.0000001", " + 0.5", " - 0.25" };
+    for (int i = 0; i < 100000; ++i) left += steps[i % 3];
+    out.push_back(left);
+
+    // 오른쪽으로 깊은 괄호 (값 스택 깊이 = 중첩 수)
+    std::string right;
+    const int depth = 20000;
+    for (int i = 0; i < depth; ++i) right += (i % 2 == 0) ? "0.5 + (" : "2 * (";
+    right += "1";
+    right += std::string(depth, ')');
+    out.push_back(right);
+
+    // 같은 부분식을 두 번씩: hash-cons 이면 노드 수가 선형, 아니면 트리로 2^16 잎
+    std::string dup = "0.75";
+    for (int i = 0; i < 16; ++i) dup = "((" + dup + ") " + kOps[i % std::size(kOps)] + " (" + dup + "))";
+    out.push_back(dup);
+
+    // 특수값이 깊이 전파되는 사슬
+    std::string special = "(0 / 0)";
+    for (int i = 0; i < 5000; ++i) special = "(" + special + (i % 2 ? " max 1)" : " min (1 / 0))");
+    out.push_back(special);
+    return out;
+}
+
+
+// pow 팩: POW 와 그 최적화 (x ^ 1 → x, x ^ 0 → 1, 잎 x ^ 2 → x * x,
+// 2 의 거듭제곱으로 나누기 → 역수 곱하기) 가 특수값에서도 그대로인지
+const char* const kPowRunExprs[] = {
+    "(0 / 0) ^ 0", "(1 / 0) ^ 0", "(0 * (0 - 1)) ^ 1", "(0 - 1 / 0) ^ 1", "(0 / 0) ^ 1",
+    "(0 * (0 - 1)) ^ 2", "1e308 ^ 2", "4.9406564584124654e-324 ^ 2", "(0 - 1 / 0) ^ 2",
+    "(0 - 1) ^ (1 / 0)", "1 ^ (0 / 0)", "(0 * (0 - 1)) ^ (0 - 1)", "0 ^ (0 - 1)",
+    "2 ^ 3 ^ 2", "(2 ^ 3) ^ 2", "(0.5 + 1) ^ 2", "(7.25 - 3) ^ 2 ^ 0.5",
+    "1 / 4.9406564584124654e-324", "(0 * (0 - 1)) / 0.5", "3 / 2.2250738585072014e-308",
+};
+
+const char* const kPowColumnExprs[] = {
+    "u ^ 0", "u ^ 1", "u ^ 2", "u ^ 0.5", "u ^ v", "v ^ u", "(u + v) ^ 2", "(u * v) ^ 1",
+    "u ^ 2 ^ v", "(u ^ 2) ^ v", "u / 2", "u / 0.5", "u / 4.9406564584124654e-324",
+    "(u - v) / 1024", "u * 2", "2 * (u + v)",
+};
+
+
+
+// ------------------------------------------------------
+// run(): 상수 식
+// ------------------------------------------------------
+void compareRun(Engines& e, const std::string& src)
+{
+    double expect;
+    try {
+        expect = e.reference.run(src);
+    } catch (const std::exception& ex) {
+        error("reference TREE", src, ex);
+        return;
+    }
+
+    for (size_t i = 0; i < e.engines.size(); ++i) {
+        std::string what = "run " + describe(e.configs[i]);
+        try {
+            check(what, src, expect, e.engines[i]->run(src));
+        } catch (const std::exception& ex) {
+            error(what, src, ex);
+        }
+    }
+}
+
+
+
+// ------------------------------------------------------
+// evaluateColumns(): 변수 식을 행마다 리터럴로 바꾼 TREE 결과와 비교
+// ------------------------------------------------------
+const double kColumnValues[] = {
+    0.0, -0.0, 1.0, -3.5, 0.5, 7.0, 1e308,
+    INFINITY, -INFINITY, NAN,
+    4.9406564584124654e-324, 2.2250738585072014e-308,
+};
+
+// 값 하나를 이 팩의 식으로 (음수는 0 - x)
+std::string literalOf(double v)
+{
+    if (std::isnan(v)) return "(0 / 0)";
+    if (std::isinf(v)) return v > 0 ? "(1 / 0)" : "(0 - 1 / 0)";
+    if (v == 0) return std::signbit(v) ? "(0 * (0 - 1))" : "0";
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", std::fabs(v));
+    return v < 0 ? "(0 - " + std::string(buf) + ")" : std::string(buf);
+}
+
+bool identChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// 식별자 u / v 를 통째로 바꾼다 (min / max 안의 글자는 건드리지 않음)
+std::string substitute(const std::string& src, const std::string& u, const std::string& v)
+{
+    std::string out;
+    for (size_t i = 0; i < src.size(); ++i) {
+        char c = src[i];
+        bool alone = (c == 'u' || c == 'v') &&
+                     (i == 0 || !identChar(src[i - 1])) &&
+                     (i + 1 == src.size() || !identChar(src[i + 1]));
+        if (alone) out += c == 'u' ? u : v;
+        else out += c;
+    }
+    return out;
+}
+
+// kColumnValues 의 모든 (u, v) 쌍
+struct Rows {
+    std::vector<double> us, vs;
+
+    Rows() {
+        for (double a : kColumnValues)
+            for (double b : kColumnValues) {
+                us.push_back(a);
+                vs.push_back(b);
+            }
+    }
+};
+
+// 행마다 u / v 를 리터럴로 바꿔 기준 엔진으로 계산
+bool expectRows(Engines& e, const std::string& src, const Rows& rows, std::vector<double>& expect)
+{
+    expect.resize(rows.us.size());
+    for (size_t r = 0; r < rows.us.size(); ++r) {
+        std::string row = substitute(src, literalOf(rows.us[r]), literalOf(rows.vs[r]));
+        try {
+            expect[r] = e.reference.run(row);
+        } catch (const std::exception& ex) {
+            error("reference TREE", row, ex);
+            return false;
+        }
+    }
+    return true;
+}
+
+void checkRows(const std::string& what, const std::string& src, const Rows& rows,
+               const std::vector<double>& expect, const std::vector<double>& got)
+{
+    for (size_t r = 0; r < rows.us.size(); ++r) {
+        size_t before = gFailures;
+        check(what, src, expect[r], got[r]);
+        if (gFailures != before && gFailures <= 20)
+            std::printf("  row:    u = %.17g, v = %.17g\n", rows.us[r], rows.vs[r]);
+    }
+}
+
+void compareColumns(Engines& e, const std::string& src)
+{
+    Rows rows;
+    std::vector<double> expect;
+    if (!expectRows(e, src, rows, expect)) return;
+    const std::vector<double>& us = rows.us;
+    const std::vector<double>& vs = rows.vs;
+
+    std::unordered_map<std::string, std::span<const double>> columns = {
+        { "u", us }, { "v", vs },
+    };
+    // 모드는 컬럼 평가에 쓰이지 않으므로 TREE 설정 엔진 (최적화 × hash-cons) 만
+    for (size_t i = 0; i < e.engines.size(); ++i) {
+        if (e.configs[i].mode != ExecMode::TREE) continue;
+        std::string what = "columns " + describe(e.configs[i]);
+        try {
+            checkRows(what, src, rows, expect, e.engines[i]->evaluateColumns(src, columns));
+        } catch (const std::exception& ex) {
+            error(what, src, ex);
+        }
+    }
+}
+
+
+
+// ------------------------------------------------------
+// emit(): 옮긴 코드를 대상 언어 도구로 빌드해 모든 (u, v) 행을 출력시킨다
+//
+// 식은 u 가 v 보다 먼저 나와야 한다 (매개변수는 처음 나온 순서).
+// 도구는 CMake 가 찾은 경우에만 정의된다 (SPONGE_CC / SPONGE_GO / SPONGE_RUSTC).
+// ------------------------------------------------------
+namespace fs = std::filesystem;
+
+struct Backend {
+    const char* name;           // emit 백엔드
+    const char* tool;           // 빌드 명령 (없으면 nullptr)
+    const char* ext;
+    std::string (*value)(double);
+    std::string (*driver)(const std::string& us, const std::string& vs);
+    std::string (*build)(const std::string& tool, const fs::path& src, const fs::path& exe);
+};
+
+std::string plain(double v)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+// 소수점이 없으면 ".0" 을 붙여 실수 리터럴로 (정수 -0 은 +0 이 된다)
+std::string floating(double v)
+{
+    std::string s = plain(v);
+    if (s.find_first_of(".e") == std::string::npos) s += ".0";
+    return s;
+}
+
+std::string cValue(double v)
+{
+    if (std::isnan(v)) return "NAN";
+    if (std::isinf(v)) return v > 0 ? "INFINITY" : "-INFINITY";
+    return floating(v);
+}
+
+std::string goValue(double v)
+{
+    // Go 상수 -0.0 은 +0 이 된다
+    if (std::isnan(v)) return "math.NaN()";
+    if (std::isinf(v)) return v > 0 ? "math.Inf(1)" : "math.Inf(-1)";
+    if (v == 0 && std::signbit(v)) return "math.Copysign(0, -1)";
+    return plain(v);
+}
+
+std::string rustValue(double v)
+{
+    if (std::isnan(v)) return "f64::NAN";
+    if (std::isinf(v)) return v > 0 ? "f64::INFINITY" : "f64::NEG_INFINITY";
+    return floating(v) + "_f64";
+}
+
+std::string cDriver(const std::string& us, const std::string& vs)
+{
+    std::string s = "\nint main(void)\n{\n    const double us[] = { ";
+    s += us;
+    s += " };\n    const double vs[] = { ";
+    s += vs;
+    s += " };\n    for (unsigned i = 0; i < sizeof(us) / sizeof(us[0]); ++i)\n"
+         "        printf(\"%.17g\\n\", sponge_expr(us[i], vs[i]));\n    return 0;\n}\n";
+    return s;
+}
+
+std::string goDriver(const std::string& us, const std::string& vs)
+{
+    std::string s = "package main\n\nimport (\n    \"fmt\"\n    \"math\"\n)\n\n"
+                    "var _ = math.NaN\n\nfunc main() {\n    us := []float64{ ";
+    s += us;
+    s += " }\n    vs := []float64{ ";
+    s += vs;
+    s += " }\n    for i := range us {\n        fmt.Println(spongeExpr(us[i], vs[i]))\n    }\n}\n";
+    return s;
+}
+
+std::string rustDriver(const std::string& us, const std::string& vs)
+{
+    std::string s = "\nfn main() {\n    let us = [ ";
+    s += us;
+    s += " ];\n    let vs = [ ";
+    s += vs;
+    s += " ];\n    for i in 0..us.len() {\n        println!(\"{}\", sponge_expr(us[i], vs[i]));\n    }\n}\n";
+    return s;
+}
+
+std::string quoted(const fs::path& p)
+{
+    return "'" + p.string() + "'";
+}
+
+std::string cBuild(const std::string& tool, const fs::path& src, const fs::path& exe)
+{
+    return tool + " -std=c99 -O2 -o " + quoted(exe) + " " + quoted(src) + " -lm";
+}
+
+std::string goBuild(const std::string& tool, const fs::path& src, const fs::path& exe)
+{
+    fs::path driver = src;
+    driver.replace_extension(".main.go");
+    return tool + " build -o " + quoted(exe) + " " + quoted(src) + " " + quoted(driver);
+}
+
+std::string rustBuild(const std::string& tool, const fs::path& src, const fs::path& exe)
+{
+    return tool + " -O -o " + quoted(exe) + " " + quoted(src);
+}
+
+#ifdef SPONGE_CC
+constexpr const char* kCC = SPONGE_CC;
+#else
+constexpr const char* kCC = nullptr;
+#endif
+#ifdef SPONGE_GO
+constexpr const char* kGo = SPONGE_GO;
+#else
+constexpr const char* kGo = nullptr;
+#endif
+#ifdef SPONGE_RUSTC
+constexpr const char* kRustc = SPONGE_RUSTC;
+#else
+constexpr const char* kRustc = nullptr;
+#endif
+
+const Backend kBackends[] = {
+    { "c",    kCC,    ".c",  cValue,    cDriver,    cBuild },
+    { "go",   kGo,    ".go", goValue,   goDriver,   goBuild },
+    { "rust", kRustc, ".rs", rustValue, rustDriver, rustBuild },
+};
+
+// NaN / ±0 에서 std::min / std::max 와 fmin / math.Min / f64::min 이 갈린다
+const char* const kEmitExprs[] = {
+    "u min v",
+    "u max v",
+    "(u min v) max (v min u)",
+    "(u max 0) min (v * 0)",
+    "(u + v) min (u - v) max (u * v)",
+    "(u % v) max (v / u)",
+};
+
+// 빌드한 프로그램의 출력 (한 줄에 값 하나)
+bool runOutput(const std::string& cmd, std::vector<double>& out)
+{
+    FILE* p = popen(cmd.c_str(), "r");
+    if (!p) return false;
+    out.clear();
+    char line[512];
+    while (std::fgets(line, sizeof(line), p)) out.push_back(std::strtod(line, nullptr));
+    return pclose(p) == 0;
+}
+
+void compareEmit(Engines& e, const Backend& b, const std::string& src, const fs::path& dir, size_t index)
+{
+    Rows rows;
+    std::vector<double> expect;
+    if (!expectRows(e, src, rows, expect)) return;
+
+    std::string us, vs;
+    for (size_t r = 0; r < rows.us.size(); ++r) {
+        if (r) { us += ", "; vs += ", "; }
+        us += b.value(rows.us[r]);
+        vs += b.value(rows.vs[r]);
+    }
+
+    std::string what = std::string("emit ") + b.name;
+    fs::path file = dir / (std::string("expr") + std::to_string(index) + b.ext);
+    fs::path exe = dir / (std::string(b.name) + "_expr" + std::to_string(index));
+    fs::path log = dir / (std::string(b.name) + "_expr" + std::to_string(index) + ".log");
+    try {
+        std::string code;
+        e.reference.emit(src, b.name, code);
+        std::string driver = b.driver(us, vs);
+        if (std::string(b.name) == "go") {
+            fs::path main = file;
+            main.replace_extension(".main.go");
+            std::ofstream(main) << driver;
+        } else {
+            code += driver;
+        }
+        std::ofstream(file) << code;
+    } catch (const std::exception& ex) {
+        error(what, src, ex);
+        return;
+    }
+
+    gChecks++;
+    if (std::system((b.build(b.tool, file, exe) + " > " + quoted(log) + " 2>&1").c_str()) != 0) {
+        if (++gFailures <= 20)
+            std::printf("FAIL %s\n  src:   %s\n  build failed, see %s\n", what.c_str(), src.c_str(),
+                        log.string().c_str());
+        return;
+    }
+
+    std::vector<double> got;
+    gChecks++;
+    if (!runOutput(quoted(exe), got) || got.size() != rows.us.size()) {
+        if (++gFailures <= 20)
+            std::printf("FAIL %s\n  src:   %s\n  bad output from %s\n", what.c_str(), src.c_str(),
+                        exe.string().c_str());
+        return;
+    }
+    checkRows(what, src, rows, expect, got);
+}
+
+void compareEmitted(Engines& e)
+{
+    fs::path dir = fs::path(SPONGE_TEST_TMP) / "differential_emit";
+    fs::create_directories(dir);
+    for (const Backend& b : kBackends) {
+        if (!b.tool) {
+            std::printf("skip emit %s: no toolchain\n", b.name);
+            continue;
+        }
+        for (size_t i = 0; i < std::size(kEmitExprs); ++i)
+            compareEmit(e, b, kEmitExprs[i], dir, i);
+    }
+}
+
+} // namespace
+
+
+
+int main()
+{
+    try {
+        Engines e(SPONGE_PACKS_DIR "/rust.meta");
+
+        ExprGen constants(20240611u, {});
+        for (int i = 0; i < 400; ++i)
+            compareRun(e, constants.expr(1 + i % 8));
+
+        for (const std::string& src : deepExprs())
+            compareRun(e, src);
+
+        ExprGen variables(7u, { "u", "v" });
+        for (int i = 0; i < 150; ++i)
+            compareColumns(e, variables.expr(1 + i % 6));
+
+        compareEmitted(e);
+
+        Engines pow(SPONGE_TESTS_DIR "/pow.meta");
+
+        ExprGen powConstants(990217u, {}, kPowOps);
+        for (int i = 0; i < 300; ++i)
+            compareRun(pow, powConstants.expr(1 + i % 7));
+        for (const char* src : kPowRunExprs)
+            compareRun(pow, src);
+
+        ExprGen powVariables(31u, { "u", "v" }, kPowOps);
+        for (int i = 0; i < 100; ++i)
+            compareColumns(pow, powVariables.expr(1 + i % 5));
+        for (const char* src : kPowColumnExprs)
+            compareColumns(pow, src);
+    } catch (const std::exception& ex) {
+        std::printf("FAIL setup: %s\n", ex.what());
+        return 1;
+    }
+
+    std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+// spongelang_pack_test: 바이너리 언어팩 (.spack)
+//
+// 왕복: 텍스트 .meta 와 그것을 compileBinaryPack() 한 .spack 이 같은 LangPack 으로 풀리고
+//       흡수한 엔진이 같은 식에 비트 단위로 같은 값을 내는지
+// 거부: checksum 뒤 아무 바이트를 바꾸거나, 헤더 필드를 망가뜨리거나, 어느 길이로 잘라도
+//       PackImage / mountFile 이 runtime_error 로 거부하는지 (crash 없이)
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "meta_absorb_loader.hpp"
+#include "meta_engine.hpp"
+#include "meta_pack_binary.hpp"
+
+using namespace sponge;
+namespace fs = std::filesystem;
+
+namespace {
+
+// ------------------------------------------------------
+// 보고
+// ------------------------------------------------------
+size_t gChecks = 0;
+size_t gFailures = 0;
+
+void expect(bool ok, const std::string& what)
+{
+    gChecks++;
+    if (!ok && ++gFailures <= 20) std::printf("FAIL %s\n", what.c_str());
+}
+
+
+
+// ------------------------------------------------------
+// 파일
+// ------------------------------------------------------
+std::string readAll(const fs::path& p)
+{
+    std::ifstream in(p, std::ios::binary);
+    return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+}
+
+void writeAll(const fs::path& p, const std::string& bytes)
+{
+    std::ofstream(p, std::ios::binary | std::ios::trunc).write(bytes.data(),
+                                                               static_cast<std::streamsize>(bytes.size()));
+}
+
+// 이 파일을 PackImage 가 runtime_error 로 거부해야 한다.
+// magic 이 남아 있으면 mountFile 도 (magic 이 없으면 텍스트 팩으로 읽는 것이 맞다)
+void expectRejected(const fs::path& p, const std::string& what)
+{
+    bool image = false, mount = true;
+    try {
+        PackImage img(p.string());
+    } catch (const std::runtime_error&) {
+        image = true;
+    }
+    if (PackImage::isBinary(readAll(p))) {
+        try {
+            SpongeMetaEngine eng;
+            MetaAbsorbLoader loader;
+            loader.mountFile(eng, p.string());
+            mount = false;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    expect(image && mount, what + " was accepted");
+}
+
+
+
+// ------------------------------------------------------
+// 왕복
+// ------------------------------------------------------
+using Pairs = std::map<std::string, std::string>;
+
+template<class Map>
+Pairs sorted(const Map& m)
+{
+    Pairs out;
+    for (auto& [k, v] : m) out[k] = v;
+    return out;
+}
+
+Pairs precedence(const MetaAbsorbLoader::LangPack& p)
+{
+    Pairs out;
+    for (auto& [k, v] : p.precedence) out[k] = std::to_string(v);
+    return out;
+}
+
+void sameLangPack(const MetaAbsorbLoader::LangPack& text, const MetaAbsorbLoader::LangPack& binary,
+                  const std::string& what)
+{
+    expect(text.name == binary.name, what + ": name");
+    expect(sorted(text.tokens) == sorted(binary.tokens), what + ": tokens");
+    expect(precedence(text) == precedence(binary), what + ": precedence");
+    expect(sorted(text.associativity) == sorted(binary.associativity), what + ": associativity");
+    expect(sorted(text.evalRules) == sorted(binary.evalRules), what + ": evaluate rules");
+    expect(sorted(text.bytecode) == sorted(binary.bytecode), what + ": bytecode");
+    expect(sorted(text.irRules) == sorted(binary.irRules), what + ": ir rules");
+}
+
+bool same(double a, double b)
+{
+    if (std::isnan(a) && std::isnan(b)) return true;
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+}
+
+void sameResults(const fs::path& meta, const fs::path& spack, const std::vector<std::string>& exprs)
+{
+    SpongeMetaEngine text, binary;
+    MetaAbsorbLoader loader;
+    loader.mountFile(text, meta.string());
+    loader.mountFile(binary, spack.string());
+
+    for (const std::string& src : exprs) {
+        std::string what = spack.filename().string() + ": " + src;
+        try {
+            double a = text.run(src);
+            double b = binary.run(src);
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), " = %.17g, .spack gives %.17g", a, b);
+            expect(same(a, b), what + buf);
+        } catch (const std::exception& e) {
+            expect(false, what + ": " + e.what());
+        }
+    }
+}
+
+fs::path roundTrip(const fs::path& meta, const fs::path& dir, const std::vector<std::string>& exprs)
+{
+    MetaAbsorbLoader loader;
+    MetaAbsorbLoader::LangPack pack = loader.loadFromFile(meta.string());
+    fs::path spack = dir / meta.filename().replace_extension(".spack");
+    compileBinaryPack(pack, spack.string());
+
+    PackImage img(spack.string());
+    sameLangPack(pack, img.toLangPack(), spack.filename().string());
+    sameResults(meta, spack, exprs);
+    return spack;
+}
+
+
+
+// ------------------------------------------------------
+// 손상
+// ------------------------------------------------------
+void corruptBody(const fs::path& spack, const fs::path& dir)
+{
+    const std::string good = readAll(spack);
+    fs::path bad = dir / "corrupt.spack";
+
+    // checksum 필드 뒤는 (헤더의 개수 / 오프셋 포함) 체크섬이 덮으므로 어느 바이트든 한 비트만 바뀌어도 거부
+    size_t accepted = 0;
+    for (size_t i = kPackChecksumFrom; i < good.size(); ++i) {
+        std::string bytes = good;
+        bytes[i] = static_cast<char>(bytes[i] ^ (1 << (i % 8)));
+        writeAll(bad, bytes);
+        size_t before = gFailures;
+        expectRejected(bad, "bit flip at byte " + std::to_string(i));
+        accepted += gFailures != before;
+    }
+    expect(accepted == 0, std::to_string(accepted) + " corrupted bodies accepted");
+}
+
+void corruptHeader(const fs::path& spack, const fs::path& dir)
+{
+    const std::string good = readAll(spack);
+    fs::path bad = dir / "header.spack";
+
+    auto patch = [&](size_t offset, uint32_t value, const std::string& what) {
+        std::string bytes = good;
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+        writeAll(bad, bytes);
+        expectRejected(bad, what);
+    };
+
+    {
+        std::string bytes = good;
+        bytes[0] = 'X';
+        writeAll(bad, bytes);
+        expectRejected(bad, "bad magic");
+    }
+    patch(offsetof(PackFileHeader, version), kPackVersion - 1, "old version");
+    patch(offsetof(PackFileHeader, version), kPackVersion + 1, "new version");
+    patch(offsetof(PackFileHeader, byteOrder), 0x04030201u, "swapped byte order");
+    patch(offsetof(PackFileHeader, fileSize), static_cast<uint32_t>(good.size() + 8), "wrong file size");
+    patch(offsetof(PackFileHeader, checksum), 0, "wrong checksum");
+
+    // 섹션 오프셋: 범위 밖 / 헤더 안 / 정렬 안 됨
+    const size_t offsets[] = {
+        offsetof(PackFileHeader, stringsOffset), offsetof(PackFileHeader, tokensOffset),
+        offsetof(PackFileHeader, opsOffset),     offsetof(PackFileHeader, bindingsOffset),
+        offsetof(PackFileHeader, irOffset),      offsetof(PackFileHeader, rulesOffset),
+        offsetof(PackFileHeader, classOffset),   offsetof(PackFileHeader, nextOffset),
+        offsetof(PackFileHeader, acceptOffset),  offsetof(PackFileHeader, blobOffset),
+    };
+    for (size_t off : offsets) {
+        std::string field = "offset field at " + std::to_string(off);
+        patch(off, 0xFFFFFFF8u, field + " past the end");
+        patch(off, 0, field + " inside the header");
+        uint32_t v;
+        std::memcpy(&v, good.data() + off, sizeof(v));
+        patch(off, v + 4, field + " misaligned");
+    }
+
+    // 개수: 파일보다 큰 섹션
+    const size_t counts[] = {
+        offsetof(PackFileHeader, stringCount), offsetof(PackFileHeader, tokenCount),
+        offsetof(PackFileHeader, opCount),     offsetof(PackFileHeader, irCount),
+        offsetof(PackFileHeader, ruleCount),   offsetof(PackFileHeader, stateCount),
+        offsetof(PackFileHeader, blobSize),
+    };
+    for (size_t off : counts)
+        patch(off, 0x7FFFFFFFu, "count field at " + std::to_string(off) + " too large");
+}
+
+void truncated(const fs::path& spack, const fs::path& dir)
+{
+    const std::string good = readAll(spack);
+    fs::path bad = dir / "truncated.spack";
+
+    size_t accepted = 0;
+    for (size_t n = 0; n < good.size(); ++n) {
+        writeAll(bad, good.substr(0, n));
+        size_t before = gFailures;
+        expectRejected(bad, "truncated to " + std::to_string(n) + " bytes");
+        accepted += gFailures != before;
+    }
+    expect(accepted == 0, std::to_string(accepted) + " truncated packs accepted");
+
+    // 뒤에 덧붙은 바이트도 fileSize 와 맞지 않는다
+    writeAll(bad, good + std::string(8, '\0'));
+    expectRejected(bad, "pack with trailing bytes");
+}
+
+} // namespace
+
+
+
+int main()
+{
+    try {
+        fs::path dir = fs::path(SPONGE_TEST_TMP) / "pack_test";
+        fs::create_directories(dir);
+
+        fs::path rust = roundTrip(SPONGE_PACKS_DIR "/rust.meta", dir, {
+            "3 + 5 * 2", "(1 + 2) * 3 - 4 / 8", "7 % 3 + 1 min 2 max 0.5",
+            "1e308 * 10", "0 / 0", "0 * (0 - 1)", "2 - 3 - 4", "8 / 4 / 2",
+            "4.9406564584124654e-324 / 2", "1 // comment\n + 2",
+        });
+        roundTrip(SPONGE_TESTS_DIR "/pow.meta", dir, {
+            "2 ^ 3 ^ 2", "(2 ^ 3) ^ 2", "2 * 3 ^ 2", "(0 - 8) ^ (1 / 3)", "0 ^ (0 - 1)",
+            "(0 / 0) ^ 0", "1 + 2 ^ 0.5 min 1",
+        });
+
+        corruptBody(rust, dir);
+        corruptHeader(rust, dir);
+        truncated(rust, dir);
+
+        // 텍스트 팩은 바이너리 팩으로 읽히지 않는다
+        expect(!PackImage::isBinary(readAll(SPONGE_PACKS_DIR "/rust.meta")), "text pack looks binary");
+    } catch (const std::exception& e) {
+        expect(false, std::string("unexpected error: ") + e.what());
+    }
+
+    std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
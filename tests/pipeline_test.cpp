@@ -0,0 +1,220 @@
+// spongelang_pipeline_test: --stream 파이프라인 (runPipeline)
+//
+// 순서: chunk 를 아주 작게 잘라도 출력 줄이 입력 줄과 1:1, 같은 순서인지
+// 오류: onError 가 전체 입력 기준 줄 번호로 불리고 그 줄이 "nan" 인지,
+//       onError 가 없으면 첫 오류가 "line N: …" 로 던져지는지
+// 끝:   마지막 줄에 줄바꿈이 없어도 평가되고 출력은 줄바꿈으로 끝나는지
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "meta_absorb_loader.hpp"
+#include "meta_engine.hpp"
+#include "meta_pipeline.hpp"
+
+using namespace sponge;
+
+namespace {
+
+// ------------------------------------------------------
+// 보고
+// ------------------------------------------------------
+size_t gChecks = 0;
+size_t gFailures = 0;
+
+void expect(bool ok, const std::string& what)
+{
+    gChecks++;
+    if (!ok && ++gFailures <= 20) std::printf("FAIL %s\n", what.c_str());
+}
+
+
+
+// ------------------------------------------------------
+// 실행
+// ------------------------------------------------------
+struct Result {
+    std::string output;
+    std::vector<uint64_t> errorLines;
+    PipelineStats stats;
+};
+
+// input 을 임시 파일로 흘려 runPipeline 을 돌린다 (collectErrors 가 아니면 onError 없음)
+Result pipe(SpongeMetaEngine& eng, const std::string& input, size_t chunk, size_t depth,
+            bool collectErrors = true)
+{
+    std::FILE* in = std::tmpfile();
+    std::FILE* out = std::tmpfile();
+    if (!in || !out) throw std::runtime_error("tmpfile failed");
+    std::fwrite(input.data(), 1, input.size(), in);
+    std::rewind(in);
+
+    Result r;
+    PipelineOptions options;
+    options.chunkBytes = chunk;
+    options.queueDepth = depth;
+    if (collectErrors)
+        options.onError = [&](uint64_t lineNo, const std::string&) { r.errorLines.push_back(lineNo); };
+
+    try {
+        r.stats = runPipeline(eng, in, out, options);
+    } catch (...) {
+        std::fclose(in);
+        std::fclose(out);
+        throw;
+    }
+
+    std::rewind(out);
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), out)) > 0) r.output.append(buf, n);
+    std::fclose(in);
+    std::fclose(out);
+    return r;
+}
+
+std::string where(size_t chunk, size_t depth)
+{
+    return " (chunk " + std::to_string(chunk) + ", depth " + std::to_string(depth) + ")";
+}
+
+// 첫 다른 줄 번호 (같으면 0)
+size_t firstDifference(const std::string& a, const std::string& b)
+{
+    size_t line = 1;
+    for (size_t i = 0; i < a.size() || i < b.size(); ++i) {
+        if (i >= a.size() || i >= b.size() || a[i] != b[i]) return line;
+        if (a[i] == '\n') line++;
+    }
+    return 0;
+}
+
+
+
+// ------------------------------------------------------
+// 경우
+// ------------------------------------------------------
+const size_t kChunks[] = { 1, 7, 64, 4096, size_t(1) << 20 };
+const size_t kDepths[] = { 1, 4 };
+
+// 줄마다 다른 값: 순서가 바뀌거나 줄이 빠지면 바로 드러난다
+void ordering(SpongeMetaEngine& eng)
+{
+    std::string input, expect;
+    for (int i = 1; i <= 20000; ++i) {
+        input += std::to_string(i) + " * 2 + 1\n";
+        expect += std::to_string(i * 2 + 1) + "\n";
+    }
+
+    for (size_t chunk : kChunks)
+        for (size_t depth : kDepths) {
+            Result r = pipe(eng, input, chunk, depth);
+            size_t diff = firstDifference(r.output, expect);
+            ::expect(diff == 0, "ordering differs at line " + std::to_string(diff) + where(chunk, depth));
+            ::expect(r.stats.lines == 20000 && r.stats.expressions == 20000 && r.stats.errors == 0,
+                     "ordering stats" + where(chunk, depth));
+        }
+}
+
+// 잘못된 줄 / 빈 줄이 섞인 입력
+void errors(SpongeMetaEngine& eng)
+{
+    std::string input, expect;
+    std::vector<uint64_t> bad;
+    const char* const broken[] = { "1 +", "(2 * 3", "4 $ 5", ")" };
+    for (uint64_t line = 1; line <= 3000; ++line) {
+        if (line % 97 == 0) {
+            input += broken[line % std::size(broken)];
+            expect += "nan";
+            bad.push_back(line);
+        } else if (line % 13 == 0) {
+            // 빈 줄은 빈 줄로
+        } else {
+            input += std::to_string(line) + " - 1";
+            expect += std::to_string(line - 1);
+        }
+        input += '\n';
+        expect += '\n';
+    }
+
+    for (size_t chunk : kChunks)
+        for (size_t depth : kDepths) {
+            Result r = pipe(eng, input, chunk, depth);
+            size_t diff = firstDifference(r.output, expect);
+            ::expect(diff == 0, "error output differs at line " + std::to_string(diff) + where(chunk, depth));
+            ::expect(r.errorLines == bad, "onError line numbers" + where(chunk, depth));
+            ::expect(r.stats.lines == 3000 && r.stats.errors == bad.size(), "error stats" + where(chunk, depth));
+        }
+
+    // onError 가 없으면 첫 오류에서 전체 기준 줄 번호로 던진다
+    for (size_t chunk : kChunks) {
+        try {
+            pipe(eng, input, chunk, 2, false);
+            ::expect(false, "no onError: did not throw" + where(chunk, 2));
+        } catch (const std::exception& e) {
+            std::string msg = e.what();
+            ::expect(msg.rfind("line 97: ", 0) == 0, "no onError: " + msg + where(chunk, 2));
+        }
+    }
+}
+
+// 마지막 줄에 줄바꿈이 없는 입력
+void finalLine(SpongeMetaEngine& eng)
+{
+    struct Case {
+        const char* input;
+        const char* output;
+        std::vector<uint64_t> bad;
+    };
+    const Case cases[] = {
+        { "1 + 1\n2 * 3", "2\n6\n", {} },
+        { "1 + 1\n2 *", "2\nnan\n", { 2 } },
+        { "7", "7\n", {} },
+        { "1\n\n", "1\n\n", {} },
+        { "1\n\n2", "1\n\n2\n", {} },
+        { "", "", {} },
+        { "\n", "\n", {} },
+        { "123456789 + 0.5 * 0", "1.23457e+08\n", {} },
+    };
+
+    for (const Case& c : cases)
+        for (size_t chunk : kChunks) {
+            Result r = pipe(eng, c.input, chunk, 2);
+            std::string what = std::string("input \"") + c.input + "\"" + where(chunk, 2);
+            expect(r.output == c.output, what + " gave \"" + r.output + "\"");
+            expect(r.errorLines == c.bad, what + " error lines");
+        }
+
+    // 한 줄이 chunk 보다 훨씬 길어도
+    std::string longLine = "1";
+    for (int i = 0; i < 5000; ++i) longLine += " + 1";
+    for (size_t chunk : kChunks) {
+        Result r = pipe(eng, longLine, chunk, 2);
+        expect(r.output == "5001\n", "long final line" + where(chunk, 2));
+    }
+}
+
+} // namespace
+
+
+
+int main()
+{
+    try {
+        SpongeMetaEngine eng;
+        MetaAbsorbLoader loader;
+        loader.mountFile(eng, SPONGE_PACKS_DIR "/rust.meta");
+
+        ordering(eng);
+        errors(eng);
+        finalLine(eng);
+    } catch (const std::exception& e) {
+        expect(false, std::string("unexpected error: ") + e.what());
+    }
+
+    std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+// spongelang_script_test: .sp 스크립트 프런트엔드 회귀 테스트
+//
+// 깊은 중첩: 파서가 "nested too deeply" 로 거절해야 한다 (컴파일러 / 인터프리터 /
+//            AST 해제가 재귀라서 그대로 받으면 스택이 넘친다)
+// 상한 안쪽: VM 과 인터프리터가 같은 출력을 내야 한다
+// 예제:      examples/xagi_fullstack.sp 를 VM 과 인터프리터 (spongelang run --interp) 로
+//            돌린 출력이 같아야 한다
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "meta_script_compiler.hpp"
+#include "meta_script_interp.hpp"
+#include "meta_script_parser.hpp"
+#include "meta_script_vm.hpp"
+
+using namespace sponge;
+
+namespace {
+
+// ------------------------------------------------------
+// 보고
+// ------------------------------------------------------
+size_t gChecks = 0;
+size_t gFailures = 0;
+
+void fail(const std::string& what, const std::string& detail)
+{
+    if (++gFailures <= 20) std::printf("FAIL %s\n  %s\n", what.c_str(), detail.c_str());
+}
+
+
+
+// ------------------------------------------------------
+// 실행
+// ------------------------------------------------------
+std::string runVM(const std::string& src)
+{
+    ScriptModule module = parseScript(src);
+    ScriptProgram program = compileScript(module);
+    std::ostringstream out;
+    ScriptVM vm(program, out);
+    vm.run();
+    return out.str();
+}
+
+std::string runInterp(const std::string& src)
+{
+    ScriptModule module = parseScript(src);
+    std::ostringstream out;
+    ScriptInterpreter interp(module, out);
+    interp.run();
+    return out.str();
+}
+
+// 파서가 line N: ... nested too deeply 로 거절해야 한다
+void expectTooDeep(const std::string& what, const std::string& src)
+{
+    gChecks++;
+    try {
+        parseScript(src);
+        fail(what, "accepted");
+    } catch (const std::exception& e) {
+        std::string msg = e.what();
+        if (msg.find("nested too deeply") == std::string::npos || msg.rfind("line ", 0) != 0)
+            fail(what, "wrong error: " + msg);
+    }
+}
+
+// VM 과 인터프리터가 모두 expect 를 출력해야 한다
+void expectOutput(const std::string& what, const std::string& src, const std::string& expect)
+{
+    struct Path {
+        const char* name;
+        std::string (*run)(const std::string&);
+    };
+    for (const Path& p : { Path{ "vm", runVM }, Path{ "interp", runInterp } }) {
+        gChecks++;
+        try {
+            std::string got = p.run(src);
+            if (got != expect) fail(what + " " + p.name, "expect: " + expect + "  got: " + got);
+        } catch (const std::exception& e) {
+            fail(what + " " + p.name, std::string("error: ") + e.what());
+        }
+    }
+}
+
+
+
+// ------------------------------------------------------
+// 깊은 입력
+// ------------------------------------------------------
+std::string nestedParens(int depth)
+{
+    std::string s = "print(";
+    s += std::string(depth, '(');
+    s += "1";
+    s += std::string(depth, ')');
+    s += ")\n";
+    return s;
+}
+
+std::string nestedIfs(int depth)
+{
+    std::string s = "let x = 1\n";
+    for (int i = 0; i < depth; ++i) s += "if x == 1 {\n";
+    s += "print(x)\n";
+    for (int i = 0; i < depth; ++i) s += "}\n";
+    return s;
+}
+
+std::string elseIfChain(int length)
+{
+    std::string s = "let x = 0\nif x == 1 { print(1) }\n";
+    for (int i = 0; i < length; ++i) s += "else if x == 1 { print(1) }\n";
+    s += "else { print(x) }\n";
+    return s;
+}
+
+std::string flatSum(int terms)
+{
+    std::string s = "print(1";
+    for (int i = 1; i < terms; ++i) s += " + 1";
+    s += ")\n";
+    return s;
+}
+
+std::string prefixChain(const char* op, int depth, const char* operand)
+{
+    std::string s = "print(";
+    for (int i = 0; i < depth; ++i) s += op;
+    s += operand;
+    s += ")\n";
+    return s;
+}
+
+std::string indexChain(int depth)
+{
+    std::string s = "let xs = [0]\nprint(xs";
+    for (int i = 0; i < depth; ++i) s += "[0]";
+    s += ")\n";
+    return s;
+}
+
+// 파일 전체를 VM 과 인터프리터로 돌려 출력을 비교한다
+void expectSameOutput(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::string src{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    gChecks++;
+    if (src.empty()) {
+        fail(path, "cannot read");
+        return;
+    }
+
+    std::string vm, interp;
+    try {
+        vm = runVM(src);
+        interp = runInterp(src);
+    } catch (const std::exception& e) {
+        fail(path, std::string("error: ") + e.what());
+        return;
+    }
+    if (vm.empty()) fail(path, "no output");
+    else if (vm != interp) fail(path, "vm:\n" + vm + "  interp:\n" + interp);
+}
+
+} // namespace
+
+
+
+int main()
+{
+    // 리뷰에서 segfault 를 낸 입력과 그 변형
+    expectTooDeep("parens 20000", nestedParens(20000));
+    expectTooDeep("if 100000", nestedIfs(100000));
+    expectTooDeep("else if 100000", elseIfChain(100000));
+    expectTooDeep("sum 50000", flatSum(50000));
+    expectTooDeep("neg 100000", prefixChain("-", 100000, "1"));
+    expectTooDeep("not 100000", prefixChain("not ", 100000, "true"));
+    expectTooDeep("index 100000", indexChain(100000));
+
+    // 상한 안쪽은 그대로 동작
+    expectOutput("parens 200", nestedParens(200), "1\n");
+    expectOutput("if 200", nestedIfs(200), "1\n");
+    expectOutput("else if 200", elseIfChain(200), "0\n");
+    expectOutput("sum 500", flatSum(500), "500\n");
+    expectOutput("neg 200", prefixChain("-", 200, "1"), "1\n");
+
+    expectSameOutput(SPONGE_EXAMPLES_DIR "/xagi_fullstack.sp");
+
+    std::printf("%zu checks, %zu failures\n", gChecks, gFailures);
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,707 @@
+#!/usr/bin/env python3
+"""packs/*.meta -> built-in language C++ (see src/meta/meta_builtin.hpp)
+
+    generate_builtin.py -o meta_builtin_packs.cpp packs/rust.meta [...]
+
+Per pack it writes constexpr operator/token/IR tables, a direct-coded lexer
+(the pack's token DFA as goto/switch) and an evaluateBuiltin<> specialization
+whose apply() switch has every operator kernel as a constant.
+
+The three pieces mirror the runtime so a built-in pack behaves exactly like
+the same file loaded through MetaAbsorbLoader:
+  - .meta reading          MetaAbsorbLoader::loadFromFile
+  - lexer rule list        GrammarBuilder::build
+  - regex syntax and DFA   LexerDFA (longest match, earlier rule wins ties)
+
+Files without a `language:` line (the meta.meta schema) are skipped.
+Standard library only.
+"""
+import argparse
+import os
+import re
+import sys
+
+# ----------------------------------------------------------
+# .meta reading (MetaAbsorbLoader::loadFromFile)
+# ----------------------------------------------------------
+SECTIONS = {
+    "tokens:": "tokens",
+    "operators:": "operators",
+    "evaluate:": "evaluate",
+    "ir:": "ir",
+    "bytecode:": "bytecode",
+}
+
+
+def trim(s):
+    return s.strip(" \t\r\n")
+
+
+def load_pack(path):
+    # bytes 1:1 (latin-1) so regexes and names go through unchanged
+    with open(path, "rb") as f:
+        text = f.read().decode("latin-1")
+
+    pack = {
+        "path": path, "name": "",
+        "tokens": {}, "precedence": {}, "assoc": {},
+        "evaluate": {}, "ir": {}, "bytecode": {},
+    }
+    section = None
+    for raw in text.split("\n"):
+        line = trim(raw)
+        if not line:
+            continue
+        if line.startswith("language:"):
+            pack["name"] = trim(line[line.find(":") + 1:])
+            continue
+        if line in SECTIONS:
+            section = SECTIONS[line]
+            continue
+        if ":" not in line:
+            continue
+
+        key = trim(line[:line.find(":")])
+        val = trim(line[line.find(":") + 1:])
+        if val and val[0] == '"' and val[-1] == '"':
+            val = val[1:-1]
+
+        if section == "tokens":
+            pack["tokens"][key] = val
+        elif section == "operators":
+            # "30" or "30 right" (std::stoi + rest)
+            m = re.match(r"[ \t\n\v\f\r]*[+-]?[0-9]+", val)
+            if not m:
+                raise SystemExit("%s: bad precedence for '%s': %s" % (path, key, val))
+            pack["precedence"][key] = int(m.group(0))
+            assoc = trim(val[m.end():])
+            if assoc in ("left", "right"):
+                pack["assoc"][key] = assoc
+            elif assoc:
+                raise SystemExit("%s: bad associativity for '%s': %s" % (path, key, assoc))
+        elif section in ("evaluate", "ir", "bytecode"):
+            pack[section][key] = val
+    return pack
+
+
+# ----------------------------------------------------------
+# kernels (kernelFromRule)
+# ----------------------------------------------------------
+KERNEL_RULES = {
+    "a+b": "ADD", "a-b": "SUB", "a*b": "MUL", "a/b": "DIV", "a%b": "MOD",
+    "pow(a,b)": "POW", "min(a,b)": "MIN", "max(a,b)": "MAX",
+    "a^b": "POW", "a**b": "POW",
+}
+
+
+def kernel_from_rule(rule):
+    return KERNEL_RULES.get(rule.replace(" ", "").replace("\t", ""), "GENERIC")
+
+
+# ----------------------------------------------------------
+# operator table: GrammarBuilder intern order
+#   + - * / first, then the pack's operators, then evaluate/bytecode-only ones
+# ----------------------------------------------------------
+def operator_table(pack):
+    order = ["+", "-", "*", "/"]
+    for name in list(pack["precedence"]) + list(pack["evaluate"]) + list(pack["bytecode"]):
+        if name and name not in order:
+            order.append(name)
+
+    # operators the parser can see must come before evaluate-only ones
+    infix = [n for n in order if n in ("+", "-", "*", "/") or n in pack["precedence"]]
+    rest = [n for n in order if n not in infix]
+
+    ops = []
+    for name in infix + rest:
+        flags = []
+        if name in pack["precedence"]:
+            flags.append("PACK_OP_PRECEDENCE")
+            if pack["assoc"].get(name) == "right":
+                flags.append("PACK_OP_RIGHT_ASSOC")
+        kernel = "NONE"
+        if name in pack["evaluate"]:
+            flags.append("PACK_OP_EVAL")
+            kernel = kernel_from_rule(pack["evaluate"][name])
+        if name in pack["bytecode"]:
+            flags.append("PACK_OP_BYTECODE")
+        ops.append({
+            "name": name,
+            "precedence": pack["precedence"].get(name, 0),
+            "kernel": kernel,
+            "flags": flags,
+            "bytecode": pack["bytecode"].get(name),
+        })
+    return ops, len(infix)
+
+
+# ----------------------------------------------------------
+# lexer rules (GrammarBuilder::build)
+# ----------------------------------------------------------
+DEFAULT_NUMBER = r"([0-9]+(\.[0-9]*)?|\.[0-9]+)([eE][+\-]?[0-9]+)?"
+DEFAULT_IDENT = r"[A-Za-z_][A-Za-z0-9_]*"
+DEFAULT_SPACE = r"[ \t\r\n\f\v]+"
+
+
+def ascii_lower(s):
+    return "".join(chr(ord(c) + 32) if "A" <= c <= "Z" else c for c in s)
+
+
+def lexer_rules(pack, ops, infix_count):
+    rules = []      # ("lit" | "re", text)
+    for op in ops[:infix_count]:
+        rules.append(("lit", op["name"]))
+    rules.append(("lit", "("))
+    rules.append(("lit", ")"))
+
+    have_number = have_ident = have_skip = False
+    for name in sorted(pack["tokens"], key=lambda n: n.encode("latin-1")):
+        lower = ascii_lower(name)
+        if any(k in lower for k in ("space", "skip", "comment")) or lower == "ws":
+            have_skip = True
+        elif any(k in lower for k in ("num", "int", "float", "digit")):
+            have_number = True
+        elif any(k in lower for k in ("ident", "name", "var")) or lower == "id":
+            have_ident = True
+        rules.append(("re", pack["tokens"][name]))
+
+    if not have_number:
+        rules.append(("re", DEFAULT_NUMBER))
+    if not have_ident:
+        rules.append(("re", DEFAULT_IDENT))
+    if not have_skip:
+        rules.append(("re", DEFAULT_SPACE))
+    return rules
+
+
+# ----------------------------------------------------------
+# regex -> AST (LexerDFA's RegexParser); byte sets are 256-bit ints
+# ----------------------------------------------------------
+ALL = (1 << 256) - 1
+
+
+def brange(lo, hi):
+    return ((1 << (hi + 1)) - 1) ^ ((1 << lo) - 1)
+
+
+def bset(*chars):
+    m = 0
+    for c in chars:
+        m |= 1 << ord(c)
+    return m
+
+
+DIGIT = brange(ord("0"), ord("9"))
+WORD = brange(ord("a"), ord("z")) | brange(ord("A"), ord("Z")) | DIGIT | bset("_")
+SPACE = bset(" ", "\t", "\n", "\r", "\f", "\v")
+
+
+class RegexError(Exception):
+    pass
+
+
+class RegexParser:
+    def __init__(self, re_):
+        self.re = re_
+        self.pos = 0
+
+    def fail(self, why):
+        raise RegexError('regex error in "%s" at %d: %s' % (self.re, self.pos, why))
+
+    def more(self):
+        return self.pos < len(self.re)
+
+    def peek(self):
+        return self.re[self.pos]
+
+    def parse(self):
+        n = self.alt()
+        if self.pos != len(self.re):
+            self.fail("unexpected ')'")
+        return n
+
+    def alt(self):
+        first = self.cat()
+        if not self.more() or self.peek() != "|":
+            return first
+        kids = [first]
+        while self.more() and self.peek() == "|":
+            self.pos += 1
+            kids.append(self.cat())
+        return ("alt", kids)
+
+    def cat(self):
+        kids = []
+        while self.more() and self.peek() not in "|)":
+            kids.append(self.repeat())
+        return ("cat", kids)
+
+    def repeat(self):
+        n = self.atom()
+        while self.more():
+            c = self.peek()
+            if c == "*":
+                lo, hi = 0, -1
+                self.pos += 1
+            elif c == "+":
+                lo, hi = 1, -1
+                self.pos += 1
+            elif c == "?":
+                lo, hi = 0, 1
+                self.pos += 1
+            elif c == "{":
+                lo, hi = self.braces()
+            else:
+                break
+            n = ("rep", n, lo, hi)
+        return n
+
+    def number(self):
+        if not self.more() or not ("0" <= self.peek() <= "9"):
+            self.fail("expected number")
+        v = 0
+        while self.more() and "0" <= self.peek() <= "9":
+            v = v * 10 + ord(self.peek()) - 48
+            if v > 1000:
+                self.fail("repeat count too large")
+            self.pos += 1
+        return v
+
+    def braces(self):
+        self.pos += 1
+        lo = self.number()
+        hi = lo
+        if self.more() and self.peek() == ",":
+            self.pos += 1
+            hi = -1 if (self.more() and self.peek() == "}") else self.number()
+        if not self.more() or self.peek() != "}":
+            self.fail("expected '}'")
+        self.pos += 1
+        if 0 <= hi < lo:
+            self.fail("bad repeat range")
+        return lo, hi
+
+    def escape(self):
+        if not self.more():
+            self.fail("dangling '\\'")
+        c = self.re[self.pos]
+        self.pos += 1
+        table = {
+            "d": DIGIT, "D": ALL ^ DIGIT, "w": WORD, "W": ALL ^ WORD,
+            "s": SPACE, "S": ALL ^ SPACE,
+            "n": bset("\n"), "t": bset("\t"), "r": bset("\r"),
+            "f": bset("\f"), "v": bset("\v"),
+        }
+        return table.get(c, 1 << ord(c))
+
+    def bracket(self):
+        self.pos += 1
+        negate = self.more() and self.peek() == "^"
+        if negate:
+            self.pos += 1
+        s = 0
+        first = True
+        re_ = self.re
+        while self.more() and (self.peek() != "]" or first):
+            first = False
+            if self.peek() == "\\":
+                self.pos += 1
+                e = self.escape()
+                single = e != 0 and (e & (e - 1)) == 0
+                if not single or not (self.more() and self.peek() == "-" and
+                                      self.pos + 1 < len(re_) and re_[self.pos + 1] != "]"):
+                    s |= e
+                    continue
+                lo = e.bit_length() - 1
+                self.pos += 1
+                hi = ord(re_[self.pos])
+                self.pos += 1
+                if hi < lo:
+                    self.fail("bad class range")
+                s |= brange(lo, hi)
+                continue
+            lo = ord(re_[self.pos])
+            self.pos += 1
+            if self.more() and self.peek() == "-" and self.pos + 1 < len(re_) and re_[self.pos + 1] != "]":
+                self.pos += 1
+                hi = ord(re_[self.pos])
+                self.pos += 1
+                if hi < lo:
+                    self.fail("bad class range")
+                s |= brange(lo, hi)
+            else:
+                s |= 1 << lo
+        if not self.more():
+            self.fail("unterminated '['")
+        self.pos += 1
+        return ALL ^ s if negate else s
+
+    def atom(self):
+        c = self.peek()
+        if c == "(":
+            self.pos += 1
+            if self.re[self.pos:self.pos + 2] == "?:":
+                self.pos += 2
+            n = self.alt()
+            if not self.more() or self.peek() != ")":
+                self.fail("expected ')'")
+            self.pos += 1
+            return n
+        if c == "[":
+            return ("set", self.bracket())
+        if c == ".":
+            self.pos += 1
+            return ("set", ALL ^ bset("\n"))
+        if c == "\\":
+            self.pos += 1
+            return ("set", self.escape())
+        if c in "*+?{":
+            self.fail("nothing to repeat")
+        self.pos += 1
+        return ("set", 1 << ord(c))
+
+
+# ----------------------------------------------------------
+# AST -> Thompson NFA -> DFA (subset construction)
+# ----------------------------------------------------------
+class Nfa:
+    def __init__(self):
+        self.mask = []      # byte set of the one character edge (0 = none)
+        self.out = []
+        self.eps = []
+        self.accept = []
+
+    def add(self):
+        self.mask.append(0)
+        self.out.append(-1)
+        self.eps.append([])
+        self.accept.append(-1)
+        return len(self.mask) - 1
+
+    def build(self, n):
+        kind = n[0]
+        if kind == "set":
+            s, e = self.add(), self.add()
+            self.mask[s] = n[1]
+            self.out[s] = e
+            return s, e
+        if kind == "cat":
+            s = self.add()
+            cur = s
+            for k in n[1]:
+                f = self.build(k)
+                self.eps[cur].append(f[0])
+                cur = f[1]
+            return s, cur
+        if kind == "alt":
+            s, e = self.add(), self.add()
+            for k in n[1]:
+                f = self.build(k)
+                self.eps[s].append(f[0])
+                self.eps[f[1]].append(e)
+            return s, e
+        # rep
+        _, k, lo, hi = n
+        s = self.add()
+        cur = s
+        for _ in range(lo):
+            f = self.build(k)
+            self.eps[cur].append(f[0])
+            cur = f[1]
+        if hi < 0:
+            f = self.build(k)
+            e = self.add()
+            self.eps[cur] += [f[0], e]
+            self.eps[f[1]] += [f[0], e]
+            return s, e
+        e = self.add()
+        for _ in range(lo, hi):
+            self.eps[cur].append(e)
+            f = self.build(k)
+            self.eps[cur].append(f[0])
+            cur = f[1]
+        self.eps[cur].append(e)
+        return s, e
+
+    def closure(self, states):
+        seen = set(states)
+        stack = list(states)
+        while stack:
+            s = stack.pop()
+            for t in self.eps[s]:
+                if t not in seen:
+                    seen.add(t)
+                    stack.append(t)
+        return frozenset(seen)
+
+
+def build_dfa(rules):
+    """-> (accept per state, [{byte: target}] per state); state 0 = start"""
+    nfa = Nfa()
+    start = nfa.add()
+    for i, (kind, text) in enumerate(rules):
+        if kind == "lit":
+            ast = ("cat", [("set", 1 << ord(c)) for c in text])
+        else:
+            ast = RegexParser(text).parse()
+        f = nfa.build(ast)
+        nfa.eps[start].append(f[0])
+        nfa.accept[f[1]] = i
+
+    ids = {}
+    sets = []
+    accept = []
+    edges = []
+
+    def intern(s):
+        if s in ids:
+            return ids[s]
+        ids[s] = len(sets)
+        sets.append(s)
+        acc = [nfa.accept[x] for x in s if nfa.accept[x] >= 0]
+        accept.append(min(acc) if acc else -1)
+        edges.append({})
+        return ids[s]
+
+    intern(nfa.closure([start]))
+    d = 0
+    while d < len(sets):
+        moved = [set() for _ in range(256)]
+        for s in sets[d]:
+            m = nfa.mask[s]
+            while m:
+                low = m & -m
+                moved[low.bit_length() - 1].add(nfa.out[s])
+                m ^= low
+        targets = {}
+        for b in range(256):
+            if not moved[b]:
+                continue
+            key = frozenset(moved[b])
+            if key not in targets:
+                targets[key] = intern(nfa.closure(key))
+            edges[d][b] = targets[key]
+        d += 1
+
+    # an empty match is not a token
+    accept[0] = -1
+    return accept, edges
+
+
+# ----------------------------------------------------------
+# C++ output
+# ----------------------------------------------------------
+def c_string(s):
+    out = ['"']
+    for ch in s:
+        b = ord(ch)
+        if ch in '"\\':
+            out.append("\\" + ch)
+        elif 32 <= b < 127 and ch != "?":
+            out.append(ch)
+        else:
+            out.append("\\%03o" % b)
+    out.append('"')
+    return "".join(out)
+
+
+def c_char(b):
+    ch = chr(b)
+    if ch in "'\\":
+        return "'\\%s'" % ch
+    if 32 <= b < 127:
+        return "'%s'" % ch
+    return "0x%02x" % b
+
+
+def cpp_ident(name):
+    s = re.sub(r"[^A-Za-z0-9]", "_", name)
+    return s[:1].upper() + s[1:]
+
+
+def emit_lexer(out, fn, accept, edges):
+    # a state is labelled only if something jumps to it (-Wunused-label)
+    targeted = set(t for e in edges for t in e.values())
+
+    out.append("size_t %s(std::string_view src, size_t pos, int& rule)" % fn)
+    out.append("{")
+    out.append("    const unsigned char* p = reinterpret_cast<const unsigned char*>(src.data());")
+    out.append("    const size_t end = src.size();")
+    out.append("    size_t i = pos;")
+    out.append("    size_t last = 0;")
+    out.append("    int lastRule = -1;")
+    out.append("    unsigned char c;")
+    out.append("")
+
+    for s in range(len(edges)):
+        if s in targeted:
+            out.append("s%d:" % s)
+        if accept[s] >= 0:
+            out.append("    last = i - pos;")
+            out.append("    lastRule = %d;" % accept[s])
+        e = edges[s]
+        if not e:
+            out.append("    goto done;")
+            continue
+        out.append("    if (i == end) goto done;")
+        out.append("    c = p[i++];")
+
+        # the target with the most bytes (or "no edge") becomes the default
+        count = {}
+        for b in range(256):
+            t = e.get(b, -1)
+            count[t] = count.get(t, 0) + 1
+        default = max(count, key=lambda t: (count[t], t == -1))
+        cases = {}
+        for b in range(256):
+            t = e.get(b, -1)
+            if t != default:
+                cases.setdefault(t, []).append(b)
+
+        if cases:
+            out.append("    switch (c) {")
+            for t in sorted(cases, key=lambda t: cases[t][0]):
+                labels = ["case %s:" % c_char(b) for b in cases[t]]
+                for k in range(0, len(labels), 8):
+                    out.append("        " + " ".join(labels[k:k + 8]))
+                out.append("            goto %s;" % ("done" if t < 0 else "s%d" % t))
+            out.append("        default:")
+            out.append("            goto %s;" % ("done" if default < 0 else "s%d" % default))
+            out.append("    }")
+        else:
+            out.append("    goto %s;" % ("done" if default < 0 else "s%d" % default))
+
+    out.append("done:")
+    out.append("    rule = lastRule;")
+    out.append("    return last;")
+    out.append("}")
+
+
+def emit_pack(out, pack, ident):
+    ops, infix_count = operator_table(pack)
+    rules = lexer_rules(pack, ops, infix_count)
+    try:
+        accept, edges = build_dfa(rules)
+    except RegexError as e:
+        raise SystemExit("%s: %s" % (pack["path"], e))
+
+    out.append("// ------------------------------------------------------")
+    out.append("// %s (%s): %d operators, %d lexer rules, %d DFA states"
+               % (pack["name"], os.path.basename(pack["path"]), len(ops), len(rules), len(edges)))
+    out.append("// ------------------------------------------------------")
+
+    if pack["tokens"]:
+        out.append("constexpr BuiltinPair k%sTokens[] = {" % ident)
+        for name, regex in pack["tokens"].items():
+            out.append("    { %s, %s }," % (c_string(name), c_string(regex)))
+        out.append("};")
+        out.append("")
+
+    out.append("constexpr BuiltinOp k%sOps[] = {" % ident)
+    for i, op in enumerate(ops):
+        flags = " | ".join(op["flags"]) or "0"
+        bc = c_string(op["bytecode"]) if op["bytecode"] is not None else "nullptr"
+        out.append("    { %s, %d, OpKernel::%s, %s, %s },   // %d"
+                   % (c_string(op["name"]), op["precedence"], op["kernel"], flags, bc, i))
+    out.append("};")
+    out.append("")
+
+    if pack["ir"]:
+        out.append("constexpr BuiltinPair k%sIR[] = {" % ident)
+        for k, v in pack["ir"].items():
+            out.append("    { %s, %s }," % (c_string(k), c_string(v)))
+        out.append("};")
+        out.append("")
+
+    emit_lexer(out, "lex%s" % ident, accept, edges)
+    out.append("")
+
+    out.append("struct %sOps {" % ident)
+    out.append("    static double apply(const OperatorTable& ops, OpId op, double a, double b)")
+    out.append("    {")
+    out.append("        switch (op) {")
+    for i, op in enumerate(ops):
+        if "PACK_OP_EVAL" not in op["flags"]:
+            continue
+        if op["kernel"] == "GENERIC":
+            # MetaAbsorbLoader::mount 과 같게: 모르는 평가식은 0
+            out.append("            case %d: return 0.0;   // %s" % (i, op["name"]))
+        else:
+            out.append("            case %d: return applyKernel(OpKernel::%s, a, b);   // %s"
+                       % (i, op["kernel"], op["name"]))
+    out.append("            default: builtinUnknownOperator(ops, op);")
+    out.append("        }")
+    out.append("    }")
+    out.append("};")
+    out.append("")
+
+    out.append("constexpr BuiltinLanguage k%s = {" % ident)
+    out.append("    %s," % c_string(pack["name"]))
+    out.append("    %s," % ("k%sTokens" % ident if pack["tokens"] else "{}"))
+    out.append("    k%sOps," % ident)
+    out.append("    %s," % ("k%sIR" % ident if pack["ir"] else "{}"))
+    out.append("    &lex%s, %d," % (ident, len(rules)))
+    out.append("    &evaluateBuiltin<%sOps>," % ident)
+    out.append("};")
+    out.append("")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("-o", "--output", required=True)
+    ap.add_argument("packs", nargs="+")
+    args = ap.parse_args()
+
+    packs = [p for p in (load_pack(path) for path in sorted(args.packs)) if p["name"]]
+
+    out = [
+        "// Generated by tools/generate_builtin.py from:",
+    ]
+    out += ["//   %s" % os.path.basename(p["path"]) for p in packs]
+    out += [
+        "// Do not edit.",
+        "#include \"meta_builtin.hpp\"",
+        "#include \"meta_pack_binary.hpp\"",
+        "",
+        "namespace sponge {",
+        "",
+        "namespace {",
+        "",
+    ]
+
+    idents = []
+    for p in packs:
+        ident = cpp_ident(p["name"])
+        if ident in idents:
+            raise SystemExit("%s: duplicate built-in language '%s'" % (p["path"], p["name"]))
+        idents.append(ident)
+        emit_pack(out, p, ident)
+
+    out += [
+        "} // namespace",
+        "",
+        "std::span<const BuiltinLanguage* const> generatedBuiltins()",
+        "{",
+    ]
+    if idents:
+        out.append("    static const BuiltinLanguage* const all[] = { %s };"
+                   % ", ".join("&k%s" % i for i in idents))
+        out.append("    return all;")
+    else:
+        out.append("    return {};")
+    out += [
+        "}",
+        "",
+        "} // namespace sponge",
+        "",
+    ]
+
+    text = "\n".join(out)
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w", encoding="latin-1", newline="\n") as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())